@@ -0,0 +1,300 @@
+/**
+ * @file acc_features.c
+ *
+ * @brief This file reduces a stream of acceleration samples into per window vibration features: mean, RMS, peak and
+ * zero-crossing rate per axis, plus band energies of the vector magnitude from a small windowed FFT. It has no
+ * hardware dependencies and works sample by sample, so raw data never has to be buffered for a whole window.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "acc_features.h"
+#include "json_writer.h"
+#include <math.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#if (0U != (ACC_FEATURES_FFT_SIZE & (ACC_FEATURES_FFT_SIZE - 1U))) || (0U != (ACC_FEATURES_WINDOW_SIZE % ACC_FEATURES_FFT_SIZE))
+#error "ACC_FEATURES_FFT_SIZE must be a power of two that divides ACC_FEATURES_WINDOW_SIZE"
+#endif
+
+#define ACC_FEATURES_PI (3.14159265358979f)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Clears the per window accumulators. Zero-crossing references and FFT tables are kept.
+ */
+static void _window_reset(acc_features_ctx_t *p_ctx);
+
+/**
+ * @brief Runs the FFT over the collected segment and adds its band energies to the window sums.
+ */
+static void _segment_process(acc_features_ctx_t *p_ctx);
+
+/**
+ * @brief In place iterative radix-2 FFT over p_ctx->re and p_ctx->im.
+ */
+static void _fft(acc_features_ctx_t *p_ctx);
+
+/**
+ * @brief Appends a named array of floats to the JSON being built.
+ */
+static void _json_array(json_writer_t *p_writer, const char *p_name, const float *p_values, uint8_t count);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+void acc_features_init(acc_features_ctx_t *p_ctx, float sample_rate_hz)
+{
+    memset(p_ctx, 0, sizeof(*p_ctx));
+    p_ctx->sample_rate_hz = sample_rate_hz;
+
+    /* Hann window; its power normalizes band energies back to the mean square of the signal. */
+    for(uint16_t i = 0U; i < ACC_FEATURES_FFT_SIZE; i++)
+    {
+        p_ctx->window[i] = 0.5f - (0.5f * cosf((2.0f * ACC_FEATURES_PI * (float)i) / (float)ACC_FEATURES_FFT_SIZE));
+        p_ctx->window_power += p_ctx->window[i] * p_ctx->window[i];
+    }
+
+    for(uint16_t i = 0U; i < (ACC_FEATURES_FFT_SIZE / 2U); i++)
+    {
+        p_ctx->twiddle_cos[i] = cosf((2.0f * ACC_FEATURES_PI * (float)i) / (float)ACC_FEATURES_FFT_SIZE);
+        p_ctx->twiddle_sin[i] = sinf((2.0f * ACC_FEATURES_PI * (float)i) / (float)ACC_FEATURES_FFT_SIZE);
+    }
+
+    _window_reset(p_ctx);
+}
+
+bool acc_features_add(acc_features_ctx_t *p_ctx, const float p_sample[ACC_AXIS_COUNT], acc_features_t *p_features)
+{
+    if(0U == p_ctx->count)
+    {
+        for(uint8_t axis = 0U; axis < ACC_AXIS_COUNT; axis++)
+        {
+            p_ctx->shift[axis] = p_sample[axis];
+            p_ctx->min[axis]   = p_sample[axis];
+            p_ctx->max[axis]   = p_sample[axis];
+        }
+    }
+
+    if(!p_ctx->b_has_zc_ref)
+    {
+        /* The very first window has no previous mean, so it crosses around its first sample. */
+        for(uint8_t axis = 0U; axis < ACC_AXIS_COUNT; axis++)
+        {
+            p_ctx->zc_ref[axis]     = p_sample[axis];
+            p_ctx->b_zc_above[axis] = false;
+        }
+        p_ctx->b_has_zc_ref = true;
+    }
+
+    float magnitude_sq = 0.0f;
+
+    for(uint8_t axis = 0U; axis < ACC_AXIS_COUNT; axis++)
+    {
+        float value = p_sample[axis];
+        float delta = value - p_ctx->shift[axis];
+
+        p_ctx->sum[axis] += delta;
+        p_ctx->sum_sq[axis] += delta * delta;
+        p_ctx->min[axis] = (value < p_ctx->min[axis]) ? value : p_ctx->min[axis];
+        p_ctx->max[axis] = (value > p_ctx->max[axis]) ? value : p_ctx->max[axis];
+
+        bool b_is_above = (value > p_ctx->zc_ref[axis]);
+        if(b_is_above != p_ctx->b_zc_above[axis])
+        {
+            p_ctx->zc_count[axis]++;
+            p_ctx->b_zc_above[axis] = b_is_above;
+        }
+
+        magnitude_sq += value * value;
+    }
+
+    p_ctx->re[p_ctx->segment_count] = sqrtf(magnitude_sq);
+    p_ctx->segment_count++;
+    p_ctx->count++;
+
+    if(ACC_FEATURES_FFT_SIZE == p_ctx->segment_count)
+    {
+        _segment_process(p_ctx);
+    }
+
+    if(ACC_FEATURES_WINDOW_SIZE > p_ctx->count)
+    {
+        return false;
+    }
+
+    float count = (float)p_ctx->count;
+
+    p_features->sample_count   = p_ctx->count;
+    p_features->sample_rate_hz = p_ctx->sample_rate_hz;
+
+    for(uint8_t axis = 0U; axis < ACC_AXIS_COUNT; axis++)
+    {
+        float mean_delta = p_ctx->sum[axis] / count;
+        float variance   = (p_ctx->sum_sq[axis] / count) - (mean_delta * mean_delta);
+        float mean       = p_ctx->shift[axis] + mean_delta;
+        float peak_high  = p_ctx->max[axis] - mean;
+        float peak_low   = mean - p_ctx->min[axis];
+
+        p_features->mean[axis]   = mean;
+        p_features->rms[axis]    = (0.0f < variance) ? sqrtf(variance) : 0.0f;
+        p_features->peak[axis]   = (peak_high > peak_low) ? peak_high : peak_low;
+        p_features->zcr_hz[axis] = ((float)p_ctx->zc_count[axis] * p_ctx->sample_rate_hz) / count;
+
+        /* The next window crosses around this window's mean. */
+        p_ctx->zc_ref[axis] = mean;
+    }
+
+    for(uint8_t band = 0U; band < ACC_FEATURES_BAND_COUNT; band++)
+    {
+        p_features->band_energy[band] = p_ctx->band_sum[band] / (float)p_ctx->segments_done;
+    }
+
+    _window_reset(p_ctx);
+
+    return true;
+}
+
+esp_err_t acc_features_to_json(const acc_features_t *p_features, char *p_buf, size_t buf_size, size_t *p_len)
+{
+    if((NULL == p_features) || (NULL == p_buf) || (NULL == p_len))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    json_writer_t writer;
+
+    json_writer_init(&writer, p_buf, buf_size);
+    json_writer_printf(&writer, "{\"ts\":%lu,\"n\":%u,\"fs\":", (unsigned long)p_features->timestamp_ms,
+                       (unsigned)p_features->sample_count);
+    json_writer_float(&writer, p_features->sample_rate_hz);
+    _json_array(&writer, "mean", p_features->mean, ACC_AXIS_COUNT);
+    _json_array(&writer, "rms", p_features->rms, ACC_AXIS_COUNT);
+    _json_array(&writer, "peak", p_features->peak, ACC_AXIS_COUNT);
+    _json_array(&writer, "zcr", p_features->zcr_hz, ACC_AXIS_COUNT);
+    _json_array(&writer, "bands", p_features->band_energy, ACC_FEATURES_BAND_COUNT);
+    json_writer_printf(&writer, "}");
+
+    return json_writer_finish(&writer, p_len);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _window_reset(acc_features_ctx_t *p_ctx)
+{
+    p_ctx->count         = 0U;
+    p_ctx->segment_count = 0U;
+    p_ctx->segments_done = 0U;
+
+    memset(p_ctx->sum, 0, sizeof(p_ctx->sum));
+    memset(p_ctx->sum_sq, 0, sizeof(p_ctx->sum_sq));
+    memset(p_ctx->zc_count, 0, sizeof(p_ctx->zc_count));
+    memset(p_ctx->band_sum, 0, sizeof(p_ctx->band_sum));
+}
+
+static void _segment_process(acc_features_ctx_t *p_ctx)
+{
+    float mean = 0.0f;
+
+    for(uint16_t i = 0U; i < ACC_FEATURES_FFT_SIZE; i++)
+    {
+        mean += p_ctx->re[i];
+    }
+    mean /= (float)ACC_FEATURES_FFT_SIZE;
+
+    /* Gravity would otherwise leak from DC into the lowest band. */
+    for(uint16_t i = 0U; i < ACC_FEATURES_FFT_SIZE; i++)
+    {
+        p_ctx->re[i] = (p_ctx->re[i] - mean) * p_ctx->window[i];
+        p_ctx->im[i] = 0.0f;
+    }
+
+    _fft(p_ctx);
+
+    /* One sided spectrum without DC and Nyquist, scaled so the bands add up to the mean square of the segment. */
+    float scale = 2.0f / ((float)ACC_FEATURES_FFT_SIZE * p_ctx->window_power);
+
+    for(uint16_t bin = 1U; bin < (ACC_FEATURES_FFT_SIZE / 2U); bin++)
+    {
+        uint8_t band = (uint8_t)(((uint32_t)bin * ACC_FEATURES_BAND_COUNT) / (ACC_FEATURES_FFT_SIZE / 2U));
+        p_ctx->band_sum[band] += ((p_ctx->re[bin] * p_ctx->re[bin]) + (p_ctx->im[bin] * p_ctx->im[bin])) * scale;
+    }
+
+    p_ctx->segment_count = 0U;
+    p_ctx->segments_done++;
+}
+
+static void _fft(acc_features_ctx_t *p_ctx)
+{
+    float *p_re = p_ctx->re;
+    float *p_im = p_ctx->im;
+
+    for(uint16_t i = 1U, j = 0U; i < ACC_FEATURES_FFT_SIZE; i++)
+    {
+        uint16_t bit = ACC_FEATURES_FFT_SIZE >> 1;
+        for(; 0U != (j & bit); bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+
+        if(i < j)
+        {
+            float tmp = p_re[i];
+            p_re[i]   = p_re[j];
+            p_re[j]   = tmp;
+            tmp       = p_im[i];
+            p_im[i]   = p_im[j];
+            p_im[j]   = tmp;
+        }
+    }
+
+    for(uint16_t len = 2U; len <= ACC_FEATURES_FFT_SIZE; len <<= 1)
+    {
+        uint16_t half = len >> 1;
+        uint16_t step = ACC_FEATURES_FFT_SIZE / len;
+
+        for(uint16_t start = 0U; start < ACC_FEATURES_FFT_SIZE; start += len)
+        {
+            for(uint16_t k = 0U; k < half; k++)
+            {
+                float w_re = p_ctx->twiddle_cos[k * step];
+                float w_im = -p_ctx->twiddle_sin[k * step];
+
+                uint16_t a    = start + k;
+                uint16_t b    = a + half;
+                float    t_re = (p_re[b] * w_re) - (p_im[b] * w_im);
+                float    t_im = (p_re[b] * w_im) + (p_im[b] * w_re);
+
+                p_re[b] = p_re[a] - t_re;
+                p_im[b] = p_im[a] - t_im;
+                p_re[a] += t_re;
+                p_im[a] += t_im;
+            }
+        }
+    }
+}
+
+static void _json_array(json_writer_t *p_writer, const char *p_name, const float *p_values, uint8_t count)
+{
+    json_writer_printf(p_writer, ",\"%s\":[", p_name);
+
+    for(uint8_t i = 0U; i < count; i++)
+    {
+        if(0U != i)
+        {
+            json_writer_printf(p_writer, ",");
+        }
+        json_writer_float(p_writer, p_values[i]);
+    }
+
+    json_writer_printf(p_writer, "]");
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,135 @@
+/**
+ * @file acc_features.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __ACC_FEATURES_C__
+#define __ACC_FEATURES_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+/* Number of samples one feature window is computed over. */
+#define ACC_FEATURES_WINDOW_SIZE (1024U)
+
+/* FFT length, must be a power of two that divides the window size. Band energies are averaged over the segments. */
+#define ACC_FEATURES_FFT_SIZE (256U)
+
+/* Number of equal width frequency bands between DC and half of the sample rate. */
+#define ACC_FEATURES_BAND_COUNT (4U)
+
+/* Worst case length of one JSON encoded feature set, with every float at its longest 16 characters. */
+#define ACC_FEATURES_JSON_SIZE_MAX (384U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Enums hold accelerometer axes.
+ *
+ */
+typedef enum
+{
+    ACC_AXIS_X,
+    ACC_AXIS_Y,
+    ACC_AXIS_Z,
+
+    ACC_AXIS_COUNT
+} acc_axis_t;
+
+/**
+ * @brief Features of one window, all accelerations in g.
+ *
+ */
+typedef struct
+{
+    uint32_t timestamp_ms;                         /* Milliseconds since boot, filled in by the driver. */
+    uint16_t sample_count;
+    float    sample_rate_hz;
+    float    mean[ACC_AXIS_COUNT];                 /* Static component, i.e. orientation. */
+    float    rms[ACC_AXIS_COUNT];                  /* RMS of the signal with the mean removed. */
+    float    peak[ACC_AXIS_COUNT];                 /* Largest deviation from the mean. */
+    float    zcr_hz[ACC_AXIS_COUNT];               /* Crossings of the previous window's mean per second. */
+    float    band_energy[ACC_FEATURES_BAND_COUNT]; /* Mean square of the vector magnitude per band, g^2. */
+} acc_features_t;
+
+/**
+ * @brief Running state of the feature extractor. It is large, so keep it in static memory.
+ *
+ */
+typedef struct
+{
+    float    sample_rate_hz;
+    uint16_t count;
+
+    /* Sums are taken around the first sample of the window to keep float cancellation small. */
+    float shift[ACC_AXIS_COUNT];
+    float sum[ACC_AXIS_COUNT];
+    float sum_sq[ACC_AXIS_COUNT];
+    float min[ACC_AXIS_COUNT];
+    float max[ACC_AXIS_COUNT];
+
+    float    zc_ref[ACC_AXIS_COUNT];
+    bool     b_zc_above[ACC_AXIS_COUNT];
+    uint16_t zc_count[ACC_AXIS_COUNT];
+    bool     b_has_zc_ref;
+
+    uint16_t segment_count;
+    uint8_t  segments_done;
+    float    band_sum[ACC_FEATURES_BAND_COUNT];
+    float    re[ACC_FEATURES_FFT_SIZE];
+    float    im[ACC_FEATURES_FFT_SIZE];
+    float    window[ACC_FEATURES_FFT_SIZE];
+    float    twiddle_cos[ACC_FEATURES_FFT_SIZE / 2U];
+    float    twiddle_sin[ACC_FEATURES_FFT_SIZE / 2U];
+    float    window_power;
+} acc_features_ctx_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function resets the extractor and precomputes FFT tables.
+ *
+ * @param [out] p_ctx          Extractor state.
+ * @param [in]  sample_rate_hz Rate the samples are produced at.
+ */
+void acc_features_init(acc_features_ctx_t *p_ctx, float sample_rate_hz);
+
+/**
+ * @brief The function adds one sample. When it closes a window the features are written out and the next window
+ * starts.
+ *
+ * @param [in]  p_ctx      Extractor state.
+ * @param [in]  p_sample   Acceleration per axis in g.
+ * @param [out] p_features Written only when the function returns true.
+ *
+ * @return true if a window was closed, false otherwise.
+ */
+bool acc_features_add(acc_features_ctx_t *p_ctx, const float p_sample[ACC_AXIS_COUNT], acc_features_t *p_features);
+
+/**
+ * @brief The function serializes one feature set into compact JSON.
+ *
+ * @param [in]  p_features Features to be encoded.
+ * @param [out] p_buf      Destination buffer, NUL terminated on success.
+ * @param [in]  buf_size   Size of the destination buffer.
+ * @param [out] p_len      Number of bytes written without the terminator.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_SIZE if the buffer is too small, fail otherwise.
+ */
+esp_err_t acc_features_to_json(const acc_features_t *p_features, char *p_buf, size_t buf_size, size_t *p_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __ACC_FEATURES_C__
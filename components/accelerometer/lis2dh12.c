@@ -0,0 +1,369 @@
+/**
+ * @file lis2dh12.c
+ *
+ * @brief This file is the LIS2DH12 accelerometer driver. The sensor samples into its hardware FIFO in stream mode and
+ * the driver task drains the whole FIFO with one burst read per wakeup, then feeds the samples into the feature
+ * extractor. Only finished feature windows leave the driver, raw samples never do.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "lis2dh12.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdbool.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define LIS2DH12_REG_WHO_AM_I  (0x0FU)
+#define LIS2DH12_REG_CTRL_REG1 (0x20U)
+#define LIS2DH12_REG_CTRL_REG3 (0x22U)
+#define LIS2DH12_REG_CTRL_REG4 (0x23U)
+#define LIS2DH12_REG_CTRL_REG5 (0x24U)
+#define LIS2DH12_REG_OUT_X_L   (0x28U)
+#define LIS2DH12_REG_FIFO_CTRL (0x2EU)
+#define LIS2DH12_REG_FIFO_SRC  (0x2FU)
+
+#define LIS2DH12_WHO_AM_I_VALUE (0x33U)
+
+/* Sub-address MSB enables auto increment. In FIFO mode it wraps from OUT_Z_H back to OUT_X_L, which is what lets
+ * the whole FIFO be read in one burst. */
+#define LIS2DH12_AUTO_INCREMENT (0x80U)
+
+#define LIS2DH12_CTRL_REG1_XYZ_EN  (0x07U)
+#define LIS2DH12_CTRL_REG3_I1_WTM  (0x04U)
+#define LIS2DH12_CTRL_REG4_BDU     (0x80U)
+#define LIS2DH12_CTRL_REG4_HR      (0x08U)
+#define LIS2DH12_CTRL_REG5_FIFO_EN (0x40U)
+#define LIS2DH12_FIFO_MODE_BYPASS  (0x00U)
+#define LIS2DH12_FIFO_MODE_STREAM  (0x80U)
+#define LIS2DH12_FIFO_SRC_OVRN     (0x40U)
+#define LIS2DH12_FIFO_SRC_FSS_MASK (0x1FU)
+
+/* Half full: leaves the other half as slack for bus contention before the FIFO overruns. */
+#define LIS2DH12_FIFO_WATERMARK (LIS2DH12_FIFO_SIZE / 2U)
+
+#define LIS2DH12_SAMPLE_SIZE (6U)
+
+#define LIS2DH12_TASK_STACK_SIZE (3U * 1024U)
+#define LIS2DH12_TASK_PRIORITY   (5U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Register value and resulting rate of one output data rate setting.
+ *
+ */
+typedef struct
+{
+    uint8_t odr_bits;
+    float   rate_hz;
+} _lis2dh12_odr_info_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Reads consecutive registers in one transaction.
+ */
+static esp_err_t _read_regs(uint8_t reg, uint8_t *p_data, size_t len, i2c_bus_prio_t prio);
+
+/**
+ * @brief Writes sensor configuration, batched into as few bus transactions as possible.
+ */
+static esp_err_t _configure(void);
+
+/**
+ * @brief Empties the FIFO with one burst read and feeds the samples into the feature extractor.
+ */
+static void _fifo_drain(void);
+
+/**
+ * @brief Driver task, wakes up on the watermark interrupt or polls at half the FIFO fill time.
+ *
+ * @param [in] p_parameter The parameter of the task.
+ */
+static void _lis2dh12_task(void *p_parameter);
+
+/**
+ * @brief FIFO watermark interrupt.
+ *
+ * @param [in] p_arg The argument of the interrupt.
+ */
+static void _int1_isr(void *p_arg);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "LIS2DH12";
+
+static const _lis2dh12_odr_info_t _odr_info[LIS2DH12_ODR_COUNT] = {
+    [LIS2DH12_ODR_100HZ]  = { .odr_bits = 0x5U, .rate_hz = 100.0f },
+    [LIS2DH12_ODR_200HZ]  = { .odr_bits = 0x6U, .rate_hz = 200.0f },
+    [LIS2DH12_ODR_400HZ]  = { .odr_bits = 0x7U, .rate_hz = 400.0f },
+    [LIS2DH12_ODR_1344HZ] = { .odr_bits = 0x9U, .rate_hz = 1344.0f },
+};
+
+/* High resolution mode sensitivity in g per digit of the 12 bit left justified output. */
+static const float _sensitivity[LIS2DH12_RANGE_COUNT] = {
+    [LIS2DH12_RANGE_2G]  = 0.001f,
+    [LIS2DH12_RANGE_4G]  = 0.002f,
+    [LIS2DH12_RANGE_8G]  = 0.004f,
+    [LIS2DH12_RANGE_16G] = 0.012f,
+};
+
+static lis2dh12_config_t _config;
+static bool              _b_is_initialized = false;
+static TaskHandle_t      p_lis2dh12_task   = NULL;
+static lis2dh12_stats_t  _stats;
+
+/* Owned by the driver task. */
+static acc_features_ctx_t _features_ctx;
+static uint8_t            _fifo_data[LIS2DH12_FIFO_SIZE * LIS2DH12_SAMPLE_SIZE];
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t lis2dh12_init(const lis2dh12_config_t *p_config)
+{
+    if((NULL == p_config) || (LIS2DH12_ODR_COUNT <= p_config->odr) || (LIS2DH12_RANGE_COUNT <= p_config->range))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(_b_is_initialized)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    _config = *p_config;
+    acc_features_init(&_features_ctx, _odr_info[_config.odr].rate_hz);
+
+    uint8_t   who_am_i = 0U;
+    esp_err_t esp_err  = i2c_bus_init(_config.port, &_config.bus);
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = _read_regs(LIS2DH12_REG_WHO_AM_I, &who_am_i, 1U, I2C_BUS_PRIO_LOW);
+        esp_err = ((ESP_OK == esp_err) && (LIS2DH12_WHO_AM_I_VALUE != who_am_i)) ? ESP_ERR_NOT_FOUND : esp_err;
+        esp_err = (ESP_FAIL == esp_err) ? ESP_ERR_NOT_FOUND : esp_err;
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        if(pdPASS != xTaskCreate(&_lis2dh12_task, "lis2dh12_task", LIS2DH12_TASK_STACK_SIZE, NULL, LIS2DH12_TASK_PRIORITY,
+                                 &p_lis2dh12_task))
+        {
+            esp_err = ESP_ERR_NO_MEM;
+        }
+    }
+
+    if((ESP_OK == esp_err) && (0 <= _config.int1_io))
+    {
+        gpio_config_t io_conf = {
+            .pin_bit_mask = (1ULL << _config.int1_io),
+            .mode         = GPIO_MODE_INPUT,
+            .pull_up_en   = GPIO_PULLUP_DISABLE,
+            .pull_down_en = GPIO_PULLDOWN_DISABLE,
+            .intr_type    = GPIO_INTR_POSEDGE,
+        };
+        esp_err = gpio_config(&io_conf);
+
+        if(ESP_OK == esp_err)
+        {
+            /* The service may already be installed by another driver. */
+            esp_err = gpio_install_isr_service(0);
+            esp_err = (ESP_ERR_INVALID_STATE == esp_err) ? ESP_OK : esp_err;
+        }
+
+        if(ESP_OK == esp_err)
+        {
+            esp_err = gpio_isr_handler_add(_config.int1_io, _int1_isr, NULL);
+        }
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = _configure();
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        _b_is_initialized = true;
+        xTaskNotifyGive(p_lis2dh12_task);
+    }
+    else
+    {
+        if(0 <= _config.int1_io)
+        {
+            (void)gpio_isr_handler_remove(_config.int1_io);
+        }
+
+        if(NULL != p_lis2dh12_task)
+        {
+            vTaskDelete(p_lis2dh12_task);
+            p_lis2dh12_task = NULL;
+        }
+
+        ESP_LOGE(TAG, "Init failed: %s", esp_err_to_name(esp_err));
+    }
+
+    return esp_err;
+}
+
+void lis2dh12_get_stats(lis2dh12_stats_t *p_stats)
+{
+    if(NULL != p_stats)
+    {
+        *p_stats = _stats;
+    }
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static esp_err_t _read_regs(uint8_t reg, uint8_t *p_data, size_t len, i2c_bus_prio_t prio)
+{
+    uint8_t      sub_address = (1U < len) ? (reg | LIS2DH12_AUTO_INCREMENT) : reg;
+    i2c_bus_op_t op          = {
+        .address   = _config.address,
+        .p_write   = &sub_address,
+        .write_len = 1U,
+        .p_read    = p_data,
+        .read_len  = len,
+    };
+
+    return i2c_bus_transfer(_config.port, &op, 1U, prio);
+}
+
+static esp_err_t _configure(void)
+{
+    const uint8_t ctrl_reg1[2] = { LIS2DH12_REG_CTRL_REG1,
+                                   (uint8_t)((_odr_info[_config.odr].odr_bits << 4) | LIS2DH12_CTRL_REG1_XYZ_EN) };
+    const uint8_t ctrl_reg3[2] = { LIS2DH12_REG_CTRL_REG3, (0 <= _config.int1_io) ? LIS2DH12_CTRL_REG3_I1_WTM : 0U };
+    const uint8_t ctrl_reg4[2] = { LIS2DH12_REG_CTRL_REG4,
+                                   (uint8_t)(LIS2DH12_CTRL_REG4_BDU | (_config.range << 4) | LIS2DH12_CTRL_REG4_HR) };
+    const uint8_t ctrl_reg5[2] = { LIS2DH12_REG_CTRL_REG5, LIS2DH12_CTRL_REG5_FIFO_EN };
+
+    /* Passing through bypass mode clears whatever the FIFO held before a warm reset. */
+    const uint8_t fifo_bypass[2] = { LIS2DH12_REG_FIFO_CTRL, LIS2DH12_FIFO_MODE_BYPASS };
+    const uint8_t fifo_stream[2] = { LIS2DH12_REG_FIFO_CTRL,
+                                     (uint8_t)(LIS2DH12_FIFO_MODE_STREAM | LIS2DH12_FIFO_WATERMARK) };
+
+    const i2c_bus_op_t ctrl_ops[] = {
+        { .address = _config.address, .p_write = ctrl_reg1, .write_len = sizeof(ctrl_reg1) },
+        { .address = _config.address, .p_write = ctrl_reg3, .write_len = sizeof(ctrl_reg3) },
+        { .address = _config.address, .p_write = ctrl_reg4, .write_len = sizeof(ctrl_reg4) },
+        { .address = _config.address, .p_write = ctrl_reg5, .write_len = sizeof(ctrl_reg5) },
+    };
+    const i2c_bus_op_t fifo_ops[] = {
+        { .address = _config.address, .p_write = fifo_bypass, .write_len = sizeof(fifo_bypass) },
+        { .address = _config.address, .p_write = fifo_stream, .write_len = sizeof(fifo_stream) },
+    };
+
+    esp_err_t esp_err = i2c_bus_transfer(_config.port, ctrl_ops, (uint8_t)(sizeof(ctrl_ops) / sizeof(ctrl_ops[0])),
+                                         I2C_BUS_PRIO_LOW);
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = i2c_bus_transfer(_config.port, fifo_ops, (uint8_t)(sizeof(fifo_ops) / sizeof(fifo_ops[0])),
+                                   I2C_BUS_PRIO_LOW);
+    }
+
+    return esp_err;
+}
+
+static void _fifo_drain(void)
+{
+    uint8_t   fifo_src = 0U;
+    esp_err_t esp_err  = _read_regs(LIS2DH12_REG_FIFO_SRC, &fifo_src, 1U, I2C_BUS_PRIO_NORMAL);
+
+    /* FSS counts up to 31, the overrun flag stands for a completely full FIFO. */
+    uint8_t count = (0U != (fifo_src & LIS2DH12_FIFO_SRC_OVRN)) ? LIS2DH12_FIFO_SIZE
+                                                                 : (fifo_src & LIS2DH12_FIFO_SRC_FSS_MASK);
+
+    if((ESP_OK == esp_err) && (0U != count))
+    {
+        esp_err = _read_regs(LIS2DH12_REG_OUT_X_L, _fifo_data, (size_t)count * LIS2DH12_SAMPLE_SIZE, I2C_BUS_PRIO_LOW);
+    }
+
+    if(ESP_OK != esp_err)
+    {
+        _stats.errors++;
+        return;
+    }
+
+    if(0U != (fifo_src & LIS2DH12_FIFO_SRC_OVRN))
+    {
+        _stats.overruns++;
+    }
+
+    float          sensitivity = _sensitivity[_config.range];
+    acc_features_t features;
+
+    for(uint8_t i = 0U; i < count; i++)
+    {
+        const uint8_t *p_raw = &_fifo_data[i * LIS2DH12_SAMPLE_SIZE];
+        float          sample[ACC_AXIS_COUNT];
+
+        for(uint8_t axis = 0U; axis < ACC_AXIS_COUNT; axis++)
+        {
+            /* 12 bit two's complement, left justified in a little endian 16 bit word. */
+            int16_t raw  = (int16_t)((uint16_t)p_raw[(2U * axis) + 1U] << 8 | p_raw[2U * axis]);
+            sample[axis] = (float)(raw >> 4) * sensitivity;
+        }
+
+        if(acc_features_add(&_features_ctx, sample, &features))
+        {
+            features.timestamp_ms = (uint32_t)(esp_timer_get_time() / 1000);
+            _stats.windows++;
+
+            if(NULL != _config.p_features_cb)
+            {
+                _config.p_features_cb(&features, _config.p_cb_arg);
+            }
+
+            if(NULL != _config.p_features_queue)
+            {
+                (void)xQueueSend(_config.p_features_queue, &features, 0U);
+            }
+        }
+    }
+
+    _stats.samples += count;
+    _stats.bursts++;
+}
+
+static void _lis2dh12_task(void *p_parameter)
+{
+    (void)p_parameter;
+
+    /* Wait for init to finish configuring the sensor. */
+    (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    /* Time for the FIFO to reach the watermark. Polling wakes up twice as often so it never overruns. */
+    uint32_t   watermark_ms = (uint32_t)((1000.0f * (float)LIS2DH12_FIFO_WATERMARK) / _odr_info[_config.odr].rate_hz);
+    TickType_t wait_ticks   = pdMS_TO_TICKS((0 <= _config.int1_io) ? (2U * watermark_ms) : (watermark_ms / 2U));
+    wait_ticks              = (0U == wait_ticks) ? 1U : wait_ticks;
+
+    for(;;)
+    {
+        if(0 <= _config.int1_io)
+        {
+            /* The timeout only recovers from a missed edge. */
+            (void)ulTaskNotifyTake(pdTRUE, wait_ticks);
+        }
+        else
+        {
+            vTaskDelay(wait_ticks);
+        }
+
+        _fifo_drain();
+    }
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
+static void IRAM_ATTR _int1_isr(void *p_arg)
+{
+    (void)p_arg;
+
+    BaseType_t b_higher_prio_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(p_lis2dh12_task, &b_higher_prio_woken);
+    portYIELD_FROM_ISR(b_higher_prio_woken);
+}
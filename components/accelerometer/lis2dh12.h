@@ -0,0 +1,131 @@
+/**
+ * @file lis2dh12.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __LIS2DH12_C__
+#define __LIS2DH12_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include "acc_features.h"
+#include "i2c_bus.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define LIS2DH12_I2C_ADDRESS_DEFAULT (0x19U)
+
+/* Depth of the hardware FIFO in samples. */
+#define LIS2DH12_FIFO_SIZE (32U)
+
+/**
+ * @brief Default configuration of the board sensor: shares I2C_NUM_0 with the SHT31, 1344 Hz, +-4 g, FIFO polled.
+ *
+ */
+#define LIS2DH12_CONFIG_DEFAULT()                                                                                    \
+    {                                                                                                                \
+        .port = I2C_NUM_0, .bus = { .sda_io = 22, .scl_io = 21, .clk_speed_hz = 400000U },                          \
+        .address = LIS2DH12_I2C_ADDRESS_DEFAULT, .odr = LIS2DH12_ODR_1344HZ, .range = LIS2DH12_RANGE_4G,             \
+        .int1_io = -1, .p_features_cb = NULL, .p_cb_arg = NULL, .p_features_queue = NULL,                            \
+    }
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Enums hold supported output data rates.
+ *
+ */
+typedef enum
+{
+    LIS2DH12_ODR_100HZ,
+    LIS2DH12_ODR_200HZ,
+    LIS2DH12_ODR_400HZ,
+    LIS2DH12_ODR_1344HZ,
+
+    LIS2DH12_ODR_COUNT
+} lis2dh12_odr_t;
+
+/**
+ * @brief Enums hold full scale ranges.
+ *
+ */
+typedef enum
+{
+    LIS2DH12_RANGE_2G,
+    LIS2DH12_RANGE_4G,
+    LIS2DH12_RANGE_8G,
+    LIS2DH12_RANGE_16G,
+
+    LIS2DH12_RANGE_COUNT
+} lis2dh12_range_t;
+
+/**
+ * @brief Callback invoked for every closed feature window. It runs in the driver task.
+ *
+ * @param [in] p_features Features of the window.
+ * @param [in] p_arg      User argument from the config.
+ */
+typedef void (*lis2dh12_features_cb_t)(const acc_features_t *p_features, void *p_arg);
+
+/**
+ * @brief Driver configuration.
+ *
+ */
+typedef struct
+{
+    i2c_port_t             port;
+    i2c_bus_config_t       bus; /* Used only if the bus is not initialized yet. */
+    uint8_t                address;
+    lis2dh12_odr_t         odr;
+    lis2dh12_range_t       range;
+    int8_t                 int1_io;          /* FIFO watermark interrupt pin, -1 to poll the FIFO instead. */
+    lis2dh12_features_cb_t p_features_cb;    /* Optional. */
+    void                  *p_cb_arg;         /* Optional. */
+    QueueHandle_t          p_features_queue; /* Optional, holds acc_features_t items. Dropped when it is full. */
+} lis2dh12_config_t;
+
+/**
+ * @brief Driver counters.
+ *
+ */
+typedef struct
+{
+    uint32_t samples;
+    uint32_t bursts;
+    uint32_t overruns; /* FIFO filled up before it was drained, samples were lost. */
+    uint32_t errors;
+    uint32_t windows;
+} lis2dh12_stats_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function joins the shared I2C bus, starts the sensor in FIFO stream mode and starts the task that drains
+ * the FIFO and delivers feature windows through the callback and/or the queue from the config.
+ *
+ * @param [in] p_config Driver configuration.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND if the sensor does not answer, fail otherwise.
+ */
+esp_err_t lis2dh12_init(const lis2dh12_config_t *p_config);
+
+/**
+ * @brief The function copies current driver counters.
+ *
+ * @param [out] p_stats Destination for the counters.
+ */
+void lis2dh12_get_stats(lis2dh12_stats_t *p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIS2DH12_C__
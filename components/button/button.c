@@ -0,0 +1,337 @@
+/**
+ * @file button.c
+ *
+ * @brief This file is the board button service. Interrupts only timestamp edges into a queue; a single task debounces
+ * them by reading the settled level and recognizes short, long and double presses, so input handling costs the same
+ * no matter how often a button bounces or is pressed.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "button.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define GPIO_BIT_MASK(X) ((1ULL << (X)))
+
+/* The level is read only once no edge was seen for this long. */
+#define BOUNCING_MS (20U)
+
+#define LONG_PRESS_MS   (800U)
+#define DOUBLE_PRESS_MS (300U)
+
+#define BUTTON_EDGE_QUEUE_SIZE (16U)
+
+#define BUTTON_TASK_STACK_SIZE (2U * 1024U)
+/* Above the application tasks, so input latency does not depend on their load. */
+#define BUTTON_TASK_PRIORITY (6U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Button config structure.
+ *
+ */
+typedef struct
+{
+    button_t button;
+    int8_t   gpio;
+    bool     b_is_active_on_high_level;
+} _button_config_t;
+
+/**
+ * @brief Edge as posted by the interrupt.
+ *
+ */
+typedef struct
+{
+    button_t button;
+    int64_t  timestamp_us;
+} _button_edge_t;
+
+/**
+ * @brief Gesture recognition state of one button, owned by the button task.
+ *
+ */
+typedef struct
+{
+    bool    b_is_settling;      /* Edges seen, level not read yet. */
+    bool    b_is_pressed;       /* Last settled level. */
+    bool    b_is_long_reported;
+    bool    b_is_click_pending; /* Released once, waiting for a possible second press. */
+    int64_t first_edge_us;      /* First edge of the current bounce burst. */
+    int64_t last_edge_us;
+    int64_t press_us;
+    int64_t click_us; /* Press of the pending click. */
+    int64_t release_us;
+} _button_state_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Button task.
+ *
+ * @param [in] p_parameter This is the parameter that is passed to the task.
+ */
+static void _button_task(void *p_parameter);
+
+/**
+ * @brief Advances the state of every button to the given time and reports recognized gestures.
+ */
+static void _buttons_update(int64_t now_us);
+
+/**
+ * @brief Returns how long the task may sleep before the next timing decision is due.
+ */
+static TickType_t _next_wait_ticks(int64_t now_us);
+
+/**
+ * @brief Reports one gesture through the callback.
+ */
+static void _event_report(button_t button, button_event_type_t type, int64_t timestamp_us);
+
+/**
+ * @brief Button edge interrupt.
+ *
+ * @param [in] p_arg Button, cast to a pointer.
+ */
+static void _button_isr(void *p_arg);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const _button_config_t _button_info[BUTTON_COUNT] = {
+    { .button = BUTTON_1, .gpio = 36, .b_is_active_on_high_level = true },
+    { .button = BUTTON_2, .gpio = 32, .b_is_active_on_high_level = true },
+};
+
+static QueueHandle_t     p_edge_queue  = NULL;
+static TaskHandle_t      p_button_task = NULL;
+static button_event_cb_t p_button_cb   = NULL;
+static void             *p_button_arg  = NULL;
+static _button_state_t   _button_state[BUTTON_COUNT];
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t button_init(button_event_cb_t p_event_cb, void *p_arg)
+{
+    if(NULL == p_event_cb)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(NULL != p_button_task)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    p_button_cb  = p_event_cb;
+    p_button_arg = p_arg;
+
+    p_edge_queue = xQueueCreate(BUTTON_EDGE_QUEUE_SIZE, sizeof(_button_edge_t));
+    if(NULL == p_edge_queue)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    if(pdPASS != xTaskCreate(&_button_task, "button_task", BUTTON_TASK_STACK_SIZE, NULL, BUTTON_TASK_PRIORITY, &p_button_task))
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    /* The service may already be installed by another driver. */
+    esp_err_t esp_err = gpio_install_isr_service(ESP_INTR_FLAG_LEVEL3);
+    esp_err           = (ESP_ERR_INVALID_STATE == esp_err) ? ESP_OK : esp_err;
+
+    for(uint8_t button = 0U; (ESP_OK == esp_err) && (button < BUTTON_COUNT); button++)
+    {
+        gpio_config_t io_conf = {
+            .pin_bit_mask = GPIO_BIT_MASK(_button_info[button].gpio),
+            .mode         = GPIO_MODE_INPUT,
+            .pull_up_en   = GPIO_PULLUP_DISABLE,
+            .pull_down_en = GPIO_PULLDOWN_DISABLE,
+            /* Both edges, releases drive double press recognition. */
+            .intr_type = GPIO_INTR_ANYEDGE,
+        };
+
+        esp_err = gpio_config(&io_conf);
+
+        if(ESP_OK == esp_err)
+        {
+            esp_err = gpio_isr_handler_add(_button_info[button].gpio, _button_isr, (void *)(uintptr_t)button);
+        }
+    }
+
+    if(ESP_OK != esp_err)
+    {
+        printf("Button interrupts were not initialized successfully\n");
+    }
+
+    return esp_err;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _button_task(void *p_parameter)
+{
+    _button_edge_t edge;
+
+    for(;;)
+    {
+        /* Sleep until an edge arrives or the nearest debounce, long or double press deadline passes. */
+        if(pdTRUE == xQueueReceive(p_edge_queue, &edge, _next_wait_ticks(esp_timer_get_time())))
+        {
+            _button_state_t *p_state = &_button_state[edge.button];
+
+            if(!p_state->b_is_settling)
+            {
+                p_state->first_edge_us = edge.timestamp_us;
+                p_state->b_is_settling = true;
+            }
+            p_state->last_edge_us = edge.timestamp_us;
+        }
+
+        _buttons_update(esp_timer_get_time());
+    }
+}
+
+static void _buttons_update(int64_t now_us)
+{
+    for(uint8_t button = 0U; button < BUTTON_COUNT; button++)
+    {
+        _button_state_t *p_state = &_button_state[button];
+
+        if(p_state->b_is_settling && ((now_us - p_state->last_edge_us) >= (BOUNCING_MS * 1000)))
+        {
+            int  level        = gpio_get_level(_button_info[button].gpio);
+            bool b_is_pressed = (_button_info[button].b_is_active_on_high_level ? 1 : 0) == level;
+
+            p_state->b_is_settling = false;
+
+            if(b_is_pressed && !p_state->b_is_pressed)
+            {
+                p_state->b_is_pressed       = true;
+                p_state->b_is_long_reported = false;
+                p_state->press_us           = p_state->first_edge_us;
+            }
+            else if(!b_is_pressed && p_state->b_is_pressed)
+            {
+                p_state->b_is_pressed = false;
+
+                if(p_state->b_is_long_reported)
+                {
+                    /* Release after a long press ends the gesture. */
+                }
+                else if(p_state->b_is_click_pending)
+                {
+                    p_state->b_is_click_pending = false;
+                    _event_report((button_t)button, BUTTON_EVENT_DOUBLE_PRESS, p_state->press_us);
+                }
+                else
+                {
+                    p_state->b_is_click_pending = true;
+                    p_state->click_us           = p_state->press_us;
+                    p_state->release_us         = p_state->first_edge_us;
+                }
+            }
+            else
+            {
+                /* Bounce that settled back to the previous level. */
+            }
+        }
+
+        if(p_state->b_is_pressed && !p_state->b_is_long_reported && ((now_us - p_state->press_us) >= (LONG_PRESS_MS * 1000)))
+        {
+            p_state->b_is_long_reported = true;
+
+            if(p_state->b_is_click_pending)
+            {
+                /* The second press turned into a long one, the first one was a click of its own. */
+                p_state->b_is_click_pending = false;
+                _event_report((button_t)button, BUTTON_EVENT_SHORT_PRESS, p_state->click_us);
+            }
+
+            _event_report((button_t)button, BUTTON_EVENT_LONG_PRESS, p_state->press_us);
+        }
+
+        if(p_state->b_is_click_pending && !p_state->b_is_pressed && !p_state->b_is_settling &&
+           ((now_us - p_state->release_us) >= (DOUBLE_PRESS_MS * 1000)))
+        {
+            p_state->b_is_click_pending = false;
+            _event_report((button_t)button, BUTTON_EVENT_SHORT_PRESS, p_state->click_us);
+        }
+    }
+}
+
+static TickType_t _next_wait_ticks(int64_t now_us)
+{
+    int64_t deadline_us = INT64_MAX;
+
+    for(uint8_t button = 0U; button < BUTTON_COUNT; button++)
+    {
+        const _button_state_t *p_state = &_button_state[button];
+        int64_t                due_us  = INT64_MAX;
+
+        if(p_state->b_is_settling)
+        {
+            due_us = p_state->last_edge_us + (BOUNCING_MS * 1000);
+        }
+        else if(p_state->b_is_pressed && !p_state->b_is_long_reported)
+        {
+            due_us = p_state->press_us + (LONG_PRESS_MS * 1000);
+        }
+        else if(p_state->b_is_click_pending)
+        {
+            due_us = p_state->release_us + (DOUBLE_PRESS_MS * 1000);
+        }
+        else
+        {
+            /* Idle, nothing is due. */
+        }
+
+        deadline_us = (due_us < deadline_us) ? due_us : deadline_us;
+    }
+
+    if(INT64_MAX == deadline_us)
+    {
+        return portMAX_DELAY;
+    }
+
+    if(deadline_us <= now_us)
+    {
+        return 0U;
+    }
+
+    /* Round up, waking a tick early would only cost another loop. */
+    return pdMS_TO_TICKS((uint32_t)((deadline_us - now_us + 999) / 1000)) + 1U;
+}
+
+static void _event_report(button_t button, button_event_type_t type, int64_t timestamp_us)
+{
+    button_event_t event = {
+        .button       = button,
+        .type         = type,
+        .timestamp_ms = (uint32_t)(timestamp_us / 1000),
+    };
+
+    p_button_cb(&event, p_button_arg);
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
+static void IRAM_ATTR _button_isr(void *p_arg)
+{
+    _button_edge_t edge = {
+        .button       = (button_t)(uintptr_t)p_arg,
+        .timestamp_us = esp_timer_get_time(),
+    };
+    BaseType_t b_higher_prio_woken = pdFALSE;
+
+    /* Losing an edge of a bounce burst is harmless, the task reads the settled level anyway. */
+    (void)xQueueSendFromISR(p_edge_queue, &edge, &b_higher_prio_woken);
+    portYIELD_FROM_ISR(b_higher_prio_woken);
+}
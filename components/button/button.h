@@ -0,0 +1,83 @@
+/**
+ * @file button.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __BUTTON_C__
+#define __BUTTON_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Enums hold all board buttons.
+ *
+ */
+typedef enum
+{
+    BUTTON_1,
+    BUTTON_2,
+
+    BUTTON_COUNT
+} button_t;
+
+/**
+ * @brief Enums hold button gestures.
+ *
+ */
+typedef enum
+{
+    BUTTON_EVENT_SHORT_PRESS,  /* Reported once the double press window has passed. */
+    BUTTON_EVENT_LONG_PRESS,   /* Reported while the button is still held. */
+    BUTTON_EVENT_DOUBLE_PRESS, /* Reported on the second release. */
+
+    BUTTON_EVENT_COUNT
+} button_event_type_t;
+
+/**
+ * @brief One recognized gesture.
+ *
+ */
+typedef struct
+{
+    button_t            button;
+    button_event_type_t type;
+    uint32_t            timestamp_ms; /* Milliseconds since boot of the press edge that started the gesture. */
+} button_event_t;
+
+/**
+ * @brief Callback invoked for every gesture. It runs in the button task and must not block.
+ *
+ * @param [in] p_event Recognized gesture.
+ * @param [in] p_arg   User argument given to button_init().
+ */
+typedef void (*button_event_cb_t)(const button_event_t *p_event, void *p_arg);
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function configures all board buttons and starts the task that turns their edges into gestures.
+ *
+ * @param [in] p_event_cb Gesture callback.
+ * @param [in] p_arg      User argument passed to the callback.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t button_init(button_event_cb_t p_event_cb, void *p_arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BUTTON_C__
@@ -0,0 +1,483 @@
+/**
+ * @file command.c
+ *
+ * @brief This file receives remote commands on "WES/<station>/cmd/<name>" topics. The topic is routed through a
+ * static table to the parser of that command, which reads the payload in place from the client's receive buffer and
+ * turns it into a user interface event with a 16-bit argument. Payloads the client delivers in pieces are put back
+ * together in a preallocated buffer first. Nothing is allocated per message, so a remote opponent or a dashboard can
+ * send commands at any rate without fragmenting the heap.
+ *
+ * Commands, payloads are plain text:
+ *   led    "<blue|red|green|all> <on|off>"
+ *   buzzer "<sos|heartbeat|breathing|error2|error3|error4|off>"
+ *   move   "<0-8|new>", the board cell as a digit, or the two byte binary move message of the tic-tac-toe engine
+ *   rate   "<0.5|1|2|4|10|art>", SHT31 measurements per second
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "command.h"
+#include "user_interface.h"
+#include "led.h"
+#include "led_pattern.h"
+#include "sht31.h"
+#include "tictactoe.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define COMMAND_FILTER_SIZE (sizeof("WES//cmd/#") + COMMAND_STATION_SIZE_MAX)
+
+#define COMMAND_QOS (1)
+
+#define COMMAND_ROUTE(NAME, EVENT, PARSE)                                                                            \
+    {                                                                                                                \
+        .p_name = NAME, .name_len = sizeof(NAME) - 1U, .event = EVENT, .p_parse = PARSE,                            \
+    }
+
+#define ARRAY_SIZE(X) (sizeof(X) / sizeof((X)[0]))
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Payload parser. The payload is not NUL terminated.
+ *
+ * @param [in]  p_data Payload.
+ * @param [in]  len    Payload length in bytes.
+ * @param [out] p_arg  Event argument.
+ *
+ * @return esp_err_t ESP_OK if the payload is valid, ESP_ERR_INVALID_ARG otherwise.
+ */
+typedef esp_err_t (*_parse_t)(const char *p_data, size_t len, uint16_t *p_arg);
+
+/**
+ * @brief Command topic suffix and what it turns into.
+ *
+ */
+typedef struct
+{
+    const char            *p_name;
+    uint8_t                name_len;
+    user_interface_event_t event;
+    _parse_t               p_parse;
+} _route_t;
+
+/**
+ * @brief Name of a LED command target.
+ *
+ */
+typedef struct
+{
+    const char *p_name;
+    uint8_t     mask;
+} _led_target_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Handles one piece of a received message.
+ */
+static void _data_handle(esp_mqtt_event_handle_t p_event);
+
+/**
+ * @brief Returns the route of a topic, or NULL if it is not a command topic.
+ */
+static const _route_t *_route_find(const char *p_topic, int topic_len);
+
+/**
+ * @brief Parses a complete payload and posts the event.
+ */
+static void _dispatch(const _route_t *p_route, const char *p_data, size_t len);
+
+static esp_err_t _led_parse(const char *p_data, size_t len, uint16_t *p_arg);
+static esp_err_t _buzzer_parse(const char *p_data, size_t len, uint16_t *p_arg);
+static esp_err_t _move_parse(const char *p_data, size_t len, uint16_t *p_arg);
+static esp_err_t _rate_parse(const char *p_data, size_t len, uint16_t *p_arg);
+
+/**
+ * @brief Splits the next space separated token off the payload.
+ *
+ * @param [in,out] pp_data Payload, advanced past the token.
+ * @param [in,out] p_len   Remaining payload length.
+ * @param [out]    p_token_len Token length, 0 if the payload holds no more tokens.
+ *
+ * @return const char* Token start.
+ */
+static const char *_token_next(const char **pp_data, size_t *p_len, size_t *p_token_len);
+
+/**
+ * @brief Looks a token up in a table of names.
+ *
+ * @return true if found, the position is stored to p_index.
+ */
+static bool _name_find(const char *const *p_names, size_t count, const char *p_token, size_t token_len,
+                       uint16_t *p_index);
+
+/**
+ * @brief Adds to one counter.
+ */
+static void _stats_add(uint32_t *p_counter);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "COMMAND";
+
+static const _route_t _routes[] = {
+    COMMAND_ROUTE("led", USER_INTERFACE_EVENT_REMOTE_LED, _led_parse),
+    COMMAND_ROUTE("buzzer", USER_INTERFACE_EVENT_REMOTE_BUZZER, _buzzer_parse),
+    COMMAND_ROUTE("move", USER_INTERFACE_EVENT_REMOTE_MOVE, _move_parse),
+    COMMAND_ROUTE("rate", USER_INTERFACE_EVENT_REMOTE_RATE, _rate_parse),
+};
+
+static const _led_target_t _led_targets[] = {
+    {.p_name = "blue", .mask = LED_MASK(LED_BLUE)},
+    {.p_name = "red", .mask = LED_MASK(LED_RED)},
+    {.p_name = "green", .mask = LED_MASK(LED_GREEN)},
+    {.p_name = "all", .mask = LED_MASK_ALL},
+};
+
+static const char *const _led_states[] = {"off", "on"};
+
+/* Indexed by led_pattern_t, the extra last entry is USER_INTERFACE_BUZZER_OFF. */
+static const char *const _buzzer_names[LED_PATTERN_COUNT + 1U] = {
+    [LED_PATTERN_SOS]       = "sos",
+    [LED_PATTERN_HEARTBEAT] = "heartbeat",
+    [LED_PATTERN_BREATHING] = "breathing",
+    [LED_PATTERN_ERROR_2]   = "error2",
+    [LED_PATTERN_ERROR_3]   = "error3",
+    [LED_PATTERN_ERROR_4]   = "error4",
+    [LED_PATTERN_COUNT]     = "off",
+};
+
+static const char *const _rate_names[SHT31_RATE_COUNT] = {
+    [SHT31_RATE_0_5_MPS] = "0.5",
+    [SHT31_RATE_1_MPS]   = "1",
+    [SHT31_RATE_2_MPS]   = "2",
+    [SHT31_RATE_4_MPS]   = "4",
+    [SHT31_RATE_10_MPS]  = "10",
+    [SHT31_RATE_ART]     = "art",
+};
+
+static char   _filter[COMMAND_FILTER_SIZE];
+static size_t _prefix_len = 0U; /* Filter without the trailing '#'. */
+
+/* Reassembly of a fragmented message, only touched from the MQTT client task. */
+static char            _rx_buf[COMMAND_PAYLOAD_SIZE_MAX];
+static size_t          _rx_len    = 0U;
+static const _route_t *p_rx_route = NULL;
+
+static portMUX_TYPE    _stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static command_stats_t _stats;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t command_init(const char *p_station)
+{
+    if((NULL == p_station) || (0U == strlen(p_station)) || (COMMAND_STATION_SIZE_MAX < strlen(p_station)))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    (void)snprintf(_filter, sizeof(_filter), "WES/%s/cmd/#", p_station);
+    _prefix_len = strlen(_filter) - 1U;
+
+    return ESP_OK;
+}
+
+void command_handle_event(esp_mqtt_event_handle_t p_event)
+{
+    if((NULL == p_event) || (0U == _prefix_len))
+    {
+        return;
+    }
+
+    switch(p_event->event_id)
+    {
+        case MQTT_EVENT_CONNECTED:
+            /* The session is clean, subscriptions do not survive a reconnect. */
+            if(0 > esp_mqtt_client_subscribe(p_event->client, _filter, COMMAND_QOS))
+            {
+                ESP_LOGW(TAG, "Subscribe to %s failed", _filter);
+            }
+            break;
+
+        case MQTT_EVENT_DATA:
+            _data_handle(p_event);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void command_get_stats(command_stats_t *p_stats)
+{
+    if(NULL == p_stats)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&_stats_lock);
+    *p_stats = _stats;
+    portEXIT_CRITICAL(&_stats_lock);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _data_handle(esp_mqtt_event_handle_t p_event)
+{
+    if((0 > p_event->data_len) || (p_event->total_data_len < p_event->data_len))
+    {
+        return;
+    }
+
+    if(0 == p_event->current_data_offset)
+    {
+        /* Only the first piece carries the topic. */
+        p_rx_route = _route_find(p_event->topic, p_event->topic_len);
+        _rx_len    = 0U;
+
+        if(NULL == p_rx_route)
+        {
+            return;
+        }
+
+        _stats_add(&_stats.received);
+
+        if(p_event->data_len == p_event->total_data_len)
+        {
+            /* Whole message in one piece, parsed right from the client's buffer. */
+            _dispatch(p_rx_route, p_event->data, (size_t)p_event->data_len);
+            p_rx_route = NULL;
+            return;
+        }
+
+        _stats_add(&_stats.fragmented);
+
+        if(COMMAND_PAYLOAD_SIZE_MAX < (size_t)p_event->total_data_len)
+        {
+            ESP_LOGW(TAG, "%.*s: %d byte payload dropped", p_event->topic_len, p_event->topic,
+                     p_event->total_data_len);
+            _stats_add(&_stats.oversized);
+            p_rx_route = NULL;
+            return;
+        }
+    }
+
+    /* Remaining pieces of a message that was dropped or not meant for us. */
+    if(NULL == p_rx_route)
+    {
+        return;
+    }
+
+    if(((size_t)p_event->current_data_offset != _rx_len) ||
+       (sizeof(_rx_buf) < (_rx_len + (size_t)p_event->data_len)))
+    {
+        _stats_add(&_stats.rejected);
+        p_rx_route = NULL;
+        return;
+    }
+
+    memcpy(&_rx_buf[_rx_len], p_event->data, (size_t)p_event->data_len);
+    _rx_len += (size_t)p_event->data_len;
+
+    if((size_t)p_event->total_data_len == _rx_len)
+    {
+        _dispatch(p_rx_route, _rx_buf, _rx_len);
+        p_rx_route = NULL;
+    }
+}
+
+static const _route_t *_route_find(const char *p_topic, int topic_len)
+{
+    if((NULL == p_topic) || ((int)_prefix_len >= topic_len) || (0 != memcmp(p_topic, _filter, _prefix_len)))
+    {
+        return NULL;
+    }
+
+    const char *p_name   = &p_topic[_prefix_len];
+    size_t      name_len = (size_t)topic_len - _prefix_len;
+
+    for(size_t route = 0U; route < ARRAY_SIZE(_routes); route++)
+    {
+        if((_routes[route].name_len == name_len) && (0 == memcmp(_routes[route].p_name, p_name, name_len)))
+        {
+            return &_routes[route];
+        }
+    }
+
+    ESP_LOGW(TAG, "Unknown command %.*s", (int)name_len, p_name);
+    _stats_add(&_stats.rejected);
+
+    return NULL;
+}
+
+static void _dispatch(const _route_t *p_route, const char *p_data, size_t len)
+{
+    uint16_t arg = 0U;
+
+    if(ESP_OK != p_route->p_parse(p_data, len, &arg))
+    {
+        ESP_LOGW(TAG, "%s: malformed payload \"%.*s\"", p_route->p_name, (int)len, p_data);
+        _stats_add(&_stats.rejected);
+        return;
+    }
+
+    if(ESP_OK != user_interface_post(p_route->event, arg))
+    {
+        ESP_LOGW(TAG, "%s: user interface queue full", p_route->p_name);
+        _stats_add(&_stats.rejected);
+        return;
+    }
+
+    _stats_add(&_stats.dispatched);
+}
+
+static esp_err_t _led_parse(const char *p_data, size_t len, uint16_t *p_arg)
+{
+    size_t      target_len;
+    size_t      state_len;
+    size_t      extra_len;
+    const char *p_target = _token_next(&p_data, &len, &target_len);
+    const char *p_state  = _token_next(&p_data, &len, &state_len);
+    (void)_token_next(&p_data, &len, &extra_len);
+
+    uint16_t state;
+    if((0U != extra_len) || !_name_find(_led_states, ARRAY_SIZE(_led_states), p_state, state_len, &state))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for(size_t target = 0U; target < ARRAY_SIZE(_led_targets); target++)
+    {
+        if((strlen(_led_targets[target].p_name) == target_len) &&
+           (0 == memcmp(_led_targets[target].p_name, p_target, target_len)))
+        {
+            uint8_t mask = _led_targets[target].mask;
+
+            *p_arg = USER_INTERFACE_LED_ARG(mask, (0U != state) ? mask : 0U);
+            return ESP_OK;
+        }
+    }
+
+    return ESP_ERR_INVALID_ARG;
+}
+
+static esp_err_t _buzzer_parse(const char *p_data, size_t len, uint16_t *p_arg)
+{
+    size_t      name_len;
+    size_t      extra_len;
+    const char *p_name = _token_next(&p_data, &len, &name_len);
+    (void)_token_next(&p_data, &len, &extra_len);
+
+    /* The position in the table is the pattern, or USER_INTERFACE_BUZZER_OFF for the last entry. */
+    return ((0U == extra_len) && _name_find(_buzzer_names, ARRAY_SIZE(_buzzer_names), p_name, name_len, p_arg))
+               ? ESP_OK
+               : ESP_ERR_INVALID_ARG;
+}
+
+static esp_err_t _move_parse(const char *p_data, size_t len, uint16_t *p_arg)
+{
+    uint8_t seq;
+    uint8_t cell;
+
+    /* A binary message is exactly two bytes with the sequence number and the cell in range, which no text move is:
+       a lone digit is one byte, "new" is three, and a digit with a trailing newline has an out of range sequence. */
+    if(ESP_OK == tictactoe_msg_decode((const uint8_t *)p_data, len, &seq, &cell))
+    {
+        *p_arg = (uint16_t)cell | ((uint16_t)seq << 8U);
+        return ESP_OK;
+    }
+
+    size_t      cell_len;
+    size_t      extra_len;
+    const char *p_cell = _token_next(&p_data, &len, &cell_len);
+    (void)_token_next(&p_data, &len, &extra_len);
+
+    if(0U != extra_len)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if((3U == cell_len) && (0 == memcmp(p_cell, "new", 3U)))
+    {
+        *p_arg = (uint16_t)TICTACTOE_CELL_NEW_GAME;
+        return ESP_OK;
+    }
+
+    if((1U != cell_len) || ('0' > p_cell[0]) || (('0' + (int)TICTACTOE_CELLS) <= p_cell[0]))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* Typed by hand, so it applies to whatever turn the game is at. */
+    *p_arg = (uint16_t)((uint8_t)p_cell[0] - (uint8_t)'0') | ((uint16_t)TICTACTOE_SEQ_ANY << 8U);
+
+    return ESP_OK;
+}
+
+static esp_err_t _rate_parse(const char *p_data, size_t len, uint16_t *p_arg)
+{
+    size_t      rate_len;
+    size_t      extra_len;
+    const char *p_rate = _token_next(&p_data, &len, &rate_len);
+    (void)_token_next(&p_data, &len, &extra_len);
+
+    return ((0U == extra_len) && _name_find(_rate_names, ARRAY_SIZE(_rate_names), p_rate, rate_len, p_arg))
+               ? ESP_OK
+               : ESP_ERR_INVALID_ARG;
+}
+
+static const char *_token_next(const char **pp_data, size_t *p_len, size_t *p_token_len)
+{
+    const char *p_data = *pp_data;
+    size_t      len    = *p_len;
+
+    /* Trailing newlines from command line clients count as separators too. */
+    while((0U < len) && ((' ' == *p_data) || ('\r' == *p_data) || ('\n' == *p_data)))
+    {
+        p_data++;
+        len--;
+    }
+
+    const char *p_token   = p_data;
+    size_t      token_len = 0U;
+
+    while((token_len < len) && (' ' != p_token[token_len]) && ('\r' != p_token[token_len]) &&
+          ('\n' != p_token[token_len]))
+    {
+        token_len++;
+    }
+
+    *pp_data     = &p_token[token_len];
+    *p_len       = len - token_len;
+    *p_token_len = token_len;
+
+    return p_token;
+}
+
+static bool _name_find(const char *const *p_names, size_t count, const char *p_token, size_t token_len,
+                       uint16_t *p_index)
+{
+    for(size_t index = 0U; index < count; index++)
+    {
+        if((strlen(p_names[index]) == token_len) && (0 == memcmp(p_names[index], p_token, token_len)))
+        {
+            *p_index = (uint16_t)index;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void _stats_add(uint32_t *p_counter)
+{
+    portENTER_CRITICAL(&_stats_lock);
+    (*p_counter)++;
+    portEXIT_CRITICAL(&_stats_lock);
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
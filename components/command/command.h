@@ -0,0 +1,73 @@
+/**
+ * @file command.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __COMMAND_C__
+#define __COMMAND_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include "mqtt_client.h"
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+/* Longest payload accepted, fragmented ones are reassembled up to this size. */
+#define COMMAND_PAYLOAD_SIZE_MAX (64U)
+
+/* Longest station name in the command topic. */
+#define COMMAND_STATION_SIZE_MAX (16U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Command counters.
+ *
+ */
+typedef struct
+{
+    uint32_t received;   /* Complete messages on the command topics. */
+    uint32_t dispatched; /* Posted to the user interface. */
+    uint32_t rejected;   /* Unknown topic, malformed payload or full user interface queue. */
+    uint32_t fragmented; /* Received in more than one piece. */
+    uint32_t oversized;  /* Longer than COMMAND_PAYLOAD_SIZE_MAX, dropped. */
+} command_stats_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function prepares the command topic filter "WES/<station>/cmd/#". User interface must be initialized
+ * before commands arrive.
+ *
+ * @param [in] p_station Station name.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t command_init(const char *p_station);
+
+/**
+ * @brief The function subscribes to the command topics on MQTT_EVENT_CONNECTED and dispatches commands on
+ * MQTT_EVENT_DATA, other events are ignored. Meant to be called from the MQTT event handler.
+ *
+ * @param [in] p_event Client event.
+ */
+void command_handle_event(esp_mqtt_event_handle_t p_event);
+
+/**
+ * @brief The function copies current command counters.
+ *
+ * @param [out] p_stats Destination for the counters.
+ */
+void command_get_stats(command_stats_t *p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __COMMAND_C__
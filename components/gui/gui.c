@@ -9,6 +9,7 @@
 
 //--------------------------------- INCLUDES ----------------------------------
 #include "gui.h"
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -19,17 +20,59 @@
 #include "esp_freertos_hooks.h"
 #include "freertos/semphr.h"
 #include "esp_log.h"
-#include "esp_timer.h"
+#include "driver/gpio.h"
 
 /* Littlevgl specific */
 #include "lvgl.h"
 #include "lvgl_helpers.h"
 
 #include "gui_app.h"
+#include "gui_perf.h"
+
+#ifdef CONFIG_LV_DISP_USE_TE
+#include "disp_te.h"
+#include "esp_timer.h"
+#endif
 //---------------------------------- MACROS -----------------------------------
-#define LV_TICK_PERIOD_MS (1U)
+/* Task notification bits that wake the GUI task before its next LVGL timer is due. */
+#define GUI_NOTIFY_TOUCH (1U << 0) /* Pen down. */
+#define GUI_NOTIFY_WORK  (1U << 1) /* Posted call or LVGL changed under the lock. */
+#define GUI_NOTIFY_VSYNC (1U << 2) /* Panel frame started while a frame of ours is pending. */
+
+/* With a pen interrupt the touch controller is only polled while touched. */
+#if defined(CONFIG_LV_TOUCH_DETECT_IRQ) || defined(CONFIG_LV_TOUCH_DETECT_IRQ_PRESSURE)
+#define GUI_TOUCH_IRQ_IO (CONFIG_LV_TOUCH_PIN_IRQ)
+#endif
+
+#define GUI_CMD_MASK (GUI_POST_QUEUE_SIZE - 1U)
+
+/* Set in a command's ticket by whoever claims it first: the GUI task to run it or a timed out caller to cancel it. */
+#define GUI_CMD_CLAIMED     (0x80000000U)
+#define GUI_CMD_TICKET(POS) ((POS) & ~GUI_CMD_CLAIMED)
 
 //-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Completion of a gui_post_sync() call, on the caller's stack.
+ *
+ */
+typedef struct
+{
+    StaticSemaphore_t sem_buf;
+    SemaphoreHandle_t p_sem;
+} _cmd_done_t;
+
+/**
+ * @brief Queued call. The slot at position pos is free while seq is pos and holds a command while seq is pos + 1.
+ *
+ */
+typedef struct
+{
+    atomic_uint  seq;
+    atomic_uint  ticket; /* GUI_CMD_TICKET() of the position the command was posted at. */
+    gui_call_t   p_call;
+    void        *p_arg;
+    _cmd_done_t *p_done; /* NULL for gui_post(). */
+} _cmd_t;
 
 //---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
 /**
@@ -38,11 +81,19 @@
 static void _create_demo_application(void);
 
 /**
- * @brief Lv's timer callback function.
+ * @brief Reads the touch controller and stops polling it once the pen is up.
  *
- * @param [in] p_arg The argument of the timer.
+ * @param [in]  p_drv  Input device driver.
+ * @param [out] p_data Touch state.
  */
-static void _lv_tick_timer(void *p_arg);
+static void _touch_read(lv_indev_drv_t *p_drv, lv_indev_data_t *p_data);
+
+/**
+ * @brief Wakes the GUI task.
+ *
+ * @param [in] bits GUI_NOTIFY_* bits.
+ */
+static void _gui_task_notify(uint32_t bits);
 
 /**
  * @brief Starts GUI task.
@@ -51,8 +102,67 @@ static void _lv_tick_timer(void *p_arg);
  */
 static void _gui_task(void *p_parameter);
 
+/**
+ * @brief Claims a free slot and fills it.
+ *
+ * @param [out] p_pos Position the command was posted at.
+ */
+static esp_err_t _cmd_post(gui_call_t p_call, void *p_arg, _cmd_done_t *p_done, unsigned *p_pos);
+
+/**
+ * @brief Runs the queued calls, at most one queue length so that a busy producer cannot hold up the frame.
+ *
+ * @return true if calls are left for the next run.
+ */
+static bool _cmds_run(void);
+
+#ifdef CONFIG_LV_DISP_FULL_FRAME_PSRAM
+/**
+ * @brief Sends the frame's areas and copies them into the other frame buffer, which LVGL draws the next frame into.
+ *
+ * @param [in] p_drv       Display driver.
+ * @param [in] p_area      Whole screen in direct mode.
+ * @param [in] p_color_map Frame buffer that was drawn.
+ */
+static void _flush_direct(lv_disp_drv_t *p_drv, const lv_area_t *p_area, lv_color_t *p_color_map);
+#endif
+
+#ifdef CONFIG_LV_DISP_USE_TE
+/**
+ * @brief Draws and flushes the pending frame if a panel frame has just started and the refresh period is over.
+ *
+ * @param [in] b_vsync Woken by the panel's TE pulse.
+ *
+ * @return Milliseconds until it has to be called again, LV_NO_TIMER_READY if nothing is pending.
+ */
+static uint32_t _vsync_refresh(bool b_vsync);
+
+/**
+ * @brief Wakes the GUI task on the panel's TE pulse while a frame is pending.
+ */
+static void _vsync_isr(void);
+#endif
+
+/**
+ * @brief Wakes the GUI task on pen down.
+ *
+ * @param [in] p_arg Unused.
+ */
+static void _touch_isr(void *p_arg);
+
 //------------------------- STATIC DATA & CONSTANTS ---------------------------
 static SemaphoreHandle_t p_gui_semaphore;
+static TaskHandle_t      p_gui_task = NULL;
+
+/* Bounded multi-producer, single-consumer queue, producers race for slots with a compare-and-swap. */
+static _cmd_t      _cmds[GUI_POST_QUEUE_SIZE];
+static atomic_uint _cmd_post_pos = 0U;
+static unsigned    _cmd_run_pos  = 0U; /* Only touched from the GUI task. */
+
+#ifdef CONFIG_LV_DISP_USE_TE
+static atomic_bool _b_vsync_armed = false;
+static int64_t     _refr_last_us  = 0; /* Panel frame the last refresh started on. */
+#endif
 
 //------------------------------- GLOBAL DATA ---------------------------------
 
@@ -64,7 +174,104 @@ void gui_init()
     slowing it down. That's why we need to "pin" the GUI task to it's own core, Core 1.
     Doing so, we reduce the risk of resource conflicts, race conditions and other potential issues.
     * NOTE: When not using Wi-Fi nor Bluetooth, you can pin the GUI task to Core 0.*/
-    xTaskCreatePinnedToCore(_gui_task, "gui", 4096 * 2, NULL, 0, NULL, 1);
+    /* Created before the task, so other tasks can lock as soon as this returns. */
+    p_gui_semaphore = xSemaphoreCreateMutex();
+
+    for(unsigned pos = 0U; pos < GUI_POST_QUEUE_SIZE; pos++)
+    {
+        atomic_init(&_cmds[pos].seq, pos);
+    }
+
+    xTaskCreatePinnedToCore(_gui_task, "gui", 4096 * 2, NULL, 0, &p_gui_task, 1);
+}
+
+esp_err_t gui_post(gui_call_t p_call, void *p_arg)
+{
+    unsigned pos;
+
+    if(NULL == p_call)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(NULL == p_gui_task)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t esp_err = _cmd_post(p_call, p_arg, NULL, &pos);
+
+    if(ESP_OK == esp_err)
+    {
+        _gui_task_notify(GUI_NOTIFY_WORK);
+    }
+
+    return esp_err;
+}
+
+esp_err_t gui_post_sync(gui_call_t p_call, void *p_arg, uint32_t timeout_ms)
+{
+    if(NULL == p_call)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(NULL == p_gui_task)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if(xTaskGetCurrentTaskHandle() == p_gui_task)
+    {
+        /* LVGL is already locked, waiting for ourselves would never end. */
+        p_call(p_arg);
+        return ESP_OK;
+    }
+
+    _cmd_done_t done;
+    unsigned    pos;
+
+    done.p_sem = xSemaphoreCreateBinaryStatic(&done.sem_buf);
+
+    esp_err_t esp_err = _cmd_post(p_call, p_arg, &done, &pos);
+
+    if(ESP_OK == esp_err)
+    {
+        _gui_task_notify(GUI_NOTIFY_WORK);
+    }
+
+    if((ESP_OK == esp_err) && (pdTRUE != xSemaphoreTake(done.p_sem, pdMS_TO_TICKS(timeout_ms))))
+    {
+        unsigned ticket = GUI_CMD_TICKET(pos);
+
+        if(atomic_compare_exchange_strong(&_cmds[pos & GUI_CMD_MASK].ticket, &ticket, ticket | GUI_CMD_CLAIMED))
+        {
+            /* The GUI task will skip it, nothing refers to our stack any more. */
+            esp_err = ESP_ERR_TIMEOUT;
+        }
+        else
+        {
+            /* The GUI task got there first and is about to give the semaphore. */
+            (void)xSemaphoreTake(done.p_sem, portMAX_DELAY);
+        }
+    }
+
+    vSemaphoreDelete(done.p_sem);
+
+    return esp_err;
+}
+
+bool gui_lock(uint32_t timeout_ms)
+{
+    return (NULL != p_gui_semaphore) && (pdTRUE == xSemaphoreTake(p_gui_semaphore, pdMS_TO_TICKS(timeout_ms)));
+}
+
+void gui_unlock(void)
+{
+    (void)xSemaphoreGive(p_gui_semaphore);
+
+    /* Whatever was changed is drawn now, not when the next LVGL timer happens to be due. */
+    _gui_task_notify(GUI_NOTIFY_WORK);
 }
 
 //---------------------------- PRIVATE FUNCTIONS ------------------------------
@@ -73,32 +280,236 @@ static void _create_demo_application(void)
     gui_app_init();
 }
 
-static void _lv_tick_timer(void *p_arg)
+static void _touch_read(lv_indev_drv_t *p_drv, lv_indev_data_t *p_data)
 {
-    (void)p_arg;
+    touch_driver_read(p_drv, p_data);
 
-    lv_tick_inc(LV_TICK_PERIOD_MS);
+#ifdef GUI_TOUCH_IRQ_IO
+    /* The pen interrupt resumes polling, a pen down racing this is seen by the task after the handler returns. */
+    if((LV_INDEV_STATE_REL == p_data->state) && (0 != gpio_get_level(GUI_TOUCH_IRQ_IO)))
+    {
+        lv_timer_pause(p_drv->read_timer);
+    }
+#endif
+}
+
+#ifdef CONFIG_LV_DISP_FULL_FRAME_PSRAM
+static void _flush_direct(lv_disp_drv_t *p_drv, const lv_area_t *p_area, lv_color_t *p_color_map)
+{
+    /* Asked first, the flush may be done and the flag cleared before the driver returns. */
+    bool b_is_last = lv_disp_flush_is_last(p_drv);
+
+    disp_driver_flush_direct(p_drv, p_area, p_color_map);
+
+    if(!b_is_last)
+    {
+        return;
+    }
+
+    /* The areas went out through the bounce buffers, the frame itself is no longer read. */
+    lv_disp_t  *p_disp  = _lv_refr_get_disp_refreshing();
+    lv_color_t *p_back  = (p_drv->draw_buf->buf1 == p_color_map) ? p_drv->draw_buf->buf2 : p_drv->draw_buf->buf1;
+    lv_coord_t  hor_res = lv_disp_get_hor_res(p_disp);
+
+    for(int32_t area = 0; area < p_disp->inv_p; area++)
+    {
+        if(0U != p_disp->inv_area_joined[area])
+        {
+            continue;
+        }
+
+        const lv_area_t *p_inv = &p_disp->inv_areas[area];
+        size_t           width = lv_area_get_width(p_inv) * sizeof(lv_color_t);
+
+        for(lv_coord_t y = p_inv->y1; y <= p_inv->y2; y++)
+        {
+            int32_t offset = (y * hor_res) + p_inv->x1;
+            memcpy(&p_back[offset], &p_color_map[offset], width);
+        }
+    }
+}
+#endif
+
+#ifdef CONFIG_LV_DISP_USE_TE
+static uint32_t _vsync_refresh(bool b_vsync)
+{
+    lv_disp_t *p_disp = lv_disp_get_default();
+
+    atomic_store(&_b_vsync_armed, false);
+
+    if(0U == p_disp->inv_p)
+    {
+        return LV_NO_TIMER_READY;
+    }
+
+    int64_t now_us    = esp_timer_get_time();
+    int64_t te_us     = disp_te_last_us();
+    int64_t frame_us  = disp_te_frame_us();
+    int64_t period_us = LV_DISP_DEF_REFR_PERIOD * 1000LL;
+    int64_t wait_us;
+
+    if((0 == frame_us) || ((now_us - te_us) > (2 * frame_us)))
+    {
+        /* No pulses, the panel sleeps or TE is not wired. LVGL's own period, as without TE. */
+        te_us   = now_us;
+        wait_us = _refr_last_us + period_us - now_us;
+    }
+    else
+    {
+        /* The whole number of panel frames closest to LVGL's period. */
+        int64_t frames = (period_us + (frame_us / 2)) / frame_us;
+        period_us      = ((0 < frames) ? frames : 1) * frame_us;
+
+        /* Started later in the panel frame, the scan could overtake the first strip. Half a frame of slack for
+        jitter between pulses. */
+        bool b_fresh = b_vsync && ((now_us - te_us) < (frame_us / 4));
+        wait_us      = (b_fresh && ((te_us - _refr_last_us) >= (period_us - (frame_us / 2)))) ? 0 : (2 * period_us);
+    }
+
+    if(0 >= wait_us)
+    {
+        _refr_last_us = te_us;
+        _lv_disp_refr_timer(NULL);
+
+        if(0U == p_disp->inv_p)
+        {
+            return LV_NO_TIMER_READY;
+        }
+
+        wait_us = period_us;
+    }
+
+    /* Woken by the next pulse, the wait only matters if the pulses stop. */
+    atomic_store(&_b_vsync_armed, true);
+
+    return (uint32_t)((wait_us + 999) / 1000);
+}
+#endif
+
+static void _gui_task_notify(uint32_t bits)
+{
+    if(NULL == p_gui_task)
+    {
+        return;
+    }
+
+    if(xPortInIsrContext())
+    {
+        BaseType_t b_higher_prio_woken = pdFALSE;
+        (void)xTaskNotifyFromISR(p_gui_task, bits, eSetBits, &b_higher_prio_woken);
+        portYIELD_FROM_ISR(b_higher_prio_woken);
+    }
+    else
+    {
+        (void)xTaskNotify(p_gui_task, bits, eSetBits);
+    }
+}
+
+static esp_err_t _cmd_post(gui_call_t p_call, void *p_arg, _cmd_done_t *p_done, unsigned *p_pos)
+{
+    unsigned pos = atomic_load_explicit(&_cmd_post_pos, memory_order_relaxed);
+    _cmd_t  *p_cmd;
+
+    for(;;)
+    {
+        p_cmd    = &_cmds[pos & GUI_CMD_MASK];
+        int diff = (int)(atomic_load_explicit(&p_cmd->seq, memory_order_acquire) - pos);
+
+        if(0 == diff)
+        {
+            /* The slot is free, on success it is ours. On failure pos is reloaded. */
+            if(atomic_compare_exchange_weak_explicit(&_cmd_post_pos, &pos, pos + 1U, memory_order_relaxed,
+                                                     memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if(0 > diff)
+        {
+            /* The GUI task has not run the command posted a lap ago. */
+            return ESP_ERR_NO_MEM;
+        }
+        else
+        {
+            /* Another producer took the slot. */
+            pos = atomic_load_explicit(&_cmd_post_pos, memory_order_relaxed);
+        }
+    }
+
+    p_cmd->p_call = p_call;
+    p_cmd->p_arg  = p_arg;
+    p_cmd->p_done = p_done;
+    atomic_store_explicit(&p_cmd->ticket, GUI_CMD_TICKET(pos), memory_order_relaxed);
+
+    /* Publishes the fields above to the GUI task. */
+    atomic_store_explicit(&p_cmd->seq, pos + 1U, memory_order_release);
+
+    *p_pos = pos;
+
+    return ESP_OK;
+}
+
+static bool _cmds_run(void)
+{
+    for(unsigned count = 0U; count < GUI_POST_QUEUE_SIZE; count++)
+    {
+        _cmd_t *p_cmd = &_cmds[_cmd_run_pos & GUI_CMD_MASK];
+
+        if(atomic_load_explicit(&p_cmd->seq, memory_order_acquire) != (_cmd_run_pos + 1U))
+        {
+            break;
+        }
+
+        unsigned ticket = GUI_CMD_TICKET(_cmd_run_pos);
+
+        /* Fails only if the caller timed out and cancelled it. */
+        if(atomic_compare_exchange_strong(&p_cmd->ticket, &ticket, ticket | GUI_CMD_CLAIMED))
+        {
+            p_cmd->p_call(p_cmd->p_arg);
+
+            if(NULL != p_cmd->p_done)
+            {
+                /* The caller may return at once, its completion is not touched after this. */
+                xSemaphoreGive(p_cmd->p_done->p_sem);
+            }
+        }
+
+        /* The slot is free for the producer a lap ahead. */
+        atomic_store_explicit(&p_cmd->seq, _cmd_run_pos + GUI_POST_QUEUE_SIZE, memory_order_release);
+        _cmd_run_pos++;
+    }
+
+    return atomic_load_explicit(&_cmds[_cmd_run_pos & GUI_CMD_MASK].seq, memory_order_acquire) == (_cmd_run_pos + 1U);
 }
 
 static void _gui_task(void *p_parameter)
 {
 
     (void)p_parameter;
-    p_gui_semaphore = xSemaphoreCreateMutex();
 
+    /* Nobody else may touch LVGL before the application is created. */
+    (void)xSemaphoreTake(p_gui_semaphore, portMAX_DELAY);
     lv_init();
 
     /* Initialize SPI or I2C bus used by the drivers */
     lvgl_driver_init();
 
-    lv_color_t *p_buf1 = heap_caps_malloc(DISP_BUF_SIZE * sizeof(lv_color_t), MALLOC_CAP_DMA);
+#ifdef CONFIG_LV_DISP_FULL_FRAME_PSRAM
+    /* Two whole frames in PSRAM. LVGL draws a frame into one while the other holds what is on the panel. */
+    uint32_t size_in_px = DISP_FRAME_BUF_SIZE;
+    uint32_t caps       = MALLOC_CAP_SPIRAM;
+#else
+    uint32_t size_in_px = DISP_BUF_SIZE;
+    uint32_t caps       = MALLOC_CAP_DMA;
+#endif
+
+    lv_color_t *p_buf1 = heap_caps_malloc(size_in_px * sizeof(lv_color_t), caps);
     assert(NULL != p_buf1);
 
     /* Use double buffered when not working with monochrome displays */
-    lv_color_t *p_buf2 = heap_caps_malloc(DISP_BUF_SIZE * sizeof(lv_color_t), MALLOC_CAP_DMA);
+    lv_color_t *p_buf2 = heap_caps_malloc(size_in_px * sizeof(lv_color_t), caps);
     assert(NULL != p_buf2);
     static lv_disp_draw_buf_t disp_draw_buf;
-    uint32_t                  size_in_px = DISP_BUF_SIZE;
 
     /* Initialize the working buffer */
     lv_disp_draw_buf_init(&disp_draw_buf, p_buf1, p_buf2, size_in_px);
@@ -108,38 +519,96 @@ static void _gui_task(void *p_parameter)
     disp_drv.ver_res = LV_VER_RES_MAX;
     lv_disp_drv_init(&disp_drv);
     disp_drv.flush_cb = disp_driver_flush;
+    /* Sleeps instead of spinning while the other buffer is still being sent. */
+    disp_drv.wait_cb = disp_driver_wait;
+
+#ifdef CONFIG_LV_DISP_FULL_FRAME_PSRAM
+    /* Drawn at screen coordinates into the frame, a frame is sent in one go once it is complete. */
+    disp_drv.direct_mode = 1;
+    disp_drv.flush_cb    = _flush_direct;
+#endif
 
     disp_drv.draw_buf = &disp_draw_buf;
+    gui_perf_attach(&disp_drv);
     lv_disp_drv_register(&disp_drv);
 
+#ifdef CONFIG_LV_DISP_USE_TE
+    /* Frames start on the panel's TE pulse instead, see _vsync_refresh(). LVGL checks for a NULL timer. */
+    lv_disp_t *p_disp = lv_disp_get_default();
+    lv_timer_del(p_disp->refr_timer);
+    p_disp->refr_timer = NULL;
+    disp_te_set_cb(_vsync_isr);
+#endif
+
     /* Register an input device */
     static lv_indev_drv_t indev_drv;
     lv_indev_drv_init(&indev_drv);
-    indev_drv.read_cb = touch_driver_read;
+    indev_drv.read_cb = _touch_read;
     indev_drv.type    = LV_INDEV_TYPE_POINTER;
     lv_indev_drv_register(&indev_drv);
 
-    /* Create and start a periodic timer interrupt to call lv_tick_inc */
-    const esp_timer_create_args_t periodic_timer_args = { .callback = &_lv_tick_timer, .name = "periodic_gui" };
+#ifdef GUI_TOUCH_IRQ_IO
+    /* The driver configured the pin as an input, the service may already be installed by another driver. */
+    esp_err_t esp_err = gpio_install_isr_service(0);
+    esp_err           = (ESP_ERR_INVALID_STATE == esp_err) ? ESP_OK : esp_err;
+    ESP_ERROR_CHECK(esp_err);
+    ESP_ERROR_CHECK(gpio_set_intr_type(GUI_TOUCH_IRQ_IO, GPIO_INTR_NEGEDGE));
+    ESP_ERROR_CHECK(gpio_isr_handler_add(GUI_TOUCH_IRQ_IO, _touch_isr, NULL));
+#endif
 
-    esp_timer_handle_t periodic_timer;
-    ESP_ERROR_CHECK(esp_timer_create(&periodic_timer_args, &periodic_timer));
-    ESP_ERROR_CHECK(esp_timer_start_periodic(periodic_timer, LV_TICK_PERIOD_MS * 1000));
+    /* LV_TICK_CUSTOM reads esp_timer_get_time(), no tick interrupt is needed. */
 
     /* Create the demo application */
     _create_demo_application();
+    xSemaphoreGive(p_gui_semaphore);
+
+    uint32_t notified = 0U;
 
     for(;;)
     {
-        /* Delay 1 tick (assumes FreeRTOS tick is 10ms */
-        vTaskDelay(pdMS_TO_TICKS(10));
+        uint32_t sleep_ms = LV_NO_TIMER_READY;
 
         /* Try to take the semaphore, call lvgl related function on success */
         if(pdTRUE == xSemaphoreTake(p_gui_semaphore, portMAX_DELAY))
         {
-            lv_task_handler();
+#ifdef GUI_TOUCH_IRQ_IO
+            if(0U != (notified & GUI_NOTIFY_TOUCH))
+            {
+                lv_timer_resume(indev_drv.read_timer);
+                lv_timer_ready(indev_drv.read_timer);
+            }
+#endif
+
+            /* Posted calls change widgets before they are drawn, in the same frame. */
+            if(_cmds_run())
+            {
+                sleep_ms = 0U;
+            }
+
+            /* Returns when the next LVGL timer is due, idle screens pause theirs. */
+            uint32_t next_ms = lv_timer_handler();
+            sleep_ms         = (next_ms < sleep_ms) ? next_ms : sleep_ms;
+
+#ifdef CONFIG_LV_DISP_USE_TE
+            /* After the timers, so that animations are stepped for the frame about to be drawn. */
+            uint32_t refr_ms = _vsync_refresh(0U != (notified & GUI_NOTIFY_VSYNC));
+            sleep_ms         = (refr_ms < sleep_ms) ? refr_ms : sleep_ms;
+#endif
             xSemaphoreGive(p_gui_semaphore);
+
+            /* Clicks of the whole frame go out together, without holding LVGL. */
+            gui_app_events_flush();
         }
+
+        TickType_t sleep_ticks = portMAX_DELAY;
+        if(LV_NO_TIMER_READY != sleep_ms)
+        {
+            /* Rounded up, waking a tick early would only find nothing due. */
+            sleep_ticks = (sleep_ms + portTICK_PERIOD_MS - 1U) / portTICK_PERIOD_MS;
+        }
+
+        /* Touch, posted work and panel frames cut the sleep short. */
+        (void)xTaskNotifyWait(0U, UINT32_MAX, &notified, sleep_ticks);
     }
 
     /* A task should NEVER return */
@@ -149,3 +618,25 @@ static void _gui_task(void *p_parameter)
 }
 
 //---------------------------- INTERRUPT HANDLERS -----------------------------
+static void IRAM_ATTR _touch_isr(void *p_arg)
+{
+    (void)p_arg;
+
+    BaseType_t b_higher_prio_woken = pdFALSE;
+    (void)xTaskNotifyFromISR(p_gui_task, GUI_NOTIFY_TOUCH, eSetBits, &b_higher_prio_woken);
+    portYIELD_FROM_ISR(b_higher_prio_woken);
+}
+
+#ifdef CONFIG_LV_DISP_USE_TE
+static void IRAM_ATTR _vsync_isr(void)
+{
+    if(!atomic_load_explicit(&_b_vsync_armed, memory_order_relaxed))
+    {
+        return;
+    }
+
+    BaseType_t b_higher_prio_woken = pdFALSE;
+    (void)xTaskNotifyFromISR(p_gui_task, GUI_NOTIFY_VSYNC, eSetBits, &b_higher_prio_woken);
+    portYIELD_FROM_ISR(b_higher_prio_woken);
+}
+#endif
@@ -15,10 +15,21 @@ extern "C" {
 #endif
 
 //--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 //---------------------------------- MACROS -----------------------------------
+/* Calls that can wait for the GUI task, a power of two. */
+#define GUI_POST_QUEUE_SIZE (16U)
 
 //-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Call run by the GUI task with LVGL locked, right before the next lv_task_handler() run. It must not block.
+ *
+ * @param [in] p_arg Argument given when posting.
+ */
+typedef void (*gui_call_t)(void *p_arg);
 
 //---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
 
@@ -28,6 +39,47 @@ extern "C" {
  */
 void gui_init(void);
 
+/**
+ * @brief The function queues a call into the GUI task and returns at once. The queue is lock-free, so it can be called
+ * from any task or interrupt without waiting for the GUI task to finish a frame.
+ *
+ * @param [in] p_call Call.
+ * @param [in] p_arg  Argument, must stay valid until the call has run.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if the queue is full, fail otherwise.
+ */
+esp_err_t gui_post(gui_call_t p_call, void *p_arg);
+
+/**
+ * @brief The function queues a call into the GUI task and waits until it has run. A call that has not started when
+ * the timeout expires is cancelled, so the argument may live on the caller's stack. Called from the GUI task it runs
+ * the call directly.
+ *
+ * @param [in] p_call     Call.
+ * @param [in] p_arg      Argument.
+ * @param [in] timeout_ms Longest time to wait for the call to start.
+ *
+ * @return esp_err_t ESP_OK once the call has run, ESP_ERR_TIMEOUT if it was cancelled, ESP_ERR_NO_MEM if the queue is
+ * full, fail otherwise.
+ */
+esp_err_t gui_post_sync(gui_call_t p_call, void *p_arg, uint32_t timeout_ms);
+
+/**
+ * @brief Takes the LVGL lock for a longer sequence of LVGL calls from another task. Short updates should use
+ * gui_post() instead, which does not wait for the frame to finish.
+ *
+ * @param [in] timeout_ms Longest time to wait for the GUI task to finish a frame.
+ *
+ * @return true if the lock was taken.
+ */
+bool gui_lock(uint32_t timeout_ms);
+
+/**
+ * @brief Releases the LVGL lock taken with gui_lock().
+ *
+ */
+void gui_unlock(void);
+
 #ifdef __cplusplus
 }
 #endif
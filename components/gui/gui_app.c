@@ -9,7 +9,12 @@
 
 //--------------------------------- INCLUDES ----------------------------------
 #include "gui_app.h"
+#include "gui.h"
+#include "gui_dashboard.h"
+#include "gui_screen.h"
+#include "tictactoe.h"
 #include <stdio.h>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
@@ -18,27 +23,169 @@
 #include "lvgl.h"
 #include "lvgl_helpers.h"
 //---------------------------------- MACROS -----------------------------------
+/* Longest a remote call waits for the GUI task to pick it up. */
+#define GUI_APP_CALL_TIMEOUT_MS (100U)
+
+/* User interface events collected during one frame. */
+#define GUI_APP_EVENTS_MAX (8U)
 
 //-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Enums hold every widget that reacts to touch. The ID is kept in the widget's user data.
+ *
+ */
+typedef enum
+{
+    GUI_APP_WIDGET_BUTTON_1,
+    GUI_APP_WIDGET_LED_ON,
+    GUI_APP_WIDGET_LED_OFF,
+    GUI_APP_WIDGET_NEXT,
+    GUI_APP_WIDGET_BACK,
+    GUI_APP_WIDGET_DASHBOARD,
+    GUI_APP_WIDGET_CELL_0, /* Cells 0 - 8 follow in order. */
+    GUI_APP_WIDGET_CELL_8 = GUI_APP_WIDGET_CELL_0 + TICTACTOE_CELLS - 1U,
+
+    GUI_APP_WIDGET_COUNT
+} gui_app_widget_t;
+
+/**
+ * @brief Enums hold screens, the IDs used with gui_screen_show().
+ *
+ */
+typedef enum
+{
+    GUI_APP_SCREEN_HOME,
+    GUI_APP_SCREEN_GAME,
+    GUI_APP_SCREEN_DASHBOARD,
+
+    GUI_APP_SCREEN_COUNT
+} gui_app_screen_t;
+
+/**
+ * @brief Handles a click on a widget. It runs in the GUI task with LVGL locked.
+ *
+ * @param [in] widget Clicked widget.
+ */
+typedef void (*_widget_handler_t)(gui_app_widget_t widget);
+
+/**
+ * @brief What a click on a widget does.
+ *
+ */
+typedef struct
+{
+    _widget_handler_t p_handler;
+    gui_app_event_t   event; /* Posted by _event_post(). */
+} _route_t;
+
+/**
+ * @brief Opponent change handed to the GUI task.
+ *
+ */
+typedef struct
+{
+    gui_app_opponent_t opponent;
+    gui_app_move_cb_t  p_cb;
+    void              *p_cb_arg;
+} _opponent_call_t;
+
+/**
+ * @brief Remote move handed to the GUI task.
+ *
+ */
+typedef struct
+{
+    uint8_t   seq;
+    uint8_t   cell;
+    esp_err_t result;
+} _move_call_t;
 
 //---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
 /**
- * @brief This function handles events that happen on LVGL buttons.
+ * @brief This function dispatches clicks on registered widgets through the route table.
  *
  * @param [in] p_event Pointer to the event type.
  */
-static void _button_event_handler(lv_event_t *p_event);
+static void _event_router(lv_event_t *p_event);
 
 /**
- * @brief The function unblockingly sends an event to the user interface queue.
+ * @brief Attaches a widget to its route.
  *
- * @param event Gui event to be sent.
+ * @param [in] p_obj  Widget.
+ * @param [in] widget Widget ID.
  */
-static void _gui_app_event_send(gui_app_event_t event);
+static void _widget_register(lv_obj_t *p_obj, gui_app_widget_t widget);
 
-static void goto_new_screen(void);
+/**
+ * @brief Queues the widget's user interface event until the end of the frame.
+ */
+static void _event_post(gui_app_widget_t widget);
+
+static void _button_1_clicked(gui_app_widget_t widget);
+static void _next_clicked(gui_app_widget_t widget);
+static void _back_clicked(gui_app_widget_t widget);
+static void _dashboard_clicked(gui_app_widget_t widget);
+
+/**
+ * @brief Plays a move on the touched cell, the cell is the widget ID less GUI_APP_WIDGET_CELL_0.
+ */
+static void _cell_clicked(gui_app_widget_t widget);
+
+/**
+ * @brief Switches the opponent in the GUI task.
+ *
+ * @param [in] p_arg _opponent_call_t.
+ */
+static void _opponent_set(void *p_arg);
+
+/**
+ * @brief Plays a remote move in the GUI task.
+ *
+ * @param [in,out] p_arg _move_call_t, its result is filled in.
+ */
+static void _remote_move_play(void *p_arg);
+
+/**
+ * @brief Clears the board and tells the remote opponent when the local player started the game.
+ */
+static void _game_new(bool b_is_local);
+
+/**
+ * @brief Shows a cell as stored in the game, if the board is built.
+ */
+static void _cell_render(uint8_t cell);
+
+/**
+ * @brief Shows whose turn it is or how the game ended.
+ */
+static void _status_render(void);
+
+/**
+ * @brief Creates the home screen widgets.
+ *
+ * @param [in] p_screen Empty screen.
+ */
+static void _home_build(lv_obj_t *p_screen);
+
+/**
+ * @brief Creates the board, the status label and the back button.
+ *
+ * @param [in] p_screen Empty screen.
+ */
+static void _game_build(lv_obj_t *p_screen);
+
+/**
+ * @brief Creates the sensor dashboard and its back button.
+ *
+ * @param [in] p_screen Empty screen.
+ */
+static void _dashboard_build(lv_obj_t *p_screen);
 
-static void lv_example_grid_1(void);
+/**
+ * @brief Forgets the widgets of a deleted screen.
+ */
+static void _home_destroy(void);
+static void _game_destroy(void);
 
 //------------------------- STATIC DATA & CONSTANTS ---------------------------
 lv_obj_t *p_btn1;
@@ -48,16 +195,10 @@ lv_obj_t *p_btn_led_off;
 // Button za novi screen
 lv_obj_t *p_btn_naprijed;
 
-// Novi screen
-lv_obj_t *novi_screen;
-
-// Pocetni screen
-lv_obj_t *pocetni_screen;
-
 // Button za povratak na stari screen
 lv_obj_t *p_btn_povratak;
 
-// Ovjde pišem X ili O
+// Ovjde pišem tko je na potezu ili tko je pobijedio
 lv_obj_t *label;
 
 // Buttoni na gridu odnosno arrayu
@@ -68,381 +209,392 @@ static lv_obj_t *array_buttona[9];
 // Array labela koji koriste za upisivanje
 static lv_obj_t *array_labela[9];
 
-static const char *znak[2] = { "X", "O" };
-
-bool is_Pressed = true;
+static const char *znak[TICTACTOE_PLAYER_COUNT + 1U] = { "X", "O", " " };
+
+static tictactoe_t        _game;
+static gui_app_opponent_t _opponent = GUI_APP_OPPONENT_LOCAL;
+static gui_app_move_cb_t  p_move_cb = NULL;
+static void              *p_move_cb_arg;
+
+static const gui_screen_desc_t _screen_descs[GUI_APP_SCREEN_COUNT] = {
+    [GUI_APP_SCREEN_HOME]      = {.p_name = "home", .p_build_cb = _home_build, .p_destroy_cb = _home_destroy},
+    [GUI_APP_SCREEN_GAME]      = {.p_name = "game", .p_build_cb = _game_build, .p_destroy_cb = _game_destroy},
+    [GUI_APP_SCREEN_DASHBOARD] =
+        {.p_name = "sensors", .p_build_cb = _dashboard_build, .p_destroy_cb = gui_dashboard_destroy},
+};
+
+static const _route_t _routes[GUI_APP_WIDGET_COUNT] = {
+    [GUI_APP_WIDGET_BUTTON_1]  = {.p_handler = _button_1_clicked},
+    [GUI_APP_WIDGET_LED_ON]    = {.p_handler = _event_post, .event = GUI_APP_EVENT_BUTTON_LED_ON_PRESSED},
+    [GUI_APP_WIDGET_LED_OFF]   = {.p_handler = _event_post, .event = GUI_APP_EVENT_BUTTON_LED_OFF_PRESSED},
+    [GUI_APP_WIDGET_NEXT]      = {.p_handler = _next_clicked},
+    [GUI_APP_WIDGET_BACK]      = {.p_handler = _back_clicked},
+    [GUI_APP_WIDGET_DASHBOARD] = {.p_handler = _dashboard_clicked},
+    [GUI_APP_WIDGET_CELL_0 ... GUI_APP_WIDGET_CELL_8] = {.p_handler = _cell_clicked},
+};
+
+/* Only touched from the GUI task. */
+static gui_app_event_t _events[GUI_APP_EVENTS_MAX];
+static uint8_t         _events_count = 0U;
 //------------------------------- GLOBAL DATA ---------------------------------
 extern QueueHandle_t p_user_interface_queue;
 
 //------------------------------ PUBLIC FUNCTIONS -----------------------------
 void gui_app_init(void)
 {
+    ESP_ERROR_CHECK(gui_dashboard_init());
+    ESP_ERROR_CHECK(gui_screen_init(_screen_descs, GUI_APP_SCREEN_COUNT));
+    ESP_ERROR_CHECK(gui_screen_show(GUI_APP_SCREEN_HOME, LV_SCR_LOAD_ANIM_NONE));
+}
+
+esp_err_t gui_app_game_set_opponent(gui_app_opponent_t opponent, gui_app_move_cb_t p_cb, void *p_cb_arg)
+{
+    if(GUI_APP_OPPONENT_COUNT <= opponent)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    _opponent_call_t call = { .opponent = opponent, .p_cb = p_cb, .p_cb_arg = p_cb_arg };
+
+    return gui_post_sync(_opponent_set, &call, GUI_APP_CALL_TIMEOUT_MS);
+}
+
+esp_err_t gui_app_game_remote_move(uint8_t seq, uint8_t cell)
+{
+    _move_call_t call = { .seq = seq, .cell = cell, .result = ESP_ERR_INVALID_STATE };
+
+    esp_err_t esp_err = gui_post_sync(_remote_move_play, &call, GUI_APP_CALL_TIMEOUT_MS);
+
+    if(ESP_OK != esp_err)
+    {
+        return esp_err;
+    }
+
+    if(ESP_OK != call.result)
+    {
+        printf("Remote move %u to cell %u ignored\n", seq, cell);
+    }
+
+    return call.result;
+}
+
+void gui_app_events_flush(void)
+{
+    for(uint8_t event = 0U; (p_user_interface_queue != NULL) && (event < _events_count); event++)
+    {
+        xQueueSend(p_user_interface_queue, &_events[event], 0U);
+    }
+
+    _events_count = 0U;
+}
 
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _event_router(lv_event_t *p_event)
+{
+    /* The route comes with the callback and the ID with the widget, nothing is searched. */
+    const _route_t *p_route = lv_event_get_user_data(p_event);
+    uintptr_t       widget  = (uintptr_t)lv_obj_get_user_data(lv_event_get_current_target(p_event));
+
+    p_route->p_handler((gui_app_widget_t)widget);
+}
+
+static void _widget_register(lv_obj_t *p_obj, gui_app_widget_t widget)
+{
+    lv_obj_set_user_data(p_obj, (void *)(uintptr_t)widget);
+    (void)lv_obj_add_event_cb(p_obj, _event_router, LV_EVENT_CLICKED, (void *)&_routes[widget]);
+}
+
+static void _event_post(gui_app_widget_t widget)
+{
+    if(GUI_APP_EVENTS_MAX <= _events_count)
+    {
+        printf("GUI event %d dropped\n", _routes[widget].event);
+        return;
+    }
+
+    /* Inform the user interface about button click once the frame is done. */
+    _events[_events_count++] = _routes[widget].event;
+}
+
+static void _button_1_clicked(gui_app_widget_t widget)
+{
+    (void)widget;
+
+    printf("Button 1 clicked\n");
+}
+
+static void _next_clicked(gui_app_widget_t widget)
+{
+    (void)widget;
+
+    (void)gui_screen_show(GUI_APP_SCREEN_GAME, LV_SCR_LOAD_ANIM_MOVE_LEFT);
+}
+
+static void _back_clicked(gui_app_widget_t widget)
+{
+    (void)widget;
+
+    (void)gui_screen_show(GUI_APP_SCREEN_HOME, LV_SCR_LOAD_ANIM_MOVE_RIGHT);
+}
+
+static void _dashboard_clicked(gui_app_widget_t widget)
+{
+    (void)widget;
+
+    (void)gui_screen_show(GUI_APP_SCREEN_DASHBOARD, LV_SCR_LOAD_ANIM_MOVE_LEFT);
+}
+
+static void _home_build(lv_obj_t *p_screen)
+{
     /* Create button 1 */
     lv_obj_t *p_label1;
-    p_btn1 = lv_btn_create(lv_scr_act());
+    p_btn1 = lv_btn_create(p_screen);
     lv_obj_align_to(p_btn1, NULL, LV_ALIGN_CENTER, 0, -80);
     p_label1 = lv_label_create(p_btn1);
     lv_label_set_text(p_label1, "Button 1");
 
     /* Add callback for button 1 */
-    (void)lv_obj_add_event_cb(p_btn1, _button_event_handler, LV_EVENT_CLICKED, NULL);
+    _widget_register(p_btn1, GUI_APP_WIDGET_BUTTON_1);
 
     /* Create "led on" button */
     lv_obj_t *p_led_on_label;
-    p_btn_led_on = lv_btn_create(lv_scr_act());
+    p_btn_led_on = lv_btn_create(p_screen);
     lv_obj_align_to(p_btn_led_on, NULL, LV_ALIGN_LEFT_MID, 0, 0);
     p_led_on_label = lv_label_create(p_btn_led_on);
     lv_label_set_text(p_led_on_label, "LED on");
 
     /* Add callback for "led on" button */
-    (void)lv_obj_add_event_cb(p_btn_led_on, _button_event_handler, LV_EVENT_CLICKED, NULL);
+    _widget_register(p_btn_led_on, GUI_APP_WIDGET_LED_ON);
 
     /* Create "led off" button */
     lv_obj_t *p_led_off_label;
-    p_btn_led_off = lv_btn_create(lv_scr_act());
+    p_btn_led_off = lv_btn_create(p_screen);
     lv_obj_align_to(p_btn_led_off, NULL, LV_ALIGN_CENTER, 0, 0);
     p_led_off_label = lv_label_create(p_btn_led_off);
     lv_label_set_text(p_led_off_label, "LED off");
 
     /* Add callback for "led off" button */
-    (void)lv_obj_add_event_cb(p_btn_led_off, _button_event_handler, LV_EVENT_CLICKED, NULL);
+    _widget_register(p_btn_led_off, GUI_APP_WIDGET_LED_OFF);
 
     // Inicijalizacija buttona koji vodi na novi screen
     lv_obj_t *p_btn_naprijed_label;
-    p_btn_naprijed = lv_btn_create(lv_scr_act());
+    p_btn_naprijed = lv_btn_create(p_screen);
     lv_obj_align_to(p_btn_naprijed, NULL, LV_ALIGN_BOTTOM_MID, 0, -20);
     p_btn_naprijed_label = lv_label_create(p_btn_naprijed);
     lv_label_set_text(p_btn_naprijed_label, "Idemo dalje");
 
-    (void)lv_obj_add_event_cb(p_btn_naprijed, _button_event_handler, LV_EVENT_CLICKED, NULL);
+    _widget_register(p_btn_naprijed, GUI_APP_WIDGET_NEXT);
+
+    lv_obj_t *p_btn_dashboard = lv_btn_create(p_screen);
+    lv_obj_align_to(p_btn_dashboard, NULL, LV_ALIGN_RIGHT_MID, 0, 0);
+    lv_label_set_text(lv_label_create(p_btn_dashboard), "Senzori");
+
+    _widget_register(p_btn_dashboard, GUI_APP_WIDGET_DASHBOARD);
 }
 
-//---------------------------- PRIVATE FUNCTIONS ------------------------------
-static void _button_event_handler(lv_event_t *p_event)
+static void _home_destroy(void)
 {
-    if(p_btn1 == p_event->target)
-    {
-        if(LV_EVENT_CLICKED == p_event->code)
-        {
-            printf("Button 1 clicked\n");
-        }
-    }
-    else if(p_btn_led_on == p_event->target)
-    {
-        if(LV_EVENT_CLICKED == p_event->code)
-        {
-            /* Inform the user interface about button click. */
-            _gui_app_event_send(GUI_APP_EVENT_BUTTON_LED_ON_PRESSED);
-        }
-    }
-    else if(p_btn_led_off == p_event->target)
-    {
-        if(LV_EVENT_CLICKED == p_event->code)
-        {
-            /* Inform the user interface about button click. */
-            _gui_app_event_send(GUI_APP_EVENT_BUTTON_LED_OFF_PRESSED);
-        }
-    }
-    else if(p_btn_naprijed == p_event->target) // Handle new button for screen transition
-    {
-        if(LV_EVENT_CLICKED == p_event->code)
-        {
-            // Load the yellow screen
-            // printf("Nesto se kuha gospodine bijeli");
-            goto_new_screen();
-            lv_example_grid_1();
-        }
-    }
-    else if(p_btn_povratak == p_event->target) // Handle new button for screen transition
-    {
-        if(LV_EVENT_CLICKED == p_event->code)
-        {
-            // Load the yellow screen
-            // printf("Nesto se kuha gospodine bijeli");
-            lv_scr_load(pocetni_screen);
-        }
-    }
+    p_btn1         = NULL;
+    p_btn_led_on   = NULL;
+    p_btn_led_off  = NULL;
+    p_btn_naprijed = NULL;
+}
 
-    // TIC TAC TOE GAME -------------------------------------------------------------------------
+static void _game_build(lv_obj_t *p_screen)
+{
+    // Inicijalizacija buttona koji vodi nazad na stari screen
+    lv_obj_t *p_btn_povratak_label;
+    p_btn_povratak = lv_btn_create(p_screen);
+    lv_obj_align_to(p_btn_povratak, NULL, LV_ALIGN_BOTTOM_RIGHT, 50, 0);
+    p_btn_povratak_label = lv_label_create(p_btn_povratak);
+    lv_label_set_text(p_btn_povratak_label, "Nazad");
+    _widget_register(p_btn_povratak, GUI_APP_WIDGET_BACK);
 
-    else if(array_buttona[0] == p_event->target) // Handle new button for screen transition
-    {
+    static int16_t col_dsc[] = { 40, 40, 40, LV_GRID_TEMPLATE_LAST };
+    static int16_t row_dsc[] = { 50, 50, 50, LV_GRID_TEMPLATE_LAST };
 
-        if(LV_EVENT_CLICKED == p_event->code)
-        {
-
-            // Load the yellow screen
-            // printf("Nesto se kuha gospodine bijeli");
-            if(is_Pressed == true)
-            {
-                lv_label_set_text_fmt(array_labela[0], znak[0]);
-                lv_obj_center(array_labela[0]);
-                is_Pressed = !is_Pressed;
-            }
-            else
-            {
-                lv_label_set_text_fmt(array_labela[0], znak[1]);
-                lv_obj_center(array_labela[0]);
-                is_Pressed = !is_Pressed;
-            }
-        }
-    }
+    /*Create a container with grid*/
 
-    else if(array_buttona[1] == p_event->target) // Handle new button for screen transition
-    {
+    // Ovo je container na novom screenu
+    lv_obj_t *cont = lv_obj_create(p_screen);
+    lv_obj_set_style_grid_column_dsc_array(cont, col_dsc, 0);
+    lv_obj_set_style_grid_row_dsc_array(cont, row_dsc, 0);
+    lv_obj_set_size(cont, 200, 220);
+    lv_obj_center(cont);
+    lv_obj_set_layout(cont, LV_LAYOUT_GRID);
 
-        if(LV_EVENT_CLICKED == p_event->code)
-        {
-
-            // Load the yellow screen
-            // printf("Nesto se kuha gospodine bijeli");
-
-            if(is_Pressed == true)
-            {
-                lv_label_set_text_fmt(array_labela[1], znak[0]);
-                lv_obj_center(array_labela[1]);
-                is_Pressed = !is_Pressed;
-            }
-            else
-            {
-                lv_label_set_text_fmt(array_labela[1], znak[1]);
-                lv_obj_center(array_labela[1]);
-                is_Pressed = !is_Pressed;
-            }
-        }
-    }
-    else if(array_buttona[2] == p_event->target) // Handle new button for screen transition
+    uint32_t i;
+
+    for(i = 0; i < 9; i++)
     {
+        uint8_t col = i % 3;
+        uint8_t row = i / 3;
 
-        if(LV_EVENT_CLICKED == p_event->code)
-        {
-
-            // Load the yellow screen
-            // printf("Nesto se kuha gospodine bijeli");
-
-            if(is_Pressed == true)
-            {
-                lv_label_set_text_fmt(array_labela[2], znak[0]);
-                lv_obj_center(array_labela[2]);
-                is_Pressed = !is_Pressed;
-            }
-            else
-            {
-                lv_label_set_text_fmt(array_labela[2], znak[1]);
-                lv_obj_center(array_labela[2]);
-                is_Pressed = !is_Pressed;
-            }
-        }
-    }
+        // Buttoni koji su vezani na gridu
 
-    else if(array_buttona[3] == p_event->target) // Handle new button for screen transition
-    {
+        array_buttona[i] = lv_btn_create(cont);
+        /*Stretch the cell horizontally and vertically too
+         *Set span to 1 to make the cell 1 column/row sized*/
+        lv_obj_set_grid_cell(array_buttona[i], LV_GRID_ALIGN_STRETCH, col, 1, LV_GRID_ALIGN_STRETCH, row, 1);
+
+        array_labela[i] = lv_label_create(array_buttona[i]);
+        lv_obj_center(array_labela[i]);
+        _cell_render(i);
 
-        if(LV_EVENT_CLICKED == p_event->code)
-        {
-
-            if(is_Pressed == true)
-            {
-                lv_label_set_text_fmt(array_labela[3], znak[0]);
-                lv_obj_center(array_labela[3]);
-                is_Pressed = !is_Pressed;
-            }
-            else
-            {
-                lv_label_set_text_fmt(array_labela[3], znak[1]);
-                lv_obj_center(array_labela[3]);
-                is_Pressed = !is_Pressed;
-            }
-        }
+        _widget_register(array_buttona[i], GUI_APP_WIDGET_CELL_0 + i);
     }
 
-    else if(array_buttona[4] == p_event->target) // Handle new button for screen transition
-    {
+    label = lv_label_create(p_screen);
+    lv_obj_align(label, LV_ALIGN_TOP_MID, 0, 0);
+    _status_render();
+}
 
-        if(LV_EVENT_CLICKED == p_event->code)
-        {
-
-            if(is_Pressed == true)
-            {
-                lv_label_set_text_fmt(array_labela[4], znak[0]);
-                lv_obj_center(array_labela[4]);
-                is_Pressed = !is_Pressed;
-            }
-            else
-            {
-                lv_label_set_text_fmt(array_labela[4], znak[1]);
-                lv_obj_center(array_labela[4]);
-                is_Pressed = !is_Pressed;
-            }
-        }
-    }
+static void _dashboard_build(lv_obj_t *p_screen)
+{
+    gui_dashboard_build(p_screen);
 
-    else if(array_buttona[5] == p_event->target) // Handle new button for screen transition
-    {
+    lv_obj_t *p_btn_back = lv_btn_create(p_screen);
+    lv_obj_align(p_btn_back, LV_ALIGN_BOTTOM_RIGHT, -5, -5);
+    lv_label_set_text(lv_label_create(p_btn_back), "Nazad");
 
-        if(LV_EVENT_CLICKED == p_event->code)
-        {
-
-            if(is_Pressed == true)
-            {
-                lv_label_set_text_fmt(array_labela[5], znak[0]);
-                lv_obj_center(array_labela[5]);
-                is_Pressed = !is_Pressed;
-            }
-            else
-            {
-                lv_label_set_text_fmt(array_labela[5], znak[1]);
-                lv_obj_center(array_labela[5]);
-                is_Pressed = !is_Pressed;
-            }
-        }
-    }
-    else if(array_buttona[6] == p_event->target) // Handle new button for screen transition
-    {
+    _widget_register(p_btn_back, GUI_APP_WIDGET_BACK);
+}
 
-        if(LV_EVENT_CLICKED == p_event->code)
-        {
-
-            if(is_Pressed == true)
-            {
-                lv_label_set_text_fmt(array_labela[6], znak[0]);
-                lv_obj_center(array_labela[6]);
-                is_Pressed = !is_Pressed;
-            }
-            else
-            {
-                lv_label_set_text_fmt(array_labela[6], znak[1]);
-                lv_obj_center(array_labela[6]);
-                is_Pressed = !is_Pressed;
-            }
-        }
-    }
+static void _game_destroy(void)
+{
+    memset(array_buttona, 0, sizeof(array_buttona));
+    memset(array_labela, 0, sizeof(array_labela));
+    label          = NULL;
+    p_btn_povratak = NULL;
+}
 
-    else if(array_buttona[7] == p_event->target) // Handle new button for screen transition
-    {
+static void _cell_clicked(gui_app_widget_t widget)
+{
+    uint8_t cell = (uint8_t)(widget - GUI_APP_WIDGET_CELL_0);
 
-        if(LV_EVENT_CLICKED == p_event->code)
-        {
-
-            if(is_Pressed == true)
-            {
-                lv_label_set_text_fmt(array_labela[7], znak[0]);
-                lv_obj_center(array_labela[7]);
-                is_Pressed = !is_Pressed;
-            }
-            else
-            {
-                lv_label_set_text_fmt(array_labela[7], znak[1]);
-                lv_obj_center(array_labela[7]);
-                is_Pressed = !is_Pressed;
-            }
-        }
+    if(TICTACTOE_STATE_PLAYING != _game.state)
+    {
+        /* A touch on a finished board starts the next game. */
+        _game_new(true);
+        return;
     }
 
-    else if(array_buttona[8] == p_event->target) // Handle new button for screen transition
+    /* Against a remote or computer opponent the touchscreen only plays X. */
+    if((GUI_APP_OPPONENT_LOCAL != _opponent) && (TICTACTOE_PLAYER_X != tictactoe_turn(&_game)))
     {
-
-        if(LV_EVENT_CLICKED == p_event->code)
-        {
-
-            if(is_Pressed == true)
-            {
-                lv_label_set_text_fmt(array_labela[8], znak[0]);
-                lv_obj_center(array_labela[8]);
-                is_Pressed = !is_Pressed;
-            }
-            else
-            {
-                lv_label_set_text_fmt(array_labela[8], znak[1]);
-                lv_obj_center(array_labela[8]);
-                is_Pressed = !is_Pressed;
-            }
-        }
+        return;
     }
 
-    else if(array_buttona[9] == p_event->target) // Handle new button for screen transition
+    if(ESP_OK != tictactoe_play(&_game, cell))
     {
+        return;
+    }
+
+    _cell_render(cell);
 
-        if(LV_EVENT_CLICKED == p_event->code)
-        {
-
-            if(is_Pressed == true)
-            {
-                lv_label_set_text_fmt(array_labela[9], znak[0]);
-                lv_obj_center(array_labela[9]);
-                is_Pressed = !is_Pressed;
-            }
-            else
-            {
-                lv_label_set_text_fmt(array_labela[9], znak[1]);
-                lv_obj_center(array_labela[9]);
-                is_Pressed = !is_Pressed;
-            }
-        }
+    if((GUI_APP_OPPONENT_REMOTE == _opponent) && (NULL != p_move_cb))
+    {
+        p_move_cb(_game.moves - 1U, cell, p_move_cb_arg);
     }
-    //-----------------------------------------------------------------------------------------------------------
-    else
+    else if((GUI_APP_OPPONENT_AI == _opponent) && (ESP_OK == tictactoe_best_move(&_game, &cell)) &&
+            (ESP_OK == tictactoe_play(&_game, cell)))
     {
-        /* Unknown button event. */
+        /* Openings come from a table and later positions are small, so the reply fits into the same frame. */
+        _cell_render(cell);
     }
+
+    _status_render();
 }
-static void _gui_app_event_send(gui_app_event_t event)
+
+static void _opponent_set(void *p_arg)
 {
-    if(p_user_interface_queue != NULL)
-    {
-        xQueueSend(p_user_interface_queue, &event, 0U);
-    }
+    const _opponent_call_t *p_call = p_arg;
+
+    _opponent     = p_call->opponent;
+    p_move_cb     = p_call->p_cb;
+    p_move_cb_arg = p_call->p_cb_arg;
+    _game_new(true);
 }
 
-static void goto_new_screen(void)
+static void _remote_move_play(void *p_arg)
 {
-    // Create a new screen
-    novi_screen = lv_obj_create(NULL);
-    // Inicijalizacija buttona koji vodi nazad na stari screen
-    lv_obj_t *p_btn_povratak_label;
-    p_btn_povratak = lv_btn_create(novi_screen);
-    lv_obj_align_to(p_btn_povratak, NULL, LV_ALIGN_BOTTOM_RIGHT, 50, 0);
-    p_btn_povratak_label = lv_label_create(p_btn_povratak);
-    lv_label_set_text(p_btn_povratak_label, "Nazad");
-    (void)lv_obj_add_event_cb(p_btn_povratak, _button_event_handler, LV_EVENT_CLICKED, NULL);
-    lv_scr_load(novi_screen);
+    _move_call_t *p_call = p_arg;
+
+    if(GUI_APP_OPPONENT_REMOTE != _opponent)
+    {
+        /* Nobody is expecting the opponent. */
+    }
+    else if(TICTACTOE_CELL_NEW_GAME == p_call->cell)
+    {
+        _game_new(false);
+        p_call->result = ESP_OK;
+    }
+    else if((TICTACTOE_PLAYER_O == tictactoe_turn(&_game)) &&
+            ((TICTACTOE_SEQ_ANY == p_call->seq) || (_game.moves == p_call->seq)) &&
+            (ESP_OK == tictactoe_play(&_game, p_call->cell)))
+    {
+        _cell_render(p_call->cell);
+        _status_render();
+        p_call->result = ESP_OK;
+    }
 }
 
-static void lv_example_grid_1(void)
+static void _game_new(bool b_is_local)
 {
-    static int16_t col_dsc[] = { 40, 40, 40, LV_GRID_TEMPLATE_LAST };
-    static int16_t row_dsc[] = { 50, 50, 50, LV_GRID_TEMPLATE_LAST };
+    tictactoe_reset(&_game);
 
-    /*Create a container with grid*/
+    for(uint8_t cell = 0U; cell < TICTACTOE_CELLS; cell++)
+    {
+        _cell_render(cell);
+    }
 
-    // Ovo je container na novom screenu
-    lv_obj_t *cont = lv_obj_create(novi_screen);
-    lv_obj_set_style_grid_column_dsc_array(cont, col_dsc, 0);
-    lv_obj_set_style_grid_row_dsc_array(cont, row_dsc, 0);
-    lv_obj_set_size(cont, 200, 220);
-    lv_obj_center(cont);
-    lv_obj_set_layout(cont, LV_LAYOUT_GRID);
+    _status_render();
 
-    uint32_t i;
+    if(b_is_local && (GUI_APP_OPPONENT_REMOTE == _opponent) && (NULL != p_move_cb))
+    {
+        p_move_cb(0U, TICTACTOE_CELL_NEW_GAME, p_move_cb_arg);
+    }
+}
 
-    for(i = 0; i < 9; i++)
+static void _cell_render(uint8_t cell)
+{
+    if(NULL == array_labela[cell])
     {
-        uint8_t col = i % 3;
-        uint8_t row = i / 3;
+        return;
+    }
 
-        // Buttoni koji su vezani na gridu
+    /* Static strings, LVGL keeps the pointer instead of a copy. */
+    lv_label_set_text_static(array_labela[cell], znak[tictactoe_cell_owner(&_game, cell)]);
 
-        array_buttona[i] = lv_btn_create(cont);
-        /*Stretch the cell horizontally and vertically too
-         *Set span to 1 to make the cell 1 column/row sized*/
-        lv_obj_set_grid_cell(array_buttona[i], LV_GRID_ALIGN_STRETCH, col, 1, LV_GRID_ALIGN_STRETCH, row, 1);
+    if(0U != (_game.win_line & (1U << cell)))
+    {
+        lv_obj_set_style_bg_color(array_buttona[cell], lv_palette_main(LV_PALETTE_GREEN), 0);
+    }
+    else
+    {
+        lv_obj_remove_local_style_prop(array_buttona[cell], LV_STYLE_BG_COLOR, 0);
+    }
+}
 
-        array_labela[i] = lv_label_create(array_buttona[i]);
-        lv_label_set_text_fmt(array_labela[i], " ");
-        lv_obj_center(array_labela[i]);
+static void _status_render(void)
+{
+    if(NULL == label)
+    {
+        return;
+    }
 
-        (void)lv_obj_add_event_cb(array_buttona[i], _button_event_handler, LV_EVENT_CLICKED, NULL);
+    if(TICTACTOE_STATE_WON == _game.state)
+    {
+        /* The winner made the last move, so it is the other player's turn. */
+        lv_label_set_text_fmt(label, "Pobjednik: %s", znak[tictactoe_turn(&_game) ^ 1U]);
+    }
+    else if(TICTACTOE_STATE_DRAW == _game.state)
+    {
+        lv_label_set_text_static(label, "Nerijeseno");
+    }
+    else
+    {
+        lv_label_set_text_fmt(label, "Na potezu: %s", znak[tictactoe_turn(&_game)]);
     }
 }
 
@@ -15,6 +15,8 @@ extern "C" {
 #endif
 
 //--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include <stdint.h>
 
 //---------------------------------- MACROS -----------------------------------
 
@@ -31,6 +33,29 @@ typedef enum
     GUI_APP_EVENT_COUNT
 } gui_app_event_t;
 
+/**
+ * @brief Enums hold who plays O in tic-tac-toe. The touchscreen always plays X.
+ *
+ */
+typedef enum
+{
+    GUI_APP_OPPONENT_LOCAL,  /* Both players share the touchscreen. */
+    GUI_APP_OPPONENT_REMOTE, /* O moves arrive over MQTT through gui_app_game_remote_move(). */
+    GUI_APP_OPPONENT_AI,     /* O is played by the perfect player. */
+
+    GUI_APP_OPPONENT_COUNT
+} gui_app_opponent_t;
+
+/**
+ * @brief Callback invoked for every local move and new game when playing a remote opponent. It runs in the GUI task
+ * and must not block.
+ *
+ * @param [in] seq   Moves played before this one.
+ * @param [in] cell  Cell or TICTACTOE_CELL_NEW_GAME.
+ * @param [in] p_arg User argument.
+ */
+typedef void (*gui_app_move_cb_t)(uint8_t seq, uint8_t cell, void *p_arg);
+
 //---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
 /**
  * @brief The function initialized first screen.
@@ -38,6 +63,35 @@ typedef enum
  */
 void gui_app_init(void);
 
+/**
+ * @brief The function posts the user interface events collected during the last frame. Called by the GUI task after
+ * every lv_task_handler() run, outside the LVGL lock.
+ *
+ */
+void gui_app_events_flush(void);
+
+/**
+ * @brief The function selects the tic-tac-toe opponent and starts a new game.
+ *
+ * @param [in] opponent  Who plays O.
+ * @param [in] p_move_cb Remote opponent only: sends local moves, optional.
+ * @param [in] p_cb_arg  User argument, optional.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_TIMEOUT if the GUI is busy, fail otherwise.
+ */
+esp_err_t gui_app_game_set_opponent(gui_app_opponent_t opponent, gui_app_move_cb_t p_move_cb, void *p_cb_arg);
+
+/**
+ * @brief The function plays a move of the remote opponent. Moves out of turn, out of sequence or repeated by a
+ * redelivery are ignored. It can be called from any task.
+ *
+ * @param [in] seq  Moves played before this one, or TICTACTOE_SEQ_ANY.
+ * @param [in] cell Cell or TICTACTOE_CELL_NEW_GAME.
+ *
+ * @return esp_err_t ESP_OK if played, ESP_ERR_INVALID_STATE if ignored, ESP_ERR_TIMEOUT if the GUI is busy.
+ */
+esp_err_t gui_app_game_remote_move(uint8_t seq, uint8_t cell);
+
 #ifdef __cplusplus
 }
 #endif
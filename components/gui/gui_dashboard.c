@@ -0,0 +1,247 @@
+/**
+ * @file gui_dashboard.c
+ *
+ * @brief This file shows the temperature and humidity on a chart, a gauge and two labels. The sensor task hands samples
+ * over through a single-producer, single-consumer ring: each side owns one index and publishes it with release
+ * ordering, so neither ever waits for the other nor for the GUI lock. An LVGL timer drains the ring once per display
+ * refresh period and writes the whole batch into the chart history before invalidating anything, so however fast
+ * samples arrive each widget is redrawn at most once per frame.
+ *
+ * The chart history is kept here and handed to LVGL as external series arrays. It costs no LVGL heap and survives the
+ * screen being evicted by the screen manager.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "gui_dashboard.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define GUI_DASHBOARD_RING_MASK (GUI_DASHBOARD_RING_SIZE - 1U)
+
+/* While the dashboard is not built the ring only has to be kept from overflowing. */
+#define GUI_DASHBOARD_IDLE_PERIOD_MS (1000U)
+
+/* Chart ranges, in tenths. */
+#define GUI_DASHBOARD_TEMP_MIN (-100)
+#define GUI_DASHBOARD_TEMP_MAX (500)
+#define GUI_DASHBOARD_HUMI_MAX (1000)
+
+#define GUI_DASHBOARD_TENTHS(X) ((int16_t)(((X) * 10.0f) + (((X) < 0.0f) ? -0.5f : 0.5f)))
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Sample as it travels through the ring.
+ *
+ */
+typedef struct
+{
+    int16_t temp; /* Tenths of a degree Celsius. */
+    int16_t humi; /* Tenths of a percent. */
+} _sample_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Moves every queued sample into the history and updates the widgets once.
+ *
+ * @param [in] p_timer Drain timer.
+ */
+static void _drain_timer_cb(lv_timer_t *p_timer);
+
+/**
+ * @brief Shows the latest sample on the labels and the gauge.
+ */
+static void _values_render(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static _sample_t   _ring[GUI_DASHBOARD_RING_SIZE];
+static atomic_uint _ring_head    = 0U; /* Written by the producer only. */
+static atomic_uint _ring_tail    = 0U; /* Written by the GUI task only. */
+static atomic_uint _ring_dropped = 0U;
+
+/* Only touched from the GUI task. */
+static lv_coord_t  _temp_points[GUI_DASHBOARD_POINTS];
+static lv_coord_t  _humi_points[GUI_DASHBOARD_POINTS];
+static uint16_t    _point_next = 0U; /* Oldest point, overwritten next. */
+static _sample_t   _latest;
+static _sample_t   _shown; /* What the labels show, to skip redrawing unchanged values. */
+static bool        _b_has_sample = false;
+static lv_timer_t *p_drain_timer = NULL;
+
+static lv_obj_t          *p_chart      = NULL;
+static lv_chart_series_t *p_temp_ser   = NULL;
+static lv_chart_series_t *p_humi_ser   = NULL;
+static lv_obj_t          *p_arc        = NULL;
+static lv_obj_t          *p_arc_label  = NULL;
+static lv_obj_t          *p_temp_label = NULL;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t gui_dashboard_init(void)
+{
+    if(NULL != p_drain_timer)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    for(uint16_t point = 0U; point < GUI_DASHBOARD_POINTS; point++)
+    {
+        _temp_points[point] = LV_CHART_POINT_NONE;
+        _humi_points[point] = LV_CHART_POINT_NONE;
+    }
+
+    p_drain_timer = lv_timer_create(_drain_timer_cb, GUI_DASHBOARD_IDLE_PERIOD_MS, NULL);
+
+    return (NULL != p_drain_timer) ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t gui_dashboard_push(float temp, float humi)
+{
+    unsigned head = atomic_load_explicit(&_ring_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&_ring_tail, memory_order_acquire);
+
+    if(GUI_DASHBOARD_RING_SIZE <= (head - tail))
+    {
+        (void)atomic_fetch_add_explicit(&_ring_dropped, 1U, memory_order_relaxed);
+        return ESP_ERR_NO_MEM;
+    }
+
+    _ring[head & GUI_DASHBOARD_RING_MASK].temp = GUI_DASHBOARD_TENTHS(temp);
+    _ring[head & GUI_DASHBOARD_RING_MASK].humi = GUI_DASHBOARD_TENTHS(humi);
+
+    /* The sample is written before the GUI task can see the new head. */
+    atomic_store_explicit(&_ring_head, head + 1U, memory_order_release);
+
+    return ESP_OK;
+}
+
+void gui_dashboard_build(lv_obj_t *p_screen)
+{
+    p_chart = lv_chart_create(p_screen);
+    lv_obj_set_size(p_chart, 200, 150);
+    lv_obj_align(p_chart, LV_ALIGN_TOP_LEFT, 5, 5);
+    lv_chart_set_type(p_chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_update_mode(p_chart, LV_CHART_UPDATE_MODE_SHIFT);
+    lv_chart_set_div_line_count(p_chart, 5, 0);
+    lv_chart_set_point_count(p_chart, GUI_DASHBOARD_POINTS);
+    lv_chart_set_range(p_chart, LV_CHART_AXIS_PRIMARY_Y, GUI_DASHBOARD_TEMP_MIN, GUI_DASHBOARD_TEMP_MAX);
+    lv_chart_set_range(p_chart, LV_CHART_AXIS_SECONDARY_Y, 0, GUI_DASHBOARD_HUMI_MAX);
+
+    /* Points are drawn as a line only, a dot per point would be redrawn on every shift. */
+    lv_obj_set_style_size(p_chart, 0, LV_PART_INDICATOR);
+
+    p_temp_ser = lv_chart_add_series(p_chart, lv_palette_main(LV_PALETTE_RED), LV_CHART_AXIS_PRIMARY_Y);
+    p_humi_ser = lv_chart_add_series(p_chart, lv_palette_main(LV_PALETTE_BLUE), LV_CHART_AXIS_SECONDARY_Y);
+    lv_chart_set_ext_y_array(p_chart, p_temp_ser, _temp_points);
+    lv_chart_set_ext_y_array(p_chart, p_humi_ser, _humi_points);
+    lv_chart_set_x_start_point(p_chart, p_temp_ser, _point_next);
+    lv_chart_set_x_start_point(p_chart, p_humi_ser, _point_next);
+
+    p_arc = lv_arc_create(p_screen);
+    lv_obj_set_size(p_arc, 100, 100);
+    lv_obj_align(p_arc, LV_ALIGN_TOP_RIGHT, -5, 5);
+    lv_arc_set_range(p_arc, 0, 100);
+    lv_obj_clear_flag(p_arc, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_remove_style(p_arc, NULL, LV_PART_KNOB);
+
+    p_arc_label = lv_label_create(p_arc);
+    lv_obj_center(p_arc_label);
+
+    p_temp_label = lv_label_create(p_screen);
+    lv_obj_align(p_temp_label, LV_ALIGN_TOP_RIGHT, -15, 115);
+
+    /* The fresh labels show nothing yet. */
+    _shown.temp = INT16_MIN;
+    _shown.humi = INT16_MIN;
+    _values_render();
+
+    lv_timer_set_period(p_drain_timer, LV_DISP_DEF_REFR_PERIOD);
+}
+
+void gui_dashboard_destroy(void)
+{
+    p_chart      = NULL;
+    p_temp_ser   = NULL;
+    p_humi_ser   = NULL;
+    p_arc        = NULL;
+    p_arc_label  = NULL;
+    p_temp_label = NULL;
+
+    lv_timer_set_period(p_drain_timer, GUI_DASHBOARD_IDLE_PERIOD_MS);
+}
+
+uint32_t gui_dashboard_get_dropped(void)
+{
+    return atomic_load_explicit(&_ring_dropped, memory_order_relaxed);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _drain_timer_cb(lv_timer_t *p_timer)
+{
+    (void)p_timer;
+
+    unsigned tail = atomic_load_explicit(&_ring_tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&_ring_head, memory_order_acquire);
+
+    if(head == tail)
+    {
+        return;
+    }
+
+    for(; tail != head; tail++)
+    {
+        _latest = _ring[tail & GUI_DASHBOARD_RING_MASK];
+
+        _temp_points[_point_next] = _latest.temp;
+        _humi_points[_point_next] = _latest.humi;
+        _point_next               = (uint16_t)((_point_next + 1U) % GUI_DASHBOARD_POINTS);
+    }
+
+    /* The slots are read before the producer may reuse them. */
+    atomic_store_explicit(&_ring_tail, tail, memory_order_release);
+    _b_has_sample = true;
+
+    if(NULL == p_chart)
+    {
+        return;
+    }
+
+    lv_chart_set_x_start_point(p_chart, p_temp_ser, _point_next);
+    lv_chart_set_x_start_point(p_chart, p_humi_ser, _point_next);
+    lv_chart_refresh(p_chart);
+
+    _values_render();
+}
+
+static void _values_render(void)
+{
+    if(!_b_has_sample)
+    {
+        lv_label_set_text_static(p_arc_label, "-- %");
+        lv_label_set_text_static(p_temp_label, "-- C");
+        return;
+    }
+
+    int16_t humi = (int16_t)((_latest.humi + 5) / 10);
+
+    if(humi != _shown.humi)
+    {
+        lv_arc_set_value(p_arc, humi);
+        lv_label_set_text_fmt(p_arc_label, "%d %%", humi);
+        _shown.humi = humi;
+    }
+
+    if(_latest.temp != _shown.temp)
+    {
+        lv_label_set_text_fmt(p_temp_label, "%s%d.%d C", (0 > _latest.temp) ? "-" : "", abs(_latest.temp) / 10,
+                              abs(_latest.temp) % 10);
+        _shown.temp = _latest.temp;
+    }
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
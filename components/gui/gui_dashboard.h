@@ -0,0 +1,73 @@
+/**
+ * @file gui_dashboard.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __GUI_DASHBOARD_C__
+#define __GUI_DASHBOARD_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include "lvgl.h"
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+/* Samples the sensor task can hand over before the GUI picks them up, a power of two. */
+#define GUI_DASHBOARD_RING_SIZE (16U)
+
+/* Samples shown on the chart. */
+#define GUI_DASHBOARD_POINTS (60U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function starts collecting samples. Must be called from the GUI task with LVGL locked.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t gui_dashboard_init(void);
+
+/**
+ * @brief The function hands one sample to the GUI. It never blocks nor takes the GUI lock, but only one task may call
+ * it.
+ *
+ * @param [in] temp Temperature in degrees Celsius.
+ * @param [in] humi Relative humidity in percent.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if the GUI fell behind and the sample was dropped.
+ */
+esp_err_t gui_dashboard_push(float temp, float humi);
+
+/**
+ * @brief The function creates the chart, the gauge and the value labels. Matches gui_screen_build_cb_t.
+ *
+ * @param [in] p_screen Empty screen.
+ */
+void gui_dashboard_build(lv_obj_t *p_screen);
+
+/**
+ * @brief The function forgets the widgets once their screen is deleted. Matches gui_screen_destroy_cb_t.
+ */
+void gui_dashboard_destroy(void);
+
+/**
+ * @brief The function returns the number of samples dropped because the GUI fell behind.
+ *
+ * @return uint32_t Dropped samples.
+ */
+uint32_t gui_dashboard_get_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __GUI_DASHBOARD_C__
@@ -0,0 +1,260 @@
+/**
+ * @file gui_perf.c
+ *
+ * @brief This file measures the GUI in the field. It uses the display driver hooks LVGL calls from its refresh timer,
+ * the same places the on-screen performance and memory monitors are fed from, but nothing is drawn and the refresh
+ * timer may still pause while the screen is idle. render_start_cb counts the invalidated areas left after joining and
+ * starts the frame clock, monitor_cb stops it once the last area is flushed. The flush callback is wrapped to start
+ * the flush clock, which the SPI driver stops from its ISR. The heap and the stack are sampled when the counters are
+ * read, LVGL keeps the peak heap usage itself.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "gui_perf.h"
+#include "gui.h"
+#include "disp_spi.h"
+#include "json_writer.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define GUI_PERF_GET_TIMEOUT_MS (100U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Argument of the call run in the GUI task.
+ *
+ */
+typedef struct
+{
+    gui_perf_stats_t *p_stats;
+    bool              b_reset;
+} _get_call_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Counts one value.
+ *
+ * @param [in,out] p_hist Histogram.
+ * @param [in]     value  Value to be counted.
+ * @param [in]     unit   Upper bound of the first bucket.
+ */
+static void _hist_add(gui_perf_hist_t *p_hist, uint32_t value, uint32_t unit);
+
+/**
+ * @brief Starts the frame clock and counts the areas about to be drawn.
+ *
+ * @param [in] p_disp_drv Display driver.
+ */
+static void _render_start_cb(lv_disp_drv_t *p_disp_drv);
+
+/**
+ * @brief Stops the frame clock.
+ *
+ * @param [in] p_disp_drv Display driver.
+ * @param [in] time_ms    Frame time as measured by LVGL, at tick resolution.
+ * @param [in] px         Pixels drawn.
+ */
+static void _monitor_cb(lv_disp_drv_t *p_disp_drv, uint32_t time_ms, uint32_t px);
+
+/**
+ * @brief Starts the flush clock and hands the area to the display driver.
+ */
+static void _flush_cb(lv_disp_drv_t *p_disp_drv, const lv_area_t *p_area, lv_color_t *p_color);
+
+/**
+ * @brief Copies the counters and samples the heap and the stack, in the GUI task.
+ *
+ * @param [in,out] p_arg Pointer to a _get_call_t.
+ */
+static void _get(void *p_arg);
+
+/**
+ * @brief Appends a named histogram to the JSON being built.
+ */
+static void _json_hist(json_writer_t *p_writer, const char *p_name, const gui_perf_hist_t *p_hist, uint32_t unit);
+
+/**
+ * @brief Stops the flush clock. Called from the SPI ISR.
+ */
+static void _flush_done_isr(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+/* Only touched from the GUI task. */
+static int64_t         _render_start_us = 0;
+static uint32_t        _render_areas    = 0U;
+static gui_perf_hist_t _render_us;
+static gui_perf_hist_t _areas;
+static gui_perf_hist_t _px;
+
+static void (*p_flush_cb)(lv_disp_drv_t *p_disp_drv, const lv_area_t *p_area, lv_color_t *p_color) = NULL;
+
+/* Shared with the SPI ISR. */
+static portMUX_TYPE     _flush_lock     = portMUX_INITIALIZER_UNLOCKED;
+static volatile int64_t _flush_start_us = 0;
+static gui_perf_hist_t  _flush_us;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+void gui_perf_attach(lv_disp_drv_t *p_disp_drv)
+{
+    p_flush_cb = p_disp_drv->flush_cb;
+
+    p_disp_drv->flush_cb        = _flush_cb;
+    p_disp_drv->render_start_cb = _render_start_cb;
+    p_disp_drv->monitor_cb      = _monitor_cb;
+
+    disp_spi_set_flush_done_cb(_flush_done_isr);
+}
+
+esp_err_t gui_perf_get(gui_perf_stats_t *p_stats, bool b_reset)
+{
+    if(NULL == p_stats)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    _get_call_t call = {
+        .p_stats = p_stats,
+        .b_reset = b_reset,
+    };
+
+    return gui_post_sync(_get, &call, GUI_PERF_GET_TIMEOUT_MS);
+}
+
+esp_err_t gui_perf_to_json(const gui_perf_stats_t *p_stats, char *p_buf, size_t buf_size, size_t *p_len)
+{
+    if((NULL == p_stats) || (NULL == p_buf) || (NULL == p_len))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    json_writer_t writer;
+
+    json_writer_init(&writer, p_buf, buf_size);
+    json_writer_printf(&writer,
+                       "{\"stack\":%lu,\"mem\":{\"pool_used\":%lu,\"max_req\":%lu,\"biggest\":%lu,\"frag\":%u}",
+                       (unsigned long)p_stats->stack_free, (unsigned long)p_stats->mem_pool_used,
+                       (unsigned long)p_stats->mem_max_requested, (unsigned long)p_stats->mem_free_biggest,
+                       (unsigned)p_stats->mem_frag_pct);
+    _json_hist(&writer, "render_us", &p_stats->render_us, GUI_PERF_TIME_UNIT_US);
+    _json_hist(&writer, "flush_us", &p_stats->flush_us, GUI_PERF_TIME_UNIT_US);
+    _json_hist(&writer, "areas", &p_stats->areas, GUI_PERF_AREA_UNIT);
+    _json_hist(&writer, "px", &p_stats->px, GUI_PERF_PX_UNIT);
+    json_writer_printf(&writer, "}");
+
+    return json_writer_finish(&writer, p_len);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void IRAM_ATTR _hist_add(gui_perf_hist_t *p_hist, uint32_t value, uint32_t unit)
+{
+    uint32_t units  = value / unit;
+    uint32_t bucket = (0U == units) ? 0U : (uint32_t)(32 - __builtin_clz(units));
+
+    if(GUI_PERF_BUCKETS <= bucket)
+    {
+        bucket = GUI_PERF_BUCKETS - 1U;
+    }
+
+    p_hist->counts[bucket]++;
+    p_hist->sum += value;
+
+    if(value > p_hist->max)
+    {
+        p_hist->max = value;
+    }
+}
+
+static void _render_start_cb(lv_disp_drv_t *p_disp_drv)
+{
+    (void)p_disp_drv;
+
+    lv_disp_t *p_disp = _lv_refr_get_disp_refreshing();
+
+    _render_areas = 0U;
+    for(uint16_t area = 0U; area < p_disp->inv_p; area++)
+    {
+        _render_areas += (0U == p_disp->inv_area_joined[area]) ? 1U : 0U;
+    }
+
+    _render_start_us = esp_timer_get_time();
+}
+
+static void _monitor_cb(lv_disp_drv_t *p_disp_drv, uint32_t time_ms, uint32_t px)
+{
+    (void)p_disp_drv;
+    (void)time_ms;
+
+    _hist_add(&_render_us, (uint32_t)(esp_timer_get_time() - _render_start_us), GUI_PERF_TIME_UNIT_US);
+    _hist_add(&_areas, _render_areas, GUI_PERF_AREA_UNIT);
+    _hist_add(&_px, px, GUI_PERF_PX_UNIT);
+}
+
+static void _flush_cb(lv_disp_drv_t *p_disp_drv, const lv_area_t *p_area, lv_color_t *p_color)
+{
+    /* LVGL does not flush again before the previous flush is done, so no lock is needed. */
+    _flush_start_us = esp_timer_get_time();
+
+    p_flush_cb(p_disp_drv, p_area, p_color);
+}
+
+static void _get(void *p_arg)
+{
+    _get_call_t     *p_call = (_get_call_t *)p_arg;
+    lv_mem_monitor_t mon;
+
+    lv_mem_monitor(&mon);
+
+    p_call->p_stats->render_us        = _render_us;
+    p_call->p_stats->areas            = _areas;
+    p_call->p_stats->px               = _px;
+    p_call->p_stats->mem_pool_used     = mon.total_size - mon.free_size;
+    p_call->p_stats->mem_max_requested = mon.max_used;
+    p_call->p_stats->mem_free_biggest  = mon.free_biggest_size;
+    p_call->p_stats->mem_frag_pct      = mon.frag_pct;
+    p_call->p_stats->stack_free        = uxTaskGetStackHighWaterMark(NULL);
+
+    portENTER_CRITICAL(&_flush_lock);
+    p_call->p_stats->flush_us = _flush_us;
+    if(p_call->b_reset)
+    {
+        memset(&_flush_us, 0, sizeof(_flush_us));
+    }
+    portEXIT_CRITICAL(&_flush_lock);
+
+    if(p_call->b_reset)
+    {
+        memset(&_render_us, 0, sizeof(_render_us));
+        memset(&_areas, 0, sizeof(_areas));
+        memset(&_px, 0, sizeof(_px));
+    }
+}
+
+static void _json_hist(json_writer_t *p_writer, const char *p_name, const gui_perf_hist_t *p_hist, uint32_t unit)
+{
+    json_writer_printf(p_writer, ",\"%s\":{\"unit\":%lu,\"n\":[", p_name, (unsigned long)unit);
+
+    for(uint8_t bucket = 0U; bucket < GUI_PERF_BUCKETS; bucket++)
+    {
+        json_writer_printf(p_writer, (0U == bucket) ? "%lu" : ",%lu", (unsigned long)p_hist->counts[bucket]);
+    }
+
+    json_writer_printf(p_writer, "],\"max\":%lu,\"sum\":%lu}", (unsigned long)p_hist->max, (unsigned long)p_hist->sum);
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
+static void IRAM_ATTR _flush_done_isr(void)
+{
+    uint32_t flush_us = (uint32_t)(esp_timer_get_time() - _flush_start_us);
+
+    portENTER_CRITICAL_ISR(&_flush_lock);
+    _hist_add(&_flush_us, flush_us, GUI_PERF_TIME_UNIT_US);
+    portEXIT_CRITICAL_ISR(&_flush_lock);
+}
@@ -0,0 +1,98 @@
+/**
+ * @file gui_perf.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __GUI_PERF_C__
+#define __GUI_PERF_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include "lvgl.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+/* Bucket 0 counts values below one unit, bucket n values from 2^(n - 1) up to 2^n units, the last one the rest. */
+#define GUI_PERF_BUCKETS (8U)
+
+/* Units of the histograms. */
+#define GUI_PERF_TIME_UNIT_US (1000U)
+#define GUI_PERF_PX_UNIT      (1024U)
+#define GUI_PERF_AREA_UNIT    (1U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Log2 histogram.
+ *
+ */
+typedef struct
+{
+    uint32_t counts[GUI_PERF_BUCKETS];
+    uint32_t max;
+    uint32_t sum;
+} gui_perf_hist_t;
+
+/**
+ * @brief GUI performance since the last reset.
+ *
+ */
+typedef struct
+{
+    gui_perf_hist_t render_us; /* Per frame, from the first invalidated area drawn to the last one flushed. */
+    gui_perf_hist_t flush_us;  /* Per flush, from the flush callback to the SPI transfer done. */
+    gui_perf_hist_t areas;     /* Invalidated areas per frame, after joining. */
+    gui_perf_hist_t px;        /* Pixels drawn per frame. */
+    uint32_t        mem_pool_used;     /* LVGL heap in use with the allocator overhead, sampled when read. */
+    uint32_t        mem_max_requested; /* Peak of the bytes requested from the LVGL heap, without the overhead. */
+    uint32_t        mem_free_biggest;
+    uint8_t         mem_frag_pct;
+    uint32_t        stack_free; /* GUI task stack that was never used, in bytes. */
+} gui_perf_stats_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function hooks the counters into the display driver. Must be called from the GUI task after flush_cb
+ * is set and before the driver is registered.
+ *
+ * @param [in,out] p_disp_drv Display driver.
+ */
+void gui_perf_attach(lv_disp_drv_t *p_disp_drv);
+
+/**
+ * @brief The function copies the counters and samples the LVGL heap and the GUI task stack. It runs in the GUI task
+ * through gui_post_sync(), so it can be called from any task.
+ *
+ * @param [out] p_stats Destination for the counters.
+ * @param [in]  b_reset Start new histograms.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_TIMEOUT if the GUI task is busy, fail otherwise.
+ */
+esp_err_t gui_perf_get(gui_perf_stats_t *p_stats, bool b_reset);
+
+/**
+ * @brief The function serializes the counters into compact JSON.
+ *
+ * @param [in]  p_stats  Counters to be encoded.
+ * @param [out] p_buf    Destination buffer, NUL terminated on success.
+ * @param [in]  buf_size Size of the destination buffer.
+ * @param [out] p_len    Number of bytes written without the terminator.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_SIZE if the buffer is too small, fail otherwise.
+ */
+esp_err_t gui_perf_to_json(const gui_perf_stats_t *p_stats, char *p_buf, size_t buf_size, size_t *p_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __GUI_PERF_C__
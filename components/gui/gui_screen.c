@@ -0,0 +1,273 @@
+/**
+ * @file gui_screen.c
+ *
+ * @brief This file keeps the application screens. A screen is built on its first show and then cached, so
+ * navigating back and forth costs only the transition. While the LVGL heap runs low, cached screens are deleted,
+ * least recently shown first, and rebuilt on their next show. Screens animating in or out are never deleted and the
+ * old screen is never handed to lv_scr_load_anim() for automatic deletion unless it is not one of ours. Bookkeeping
+ * hangs off each screen's LV_EVENT_DELETE, so it stays right whoever deletes it.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "gui_screen.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <stdio.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define GUI_SCREEN_ANIM_TIME_MS (200U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Managed screen.
+ *
+ */
+typedef struct
+{
+    lv_obj_t *p_obj;     /* NULL while not built. */
+    uint32_t  last_show; /* Show counter value of the last show, for LRU. */
+} _screen_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Builds a screen and measures it.
+ */
+static esp_err_t _build(uint8_t screen);
+
+/**
+ * @brief Deletes the least recently shown screen that is not on the display.
+ *
+ * @param [in] keep Screen that is about to be shown.
+ *
+ * @return true if a screen was deleted.
+ */
+static bool _evict_one(uint8_t keep);
+
+/**
+ * @brief Returns the LVGL heap currently in use.
+ */
+static uint32_t _mem_used(void);
+
+/**
+ * @brief Forgets a deleted screen and lets its owner forget the widgets.
+ *
+ * @param [in] p_event Delete event, the user data is the screen ID.
+ */
+static void _delete_event_cb(lv_event_t *p_event);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const gui_screen_desc_t *p_descs = NULL;
+static uint8_t                  _count  = 0U;
+
+/* Only touched from the GUI task. */
+static _screen_t _screens[GUI_SCREEN_MAX];
+static uint32_t  _show_count = 0U;
+
+static portMUX_TYPE       _stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static gui_screen_stats_t _stats[GUI_SCREEN_MAX];
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t gui_screen_init(const gui_screen_desc_t *p_screen_descs, uint8_t count)
+{
+    if((NULL == p_screen_descs) || (0U == count) || (GUI_SCREEN_MAX < count))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for(uint8_t screen = 0U; screen < count; screen++)
+    {
+        if(NULL == p_screen_descs[screen].p_build_cb)
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    p_descs = p_screen_descs;
+    _count  = count;
+
+    return ESP_OK;
+}
+
+esp_err_t gui_screen_show(uint8_t screen, lv_scr_load_anim_t anim)
+{
+    if(screen >= _count)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    lv_obj_t *p_active = lv_scr_act();
+
+    if((NULL != _screens[screen].p_obj) && (_screens[screen].p_obj == p_active))
+    {
+        return ESP_OK;
+    }
+
+    if(NULL == _screens[screen].p_obj)
+    {
+        lv_mem_monitor_t mon;
+        lv_mem_monitor(&mon);
+
+        while((GUI_SCREEN_MEM_FREE_MIN > mon.free_size) && _evict_one(screen))
+        {
+            lv_mem_monitor(&mon);
+        }
+
+        esp_err_t esp_err = _build(screen);
+        if(ESP_OK != esp_err)
+        {
+            return esp_err;
+        }
+    }
+
+    /* The outgoing screen is deleted after the transition only if nobody caches it, e.g. the display's default one. */
+    bool b_is_managed = false;
+    for(uint8_t other = 0U; other < _count; other++)
+    {
+        b_is_managed |= (p_active == _screens[other].p_obj);
+    }
+
+    _screens[screen].last_show = ++_show_count;
+
+    portENTER_CRITICAL(&_stats_lock);
+    _stats[screen].shows++;
+    portEXIT_CRITICAL(&_stats_lock);
+
+    lv_scr_load_anim(_screens[screen].p_obj, anim, (LV_SCR_LOAD_ANIM_NONE == anim) ? 0U : GUI_SCREEN_ANIM_TIME_MS, 0U,
+                     !b_is_managed);
+
+    return ESP_OK;
+}
+
+esp_err_t gui_screen_get_stats(uint8_t screen, gui_screen_stats_t *p_stats)
+{
+    if((screen >= _count) || (NULL == p_stats))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&_stats_lock);
+    *p_stats = _stats[screen];
+    portEXIT_CRITICAL(&_stats_lock);
+
+    return ESP_OK;
+}
+
+void gui_screen_report_print(void)
+{
+    gui_screen_stats_t stats;
+
+    printf("GUI screens:\n");
+
+    for(uint8_t screen = 0U; screen < _count; screen++)
+    {
+        (void)gui_screen_get_stats(screen, &stats);
+
+        printf("  %-8s %-6s %6lu B %6lu us, %u builds, %u shows, %u evictions\n", p_descs[screen].p_name,
+               stats.b_is_built ? "cached" : "-", (unsigned long)stats.mem_bytes, (unsigned long)stats.build_us,
+               stats.builds, stats.shows, stats.evictions);
+    }
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static esp_err_t _build(uint8_t screen)
+{
+    uint32_t mem_before = _mem_used();
+    int64_t  start_us   = esp_timer_get_time();
+
+    lv_obj_t *p_obj = lv_obj_create(NULL);
+    if(NULL == p_obj)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    p_descs[screen].p_build_cb(p_obj);
+    (void)lv_obj_add_event_cb(p_obj, _delete_event_cb, LV_EVENT_DELETE, (void *)(uintptr_t)screen);
+    _screens[screen].p_obj = p_obj;
+
+    uint32_t build_us  = (uint32_t)(esp_timer_get_time() - start_us);
+    uint32_t mem_after = _mem_used();
+
+    portENTER_CRITICAL(&_stats_lock);
+    _stats[screen].mem_bytes  = (mem_after > mem_before) ? (mem_after - mem_before) : 0U;
+    _stats[screen].build_us   = build_us;
+    _stats[screen].b_is_built = true;
+    _stats[screen].builds++;
+    portEXIT_CRITICAL(&_stats_lock);
+
+    return ESP_OK;
+}
+
+static bool _evict_one(uint8_t keep)
+{
+    lv_disp_t *p_disp   = lv_disp_get_default();
+    uint8_t    victim   = GUI_SCREEN_MAX;
+    uint32_t   min_show = UINT32_MAX;
+
+    for(uint8_t screen = 0U; screen < _count; screen++)
+    {
+        lv_obj_t *p_obj = _screens[screen].p_obj;
+
+        /* The active screen and one still animating out stay. */
+        if((screen == keep) || (NULL == p_obj) || (p_obj == lv_scr_act()) || (p_obj == p_disp->prev_scr))
+        {
+            continue;
+        }
+
+        if(_screens[screen].last_show < min_show)
+        {
+            min_show = _screens[screen].last_show;
+            victim   = screen;
+        }
+    }
+
+    if(GUI_SCREEN_MAX == victim)
+    {
+        return false;
+    }
+
+    portENTER_CRITICAL(&_stats_lock);
+    _stats[victim].evictions++;
+    portEXIT_CRITICAL(&_stats_lock);
+
+    /* Bookkeeping happens in the delete event. */
+    lv_obj_del(_screens[victim].p_obj);
+
+    return true;
+}
+
+static uint32_t _mem_used(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+
+    return mon.total_size - mon.free_size;
+}
+
+static void _delete_event_cb(lv_event_t *p_event)
+{
+    uint8_t screen = (uint8_t)(uintptr_t)lv_event_get_user_data(p_event);
+
+    /* Ignore children's delete events should they ever bubble up. */
+    if(lv_event_get_target(p_event) != _screens[screen].p_obj)
+    {
+        return;
+    }
+
+    _screens[screen].p_obj = NULL;
+
+    portENTER_CRITICAL(&_stats_lock);
+    _stats[screen].b_is_built = false;
+    portEXIT_CRITICAL(&_stats_lock);
+
+    if(NULL != p_descs[screen].p_destroy_cb)
+    {
+        p_descs[screen].p_destroy_cb();
+    }
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
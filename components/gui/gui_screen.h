@@ -0,0 +1,109 @@
+/**
+ * @file gui_screen.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __GUI_SCREEN_C__
+#define __GUI_SCREEN_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include "lvgl.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+/* Upper bound for the number of managed screens. */
+#define GUI_SCREEN_MAX (8U)
+
+/* Cached screens are evicted, least recently shown first, while less LVGL heap than this is free. */
+#define GUI_SCREEN_MEM_FREE_MIN (12U * 1024U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Creates the widgets of a screen. It runs in the GUI task with LVGL locked.
+ *
+ * @param [in] p_screen Freshly created, empty screen.
+ */
+typedef void (*gui_screen_build_cb_t)(lv_obj_t *p_screen);
+
+/**
+ * @brief Called when a screen is deleted, so its owner can forget the widget pointers. It runs in the GUI task.
+ */
+typedef void (*gui_screen_destroy_cb_t)(void);
+
+/**
+ * @brief Screen description.
+ *
+ */
+typedef struct
+{
+    const char             *p_name;
+    gui_screen_build_cb_t   p_build_cb;
+    gui_screen_destroy_cb_t p_destroy_cb; /* Optional. */
+} gui_screen_desc_t;
+
+/**
+ * @brief Per-screen counters.
+ *
+ */
+typedef struct
+{
+    uint32_t mem_bytes; /* LVGL heap taken by the last build. */
+    uint32_t build_us;  /* Duration of the last build. */
+    uint16_t builds;
+    uint16_t shows;
+    uint16_t evictions;
+    bool     b_is_built;
+} gui_screen_stats_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function registers the screens. Nothing is built until a screen is shown. Must be called from the GUI
+ * task.
+ *
+ * @param [in] p_screen_descs Screen descriptions, must stay valid. A screen's ID is its index.
+ * @param [in] count          Number of screens, up to GUI_SCREEN_MAX.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t gui_screen_init(const gui_screen_desc_t *p_screen_descs, uint8_t count);
+
+/**
+ * @brief The function shows a screen, building it first if it is not cached. Must be called with LVGL locked.
+ *
+ * @param [in] screen Screen ID.
+ * @param [in] anim   Transition.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if the LVGL heap is exhausted, fail otherwise.
+ */
+esp_err_t gui_screen_show(uint8_t screen, lv_scr_load_anim_t anim);
+
+/**
+ * @brief The function copies the counters of one screen. It can be called from any task.
+ *
+ * @param [in]  screen  Screen ID.
+ * @param [out] p_stats Destination for the counters.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t gui_screen_get_stats(uint8_t screen, gui_screen_stats_t *p_stats);
+
+/**
+ * @brief The function prints the counters of all screens to the console. It can be called from any task.
+ */
+void gui_screen_report_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __GUI_SCREEN_C__
@@ -0,0 +1,371 @@
+/**
+ * @file i2c_bus.c
+ *
+ * @brief This file implements the shared I2C bus service. Every bus is owned by one task that serves a queue per
+ * priority, so a touch read never waits behind a backlog of sensor reads. All drivers on the bus go through here
+ * instead of calling i2c_master_cmd_begin themselves.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "i2c_bus.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdbool.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define I2C_BUS_QUEUE_SIZE      (8U)
+#define I2C_BUS_TASK_STACK_SIZE (3 * 1024)
+#define I2C_BUS_TASK_PRIORITY   (10U)
+#define I2C_BUS_TIMEOUT_MS      (50U)
+
+/* Every operation needs start, address, write, restart, address, read and stop. */
+#define I2C_BUS_CMD_LINK_SIZE (I2C_LINK_RECOMMENDED_SIZE(I2C_BUS_OPS_MAX * 4U))
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Queued transaction together with its submit timestamp.
+ *
+ */
+typedef struct
+{
+    i2c_bus_transaction_t trans;
+    int64_t               submit_us;
+} _queued_trans_t;
+
+/**
+ * @brief State of one bus.
+ *
+ */
+typedef struct
+{
+    bool             b_is_initialized;
+    bool             b_is_installing; /* Set by the caller of init that installs the driver, others wait for it. */
+    uint32_t         install_count;   /* Install attempts, tells a waiter that its attempt has ended. */
+    esp_err_t        install_err;     /* Result of the last install attempt that failed. */
+    i2c_bus_config_t config;
+    TaskHandle_t     p_task;
+    QueueHandle_t    p_queue[I2C_BUS_PRIO_COUNT];
+    i2c_bus_stats_t  stats[I2C_BUS_PRIO_COUNT];
+    uint8_t          cmd_link_buf[I2C_BUS_CMD_LINK_SIZE];
+} _bus_t;
+
+/**
+ * @brief Completion context of a blocking transfer, lives on the caller's stack.
+ *
+ */
+typedef struct
+{
+    StaticSemaphore_t sem_buf;
+    SemaphoreHandle_t p_sem;
+    esp_err_t         result;
+} _transfer_done_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Bus owner task.
+ *
+ * @param [in] p_parameter I2C port owned by the task.
+ */
+static void _i2c_bus_task(void *p_parameter);
+
+/**
+ * @brief Executes all operations of a transaction as one command link.
+ */
+static esp_err_t _execute(_bus_t *p_bus, i2c_port_t port, const i2c_bus_transaction_t *p_trans);
+
+/**
+ * @brief Completion callback used by the blocking transfer.
+ */
+static void _transfer_done_cb(esp_err_t result, void *p_arg);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "I2C_BUS";
+
+static _bus_t       _bus[I2C_NUM_MAX];
+static portMUX_TYPE _stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static portMUX_TYPE _init_lock  = portMUX_INITIALIZER_UNLOCKED;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t i2c_bus_init(i2c_port_t port, const i2c_bus_config_t *p_config)
+{
+    if((I2C_NUM_MAX <= port) || (NULL == p_config))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    _bus_t *p_bus = &_bus[port];
+
+    taskENTER_CRITICAL(&_init_lock);
+    bool     b_is_waiting = p_bus->b_is_initialized || p_bus->b_is_installing;
+    uint32_t attempt      = p_bus->install_count;
+    if(!b_is_waiting)
+    {
+        p_bus->b_is_installing = true;
+        p_bus->install_count++;
+    }
+    taskEXIT_CRITICAL(&_init_lock);
+
+    if(b_is_waiting)
+    {
+        /* Another bus user is installing the driver right now, wait for it to finish. */
+        bool b_is_done = false;
+
+        while(!b_is_done)
+        {
+            taskENTER_CRITICAL(&_init_lock);
+            b_is_done = p_bus->b_is_initialized || (attempt != p_bus->install_count) || !p_bus->b_is_installing;
+            taskEXIT_CRITICAL(&_init_lock);
+
+            if(!b_is_done)
+            {
+                vTaskDelay(1U);
+            }
+        }
+
+        if(!p_bus->b_is_initialized)
+        {
+            /* The install failed, every caller that waited for it gets its error. */
+            return p_bus->install_err;
+        }
+
+        bool b_is_same = (p_bus->config.sda_io == p_config->sda_io) && (p_bus->config.scl_io == p_config->scl_io);
+
+        if(b_is_same && (p_bus->config.clk_speed_hz != p_config->clk_speed_hz))
+        {
+            /* The bus runs at the speed of the first user, slower devices must say so first. */
+            ESP_LOGW(TAG, "Port %d already runs at %lu Hz", port, (unsigned long)p_bus->config.clk_speed_hz);
+        }
+
+        return b_is_same ? ESP_OK : ESP_ERR_INVALID_STATE;
+    }
+
+    i2c_config_t conf = {
+        .mode             = I2C_MODE_MASTER,
+        .sda_io_num       = p_config->sda_io,
+        .sda_pullup_en    = GPIO_PULLUP_ENABLE,
+        .scl_io_num       = p_config->scl_io,
+        .scl_pullup_en    = GPIO_PULLUP_ENABLE,
+        .master.clk_speed = p_config->clk_speed_hz,
+    };
+
+    bool      b_is_installed = false;
+    esp_err_t esp_err        = i2c_param_config(port, &conf);
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err        = i2c_driver_install(port, conf.mode, 0U, 0U, 0);
+        b_is_installed = (ESP_OK == esp_err);
+    }
+
+    for(uint8_t prio = 0U; (ESP_OK == esp_err) && (prio < I2C_BUS_PRIO_COUNT); prio++)
+    {
+        p_bus->p_queue[prio] = xQueueCreate(I2C_BUS_QUEUE_SIZE, sizeof(_queued_trans_t));
+        if(NULL == p_bus->p_queue[prio])
+        {
+            esp_err = ESP_ERR_NO_MEM;
+        }
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        p_bus->config = *p_config;
+
+        if(pdPASS != xTaskCreate(&_i2c_bus_task, "i2c_bus_task", I2C_BUS_TASK_STACK_SIZE, (void *)port, I2C_BUS_TASK_PRIORITY, &p_bus->p_task))
+        {
+            esp_err = ESP_ERR_NO_MEM;
+        }
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        ESP_LOGI(TAG, "Port %d: SDA %d, SCL %d, %lu Hz", port, p_config->sda_io, p_config->scl_io,
+                 (unsigned long)p_config->clk_speed_hz);
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Init of port %d failed: %s", port, esp_err_to_name(esp_err));
+
+        /* Undone, so a later init can try again. */
+        for(uint8_t prio = 0U; prio < I2C_BUS_PRIO_COUNT; prio++)
+        {
+            if(NULL != p_bus->p_queue[prio])
+            {
+                vQueueDelete(p_bus->p_queue[prio]);
+                p_bus->p_queue[prio] = NULL;
+            }
+        }
+
+        if(b_is_installed)
+        {
+            (void)i2c_driver_delete(port);
+        }
+    }
+
+    taskENTER_CRITICAL(&_init_lock);
+    p_bus->b_is_initialized = (ESP_OK == esp_err);
+    p_bus->install_err      = esp_err;
+    p_bus->b_is_installing  = false;
+    taskEXIT_CRITICAL(&_init_lock);
+
+    return esp_err;
+}
+
+esp_err_t i2c_bus_submit(i2c_port_t port, const i2c_bus_transaction_t *p_trans)
+{
+    if((I2C_NUM_MAX <= port) || (NULL == p_trans) || (0U == p_trans->op_count) || (I2C_BUS_OPS_MAX < p_trans->op_count) ||
+       (I2C_BUS_PRIO_COUNT <= p_trans->prio))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    _bus_t *p_bus = &_bus[port];
+
+    if(!p_bus->b_is_initialized)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    _queued_trans_t item = { .trans = *p_trans, .submit_us = esp_timer_get_time() };
+
+    if(pdTRUE != xQueueSend(p_bus->p_queue[p_trans->prio], &item, 0U))
+    {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    /* One notification per queued item, the owner task takes them one by one. */
+    xTaskNotifyGive(p_bus->p_task);
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_bus_transfer(i2c_port_t port, const i2c_bus_op_t *p_ops, uint8_t op_count, i2c_bus_prio_t prio)
+{
+    if((NULL == p_ops) || (0U == op_count) || (I2C_BUS_OPS_MAX < op_count))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    _transfer_done_t done;
+
+    done.p_sem  = xSemaphoreCreateBinaryStatic(&done.sem_buf);
+    done.result = ESP_FAIL;
+
+    i2c_bus_transaction_t trans = { .op_count = op_count, .prio = prio, .p_done_cb = _transfer_done_cb, .p_arg = &done };
+    memcpy(trans.ops, p_ops, op_count * sizeof(i2c_bus_op_t));
+
+    esp_err_t esp_err = i2c_bus_submit(port, &trans);
+
+    if(ESP_OK == esp_err)
+    {
+        /* The owner task always completes a queued transaction, the I2C timeout bounds the wait. */
+        (void)xSemaphoreTake(done.p_sem, portMAX_DELAY);
+        esp_err = done.result;
+    }
+
+    vSemaphoreDelete(done.p_sem);
+
+    return esp_err;
+}
+
+void i2c_bus_get_stats(i2c_port_t port, i2c_bus_prio_t prio, i2c_bus_stats_t *p_stats)
+{
+    if((I2C_NUM_MAX > port) && (I2C_BUS_PRIO_COUNT > prio) && (NULL != p_stats))
+    {
+        taskENTER_CRITICAL(&_stats_lock);
+        *p_stats = _bus[port].stats[prio];
+        taskEXIT_CRITICAL(&_stats_lock);
+    }
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _i2c_bus_task(void *p_parameter)
+{
+    i2c_port_t      port  = (i2c_port_t)p_parameter;
+    _bus_t         *p_bus = &_bus[port];
+    _queued_trans_t item;
+
+    for(;;)
+    {
+        (void)ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+
+        /* Always serve the most urgent queue first. */
+        for(uint8_t prio = 0U; prio < I2C_BUS_PRIO_COUNT; prio++)
+        {
+            if(pdTRUE == xQueueReceive(p_bus->p_queue[prio], &item, 0U))
+            {
+                int64_t   start_us = esp_timer_get_time();
+                esp_err_t esp_err  = _execute(p_bus, port, &item.trans);
+                int64_t   end_us   = esp_timer_get_time();
+
+                uint32_t wait_us = (uint32_t)(start_us - item.submit_us);
+                uint32_t bus_us  = (uint32_t)(end_us - start_us);
+
+                taskENTER_CRITICAL(&_stats_lock);
+                i2c_bus_stats_t *p_stats = &p_bus->stats[prio];
+                p_stats->count++;
+                p_stats->errors += (ESP_OK != esp_err) ? 1U : 0U;
+                p_stats->wait_us_total += wait_us;
+                p_stats->bus_us_total += bus_us;
+                p_stats->wait_us_max = (wait_us > p_stats->wait_us_max) ? wait_us : p_stats->wait_us_max;
+                p_stats->bus_us_max  = (bus_us > p_stats->bus_us_max) ? bus_us : p_stats->bus_us_max;
+                taskEXIT_CRITICAL(&_stats_lock);
+
+                if(NULL != item.trans.p_done_cb)
+                {
+                    item.trans.p_done_cb(esp_err, item.trans.p_arg);
+                }
+
+                break;
+            }
+        }
+    }
+}
+
+static esp_err_t _execute(_bus_t *p_bus, i2c_port_t port, const i2c_bus_transaction_t *p_trans)
+{
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create_static(p_bus->cmd_link_buf, sizeof(p_bus->cmd_link_buf));
+
+    for(uint8_t i = 0U; i < p_trans->op_count; i++)
+    {
+        const i2c_bus_op_t *p_op = &p_trans->ops[i];
+
+        if(0U != p_op->write_len)
+        {
+            (void)i2c_master_start(cmd);
+            (void)i2c_master_write_byte(cmd, (uint8_t)((p_op->address << 1) | I2C_MASTER_WRITE), true);
+            (void)i2c_master_write(cmd, p_op->p_write, p_op->write_len, true);
+        }
+
+        if(0U != p_op->read_len)
+        {
+            (void)i2c_master_start(cmd);
+            (void)i2c_master_write_byte(cmd, (uint8_t)((p_op->address << 1) | I2C_MASTER_READ), true);
+            (void)i2c_master_read(cmd, p_op->p_read, p_op->read_len, I2C_MASTER_LAST_NACK);
+        }
+    }
+
+    (void)i2c_master_stop(cmd);
+    esp_err_t esp_err = i2c_master_cmd_begin(port, cmd, pdMS_TO_TICKS(I2C_BUS_TIMEOUT_MS));
+    i2c_cmd_link_delete_static(cmd);
+
+    return esp_err;
+}
+
+static void _transfer_done_cb(esp_err_t result, void *p_arg)
+{
+    _transfer_done_t *p_done = p_arg;
+
+    p_done->result = result;
+    xSemaphoreGive(p_done->p_sem);
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,150 @@
+/**
+ * @file i2c_bus.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __I2C_BUS_C__
+#define __I2C_BUS_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include "driver/i2c.h"
+#include "freertos/FreeRTOS.h"
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+/* Maximum number of device operations batched into one transaction. */
+#define I2C_BUS_OPS_MAX (4U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Enums hold transaction priorities. Lower value is served first.
+ *
+ */
+typedef enum
+{
+    I2C_BUS_PRIO_HIGH,   /* Latency critical, e.g. touch. */
+    I2C_BUS_PRIO_NORMAL, /* Periodic sensor reads. */
+    I2C_BUS_PRIO_LOW,    /* Configuration and bulk transfers. */
+
+    I2C_BUS_PRIO_COUNT
+} i2c_bus_prio_t;
+
+/**
+ * @brief Bus configuration.
+ *
+ */
+typedef struct
+{
+    int8_t   sda_io;
+    int8_t   scl_io;
+    uint32_t clk_speed_hz;
+} i2c_bus_config_t;
+
+/**
+ * @brief One device operation: an optional write followed by an optional read after a repeated start.
+ *
+ */
+typedef struct
+{
+    uint8_t        address;
+    const uint8_t *p_write;
+    size_t         write_len;
+    uint8_t       *p_read;
+    size_t         read_len;
+} i2c_bus_op_t;
+
+/**
+ * @brief Completion callback. It runs in the bus owner task and must not block.
+ *
+ * @param [in] result Result of the transaction.
+ * @param [in] p_arg  User argument from the transaction.
+ */
+typedef void (*i2c_bus_done_cb_t)(esp_err_t result, void *p_arg);
+
+/**
+ * @brief A batch of device operations executed back to back without releasing the bus.
+ *
+ */
+typedef struct
+{
+    i2c_bus_op_t      ops[I2C_BUS_OPS_MAX];
+    uint8_t           op_count;
+    i2c_bus_prio_t    prio;
+    i2c_bus_done_cb_t p_done_cb; /* Optional. */
+    void             *p_arg;
+} i2c_bus_transaction_t;
+
+/**
+ * @brief Per priority latency counters, all times in microseconds.
+ *
+ */
+typedef struct
+{
+    uint32_t count;
+    uint32_t errors;
+    uint32_t wait_us_max;  /* Time spent in the queue. */
+    uint64_t wait_us_total;
+    uint32_t bus_us_max;   /* Time spent on the wire. */
+    uint64_t bus_us_total;
+} i2c_bus_stats_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function installs the I2C driver on the port and starts its owner task. Calling it again for an already
+ * initialized port with the same pins is not an error, so every bus user may call it. Callers that find the driver
+ * being installed wait for it and get the install's error if it fails, a later call then tries again.
+ *
+ * @param [in] port     I2C port.
+ * @param [in] p_config Bus configuration.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t i2c_bus_init(i2c_port_t port, const i2c_bus_config_t *p_config);
+
+/**
+ * @brief The function queues a transaction and returns immediately. Buffers referenced by the operations must stay
+ * valid until the completion callback runs.
+ *
+ * @param [in] port    I2C port.
+ * @param [in] p_trans Transaction, copied into the queue.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_TIMEOUT if the queue is full, fail otherwise.
+ */
+esp_err_t i2c_bus_submit(i2c_port_t port, const i2c_bus_transaction_t *p_trans);
+
+/**
+ * @brief The function executes operations and waits for them to finish.
+ *
+ * @param [in] port     I2C port.
+ * @param [in] p_ops    Operations.
+ * @param [in] op_count Number of operations, up to I2C_BUS_OPS_MAX.
+ * @param [in] prio     Transaction priority.
+ *
+ * @return esp_err_t Result of the transaction.
+ */
+esp_err_t i2c_bus_transfer(i2c_port_t port, const i2c_bus_op_t *p_ops, uint8_t op_count, i2c_bus_prio_t prio);
+
+/**
+ * @brief The function copies latency counters of one priority level.
+ *
+ * @param [in]  port    I2C port.
+ * @param [in]  prio    Priority level.
+ * @param [out] p_stats Destination for the counters.
+ */
+void i2c_bus_get_stats(i2c_port_t port, i2c_bus_prio_t prio, i2c_bus_stats_t *p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __I2C_BUS_C__
@@ -0,0 +1,417 @@
+/**
+ * @file json_writer.c
+ *
+ * @brief This file builds small JSON documents, such as the vibration features and the GUI counters, straight into a
+ * caller provided buffer. The output stays NUL terminated and an overflow is only reported once the document is done,
+ * so the callers do not have to check every append. Floats are printed without printf, which may allocate for them,
+ * as the shortest text that reads back as the very same float.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "json_writer.h"
+#include <float.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+/* Significant digits that are always enough for a float to survive a text round trip. */
+#define JSON_FLOAT_DIGITS_MAX (9)
+
+/* Fewest significant digits tried before falling back to more. */
+#define JSON_FLOAT_DIGITS_MIN (6)
+
+/* Values inside [1e-5, 1e9) are printed without an exponent. */
+#define JSON_FIXED_EXP_MIN (-5)
+#define JSON_FIXED_EXP_MAX (8)
+
+/* 32 bit words of the exact integers _float_reads_back() compares. The largest is a float's rounding bound times 5^53,
+ * for nine digits of the smallest subnormal, about 150 bits. */
+#define BIG_WORDS (8)
+
+/* Largest power of five that fits a word. */
+#define BIG_POW5_STEP     (13U)
+#define BIG_POW5_STEP_VAL (1220703125U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Cursor over a float text buffer of JSON_WRITER_FLOAT_SIZE, kept NUL terminated.
+ *
+ */
+typedef struct
+{
+    char  *p_buf;
+    size_t len;
+} _text_t;
+
+/**
+ * @brief Unsigned integer of BIG_WORDS words, least significant first.
+ *
+ */
+typedef struct
+{
+    uint32_t w[BIG_WORDS];
+} _big_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+static void _append(json_writer_t *p_writer, const char *p_text, size_t len);
+static void _text_char(_text_t *p_text, char c);
+static void _text_str(_text_t *p_text, const char *p_str);
+static void _text_uint(_text_t *p_text, uint64_t value, uint8_t min_digits);
+static bool _float_reads_back(float value, uint64_t scaled, int32_t pow10);
+static void _big_set(_big_t *p_big, uint64_t value);
+static void _big_mul(_big_t *p_big, uint32_t factor);
+static void _big_mul_pow5(_big_t *p_big, uint32_t exponent);
+static void _big_shl(_big_t *p_big, uint32_t bits);
+static int  _big_cmp(const _big_t *p_a, const _big_t *p_b);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const double _pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14 };
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+void json_writer_init(json_writer_t *p_writer, char *p_buf, size_t buf_size)
+{
+    p_writer->p_buf = p_buf;
+    p_writer->size  = buf_size;
+    p_writer->len   = 0U;
+
+    if(0U != buf_size)
+    {
+        p_buf[0] = '\0';
+    }
+}
+
+void json_writer_printf(json_writer_t *p_writer, const char *p_format, ...)
+{
+    if(p_writer->len >= p_writer->size)
+    {
+        return;
+    }
+
+    va_list args;
+    va_start(args, p_format);
+    int written = vsnprintf(&p_writer->p_buf[p_writer->len], p_writer->size - p_writer->len, p_format, args);
+    va_end(args);
+
+    /* vsnprintf reports the untruncated length, so an overflow pushes len past size. */
+    p_writer->len = (0 <= written) ? (p_writer->len + (size_t)written) : p_writer->size;
+}
+
+void json_writer_float(json_writer_t *p_writer, float value)
+{
+    char text[JSON_WRITER_FLOAT_SIZE];
+
+    _append(p_writer, text, json_writer_float_format(value, text));
+}
+
+size_t json_writer_float_format(float value, char *p_buf)
+{
+    _text_t text = { .p_buf = p_buf, .len = 0U };
+
+    if(!isfinite(value))
+    {
+        /* JSON has no representation for NaN or infinity. */
+        _text_str(&text, "null");
+        return text.len;
+    }
+
+    if(signbit(value))
+    {
+        _text_char(&text, '-');
+        value = -value;
+    }
+
+    if(0.0f == value)
+    {
+        _text_char(&text, '0');
+        return text.len;
+    }
+
+    /* Split the value into mantissa in [1, 10) and a decimal exponent. */
+    double  mantissa = value;
+    int32_t exponent = 0;
+
+    while(10.0 <= mantissa)
+    {
+        mantissa /= 10.0;
+        exponent++;
+    }
+    while(1.0 > mantissa)
+    {
+        mantissa *= 10.0;
+        exponent--;
+    }
+
+    bool     b_fixed  = (JSON_FIXED_EXP_MIN <= exponent) && (JSON_FIXED_EXP_MAX >= exponent);
+    uint8_t  decimals = 0U;
+    uint64_t scaled   = 0U;
+
+    /* Take the shortest representation that still reads back as the very same float. */
+    for(int32_t digits = JSON_FLOAT_DIGITS_MIN; digits <= JSON_FLOAT_DIGITS_MAX; digits++)
+    {
+        int32_t pow10 = 0;
+
+        if(b_fixed)
+        {
+            decimals = (uint8_t)(((digits - 1) > exponent) ? (digits - 1 - exponent) : 0);
+            scaled   = (uint64_t)((double)value * _pow10[decimals] + 0.5);
+            pow10    = -(int32_t)decimals;
+        }
+        else
+        {
+            decimals = (uint8_t)(digits - 1);
+            scaled   = (uint64_t)(mantissa * _pow10[decimals] + 0.5);
+            pow10    = exponent - (int32_t)decimals;
+        }
+
+        if(_float_reads_back(value, scaled, pow10))
+        {
+            break;
+        }
+
+        if(JSON_FLOAT_DIGITS_MAX == digits)
+        {
+            /* The mantissa carries the rounding of the divisions above, so the last digit can be one off. Nine
+             * correctly rounded digits always read back. */
+            scaled = _float_reads_back(value, scaled + 1U, pow10) ? (scaled + 1U) : (scaled - 1U);
+        }
+    }
+
+    if(!b_fixed && ((uint64_t)_pow10[decimals + 1U] <= scaled))
+    {
+        /* Rounding carried into a new digit, e.g. 9.99999999 -> 10.0000000. */
+        scaled /= 10U;
+        exponent++;
+    }
+
+    uint64_t divisor     = (uint64_t)_pow10[decimals];
+    uint64_t integer     = scaled / divisor;
+    uint64_t fraction    = scaled % divisor;
+    uint8_t  frac_digits = decimals;
+
+    while((0U != frac_digits) && (0U == (fraction % 10U)))
+    {
+        fraction /= 10U;
+        frac_digits--;
+    }
+
+    _text_uint(&text, integer, 1U);
+
+    if(0U != frac_digits)
+    {
+        _text_char(&text, '.');
+        _text_uint(&text, fraction, frac_digits);
+    }
+
+    if(!b_fixed)
+    {
+        _text_char(&text, 'e');
+        if(0 > exponent)
+        {
+            _text_char(&text, '-');
+            exponent = -exponent;
+        }
+        _text_uint(&text, (uint64_t)exponent, 1U);
+    }
+
+    return text.len;
+}
+
+esp_err_t json_writer_finish(const json_writer_t *p_writer, size_t *p_len)
+{
+    if(p_writer->len >= p_writer->size)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    *p_len = p_writer->len;
+
+    return ESP_OK;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _append(json_writer_t *p_writer, const char *p_text, size_t len)
+{
+    if(p_writer->len >= p_writer->size)
+    {
+        return;
+    }
+
+    if((p_writer->size - p_writer->len) <= len)
+    {
+        /* No room for the text and the terminator, the same overflow vsnprintf reports. */
+        p_writer->len += len;
+        return;
+    }
+
+    (void)memcpy(&p_writer->p_buf[p_writer->len], p_text, len);
+    p_writer->len += len;
+    p_writer->p_buf[p_writer->len] = '\0';
+}
+
+static void _text_char(_text_t *p_text, char c)
+{
+    p_text->p_buf[p_text->len++] = c;
+    p_text->p_buf[p_text->len]   = '\0';
+}
+
+static void _text_str(_text_t *p_text, const char *p_str)
+{
+    while('\0' != *p_str)
+    {
+        _text_char(p_text, *p_str++);
+    }
+}
+
+static void _text_uint(_text_t *p_text, uint64_t value, uint8_t min_digits)
+{
+    char    digits[20];
+    uint8_t count = 0U;
+
+    do
+    {
+        digits[count++] = (char)('0' + (value % 10U));
+        value /= 10U;
+    } while((0U != value) && (count < sizeof(digits)));
+
+    while(count < min_digits)
+    {
+        digits[count++] = '0';
+    }
+
+    while(0U != count)
+    {
+        _text_char(p_text, digits[--count]);
+    }
+}
+
+static bool _float_reads_back(float value, uint64_t scaled, int32_t pow10)
+{
+    /* value is m * 2^e2, with the spacing of the subnormals below the normal range. */
+    int32_t  e2 = 0;
+    uint32_t m  = (uint32_t)ldexpf(frexpf(value, &e2), FLT_MANT_DIG);
+
+    e2 -= FLT_MANT_DIG;
+    if((FLT_MIN_EXP - FLT_MANT_DIG) > e2)
+    {
+        m >>= (FLT_MIN_EXP - FLT_MANT_DIG) - e2;
+        e2 = FLT_MIN_EXP - FLT_MANT_DIG;
+    }
+
+    /* Halfway to the neighbours, in units of 2^(e2 - 2). Below a power of two the lower neighbour is twice as close. */
+    bool     b_is_pow2 = ((1UL << (FLT_MANT_DIG - 1)) == m) && ((FLT_MIN_EXP - FLT_MANT_DIG) < e2);
+    uint64_t low       = (4U * (uint64_t)m) - (b_is_pow2 ? 1U : 2U);
+    uint64_t high      = (4U * (uint64_t)m) + 2U;
+
+    /* The candidate is scaled * 10^pow10 = scaled * 5^pow10 * 2^pow10, compared as integers. */
+    _big_t candidate;
+    _big_t big_low;
+    _big_t big_high;
+
+    _big_set(&candidate, scaled);
+    _big_set(&big_low, low);
+    _big_set(&big_high, high);
+
+    if(0 <= pow10)
+    {
+        _big_mul_pow5(&candidate, (uint32_t)pow10);
+    }
+    else
+    {
+        _big_mul_pow5(&big_low, (uint32_t)-pow10);
+        _big_mul_pow5(&big_high, (uint32_t)-pow10);
+    }
+
+    int32_t shift = pow10 - (e2 - 2);
+
+    if(0 <= shift)
+    {
+        _big_shl(&candidate, (uint32_t)shift);
+    }
+    else
+    {
+        _big_shl(&big_low, (uint32_t)-shift);
+        _big_shl(&big_high, (uint32_t)-shift);
+    }
+
+    int cmp_low  = _big_cmp(&candidate, &big_low);
+    int cmp_high = _big_cmp(&candidate, &big_high);
+
+    /* Halfway reads back as the neighbour with the even mantissa. */
+    return (0U == (m & 1U)) ? ((0 <= cmp_low) && (0 >= cmp_high)) : ((0 < cmp_low) && (0 > cmp_high));
+}
+
+static void _big_set(_big_t *p_big, uint64_t value)
+{
+    (void)memset(p_big, 0, sizeof(*p_big));
+    p_big->w[0] = (uint32_t)value;
+    p_big->w[1] = (uint32_t)(value >> 32);
+}
+
+static void _big_mul(_big_t *p_big, uint32_t factor)
+{
+    uint64_t carry = 0U;
+
+    for(uint8_t i = 0U; i < BIG_WORDS; i++)
+    {
+        carry += (uint64_t)p_big->w[i] * factor;
+        p_big->w[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+}
+
+static void _big_mul_pow5(_big_t *p_big, uint32_t exponent)
+{
+    for(; BIG_POW5_STEP <= exponent; exponent -= BIG_POW5_STEP)
+    {
+        _big_mul(p_big, BIG_POW5_STEP_VAL);
+    }
+
+    uint32_t factor = 1U;
+
+    for(; 0U < exponent; exponent--)
+    {
+        factor *= 5U;
+    }
+
+    _big_mul(p_big, factor);
+}
+
+static void _big_shl(_big_t *p_big, uint32_t bits)
+{
+    uint32_t words = bits / 32U;
+    uint32_t rest  = bits % 32U;
+
+    for(int32_t i = BIG_WORDS - 1; 0 <= i; i--)
+    {
+        int32_t  src  = i - (int32_t)words;
+        uint32_t high = (0 <= src) ? p_big->w[src] : 0U;
+        uint32_t low  = ((0 < src) && (0U != rest)) ? (p_big->w[src - 1] >> (32U - rest)) : 0U;
+
+        p_big->w[i] = (0U != rest) ? ((high << rest) | low) : high;
+    }
+}
+
+static int _big_cmp(const _big_t *p_a, const _big_t *p_b)
+{
+    for(int32_t i = BIG_WORDS - 1; 0 <= i; i--)
+    {
+        if(p_a->w[i] != p_b->w[i])
+        {
+            return (p_a->w[i] > p_b->w[i]) ? 1 : -1;
+        }
+    }
+
+    return 0;
+}
+
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
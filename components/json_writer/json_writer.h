@@ -0,0 +1,89 @@
+/**
+ * @file json_writer.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __JSON_WRITER_C__
+#define __JSON_WRITER_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include <stddef.h>
+
+//---------------------------------- MACROS -----------------------------------
+/* Buffer json_writer_float_format() needs. The longest text is 16 characters, e.g. -0.0000123456789. */
+#define JSON_WRITER_FLOAT_SIZE (24U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Output cursor over a caller provided buffer. Once it overflows len stays past size and nothing else is
+ * written.
+ *
+ */
+typedef struct
+{
+    char  *p_buf;
+    size_t size;
+    size_t len;
+} json_writer_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function starts a JSON document in the given buffer.
+ *
+ * @param [out] p_writer Writer to be initialized.
+ * @param [out] p_buf    Destination buffer.
+ * @param [in]  buf_size Size of the destination buffer.
+ */
+void json_writer_init(json_writer_t *p_writer, char *p_buf, size_t buf_size);
+
+/**
+ * @brief The function appends formatted text, the format is the one of printf().
+ *
+ * @param [in,out] p_writer Writer.
+ * @param [in]     p_format Format string.
+ */
+void json_writer_printf(json_writer_t *p_writer, const char *p_format, ...);
+
+/**
+ * @brief The function appends a float as the shortest text that reads back as the very same float. NaN and infinity,
+ * which JSON can not represent, are written as null. It does not use the heap.
+ *
+ * @param [in,out] p_writer Writer.
+ * @param [in]     value    Value to be written.
+ */
+void json_writer_float(json_writer_t *p_writer, float value);
+
+/**
+ * @brief The function prints a float the way json_writer_float() does, into a buffer of its own.
+ *
+ * @param [in]  value Value to be printed.
+ * @param [out] p_buf Destination of JSON_WRITER_FLOAT_SIZE bytes, NUL terminated.
+ *
+ * @return Length of the text without the terminator.
+ */
+size_t json_writer_float_format(float value, char *p_buf);
+
+/**
+ * @brief The function ends the document.
+ *
+ * @param [in]  p_writer Writer.
+ * @param [out] p_len    Number of bytes written without the NUL terminator.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_SIZE if the buffer was too small.
+ */
+esp_err_t json_writer_finish(const json_writer_t *p_writer, size_t *p_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __JSON_WRITER_C__
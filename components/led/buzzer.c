@@ -0,0 +1,103 @@
+/**
+ * @file buzzer.c
+ *
+ * @brief This file drives the passive buzzer with a LEDC square wave.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "buzzer.h"
+#include "driver/ledc.h"
+#include <stdbool.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define BUZZER_GPIO       (2)
+#define BUZZER_MODE       (LEDC_HIGH_SPEED_MODE)
+#define BUZZER_TIMER      (LEDC_TIMER_0)
+#define BUZZER_CHANNEL    (LEDC_CHANNEL_0)
+#define BUZZER_FREQ_HZ    (1000U)
+#define BUZZER_RESOLUTION (LEDC_TIMER_8_BIT)
+
+/* Half of the 8 bit period gives the loudest square wave. */
+#define BUZZER_DUTY_ON (128U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Sets the tone duty.
+ */
+static esp_err_t _buzzer_duty_set(uint32_t duty);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static bool _b_is_initialized = false;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t buzzer_init(void)
+{
+    if(_b_is_initialized)
+    {
+        return ESP_OK;
+    }
+
+    ledc_timer_config_t ledc_timer = {
+        .speed_mode      = BUZZER_MODE,
+        .duty_resolution = BUZZER_RESOLUTION,
+        .timer_num       = BUZZER_TIMER,
+        .freq_hz         = BUZZER_FREQ_HZ,
+        .clk_cfg         = LEDC_AUTO_CLK,
+    };
+    esp_err_t esp_err = ledc_timer_config(&ledc_timer);
+
+    if(ESP_OK == esp_err)
+    {
+        ledc_channel_config_t ledc_channel = {
+            .gpio_num   = BUZZER_GPIO,
+            .speed_mode = BUZZER_MODE,
+            .channel    = BUZZER_CHANNEL,
+            .intr_type  = LEDC_INTR_DISABLE,
+            .timer_sel  = BUZZER_TIMER,
+            .duty       = 0U,
+            .hpoint     = 0,
+        };
+        esp_err = ledc_channel_config(&ledc_channel);
+    }
+
+    _b_is_initialized = (ESP_OK == esp_err);
+
+    return esp_err;
+}
+
+esp_err_t buzzer_on(void)
+{
+    return _buzzer_duty_set(BUZZER_DUTY_ON);
+}
+
+esp_err_t buzzer_off(void)
+{
+    return _buzzer_duty_set(0U);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static esp_err_t _buzzer_duty_set(uint32_t duty)
+{
+    esp_err_t esp_err = _b_is_initialized ? ESP_OK : ESP_ERR_INVALID_STATE;
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = ledc_set_duty(BUZZER_MODE, BUZZER_CHANNEL, duty);
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = ledc_update_duty(BUZZER_MODE, BUZZER_CHANNEL);
+    }
+
+    return esp_err;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
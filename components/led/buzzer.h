@@ -0,0 +1,50 @@
+/**
+ * @file buzzer.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __BUZZER_C__
+#define __BUZZER_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function initializes the buzzer tone generator, silent.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t buzzer_init(void);
+
+/**
+ * @brief The function starts the buzzer tone.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t buzzer_on(void);
+
+/**
+ * @brief The function stops the buzzer tone.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t buzzer_off(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BUZZER_C__
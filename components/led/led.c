@@ -1,7 +1,8 @@
 /**
  * @file led.c
  *
- * @brief This file controls LEDs.
+ * @brief This file controls LEDs. On/off writes go straight to the GPIO set/clear registers, so any combination of
+ * LEDs changes in the same instant; brightness goes through LEDC PWM. A pin is handed between the two on demand.
  *
  * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
  * All rights reserved.
@@ -10,12 +11,24 @@
 //--------------------------------- INCLUDES ----------------------------------
 #include "led.h"
 #include "driver/gpio.h"
+#include "driver/ledc.h"
+#include "esp_rom_gpio.h"
+#include "soc/gpio_sig_map.h"
+#include "soc/gpio_struct.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include <stdio.h>
 #include <stdbool.h>
 
 //---------------------------------- MACROS -----------------------------------
 #define GPIO_BIT_MASK(X) ((1ULL << (X)))
 
+/* LEDs share one low speed timer, the high speed group is left to the buzzer. */
+#define LED_LEDC_MODE       (LEDC_LOW_SPEED_MODE)
+#define LED_LEDC_TIMER      (LEDC_TIMER_1)
+#define LED_LEDC_RESOLUTION (LEDC_TIMER_8_BIT)
+#define LED_LEDC_FREQ_HZ    (5000U)
+
 //-------------------------------- DATA TYPES ---------------------------------
 /**
  * @brief LED config structure.
@@ -23,17 +36,42 @@
  */
 typedef struct
 {
-    led_t  led;
-    int8_t gpio;
-    bool   b_is_active_on_high_level;
+    led_t          led;
+    int8_t         gpio;
+    bool           b_is_active_on_high_level;
+    ledc_channel_t ledc_channel;
 } _led_config_t;
 
 //---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Hands the LED pin over to its LEDC channel on first use.
+ *
+ * @param [in] led LED instance.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+static esp_err_t _led_pwm_attach(led_t led);
+
+/**
+ * @brief Stops the LEDC channel and hands the LED pin back to the GPIO output register.
+ *
+ * @param [in] led LED instance.
+ */
+static void _led_pwm_detach(led_t led);
 
 //------------------------- STATIC DATA & CONSTANTS ---------------------------
 static const _led_config_t _led_info[LED_COUNT] = {
-    { .led = LED_BLUE, .gpio = 14, .b_is_active_on_high_level = true },
+    { .led = LED_BLUE, .gpio = 14, .b_is_active_on_high_level = true, .ledc_channel = LEDC_CHANNEL_1 },
+    { .led = LED_RED, .gpio = 26, .b_is_active_on_high_level = true, .ledc_channel = LEDC_CHANNEL_2 },
+    { .led = LED_GREEN, .gpio = 27, .b_is_active_on_high_level = true, .ledc_channel = LEDC_CHANNEL_3 },
 };
+
+static bool _b_is_ledc_ready = false;
+static bool _b_is_pwm[LED_COUNT];
+
+/* Serializes UI, pattern and application writers, which all share the same pins. */
+static StaticSemaphore_t _led_mutex_buffer;
+static SemaphoreHandle_t p_led_mutex = NULL;
 //------------------------------- GLOBAL DATA ---------------------------------
 
 //------------------------------ PUBLIC FUNCTIONS -----------------------------
@@ -41,6 +79,11 @@ esp_err_t led_init(led_t led)
 {
     esp_err_t esp_err = ESP_OK;
 
+    if(NULL == p_led_mutex)
+    {
+        p_led_mutex = xSemaphoreCreateMutexStatic(&_led_mutex_buffer);
+    }
+
     if(led < LED_COUNT)
     {
         /* Zero-initialize the config structure. */
@@ -68,34 +111,183 @@ esp_err_t led_init(led_t led)
 
 esp_err_t led_on(led_t led)
 {
-    esp_err_t esp_err = ESP_FAIL;
+    return (led < LED_COUNT) ? led_set_masked(LED_MASK(led), LED_MASK(led)) : ESP_FAIL;
+}
 
-    if(led < LED_COUNT)
+esp_err_t led_off(led_t led)
+{
+    return (led < LED_COUNT) ? led_set_masked(LED_MASK(led), 0U) : ESP_FAIL;
+}
+
+esp_err_t led_set_all(uint8_t on_mask)
+{
+    return led_set_masked(LED_MASK_ALL, on_mask);
+}
+
+esp_err_t led_set_masked(uint8_t mask, uint8_t on_mask)
+{
+    if(NULL == p_led_mutex)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint64_t set_bits   = 0U;
+    uint64_t clear_bits = 0U;
+
+    xSemaphoreTake(p_led_mutex, portMAX_DELAY);
+
+    for(uint8_t led = 0U; led < LED_COUNT; led++)
+    {
+        if(0U != (mask & LED_MASK(led)))
+        {
+            if(_b_is_pwm[led])
+            {
+                _led_pwm_detach((led_t)led);
+            }
+
+            /* Figure out if the LED needs 1 or 0 on its pin. */
+            bool b_is_on = (0U != (on_mask & LED_MASK(led)));
+            if(b_is_on == _led_info[led].b_is_active_on_high_level)
+            {
+                set_bits |= GPIO_BIT_MASK(_led_info[led].gpio);
+            }
+            else
+            {
+                clear_bits |= GPIO_BIT_MASK(_led_info[led].gpio);
+            }
+        }
+    }
+
+    /* Write-one-to-set/clear registers leave every other pin alone, so no read-modify-write is needed. */
+    GPIO.out_w1ts = (uint32_t)set_bits;
+    GPIO.out_w1tc = (uint32_t)clear_bits;
+
+    if(0U != ((set_bits | clear_bits) >> 32))
+    {
+        GPIO.out1_w1ts.val = (uint32_t)(set_bits >> 32);
+        GPIO.out1_w1tc.val = (uint32_t)(clear_bits >> 32);
+    }
+
+    xSemaphoreGive(p_led_mutex);
+
+    return ESP_OK;
+}
+
+esp_err_t led_set_level(led_t led, uint8_t level)
+{
+    if(NULL == p_led_mutex)
     {
-        /* Figure out if the LED will turn on after outputting 1 or 0. */
-        uint32_t level = _led_info[led].b_is_active_on_high_level ? 1U : 0U;
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(p_led_mutex, portMAX_DELAY);
+
+    esp_err_t esp_err = (led < LED_COUNT) ? _led_pwm_attach(led) : ESP_FAIL;
 
-        esp_err = gpio_set_level(_led_info[led].gpio, level);
+    if(ESP_OK == esp_err)
+    {
+        /* Waits for a running fade instead of racing with the fade interrupt. */
+        esp_err = ledc_set_duty_and_update(LED_LEDC_MODE, _led_info[led].ledc_channel, level, 0U);
     }
 
+    xSemaphoreGive(p_led_mutex);
+
     return esp_err;
 }
 
-esp_err_t led_off(led_t led)
+esp_err_t led_set_rgb(uint8_t red, uint8_t green, uint8_t blue)
 {
-    esp_err_t esp_err = ESP_FAIL;
+    esp_err_t esp_err = led_set_level(LED_RED, red);
 
-    if(led < LED_COUNT)
+    if(ESP_OK == esp_err)
     {
-        /* Figure out if the LED will turn off after outputting 1 or 0. */
-        uint32_t level = _led_info[led].b_is_active_on_high_level ? 0U : 1U;
+        esp_err = led_set_level(LED_GREEN, green);
+    }
 
-        esp_err = gpio_set_level(_led_info[led].gpio, level);
+    if(ESP_OK == esp_err)
+    {
+        esp_err = led_set_level(LED_BLUE, blue);
     }
 
     return esp_err;
 }
 
+esp_err_t led_fade(led_t led, uint8_t level, uint32_t time_ms)
+{
+    if(NULL == p_led_mutex)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(p_led_mutex, portMAX_DELAY);
+
+    esp_err_t esp_err = (led < LED_COUNT) ? _led_pwm_attach(led) : ESP_FAIL;
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = ledc_set_fade_time_and_start(LED_LEDC_MODE, _led_info[led].ledc_channel, level, time_ms,
+                                               LEDC_FADE_NO_WAIT);
+    }
+
+    xSemaphoreGive(p_led_mutex);
+
+    return esp_err;
+}
+
 //---------------------------- PRIVATE FUNCTIONS ------------------------------
+static esp_err_t _led_pwm_attach(led_t led)
+{
+    esp_err_t esp_err = ESP_OK;
+
+    if(!_b_is_ledc_ready)
+    {
+        ledc_timer_config_t ledc_timer = {
+            .speed_mode      = LED_LEDC_MODE,
+            .duty_resolution = LED_LEDC_RESOLUTION,
+            .timer_num       = LED_LEDC_TIMER,
+            .freq_hz         = LED_LEDC_FREQ_HZ,
+            .clk_cfg         = LEDC_AUTO_CLK,
+        };
+        esp_err = ledc_timer_config(&ledc_timer);
+
+        if(ESP_OK == esp_err)
+        {
+            /* Another LEDC user may have installed the fade service already. */
+            esp_err = ledc_fade_func_install(0);
+            esp_err = (ESP_ERR_INVALID_STATE == esp_err) ? ESP_OK : esp_err;
+        }
+
+        _b_is_ledc_ready = (ESP_OK == esp_err);
+    }
+
+    if((ESP_OK == esp_err) && !_b_is_pwm[led])
+    {
+        ledc_channel_config_t ledc_channel = {
+            .gpio_num   = _led_info[led].gpio,
+            .speed_mode = LED_LEDC_MODE,
+            .channel    = _led_info[led].ledc_channel,
+            .intr_type  = LEDC_INTR_DISABLE,
+            .timer_sel  = LED_LEDC_TIMER,
+            .duty       = 0U,
+            .hpoint     = 0,
+            .flags      = { .output_invert = _led_info[led].b_is_active_on_high_level ? 0U : 1U },
+        };
+        esp_err = ledc_channel_config(&ledc_channel);
+
+        _b_is_pwm[led] = (ESP_OK == esp_err);
+    }
+
+    return esp_err;
+}
+
+static void _led_pwm_detach(led_t led)
+{
+    uint32_t idle_level = _led_info[led].b_is_active_on_high_level ? 0U : 1U;
+
+    (void)ledc_stop(LED_LEDC_MODE, _led_info[led].ledc_channel, idle_level);
+    esp_rom_gpio_connect_out_signal(_led_info[led].gpio, SIG_GPIO_OUT_IDX, false, false);
+
+    _b_is_pwm[led] = false;
+}
 
 //---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -16,8 +16,14 @@ extern "C" {
 
 //--------------------------------- INCLUDES ----------------------------------
 #include "esp_err.h"
+#include <stdint.h>
 
 //---------------------------------- MACROS -----------------------------------
+/* Full brightness for led_set_level() and led_fade(). */
+#define LED_LEVEL_MAX (255U)
+
+#define LED_MASK(X)  ((uint8_t)(1U << (X)))
+#define LED_MASK_ALL ((uint8_t)((1U << LED_COUNT) - 1U))
 
 //-------------------------------- DATA TYPES ---------------------------------
 /**
@@ -27,6 +33,8 @@ extern "C" {
 typedef enum
 {
     LED_BLUE,
+    LED_RED,
+    LED_GREEN,
 
     LED_COUNT
 } led_t;
@@ -59,6 +67,60 @@ esp_err_t led_on(led_t led);
  */
 esp_err_t led_off(led_t led);
 
+/**
+ * @brief The function switches all LEDs at once: LEDs in on_mask are turned on, all others off. It takes one write to
+ * the GPIO set and one to the clear register.
+ *
+ * @param [in] on_mask Mask of LED_MASK() bits.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t led_set_all(uint8_t on_mask);
+
+/**
+ * @brief The function switches the LEDs selected by mask at once and leaves the others untouched.
+ *
+ * @param [in] mask    LEDs to be written, mask of LED_MASK() bits.
+ * @param [in] on_mask LEDs out of mask to be turned on, the rest of mask is turned off.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t led_set_masked(uint8_t mask, uint8_t on_mask);
+
+/**
+ * @brief The function sets LED brightness through LEDC PWM. The pin is handed over to LEDC until the next on/off
+ * write takes it back.
+ *
+ * @param [in] led   LED instance (e.g. LED_BLUE).
+ * @param [in] level Brightness from 0 to LED_LEVEL_MAX.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t led_set_level(led_t led, uint8_t level);
+
+/**
+ * @brief The function starts a LEDC hardware fade to the given brightness and returns immediately. A following level
+ * change waits for the running fade to finish.
+ *
+ * @param [in] led     LED instance (e.g. LED_BLUE).
+ * @param [in] level   Target brightness from 0 to LED_LEVEL_MAX.
+ * @param [in] time_ms Fade duration.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t led_fade(led_t led, uint8_t level, uint32_t time_ms);
+
+/**
+ * @brief The function mixes a color on the RGB LEDs through LEDC PWM.
+ *
+ * @param [in] red   Red brightness from 0 to LED_LEVEL_MAX.
+ * @param [in] green Green brightness from 0 to LED_LEVEL_MAX.
+ * @param [in] blue  Blue brightness from 0 to LED_LEVEL_MAX.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t led_set_rgb(uint8_t red, uint8_t green, uint8_t blue);
+
 #ifdef __cplusplus
 }
 #endif
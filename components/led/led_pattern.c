@@ -0,0 +1,454 @@
+/**
+ * @file led_pattern.c
+ *
+ * @brief This file plays LED and buzzer patterns declared as step tables. Each pattern owns a one-shot esp_timer
+ * that is re-armed for the duration of the current step and drives every channel playing the pattern, so those
+ * channels stay in step. Fading steps are handed to the LEDC hardware, so no task sleeps through a pattern and
+ * nothing wakes up between steps.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "led_pattern.h"
+#include "led.h"
+#include "buzzer.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define STEP_ON(MS)           { .level = LED_LEVEL_MAX, .b_is_fade = false, .duration_ms = (MS) }
+#define STEP_OFF(MS)          { .level = 0U, .b_is_fade = false, .duration_ms = (MS) }
+#define STEP_FADE(LEVEL, MS)  { .level = (LEVEL), .b_is_fade = true, .duration_ms = (MS) }
+#define PATTERN(STEPS)        { .p_steps = (STEPS), .step_count = (uint8_t)(sizeof(STEPS) / sizeof((STEPS)[0])) }
+
+#define SOS_SHORT_MS (100U)
+#define SOS_LONG_MS  (300U)
+#define SOS_PAUSE_MS (1000U)
+
+#define ERROR_BLINK_MS (200U)
+#define ERROR_PAUSE_MS (1500U)
+
+/* No pattern occupies the channel. */
+#define CHANNEL_IDLE (LED_PATTERN_PRIO_COUNT)
+
+/* A timer callback that fires this much before the step it belongs to is due was dispatched for an older step. */
+#define STALE_CALLBACK_US (1000)
+
+/* The timer callback does not wait for play or stop to release the state, it retries this much later instead. */
+#define BUSY_RETRY_US (1000U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief One pattern step: output level held, or faded to, for the given time.
+ *
+ */
+typedef struct
+{
+    uint8_t  level;
+    bool     b_is_fade;
+    uint16_t duration_ms;
+} _led_pattern_step_t;
+
+/**
+ * @brief Pattern step table.
+ *
+ */
+typedef struct
+{
+    const _led_pattern_step_t *p_steps;
+    uint8_t                    step_count;
+} _led_pattern_info_t;
+
+/**
+ * @brief Priority slots of one channel.
+ *
+ */
+typedef struct
+{
+    bool          b_is_slot_used[LED_PATTERN_PRIO_COUNT];
+    led_pattern_t slot_pattern[LED_PATTERN_PRIO_COUNT];
+    uint8_t       playing_prio; /* CHANNEL_IDLE when nothing plays. */
+} _led_pattern_channel_t;
+
+/**
+ * @brief Playback state of one pattern, shared by all channels playing it.
+ *
+ */
+typedef struct
+{
+    esp_timer_handle_t p_timer;
+    uint8_t            channels; /* Mask of LED_PATTERN_CHANNEL_MASK() bits, 0 when no channel plays the pattern. */
+    uint8_t            step;
+    int64_t            step_end_us;
+} _led_pattern_track_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Moves every given channel to its highest priority pattern, or silences it.
+ */
+static void _channels_schedule(uint8_t channels);
+
+/**
+ * @brief Adds channels to the pattern track. An idle track starts from its first step, a running one is joined at
+ * the current step.
+ */
+static void _track_join(led_pattern_t pattern, uint8_t channels);
+
+/**
+ * @brief Applies the current step of the pattern to all its channels and arms its timer for the step duration.
+ */
+static void _step_apply(led_pattern_t pattern);
+
+/**
+ * @brief Drives the outputs of the given channels. Blinking LEDs are switched together with one masked write.
+ */
+static void _outputs_set(uint8_t channels, uint8_t level, bool b_is_fade, uint32_t time_ms);
+
+/**
+ * @brief Step timer callback, runs in the esp_timer task.
+ *
+ * @param [in] p_arg Pattern, cast to a pointer.
+ */
+static void _step_timer_cb(void *p_arg);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const _led_pattern_step_t _sos_steps[] = {
+    STEP_ON(SOS_SHORT_MS), STEP_OFF(SOS_SHORT_MS), STEP_ON(SOS_SHORT_MS), STEP_OFF(SOS_SHORT_MS),
+    STEP_ON(SOS_SHORT_MS), STEP_OFF(SOS_SHORT_MS), STEP_ON(SOS_LONG_MS),  STEP_OFF(SOS_LONG_MS),
+    STEP_ON(SOS_LONG_MS),  STEP_OFF(SOS_LONG_MS),  STEP_ON(SOS_LONG_MS),  STEP_OFF(SOS_LONG_MS),
+    STEP_ON(SOS_SHORT_MS), STEP_OFF(SOS_SHORT_MS), STEP_ON(SOS_SHORT_MS), STEP_OFF(SOS_SHORT_MS),
+    STEP_ON(SOS_SHORT_MS), STEP_OFF(SOS_SHORT_MS + SOS_PAUSE_MS),
+};
+
+static const _led_pattern_step_t _heartbeat_steps[] = {
+    STEP_ON(80U),
+    STEP_OFF(120U),
+    STEP_ON(80U),
+    STEP_OFF(720U),
+};
+
+static const _led_pattern_step_t _breathing_steps[] = {
+    STEP_FADE(LED_LEVEL_MAX, 1000U),
+    STEP_FADE(0U, 1000U),
+    STEP_OFF(500U),
+};
+
+static const _led_pattern_step_t _error_2_steps[] = {
+    STEP_ON(ERROR_BLINK_MS), STEP_OFF(ERROR_BLINK_MS), STEP_ON(ERROR_BLINK_MS), STEP_OFF(ERROR_PAUSE_MS),
+};
+
+static const _led_pattern_step_t _error_3_steps[] = {
+    STEP_ON(ERROR_BLINK_MS), STEP_OFF(ERROR_BLINK_MS), STEP_ON(ERROR_BLINK_MS),
+    STEP_OFF(ERROR_BLINK_MS), STEP_ON(ERROR_BLINK_MS), STEP_OFF(ERROR_PAUSE_MS),
+};
+
+static const _led_pattern_step_t _error_4_steps[] = {
+    STEP_ON(ERROR_BLINK_MS), STEP_OFF(ERROR_BLINK_MS), STEP_ON(ERROR_BLINK_MS), STEP_OFF(ERROR_BLINK_MS),
+    STEP_ON(ERROR_BLINK_MS), STEP_OFF(ERROR_BLINK_MS), STEP_ON(ERROR_BLINK_MS), STEP_OFF(ERROR_PAUSE_MS),
+};
+
+static const _led_pattern_info_t _pattern_info[LED_PATTERN_COUNT] = {
+    [LED_PATTERN_SOS]       = PATTERN(_sos_steps),
+    [LED_PATTERN_HEARTBEAT] = PATTERN(_heartbeat_steps),
+    [LED_PATTERN_BREATHING] = PATTERN(_breathing_steps),
+    [LED_PATTERN_ERROR_2]   = PATTERN(_error_2_steps),
+    [LED_PATTERN_ERROR_3]   = PATTERN(_error_3_steps),
+    [LED_PATTERN_ERROR_4]   = PATTERN(_error_4_steps),
+};
+
+static const led_t _channel_led[LED_PATTERN_CHANNEL_BUZZER] = {
+    [LED_PATTERN_CHANNEL_BLUE]  = LED_BLUE,
+    [LED_PATTERN_CHANNEL_RED]   = LED_RED,
+    [LED_PATTERN_CHANNEL_GREEN] = LED_GREEN,
+};
+
+static _led_pattern_channel_t _channels[LED_PATTERN_CHANNEL_COUNT];
+static _led_pattern_track_t   _tracks[LED_PATTERN_COUNT];
+static SemaphoreHandle_t      p_pattern_mutex = NULL;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t led_pattern_init(void)
+{
+    if(NULL != p_pattern_mutex)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    /* A mutex rather than a spinlock, LEDC fade calls may block. */
+    p_pattern_mutex = xSemaphoreCreateMutex();
+    if(NULL == p_pattern_mutex)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t esp_err = buzzer_init();
+
+    for(uint8_t led = 0U; (ESP_OK == esp_err) && (led < LED_COUNT); led++)
+    {
+        esp_err = led_init((led_t)led);
+    }
+
+    for(uint8_t channel = 0U; channel < LED_PATTERN_CHANNEL_COUNT; channel++)
+    {
+        _channels[channel].playing_prio = CHANNEL_IDLE;
+    }
+
+    for(uint8_t pattern = 0U; (ESP_OK == esp_err) && (pattern < LED_PATTERN_COUNT); pattern++)
+    {
+        const esp_timer_create_args_t timer_args = {
+            .callback = &_step_timer_cb,
+            .arg      = (void *)(uintptr_t)pattern,
+            .name     = "led_pattern",
+        };
+
+        esp_err = esp_timer_create(&timer_args, &_tracks[pattern].p_timer);
+    }
+
+    return esp_err;
+}
+
+esp_err_t led_pattern_play(led_pattern_t pattern, uint8_t channels, led_pattern_prio_t prio)
+{
+    if((LED_PATTERN_COUNT <= pattern) || (LED_PATTERN_PRIO_COUNT <= prio))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(NULL == p_pattern_mutex)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint8_t rescheduled = 0U;
+
+    xSemaphoreTake(p_pattern_mutex, portMAX_DELAY);
+
+    for(uint8_t channel = 0U; channel < LED_PATTERN_CHANNEL_COUNT; channel++)
+    {
+        if(0U != (channels & LED_PATTERN_CHANNEL_MASK(channel)))
+        {
+            _channels[channel].b_is_slot_used[prio] = true;
+            _channels[channel].slot_pattern[prio]   = pattern;
+
+            /* Higher priority patterns keep playing, this one waits in its slot. */
+            if((CHANNEL_IDLE == _channels[channel].playing_prio) || (prio >= _channels[channel].playing_prio))
+            {
+                rescheduled |= LED_PATTERN_CHANNEL_MASK(channel);
+            }
+        }
+    }
+
+    _channels_schedule(rescheduled);
+
+    xSemaphoreGive(p_pattern_mutex);
+
+    return ESP_OK;
+}
+
+esp_err_t led_pattern_stop(uint8_t channels, led_pattern_prio_t prio)
+{
+    if(LED_PATTERN_PRIO_COUNT <= prio)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(NULL == p_pattern_mutex)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint8_t rescheduled = 0U;
+
+    xSemaphoreTake(p_pattern_mutex, portMAX_DELAY);
+
+    for(uint8_t channel = 0U; channel < LED_PATTERN_CHANNEL_COUNT; channel++)
+    {
+        if((0U != (channels & LED_PATTERN_CHANNEL_MASK(channel))) && _channels[channel].b_is_slot_used[prio])
+        {
+            _channels[channel].b_is_slot_used[prio] = false;
+
+            if(prio == _channels[channel].playing_prio)
+            {
+                rescheduled |= LED_PATTERN_CHANNEL_MASK(channel);
+            }
+        }
+    }
+
+    _channels_schedule(rescheduled);
+
+    xSemaphoreGive(p_pattern_mutex);
+
+    return ESP_OK;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _channels_schedule(uint8_t channels)
+{
+    uint8_t silenced                   = 0U;
+    uint8_t joining[LED_PATTERN_COUNT] = { 0U };
+
+    for(uint8_t channel = 0U; channel < LED_PATTERN_CHANNEL_COUNT; channel++)
+    {
+        _led_pattern_channel_t *p_channel = &_channels[channel];
+
+        if(0U == (channels & LED_PATTERN_CHANNEL_MASK(channel)))
+        {
+            continue;
+        }
+
+        if(CHANNEL_IDLE != p_channel->playing_prio)
+        {
+            _led_pattern_track_t *p_track = &_tracks[p_channel->slot_pattern[p_channel->playing_prio]];
+
+            p_track->channels &= (uint8_t)~LED_PATTERN_CHANNEL_MASK(channel);
+            if(0U == p_track->channels)
+            {
+                (void)esp_timer_stop(p_track->p_timer);
+            }
+        }
+
+        p_channel->playing_prio = CHANNEL_IDLE;
+        for(int8_t prio = (int8_t)LED_PATTERN_PRIO_COUNT - 1; prio >= 0; prio--)
+        {
+            if(p_channel->b_is_slot_used[prio])
+            {
+                p_channel->playing_prio = (uint8_t)prio;
+                break;
+            }
+        }
+
+        if(CHANNEL_IDLE == p_channel->playing_prio)
+        {
+            silenced |= LED_PATTERN_CHANNEL_MASK(channel);
+        }
+        else
+        {
+            joining[p_channel->slot_pattern[p_channel->playing_prio]] |= LED_PATTERN_CHANNEL_MASK(channel);
+        }
+    }
+
+    if(0U != silenced)
+    {
+        _outputs_set(silenced, 0U, false, 0U);
+    }
+
+    for(uint8_t pattern = 0U; pattern < LED_PATTERN_COUNT; pattern++)
+    {
+        if(0U != joining[pattern])
+        {
+            _track_join((led_pattern_t)pattern, joining[pattern]);
+        }
+    }
+}
+
+static void _track_join(led_pattern_t pattern, uint8_t channels)
+{
+    _led_pattern_track_t *p_track = &_tracks[pattern];
+
+    if(0U == p_track->channels)
+    {
+        p_track->channels = channels;
+        p_track->step     = 0U;
+        _step_apply(pattern);
+    }
+    else
+    {
+        /* Late channels pick up the running step for what is left of it. */
+        const _led_pattern_step_t *p_step    = &_pattern_info[pattern].p_steps[p_track->step];
+        int64_t                    remain_us = p_track->step_end_us - esp_timer_get_time();
+
+        p_track->channels |= channels;
+        _outputs_set(channels, p_step->level, p_step->b_is_fade, (0 < remain_us) ? (uint32_t)(remain_us / 1000) : 0U);
+    }
+}
+
+static void _step_apply(led_pattern_t pattern)
+{
+    _led_pattern_track_t      *p_track = &_tracks[pattern];
+    const _led_pattern_step_t *p_step  = &_pattern_info[pattern].p_steps[p_track->step];
+
+    _outputs_set(p_track->channels, p_step->level, p_step->b_is_fade, p_step->duration_ms);
+
+    p_track->step_end_us = esp_timer_get_time() + ((int64_t)p_step->duration_ms * 1000);
+    (void)esp_timer_start_once(p_track->p_timer, (uint64_t)p_step->duration_ms * 1000U);
+}
+
+static void _outputs_set(uint8_t channels, uint8_t level, bool b_is_fade, uint32_t time_ms)
+{
+    uint8_t blink_mask = 0U;
+
+    for(uint8_t channel = 0U; channel < LED_PATTERN_CHANNEL_COUNT; channel++)
+    {
+        if(0U == (channels & LED_PATTERN_CHANNEL_MASK(channel)))
+        {
+            continue;
+        }
+
+        if(LED_PATTERN_CHANNEL_BUZZER == channel)
+        {
+            /* The buzzer only knows on and off, fades snap to their target. */
+            (void)((0U != level) ? buzzer_on() : buzzer_off());
+        }
+        else if(b_is_fade)
+        {
+            (void)led_fade(_channel_led[channel], level, time_ms);
+        }
+        else if((0U == level) || (LED_LEVEL_MAX == level))
+        {
+            blink_mask |= LED_MASK(_channel_led[channel]);
+        }
+        else
+        {
+            (void)led_set_level(_channel_led[channel], level);
+        }
+    }
+
+    if(0U != blink_mask)
+    {
+        /* Plain blinks skip LEDC entirely, all of them cost one register write. */
+        (void)led_set_masked(blink_mask, (0U != level) ? blink_mask : 0U);
+    }
+}
+
+static void _step_timer_cb(void *p_arg)
+{
+    led_pattern_t         pattern = (led_pattern_t)(uintptr_t)p_arg;
+    _led_pattern_track_t *p_track = &_tracks[pattern];
+
+    /* Play and stop may hold the mutex through a blocking LEDC call, the esp_timer task must not wait for them. */
+    if(pdTRUE != xSemaphoreTake(p_pattern_mutex, 0U))
+    {
+        (void)esp_timer_start_once(p_track->p_timer, BUSY_RETRY_US);
+        return;
+    }
+
+    int64_t now_us = esp_timer_get_time();
+
+    if(0U == p_track->channels)
+    {
+        /* Stop silenced the pattern since this callback was dispatched. */
+    }
+    else if(now_us < (p_track->step_end_us - STALE_CALLBACK_US))
+    {
+        /* Dispatched for an older step, or a busy retry got the timer before play restarted the pattern. Whichever
+         * it was, the current step still has to end on time. */
+        (void)esp_timer_start_once(p_track->p_timer, (uint64_t)(p_track->step_end_us - now_us));
+    }
+    else
+    {
+        /* Patterns repeat until their slot is stopped. */
+        p_track->step = (uint8_t)((p_track->step + 1U) % _pattern_info[pattern].step_count);
+        _step_apply(pattern);
+    }
+
+    xSemaphoreGive(p_pattern_mutex);
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,110 @@
+/**
+ * @file led_pattern.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __LED_PATTERN_C__
+#define __LED_PATTERN_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define LED_PATTERN_CHANNEL_MASK(X) ((uint8_t)(1U << (X)))
+
+#define LED_PATTERN_CHANNELS_RGB                                                                                     \
+    (LED_PATTERN_CHANNEL_MASK(LED_PATTERN_CHANNEL_BLUE) | LED_PATTERN_CHANNEL_MASK(LED_PATTERN_CHANNEL_RED) |        \
+     LED_PATTERN_CHANNEL_MASK(LED_PATTERN_CHANNEL_GREEN))
+
+#define LED_PATTERN_CHANNELS_ALL (LED_PATTERN_CHANNELS_RGB | LED_PATTERN_CHANNEL_MASK(LED_PATTERN_CHANNEL_BUZZER))
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Enums hold available patterns.
+ *
+ */
+typedef enum
+{
+    LED_PATTERN_SOS,       /* ... --- ..., then a pause. */
+    LED_PATTERN_HEARTBEAT, /* Double blink once per second. */
+    LED_PATTERN_BREATHING, /* Slow hardware fade in and out. */
+    LED_PATTERN_ERROR_2,   /* Error codes: N blinks, then a pause. */
+    LED_PATTERN_ERROR_3,
+    LED_PATTERN_ERROR_4,
+
+    LED_PATTERN_COUNT
+} led_pattern_t;
+
+/**
+ * @brief Enums hold outputs a pattern can play on. Every channel has its own priority slots, channels playing the
+ * same pattern play it in step.
+ *
+ */
+typedef enum
+{
+    LED_PATTERN_CHANNEL_BLUE,
+    LED_PATTERN_CHANNEL_RED,
+    LED_PATTERN_CHANNEL_GREEN,
+    LED_PATTERN_CHANNEL_BUZZER,
+
+    LED_PATTERN_CHANNEL_COUNT
+} led_pattern_channel_t;
+
+/**
+ * @brief Enums hold pattern priorities. A channel plays its highest priority pattern and falls back to the next one
+ * when that is stopped.
+ *
+ */
+typedef enum
+{
+    LED_PATTERN_PRIO_LOW,    /* Ambient status, e.g. connected heartbeat. */
+    LED_PATTERN_PRIO_NORMAL, /* Error codes. */
+    LED_PATTERN_PRIO_HIGH,   /* Alarms. */
+
+    LED_PATTERN_PRIO_COUNT
+} led_pattern_prio_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function initializes all LEDs, the buzzer and one playback timer per pattern.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t led_pattern_init(void);
+
+/**
+ * @brief The function starts a repeating pattern on the given channels at the given priority. Channels busy with a
+ * higher priority pattern pick it up once that one stops.
+ *
+ * @param [in] pattern  Pattern to play.
+ * @param [in] channels Mask of LED_PATTERN_CHANNEL_MASK() bits.
+ * @param [in] prio     Priority slot the pattern occupies.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t led_pattern_play(led_pattern_t pattern, uint8_t channels, led_pattern_prio_t prio);
+
+/**
+ * @brief The function clears one priority slot on the given channels, right away and mid-pattern if needed.
+ *
+ * @param [in] channels Mask of LED_PATTERN_CHANNEL_MASK() bits.
+ * @param [in] prio     Priority slot to clear.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t led_pattern_stop(uint8_t channels, led_pattern_prio_t prio);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LED_PATTERN_C__
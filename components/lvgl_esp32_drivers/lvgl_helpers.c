@@ -17,6 +17,7 @@
 #include "lvgl_i2c_conf.h"
 
 #include "driver/i2c.h"
+#include "i2c_bus.h"
 
 #ifdef LV_LVGL_H_INCLUDE_SIMPLE
 #include "src/core/lv_refr.h"
@@ -174,24 +175,14 @@ bool lvgl_i2c_driver_init(int port, int sda_pin, int scl_pin, int speed_hz)
     ESP_LOGI(TAG, "SDA pin: %d, SCL pin: %d, Speed: %d (Hz)",
         sda_pin, scl_pin, speed_hz);
     
-    i2c_config_t conf = {
-        .mode               = I2C_MODE_MASTER,
-        .sda_io_num         = sda_pin,
-        .sda_pullup_en      = GPIO_PULLUP_ENABLE,
-        .scl_io_num         = scl_pin,
-        .scl_pullup_en      = GPIO_PULLUP_ENABLE,
-        .master.clk_speed   = speed_hz,
+    /* The port is owned by the shared bus service, sensors on the same pins join it. */
+    i2c_bus_config_t conf = {
+        .sda_io         = sda_pin,
+        .scl_io         = scl_pin,
+        .clk_speed_hz   = speed_hz,
     };
 
-    ESP_LOGI(TAG, "Setting I2C master configuration...");
-    err = i2c_param_config(port, &conf);
-    assert(ESP_OK == err);
-
-    ESP_LOGI(TAG, "Installing I2C master driver...");
-    err = i2c_driver_install(port,
-        I2C_MODE_MASTER,
-        0, 0 /*I2C_MASTER_RX_BUF_DISABLE, I2C_MASTER_TX_BUF_DISABLE */,
-        0 /* intr_alloc_flags */);
+    err = i2c_bus_init(port, &conf);
     assert(ESP_OK == err);
 
     return ESP_OK != err;
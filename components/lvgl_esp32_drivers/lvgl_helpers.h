@@ -95,6 +95,14 @@ extern "C" {
 #endif
 #endif
 
+/* With full frames in PSRAM, see LV_DISP_FULL_FRAME_PSRAM, LVGL draws into two
+ * frame sized buffers and the flushes go out through two internal RAM bounce
+ * buffers of DISP_BOUNCE_BUF_SIZE pixels each. */
+#if defined (CONFIG_LV_DISP_FULL_FRAME_PSRAM)
+#define DISP_FRAME_BUF_SIZE  (LV_HOR_RES_MAX * LV_VER_RES_MAX)
+#define DISP_BOUNCE_BUF_SIZE (LV_HOR_RES_MAX * CONFIG_LV_DISP_BOUNCE_BUF_LINES)
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
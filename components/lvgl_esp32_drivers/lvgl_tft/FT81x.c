@@ -4,6 +4,7 @@
 #include "driver/gpio.h"
 
 #include "FT81x.h"
+#include "disp_driver.h"
 
 #include "EVE.h"
 #include "EVE_commands.h"
@@ -320,4 +321,10 @@ void TFT_WriteBitmap(uint8_t* Bitmap, uint16_t X, uint16_t Y, uint16_t Width, ui
 void FT81x_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_map)
 {
 	TFT_WriteBitmap((uint8_t*)color_map, area->x1, area->y1, lv_area_get_width(area), lv_area_get_height(area));
-}
\ No newline at end of file
+}
+
+DISP_DRIVER_REGISTER(ft81x) = {
+    .name = "FT81x",
+    .init = FT81x_init,
+    .flush = FT81x_flush,
+};
@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include "GC9A01.h"
+#include "disp_driver.h"
 #include "disp_spi.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
@@ -33,6 +34,7 @@ typedef struct {
  *  STATIC PROTOTYPES
  **********************/
 static void GC9A01_set_orientation(uint8_t orientation);
+static void GC9A01_set_madctl(uint8_t madctl);
 
 static void GC9A01_send_cmd(uint8_t cmd);
 static void GC9A01_send_data(void * data, uint16_t length);
@@ -267,6 +269,31 @@ static void GC9A01_set_orientation(uint8_t orientation)
 
     ESP_LOGI(TAG, "0x36 command value: 0x%02X", data[orientation]);
 
+    GC9A01_set_madctl(data[orientation]);
+}
+
+static void GC9A01_set_madctl(uint8_t madctl)
+{
     GC9A01_send_cmd(0x36);
-    GC9A01_send_data((void *) &data[orientation], 1);
+    GC9A01_send_data(&madctl, 1);
+
+    disp_driver_madctl_written(madctl);
 }
+
+static void gc9a01_sleep(bool sleep)
+{
+    if (sleep) {
+        GC9A01_sleep_in();
+    } else {
+        GC9A01_sleep_out();
+    }
+}
+
+DISP_DRIVER_REGISTER(gc9a01) = {
+    .name = "GC9A01",
+    .init = GC9A01_init,
+    .flush = GC9A01_flush,
+    .sleep = gc9a01_sleep,
+    .set_orientation = GC9A01_set_orientation,
+    .set_madctl = GC9A01_set_madctl,
+};
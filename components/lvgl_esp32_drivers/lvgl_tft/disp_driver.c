@@ -4,108 +4,401 @@
 
 #include "disp_driver.h"
 #include "disp_spi.h"
+#if defined CONFIG_LV_DISP_USE_TE
+#include "disp_te.h"
+#endif
+
+#include <string.h>
+
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "nvs.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "../lvgl_spi_conf.h"
+
+#define TAG "disp_driver"
+
+/******************************************************************************
+ * Notes about the controller registry
+ *
+ * Every controller driver that is linked in registers a disp_driver_t with
+ * DISP_DRIVER_REGISTER(). linker.lf keeps the descriptors together, so the
+ * drivers are known without a list to maintain here, and an image can carry
+ * more than one of them, see LV_TFT_DISPLAY_RUNTIME_*. disp_driver_init()
+ * picks one in this order:
+ *
+ * - the name stored in NVS under DISP_DRIVER_NVS_NAMESPACE/DISP_DRIVER_NVS_KEY,
+ * - the first controller whose probe reads its ID from the panel,
+ * - the controller chosen in menuconfig.
+ *
+ * The probes need the controller's SDO on the bus MISO. Without it every
+ * probe fails and the menuconfig choice is taken, which is logged as a
+ * warning since it may not be the panel on the board.
+ *
+ * There is one display. The bus, the address window, the rotation and the
+ * tearing effect state live in static variables of disp_spi.c, disp_te.c and
+ * this file, so a second display would need all of them per display.
+ *
+ *****************************************************************************/
+
+/******************************************************************************
+ * Notes about the hardware rotation
+ *
+ * LVGL rotates a display in software by copying every strip into a rotated
+ * buffer before the flush. Controllers with a MIPI DCS MADCTL can scan their
+ * frame memory in any of the eight row/column orders instead, so
+ * disp_driver_set_rotation() derives the MADCTL of the rotation from the one
+ * the driver wrote for the orientation chosen in menuconfig, swaps the
+ * resolution and lets LVGL lay the screens out for it once. LVGL keeps
+ * drawing unrotated, at no cost per frame.
+ *
+ * The touch panel is calibrated for the orientation chosen in menuconfig,
+ * touch_driver_read() maps its points with disp_driver_rotate_point().
+ *
+ * A quarter turn exchanges rows and columns (MV) and mirrors what becomes the
+ * rows, MY without the exchange and MX with it. This follows LVGL, which maps
+ * (x, y) to (ver_res - 1 - y, x) for LV_DISP_ROT_90.
+ *
+ * There is one rotation, for the display of the controller disp_driver_init()
+ * picked.
+ *
+ *****************************************************************************/
+
+/*********************
+ *      DEFINES
+ *********************/
+/* Register reads are specified for much slower clocks than memory writes */
+#define DISP_DRIVER_PROBE_SPEED_HZ  (4 * 1000 * 1000)
+
+#define DISP_DRIVER_NAME_LEN        16
+
+/* Software reset, MIPI DCS */
+#define DISP_DRIVER_CMD_SWRESET     0x01
+
+/* MADCTL bits of the scan order, MIPI DCS */
+#define DISP_DRIVER_MADCTL_MY       0x80    /* Row address order */
+#define DISP_DRIVER_MADCTL_MX       0x40    /* Column address order */
+#define DISP_DRIVER_MADCTL_MV       0x20    /* Row and column exchange */
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static const disp_driver_t * driver_from_nvs(void);
+static const disp_driver_t * driver_from_probe(void);
+static uint8_t madctl_rotate(uint8_t madctl, lv_disp_rot_t rotation);
 
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+extern const disp_driver_t _disp_driver_desc_start;
+extern const disp_driver_t _disp_driver_desc_end;
+
+static const disp_driver_t * active;
+
+static bool madctl_valid;       /* the driver wrote MADCTL */
+static uint8_t madctl_last;
+static uint8_t madctl_base;     /* for the orientation chosen in menuconfig */
+static lv_disp_rot_t rotation;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
 void disp_driver_init(void)
 {
-#if defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ILI9341
-    ili9341_init();
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ILI9481
-    ili9481_init();
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ILI9488
-    ili9488_init();
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ST7789
-    st7789_init();
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ST7796S
-    st7796s_init();
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ST7735S
-    st7735s_init();
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_HX8357
-    hx8357_init();
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ILI9486 
-    ili9486_init();
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_SH1107
-    sh1107_init();
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_SSD1306
-    ssd1306_init();
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_FT81X
-    FT81x_init();
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_IL3820
-    il3820_init();
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_RA8875
-    ra8875_init();
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_GC9A01
-   GC9A01_init();
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_JD79653A
-   jd79653a_init();
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_UC8151D
-   uc8151d_init();
+    const disp_driver_t * first = &_disp_driver_desc_start;
+    const disp_driver_t * last = &_disp_driver_desc_end;
+
+    assert(first < last);
+
+    /* Nothing to choose from with a single controller linked in */
+    active = (last - first == 1) ? first : driver_from_nvs();
+
+    if (active == NULL) {
+        active = driver_from_probe();
+    }
+
+    if (active == NULL) {
+        active = disp_driver_find(CONFIG_LV_TFT_DISPLAY_CONTROLLER_NAME);
+
+        if (last - first > 1) {
+            ESP_LOGW(TAG, "No controller in NVS %s/%s and none answered its probe, assuming %s from menuconfig",
+                DISP_DRIVER_NVS_NAMESPACE, DISP_DRIVER_NVS_KEY,
+                (active != NULL) ? active->name : first->name);
+        }
+    }
+
+    if (active == NULL) {
+        active = first;
+    }
+
+    ESP_LOGI(TAG, "Display controller: %s", active->name);
+    active->init();
+
+    madctl_base = madctl_last;
+
+#if defined CONFIG_LV_DISP_USE_TE
+    disp_te_init();
+#endif
+}
+
+const disp_driver_t * disp_driver_find(const char * name)
+{
+    for (const disp_driver_t * drv = &_disp_driver_desc_start; drv < &_disp_driver_desc_end; drv++) {
+        if (strcmp(drv->name, name) == 0) {
+            return drv;
+        }
+    }
+
+    return NULL;
+}
+
+const disp_driver_t * disp_driver_get(lv_disp_drv_t * drv)
+{
+    return ((drv != NULL) && (drv->user_data != NULL)) ? (const disp_driver_t *) drv->user_data : active;
+}
+
+void disp_driver_sleep(lv_disp_drv_t * drv, bool sleep)
+{
+    const disp_driver_t * ctrl = disp_driver_get(drv);
+
+    if (ctrl->sleep) {
+        ctrl->sleep(sleep);
+    }
+}
+
+bool disp_driver_set_rotation(lv_disp_t * disp, lv_disp_rot_t rot)
+{
+    if (disp == NULL) {
+        disp = lv_disp_get_default();
+    }
+
+    lv_disp_drv_t * drv = disp->driver;
+    const disp_driver_t * ctrl = disp_driver_get(drv);
+
+    if ((ctrl != active) || (ctrl->set_madctl == NULL) || !madctl_valid) {
+        ESP_LOGW(TAG, "%s can't rotate in hardware", ctrl->name);
+        return false;
+    }
+
+    if (rot == rotation) {
+        return true;
+    }
+
+    /* Waits for the strips in flight, they were drawn for the old rotation */
+    ctrl->set_madctl(madctl_rotate(madctl_base, rot));
+
+    if ((rot ^ rotation) & 1) {
+        lv_coord_t hor_res = drv->hor_res;
+        drv->hor_res = drv->ver_res;
+        drv->ver_res = hor_res;
+    }
+
+    rotation = rot;
+
+    ESP_LOGI(TAG, "Rotated by %d degrees, MADCTL 0x%02X", rot * 90, madctl_last);
+
+    /* Resizes the screens and invalidates them, they are laid out once on the next refresh */
+    drv->sw_rotate = 0;
+    drv->rotated = LV_DISP_ROT_NONE;
+    lv_disp_drv_update(disp, drv);
+
+    return true;
+}
+
+lv_disp_rot_t disp_driver_get_rotation(void)
+{
+    return rotation;
+}
+
+void disp_driver_rotate_point(lv_disp_drv_t * drv, lv_point_t * point)
+{
+    if ((drv == NULL) || (rotation == LV_DISP_ROT_NONE)) {
+        return;
+    }
+
+    /* Resolution in the orientation chosen in menuconfig */
+    lv_coord_t hor_res = (rotation & 1) ? drv->ver_res : drv->hor_res;
+    lv_coord_t ver_res = (rotation & 1) ? drv->hor_res : drv->ver_res;
+    lv_coord_t x = point->x;
+    lv_coord_t y = point->y;
+
+    switch (rotation) {
+    case LV_DISP_ROT_90:
+        point->x = ver_res - 1 - y;
+        point->y = x;
+        break;
+    case LV_DISP_ROT_180:
+        point->x = hor_res - 1 - x;
+        point->y = ver_res - 1 - y;
+        break;
+    case LV_DISP_ROT_270:
+        point->x = y;
+        point->y = hor_res - 1 - x;
+        break;
+    default:
+        break;
+    }
+}
+
+void disp_driver_madctl_written(uint8_t madctl)
+{
+    madctl_valid = true;
+    madctl_last = madctl;
+
+#if defined CONFIG_LV_DISP_USE_TE
+    disp_te_set_madctl(madctl);
 #endif
 }
 
 void disp_driver_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_map)
 {
-#if defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ILI9341
-    ili9341_flush(drv, area, color_map);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ILI9481
-    ili9481_flush(drv, area, color_map);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ILI9488
-    ili9488_flush(drv, area, color_map);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ST7789
-    st7789_flush(drv, area, color_map);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ST7796S
-    st7796s_flush(drv, area, color_map);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ST7735S
-    st7735s_flush(drv, area, color_map);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_HX8357
-	hx8357_flush(drv, area, color_map);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ILI9486
-    ili9486_flush(drv, area, color_map);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_SH1107
-	sh1107_flush(drv, area, color_map);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_SSD1306
-    ssd1306_flush(drv, area, color_map);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_FT81X
-    FT81x_flush(drv, area, color_map);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_IL3820
-    il3820_flush(drv, area, color_map);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_RA8875
-    ra8875_flush(drv, area, color_map);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_GC9A01
-    GC9A01_flush(drv, area, color_map);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_JD79653A
-    jd79653a_lv_fb_flush(drv, area, color_map);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_UC8151D
-    uc8151d_lv_fb_flush(drv, area, color_map);
+#if defined CONFIG_LV_DISP_USE_TE
+    /* Behind the panel's scan line */
+    disp_te_wait_area(drv, area);
 #endif
+
+    disp_driver_get(drv)->flush(drv, area, color_map);
 }
 
-void disp_driver_rounder(lv_disp_drv_t * disp_drv, lv_area_t * area)
+void disp_driver_wait(lv_disp_drv_t * drv)
+{
+#if defined CONFIG_LV_TFT_DISPLAY_PROTOCOL_SPI
+    disp_spi_wait_for_flush();
+#endif
+}
+
+#if defined CONFIG_LV_DISP_FULL_FRAME_PSRAM
+void disp_driver_flush_direct(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_map)
 {
-#if defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_SSD1306
-    ssd1306_rounder(disp_drv, area);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_SH1107
-    sh1107_rounder(disp_drv, area);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_IL3820
-    il3820_rounder(disp_drv, area);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_JD79653A
-    jd79653a_lv_rounder_cb(disp_drv, area);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_UC8151D
-    uc8151d_lv_rounder_cb(disp_drv, area);
+    /* Every area of the frame is drawn before any is sent */
+    if (!lv_disp_flush_is_last(drv)) {
+        lv_disp_flush_ready(drv);
+        return;
+    }
+
+    lv_disp_t * disp = _lv_refr_get_disp_refreshing();
+    lv_coord_t hor_res = lv_disp_get_hor_res(disp);
+    int32_t last = -1;
+
+    for (int32_t i = 0; i < disp->inv_p; i++) {
+        if (!disp->inv_area_joined[i]) {
+            last = i;
+        }
+    }
+
+    /* LVGL is told once the last area is sent */
+    for (int32_t i = 0; i <= last; i++) {
+        if (disp->inv_area_joined[i]) {
+            continue;
+        }
+
+        const lv_area_t * inv = &disp->inv_areas[i];
+
+#if defined CONFIG_LV_DISP_USE_TE
+        disp_te_wait_area(drv, inv);
 #endif
+
+        disp_spi_send_window_rows(inv->x1, inv->y1, inv->x2, inv->y2,
+            (const uint8_t *) &color_map[(inv->y1 * hor_res) + inv->x1],
+            hor_res * sizeof(lv_color_t), i == last);
+    }
+}
+#endif
+
+void disp_driver_rounder(lv_disp_drv_t * disp_drv, lv_area_t * area)
+{
+    const disp_driver_t * ctrl = disp_driver_get(disp_drv);
+
+    if (ctrl->rounder) {
+        ctrl->rounder(disp_drv, area);
+    }
 }
 
 void disp_driver_set_px(lv_disp_drv_t * disp_drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
     lv_color_t color, lv_opa_t opa) 
 {
-#if defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_SSD1306
-    ssd1306_set_px_cb(disp_drv, buf, buf_w, x, y, color, opa);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_SH1107
-    sh1107_set_px_cb(disp_drv, buf, buf_w, x, y, color, opa);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_IL3820
-    il3820_set_px_cb(disp_drv, buf, buf_w, x, y, color, opa);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_JD79653A
-    jd79653a_lv_set_fb_cb(disp_drv, buf, buf_w, x, y, color, opa);
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_UC8151D
-    uc8151d_lv_set_fb_cb(disp_drv, buf, buf_w, x, y, color, opa);
+    const disp_driver_t * ctrl = disp_driver_get(disp_drv);
+
+    if (ctrl->set_px) {
+        ctrl->set_px(disp_drv, buf, buf_w, x, y, color, opa);
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+static const disp_driver_t * driver_from_nvs(void)
+{
+    nvs_handle_t nvs;
+    char name[DISP_DRIVER_NAME_LEN];
+    size_t length = sizeof(name);
+
+    /* Not provisioned, or NVS isn't initialized yet */
+    if (nvs_open(DISP_DRIVER_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return NULL;
+    }
+
+    esp_err_t ret = nvs_get_str(nvs, DISP_DRIVER_NVS_KEY, name, &length);
+    nvs_close(nvs);
+
+    if (ret != ESP_OK) {
+        return NULL;
+    }
+
+    const disp_driver_t * drv = disp_driver_find(name);
+
+    if (drv == NULL) {
+        ESP_LOGW(TAG, "Controller %s from NVS is not linked in", name);
+    }
+
+    return drv;
+}
+
+static const disp_driver_t * driver_from_probe(void)
+{
+#if defined (CONFIG_LV_DISP_PIN_DC)
+    const disp_driver_t * found = NULL;
+
+    uint8_t swreset = DISP_DRIVER_CMD_SWRESET;
+
+    gpio_reset_pin(CONFIG_LV_DISP_PIN_DC);
+    gpio_set_direction(CONFIG_LV_DISP_PIN_DC, GPIO_MODE_OUTPUT);
+
+    /* Not every board wires the reset pin, the controllers answer register reads right after a software reset */
+    gpio_set_level(CONFIG_LV_DISP_PIN_DC, 0);
+    disp_spi_send_data(&swreset, 1);
+    vTaskDelay(120 / portTICK_PERIOD_MS);
+
+    disp_spi_change_device_speed(DISP_DRIVER_PROBE_SPEED_HZ);
+
+    for (const disp_driver_t * drv = &_disp_driver_desc_start; drv < &_disp_driver_desc_end; drv++) {
+        if (drv->probe && drv->probe()) {
+            found = drv;
+            break;
+        }
+    }
+
+    disp_spi_change_device_speed(0);
+
+    return found;
+#else
+    /* Register reads need the D/C line */
+    return NULL;
 #endif
 }
+
+static uint8_t madctl_rotate(uint8_t madctl, lv_disp_rot_t rot)
+{
+    for (int i = 0; i < rot; i++) {
+        if (madctl & DISP_DRIVER_MADCTL_MV) {
+            madctl ^= DISP_DRIVER_MADCTL_MV | DISP_DRIVER_MADCTL_MX;
+        } else {
+            madctl ^= DISP_DRIVER_MADCTL_MV | DISP_DRIVER_MADCTL_MY;
+        }
+    }
+
+    return madctl;
+}
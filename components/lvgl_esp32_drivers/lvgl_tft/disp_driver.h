@@ -18,58 +18,73 @@ extern "C" {
 #include "lvgl/lvgl.h"
 #endif
 
-#if defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ILI9341
-#include "ili9341.h"
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ILI9481
-#include "ili9481.h"
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ILI9488
-#include "ili9488.h"
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ST7789
-#include "st7789.h"
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ST7796S
-#include "st7796s.h"
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ST7735S
-#include "st7735s.h"
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_HX8357
-#include "hx8357.h"
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_ILI9486
-#include "ili9486.h"
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_SH1107
-#include "sh1107.h"
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_SSD1306
-#include "ssd1306.h"
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_FT81X
-#include "FT81x.h"
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_IL3820
-#include "il3820.h"
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_RA8875
-#include "ra8875.h"
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_GC9A01
-#include "GC9A01.h"
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_JD79653A
-#include "jd79653a.h"
-#elif defined CONFIG_LV_TFT_DISPLAY_CONTROLLER_UC8151D
-#include "uc8151d.h"
-#endif
+#include <stdbool.h>
+#include <stdint.h>
 
 /*********************
  *      DEFINES
  *********************/
+/* NVS namespace and key of the controller name disp_driver_init() picks, e.g. "ST7789" */
+#define DISP_DRIVER_NVS_NAMESPACE   "lvgl_disp"
+#define DISP_DRIVER_NVS_KEY         "ctrl"
 
 /**********************
  *      TYPEDEFS
  **********************/
+/* Display controller driver. Members a controller doesn't have are NULL, except init and flush. */
+typedef struct {
+    const char * name;
+    /* Reads the controller's ID register, true if it is this controller */
+    bool (*probe)(void);
+    void (*init)(void);
+    void (*flush)(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_map);
+    void (*rounder)(lv_disp_drv_t * drv, lv_area_t * area);
+    void (*set_px)(lv_disp_drv_t * drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+        lv_color_t color, lv_opa_t opa);
+    void (*sleep)(bool sleep);
+    void (*set_orientation)(uint8_t orientation);
+    /* Writes MIPI DCS MADCTL (36h), the hardware rotation, see disp_driver_set_rotation() */
+    void (*set_madctl)(uint8_t madctl);
+} disp_driver_t;
 
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
 
-/* Initialize display */
+/* Picks the controller, from NVS, by probing or the one chosen in menuconfig, and initializes it */
 void disp_driver_init(void);
 
+/* Registered controller of that name, NULL if it is not linked in */
+const disp_driver_t * disp_driver_find(const char * name);
+
+/* Controller of a display, its drv->user_data if set, else the one disp_driver_init() picked */
+const disp_driver_t * disp_driver_get(lv_disp_drv_t * drv);
+
+/* Puts the display's controller to sleep or wakes it, if it can */
+void disp_driver_sleep(lv_disp_drv_t * drv, bool sleep);
+
+/* Rotates the display from the orientation chosen in menuconfig, as lv_disp_set_rotation() does, but by
+ * rewriting the controller's MADCTL instead of rotating every strip in software. false if it can't */
+bool disp_driver_set_rotation(lv_disp_t * disp, lv_disp_rot_t rot);
+
+/* Rotation set with disp_driver_set_rotation() */
+lv_disp_rot_t disp_driver_get_rotation(void);
+
+/* Maps a point from the orientation chosen in menuconfig, e.g. a touch, to the display's rotation */
+void disp_driver_rotate_point(lv_disp_drv_t * drv, lv_point_t * point);
+
+/* Called by the controller drivers with every MADCTL value they write */
+void disp_driver_madctl_written(uint8_t madctl);
+
 /* Display flush callback */
 void disp_driver_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_map);
 
+/* Direct mode flush callback for full frame buffers, sends the invalidated areas of the frame */
+void disp_driver_flush_direct(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_map);
+
+/* Display wait callback, sleeps while LVGL waits for a flush to finish */
+void disp_driver_wait(lv_disp_drv_t * drv);
+
 /* Display rounder callback, used with monochrome dispays */
 void disp_driver_rounder(lv_disp_drv_t * disp_drv, lv_area_t * area);
 
@@ -80,6 +95,15 @@ void disp_driver_set_px(lv_disp_drv_t * disp_drv, uint8_t * buf, lv_coord_t buf_
 /**********************
  *      MACROS
  **********************/
+/* Registers a controller at link time, in the driver's source:
+ *
+ *   DISP_DRIVER_REGISTER(ili9341) = { .name = "ILI9341", .init = ili9341_init, ... };
+ *
+ * The drivers are collected by linker.lf, between _disp_driver_desc_start and _end.
+ */
+#define DISP_DRIVER_REGISTER(id) \
+    static const disp_driver_t id##_disp_driver \
+        __attribute__((used, aligned(4), section(".disp_driver_desc")))
 
 #ifdef __cplusplus
 } /* extern "C" */
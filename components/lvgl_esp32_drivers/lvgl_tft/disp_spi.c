@@ -32,37 +32,41 @@
 #include "../lvgl_spi_conf.h"
 
 /******************************************************************************
- * Notes about DMA spi_transaction_ext_t structure pooling
- * 
- * An xQueue is used to hold a pool of reusable SPI spi_transaction_ext_t 
- * structures that get used for all DMA SPI transactions. While an xQueue may 
- * seem like overkill it is an already built-in RTOS feature that comes at 
- * little cost. xQueues are also ISR safe if it ever becomes necessary to 
- * access the pool in the ISR callback.
- * 
- * When a DMA request is sent, a transaction structure is removed from the 
- * pool, filled out, and passed off to the esp32 SPI driver. Later, when 
- * servicing pending SPI transaction results, the transaction structure is 
- * recycled back into the pool for later reuse. This matches the DMA SPI 
- * transaction life cycle requirements of the esp32 SPI driver.
- * 
- * When polling or synchronously sending SPI requests, and as required by the 
- * esp32 SPI driver, all pending DMA transactions are first serviced. Then the 
- * polling SPI request takes place. 
- * 
- * When sending an asynchronous DMA SPI request, if the pool is empty, some 
- * small percentage of pending transactions are first serviced before sending 
- * any new DMA SPI transactions. Not too many and not too few as this balance 
- * controls DMA transaction latency.
- * 
- * It is therefore not the design that all pending transactions must be 
- * serviced and placed back into the pool with DMA SPI requests - that 
- * will happen eventually. The pool just needs to contain enough to float some 
- * number of in-flight SPI requests to speed up the overall DMA SPI data rate 
- * and reduce transaction latency. If however a display driver uses some 
- * polling SPI requests or calls disp_wait_for_pending_transactions() directly,
- * the pool will reach the full state more often and speed up DMA queuing.
- * 
+ * Notes about the DMA transaction ring
+ *
+ * Queued transactions are built in place in a ring of spi_transaction_ext_t
+ * structures, SPI_TRANSACTION_POOL_SIZE deep, which is also the depth of the
+ * esp32 SPI driver's queue. The driver completes the transactions of a device
+ * in the order they were queued, so the ring needs no free list, only two
+ * counters: how many transactions were queued and how many of their results
+ * were taken back with spi_device_get_trans_result(). A slot is free again
+ * once its result has been taken.
+ *
+ * spi_ready() counts completions in the SPI ISR. A task that has to wait for
+ * a completion, be it a free slot, the end of a flush or an idle device,
+ * sleeps on a task notification which spi_ready() gives once the count the
+ * task waits for is reached. Nothing is polled. The results of completed
+ * transactions are collected afterwards, the driver posts them right after
+ * the post transaction callback returns.
+ *
+ * Flushes to controllers with a MIPI DCS address window (CASET, RASET and
+ * RAMWR) go through disp_spi_send_window(). Its transactions are built once,
+ * in disp_spi_set_window(), and only the window coordinates and the color
+ * buffer are patched for each flush. The whole chain is queued at once with
+ * the D/C line driven from the pre transaction callback, so the flush returns
+ * right away and LVGL renders its next buffer while this one is on the wire.
+ * A window equal to the previous one is not sent again, only RAMWR and the
+ * colors are. Two chains are used in turn, one can be patched while the
+ * results of the other are still to be collected.
+ *
+ * Frame buffers the DMA cannot read, such as full frames in PSRAM, are sent
+ * with disp_spi_send_window_rows(). The rows are copied into one of two
+ * bounce buffers in internal RAM, which are queued as the window's colors,
+ * and the next rows are copied into the other one while the first is sent.
+ *
+ * When polling or synchronously sending SPI requests, and as required by the
+ * esp32 SPI driver, all queued transactions are first waited for.
+ *
  *****************************************************************************/
 
 /*********************
@@ -70,30 +74,86 @@
  *********************/
 #define SPI_TRANSACTION_POOL_SIZE 50	/* maximum number of DMA transactions simultaneously in-flight */
 
-/* DMA Transactions to reserve before queueing additional DMA transactions. A 1/10th seems to be a good balance. Too many (or all) and it will increase latency. */
-#define SPI_TRANSACTION_POOL_RESERVE_PERCENTAGE 10
-#if SPI_TRANSACTION_POOL_SIZE >= SPI_TRANSACTION_POOL_RESERVE_PERCENTAGE
-#define SPI_TRANSACTION_POOL_RESERVE (SPI_TRANSACTION_POOL_SIZE / SPI_TRANSACTION_POOL_RESERVE_PERCENTAGE)	
-#else
-#define SPI_TRANSACTION_POOL_RESERVE 1	/* defines minimum size */
+/* Task notification used by the waits below, index 0 is left to the application */
+#define DISP_SPI_NOTIFY_INDEX 1
+#if CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES <= DISP_SPI_NOTIFY_INDEX
+#error "disp_spi needs CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES of at least 2"
 #endif
 
+/* Address window transactions, in the order they are queued */
+enum {
+    WINDOW_CASET_CMD,
+    WINDOW_CASET_DATA,
+    WINDOW_RASET_CMD,
+    WINDOW_RASET_DATA,
+    WINDOW_RAMWR_CMD,
+    WINDOW_COLORS,
+    WINDOW_TRANS_NUM
+};
+
+#define WINDOW_CHAIN_NUM 2
+
+#define BOUNCE_BUF_NUM 2
+
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct {
+    spi_transaction_t trans[WINDOW_TRANS_NUM];
+    uint32_t end;	/* queued count once the chain was last queued */
+} window_chain_t;
+
+typedef struct {
+    uint8_t *buf;
+    uint32_t end;	/* queued count once the buffer was last queued */
+} bounce_buf_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void IRAM_ATTR spi_pre (spi_transaction_t *trans);
 static void IRAM_ATTR spi_ready (spi_transaction_t *trans);
+static spi_transaction_ext_t *ring_trans(void);
+static void queue_trans(spi_transaction_t *trans);
+static void queue_window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+    const uint8_t *colors, size_t length, disp_spi_send_flag_t flags);
+static void reserve_trans(uint32_t count);
+static void wait_done(uint32_t count);
+static void collect_done(void);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static spi_host_device_t spi_host;
 static spi_device_handle_t spi;
-static QueueHandle_t TransactionPool = NULL;
+static transaction_cb_t chained_pre_cb;
 static transaction_cb_t chained_post_cb;
+static disp_spi_flush_done_cb_t flush_done_cb = NULL;
+
+static DMA_ATTR spi_transaction_ext_t trans_ring[SPI_TRANSACTION_POOL_SIZE];
+static uint32_t trans_ring_next;	/* next ring slot, in queueing order */
+
+/* Queued transactions. trans_queued and trans_collected are only touched by the
+ * task using the display, trans_done by spi_ready() */
+static uint32_t trans_queued;
+static uint32_t trans_collected;
+static volatile uint32_t trans_done;
+static uint32_t flush_end;	/* trans_queued once the last flush was queued */
+
+static portMUX_TYPE trans_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t trans_waiter = NULL;
+static uint32_t trans_wait_count;
+
+static window_chain_t window_chains[WINDOW_CHAIN_NUM];
+static uint32_t window_chain_next;
+static disp_spi_window_t window_cfg = { .dc_io = -1 };
+static bool window_valid = false;	/* the controller still has window_last set */
+static uint16_t window_last[4];
+
+#if defined (DISP_BOUNCE_BUF_SIZE)
+static bounce_buf_t bounce_bufs[BOUNCE_BUF_NUM];
+static uint32_t bounce_buf_next;
+#endif
 
 /**********************
  *      MACROS
@@ -105,7 +165,9 @@ static transaction_cb_t chained_post_cb;
 void disp_spi_add_device_config(spi_host_device_t host, spi_device_interface_config_t *devcfg)
 {
     spi_host=host;
+    chained_pre_cb=devcfg->pre_cb;
     chained_post_cb=devcfg->post_cb;
+    devcfg->pre_cb=spi_pre;
     devcfg->post_cb=spi_ready;
     esp_err_t ret=spi_bus_add_device(host, devcfg, &spi);
     assert(ret==ESP_OK);
@@ -143,18 +205,14 @@ void disp_spi_add_device_with_speed(spi_host_device_t host, int clock_speed_hz)
 
     disp_spi_add_device_config(host, &devcfg);
 
-	/* create the transaction pool and fill it with ptrs to spi_transaction_ext_t to reuse */
-	if(TransactionPool == NULL) {
-		TransactionPool = xQueueCreate(SPI_TRANSACTION_POOL_SIZE, sizeof(spi_transaction_ext_t*));
-		assert(TransactionPool != NULL);
-		for (size_t i = 0; i < SPI_TRANSACTION_POOL_SIZE; i++)
-		{
-			spi_transaction_ext_t* pTransaction = (spi_transaction_ext_t*)heap_caps_malloc(sizeof(spi_transaction_ext_t), MALLOC_CAP_DMA);
-			assert(pTransaction != NULL);
-			memset(pTransaction, 0, sizeof(spi_transaction_ext_t));
-			xQueueSend(TransactionPool, &pTransaction, portMAX_DELAY);
-		}
-	}
+#if defined (DISP_BOUNCE_BUF_SIZE)
+    for (size_t i = 0; i < BOUNCE_BUF_NUM; i++) {
+        if (bounce_bufs[i].buf == NULL) {
+            bounce_bufs[i].buf = heap_caps_malloc(DISP_BOUNCE_BUF_SIZE * sizeof(lv_color_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+            assert(bounce_bufs[i].buf != NULL);
+        }
+    }
+#endif
 }
 
 void disp_spi_change_device_speed(int clock_speed_hz)
@@ -184,103 +242,213 @@ void disp_spi_transaction(const uint8_t *data, size_t length,
         return;
     }
 
-    spi_transaction_ext_t t = {0};
+    /* Any command may have moved the controller's address window */
+    window_valid = false;
+
+    spi_transaction_ext_t t_polled;
+    spi_transaction_ext_t *t = &t_polled;
+
+    /* Queued transactions are built right in their ring slot */
+    if (!(flags & (DISP_SPI_SEND_POLLING | DISP_SPI_SEND_SYNCHRONOUS))) {
+        t = ring_trans();
+    } else {
+        memset(t, 0, sizeof(*t));
+    }
 
     /* transaction length is in bits */
-    t.base.length = length * 8;
+    t->base.length = length * 8;
 
     if (length <= 4 && data != NULL) {
-        t.base.flags = SPI_TRANS_USE_TXDATA;
-        memcpy(t.base.tx_data, data, length);
+        t->base.flags = SPI_TRANS_USE_TXDATA;
+        memcpy(t->base.tx_data, data, length);
     } else {
-        t.base.tx_buffer = data;
+        t->base.tx_buffer = data;
     }
 
     if (flags & DISP_SPI_RECEIVE) {
         assert(out != NULL && (flags & (DISP_SPI_SEND_POLLING | DISP_SPI_SEND_SYNCHRONOUS)));
-        t.base.rx_buffer = out;
+        t->base.rx_buffer = out;
 
 #if defined(DISP_SPI_HALF_DUPLEX)
-		t.base.rxlength = t.base.length;
-		t.base.length = 0;	/* no MOSI phase in half-duplex reads */
+		t->base.rxlength = t->base.length;
+		t->base.length = 0;	/* no MOSI phase in half-duplex reads */
 #else
-		t.base.rxlength = 0; /* in full-duplex mode, zero means same as tx length */
+		t->base.rxlength = 0; /* in full-duplex mode, zero means same as tx length */
 #endif
     }
 
     if (flags & DISP_SPI_ADDRESS_8) {
-        t.address_bits = 8;
+        t->address_bits = 8;
     } else if (flags & DISP_SPI_ADDRESS_16) {
-        t.address_bits = 16;
+        t->address_bits = 16;
     } else if (flags & DISP_SPI_ADDRESS_24) {
-        t.address_bits = 24;
+        t->address_bits = 24;
     } else if (flags & DISP_SPI_ADDRESS_32) {
-        t.address_bits = 32;
+        t->address_bits = 32;
     }
-    if (t.address_bits) {
-        t.base.addr = addr;
-        t.base.flags |= SPI_TRANS_VARIABLE_ADDR;
+    if (t->address_bits) {
+        t->base.addr = addr;
+        t->base.flags |= SPI_TRANS_VARIABLE_ADDR;
     }
 
 #if defined(DISP_SPI_HALF_DUPLEX)
 	if (flags & DISP_SPI_MODE_DIO) {
-		t.base.flags |= SPI_TRANS_MODE_DIO;
+		t->base.flags |= SPI_TRANS_MODE_DIO;
 	} else if (flags & DISP_SPI_MODE_QIO) {
-		t.base.flags |= SPI_TRANS_MODE_QIO;
+		t->base.flags |= SPI_TRANS_MODE_QIO;
 	}
 
 	if (flags & DISP_SPI_MODE_DIOQIO_ADDR) {
-		t.base.flags |= SPI_TRANS_MODE_DIOQIO_ADDR;
+		t->base.flags |= SPI_TRANS_MODE_DIOQIO_ADDR;
 	}
 
 	if ((flags & DISP_SPI_VARIABLE_DUMMY) && dummy_bits) {
-		t.dummy_bits = dummy_bits;
-		t.base.flags |= SPI_TRANS_VARIABLE_DUMMY;
+		t->dummy_bits = dummy_bits;
+		t->base.flags |= SPI_TRANS_VARIABLE_DUMMY;
 	}
 #endif
 
     /* Save flags for pre/post transaction processing */
-    t.base.user = (void *) flags;
+    t->base.user = (void *) flags;
 
     /* Poll/Complete/Queue transaction */
     if (flags & DISP_SPI_SEND_POLLING) {
 		disp_wait_for_pending_transactions();	/* before polling, all previous pending transactions need to be serviced */
-        spi_device_polling_transmit(spi, (spi_transaction_t *) &t);
+        spi_device_polling_transmit(spi, (spi_transaction_t *) t);
     } else if (flags & DISP_SPI_SEND_SYNCHRONOUS) {
 		disp_wait_for_pending_transactions();	/* before synchronous queueing, all previous pending transactions need to be serviced */
-        spi_device_transmit(spi, (spi_transaction_t *) &t);
+        spi_device_transmit(spi, (spi_transaction_t *) t);
     } else {
-		
-		/* if necessary, ensure we can queue new transactions by servicing some previous transactions */
-		if(uxQueueMessagesWaiting(TransactionPool) == 0) {
-			spi_transaction_t *presult;
-			while(uxQueueMessagesWaiting(TransactionPool) < SPI_TRANSACTION_POOL_RESERVE) {
-				if (spi_device_get_trans_result(spi, &presult, 1) == ESP_OK) {
-					xQueueSend(TransactionPool, &presult, portMAX_DELAY);	/* back to the pool to be reused */
-				}
-			}
-		}
-
-		spi_transaction_ext_t *pTransaction = NULL;
-		xQueueReceive(TransactionPool, &pTransaction, portMAX_DELAY);
-        memcpy(pTransaction, &t, sizeof(t));
-        if (spi_device_queue_trans(spi, (spi_transaction_t *) pTransaction, portMAX_DELAY) != ESP_OK) {
-			xQueueSend(TransactionPool, &pTransaction, portMAX_DELAY);	/* send failed transaction back to the pool to be reused */
+        queue_trans((spi_transaction_t *) t);
+    }
+}
+
+void disp_spi_read_reg(int dc_io, uint8_t cmd, uint8_t *out, size_t length, uint8_t dummy_bits)
+{
+#if defined(DISP_SPI_HALF_DUPLEX)
+    disp_wait_for_pending_transactions();
+    gpio_set_level(dc_io, 0);
+
+    /* The command goes out in the address phase, the controller answers after the dummy bits */
+    disp_spi_transaction(NULL, length,
+        DISP_SPI_SEND_POLLING | DISP_SPI_RECEIVE | DISP_SPI_ADDRESS_8 | DISP_SPI_VARIABLE_DUMMY,
+        out, cmd, dummy_bits);
+#else
+    /* Full duplex has no dummy phase. The command, the dummy bits and the
+     * reply are clocked as one transfer, the reply is shifted back in place */
+    uint32_t tx[(DISP_SPI_READ_REG_MAX + 6) / 4] = {0};
+    uint32_t rx[(DISP_SPI_READ_REG_MAX + 6) / 4] = {0};
+    uint8_t * tx_bytes = (uint8_t *) tx;
+    uint8_t * rx_bytes = (uint8_t *) rx;
+    size_t skip = 1 + dummy_bits / 8;
+    uint8_t shift = dummy_bits % 8;
+
+    assert((length <= DISP_SPI_READ_REG_MAX) && (dummy_bits <= 8));
+
+    tx_bytes[0] = cmd;
+
+    disp_wait_for_pending_transactions();
+    gpio_set_level(dc_io, 0);
+
+    disp_spi_transaction(tx_bytes, skip + length + ((shift != 0) ? 1 : 0),
+        DISP_SPI_SEND_POLLING | DISP_SPI_RECEIVE, rx_bytes, 0, 0);
+
+    for (size_t i = 0; i < length; i++) {
+        out[i] = (shift != 0)
+            ? (uint8_t) ((rx_bytes[skip + i] << shift) | (rx_bytes[skip + i + 1] >> (8 - shift)))
+            : rx_bytes[skip + i];
+    }
+#endif
+}
+
+void disp_spi_set_window(const disp_spi_window_t *window)
+{
+    disp_wait_for_pending_transactions();
+
+    window_cfg = *window;
+    window_valid = false;
+
+    for (size_t i = 0; i < WINDOW_CHAIN_NUM; i++) {
+        spi_transaction_t *t = window_chains[i].trans;
+
+        memset(t, 0, sizeof(window_chains[i].trans));
+
+        for (size_t j = 0; j < WINDOW_TRANS_NUM; j++) {
+            t[j].flags = SPI_TRANS_USE_TXDATA;
+            t[j].length = 8;
+            t[j].user = (void *) DISP_SPI_DC_CMD;
         }
+
+        t[WINDOW_CASET_CMD].tx_data[0] = window->caset;
+        t[WINDOW_RASET_CMD].tx_data[0] = window->raset;
+        t[WINDOW_RAMWR_CMD].tx_data[0] = window->ramwr;
+
+        t[WINDOW_CASET_DATA].length = 32;
+        t[WINDOW_CASET_DATA].user = (void *) DISP_SPI_DC_DATA;
+        t[WINDOW_RASET_DATA].length = 32;
+        t[WINDOW_RASET_DATA].user = (void *) DISP_SPI_DC_DATA;
+
+        t[WINDOW_COLORS].flags = 0;
+
+        window_chains[i].end = trans_queued;
     }
 }
 
+void disp_spi_send_window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+    const uint8_t *colors, size_t length)
+{
+    queue_window(x1, y1, x2, y2, colors, length, DISP_SPI_SIGNAL_FLUSH);
+}
 
-void disp_wait_for_pending_transactions(void)
+#if defined (DISP_BOUNCE_BUF_SIZE)
+void disp_spi_send_window_rows(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+    const uint8_t *src, size_t stride, bool flush)
 {
-    spi_transaction_t *presult;
+    const size_t row_bytes = (x2 - x1 + 1) * sizeof(lv_color_t);
+    const uint32_t buf_rows = (DISP_BOUNCE_BUF_SIZE * sizeof(lv_color_t)) / row_bytes;
+    const uint32_t rows = y2 - y1 + 1;
+
+    for (uint32_t row = 0; row < rows; row += buf_rows) {
+        uint32_t count = LV_MIN(buf_rows, rows - row);
+        bounce_buf_t *bounce = &bounce_bufs[bounce_buf_next];
+        bounce_buf_next = (bounce_buf_next + 1) % BOUNCE_BUF_NUM;
+
+        /* The DMA is done reading it once its transaction completed */
+        wait_done(bounce->end);
+
+        for (uint32_t i = 0; i < count; i++) {
+            memcpy(&bounce->buf[i * row_bytes], &src[(row + i) * stride], row_bytes);
+        }
 
-	while(uxQueueMessagesWaiting(TransactionPool) < SPI_TRANSACTION_POOL_SIZE) {	/* service until the transaction reuse pool is full again */
-        if (spi_device_get_trans_result(spi, &presult, 1) == ESP_OK) {
-			xQueueSend(TransactionPool, &presult, portMAX_DELAY);
+        disp_spi_send_flag_t flags = (flush && (row + count == rows)) ? DISP_SPI_SIGNAL_FLUSH : 0;
+
+        if (row == 0) {
+            queue_window(x1, y1, x2, y2, bounce->buf, count * row_bytes, flags);
+        } else {
+            /* Still in RAMWR, further data carries on where the last left off */
+            spi_transaction_ext_t *t = ring_trans();
+            t->base.tx_buffer = bounce->buf;
+            t->base.length = count * row_bytes * 8;
+            t->base.user = (void *) (DISP_SPI_DC_DATA | flags);
+            queue_trans((spi_transaction_t *) t);
         }
+
+        bounce->end = trans_queued;
     }
 }
+#endif
+
+void disp_wait_for_pending_transactions(void)
+{
+    wait_done(trans_queued);
+    collect_done();
+}
+
+void disp_spi_wait_for_flush(void)
+{
+    wait_done(flush_end);
+    collect_done();
+}
 
 void disp_spi_acquire(void)
 {
@@ -293,10 +461,150 @@ void disp_spi_release(void)
     spi_device_release_bus(spi);
 }
 
+void disp_spi_set_flush_done_cb(disp_spi_flush_done_cb_t cb)
+{
+    flush_done_cb = cb;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+/* Takes the next ring slot, zeroed */
+static spi_transaction_ext_t *ring_trans(void)
+{
+    reserve_trans(1);
+
+    spi_transaction_ext_t *t = &trans_ring[trans_ring_next];
+    trans_ring_next = (trans_ring_next + 1) % SPI_TRANSACTION_POOL_SIZE;
+    memset(t, 0, sizeof(*t));
+
+    return t;
+}
+
+static void queue_trans(spi_transaction_t *trans)
+{
+    disp_spi_send_flag_t flags = (disp_spi_send_flag_t) trans->user;
+
+    /* The ring never holds more than the driver's queue, this does not block */
+    if (spi_device_queue_trans(spi, trans, portMAX_DELAY) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to queue transaction");
+        return;
+    }
+
+    trans_queued++;
+
+    if (flags & DISP_SPI_SIGNAL_FLUSH) {
+        flush_end = trans_queued;
+    }
+}
+
+/* Queues the window chain, flags go with the colors */
+static void queue_window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+    const uint8_t *colors, size_t length, disp_spi_send_flag_t flags)
+{
+    assert(window_cfg.dc_io >= 0);
+
+    x1 += window_cfg.x_offset;
+    x2 += window_cfg.x_offset;
+    y1 += window_cfg.y_offset;
+    y2 += window_cfg.y_offset;
+
+    const uint16_t window[4] = {x1, y1, x2, y2};
+    size_t first = WINDOW_CASET_CMD;
+
+    if (window_valid && (0 == memcmp(window, window_last, sizeof(window)))) {
+        first = WINDOW_RAMWR_CMD;	/* RAMWR restarts at the top left of the window */
+    }
+
+    window_chain_t *chain = &window_chains[window_chain_next];
+    window_chain_next = (window_chain_next + 1) % WINDOW_CHAIN_NUM;
+
+    /* Results of the chain's previous flush are collected before it is patched */
+    wait_done(chain->end);
+    reserve_trans(WINDOW_TRANS_NUM - first);
+
+    spi_transaction_t *t = chain->trans;
+
+    t[WINDOW_CASET_DATA].tx_data[0] = (x1 >> 8) & 0xFF;
+    t[WINDOW_CASET_DATA].tx_data[1] = x1 & 0xFF;
+    t[WINDOW_CASET_DATA].tx_data[2] = (x2 >> 8) & 0xFF;
+    t[WINDOW_CASET_DATA].tx_data[3] = x2 & 0xFF;
+
+    t[WINDOW_RASET_DATA].tx_data[0] = (y1 >> 8) & 0xFF;
+    t[WINDOW_RASET_DATA].tx_data[1] = y1 & 0xFF;
+    t[WINDOW_RASET_DATA].tx_data[2] = (y2 >> 8) & 0xFF;
+    t[WINDOW_RASET_DATA].tx_data[3] = y2 & 0xFF;
+
+    t[WINDOW_COLORS].tx_buffer = colors;
+    t[WINDOW_COLORS].length = length * 8;
+    t[WINDOW_COLORS].user = (void *) (DISP_SPI_DC_DATA | flags);
+
+    for (size_t i = first; i < WINDOW_TRANS_NUM; i++) {
+        queue_trans(&t[i]);
+    }
+
+    chain->end = trans_queued;
+    memcpy(window_last, window, sizeof(window));
+    window_valid = true;
+}
+
+/* Makes room for count more queued transactions */
+static void reserve_trans(uint32_t count)
+{
+    collect_done();
+
+    if (trans_queued - trans_collected + count > SPI_TRANSACTION_POOL_SIZE) {
+        wait_done(trans_queued + count - SPI_TRANSACTION_POOL_SIZE);
+        collect_done();
+    }
+}
+
+/* Sleeps until spi_ready() has seen count queued transactions complete */
+static void wait_done(uint32_t count)
+{
+    portENTER_CRITICAL(&trans_lock);
+    while ((int32_t) (trans_done - count) < 0) {
+        trans_waiter = xTaskGetCurrentTaskHandle();
+        trans_wait_count = count;
+        portEXIT_CRITICAL(&trans_lock);
+
+        ulTaskNotifyTakeIndexed(DISP_SPI_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+
+        portENTER_CRITICAL(&trans_lock);
+    }
+    portEXIT_CRITICAL(&trans_lock);
+}
+
+/* Takes back the results of completed transactions, freeing their ring slots */
+static void collect_done(void)
+{
+    uint32_t done = trans_done;
+    spi_transaction_t *presult;
+
+    while (trans_collected != done) {
+        /* Already complete, the driver posts it as soon as spi_ready() returns */
+        esp_err_t ret = spi_device_get_trans_result(spi, &presult, portMAX_DELAY);
+        assert(ret == ESP_OK);
+        trans_collected++;
+    }
+}
+
+static void IRAM_ATTR spi_pre(spi_transaction_t *trans)
+{
+    disp_spi_send_flag_t flags = (disp_spi_send_flag_t) trans->user;
+
+    if (flags & DISP_SPI_DC_CMD) {
+        gpio_set_level(window_cfg.dc_io, 0);
+    } else if (flags & DISP_SPI_DC_DATA) {
+        gpio_set_level(window_cfg.dc_io, 1);
+    }
+
+    if (chained_pre_cb) {
+        chained_pre_cb(trans);
+    }
+}
+
 static void IRAM_ATTR spi_ready(spi_transaction_t *trans)
 {
     disp_spi_send_flag_t flags = (disp_spi_send_flag_t) trans->user;
@@ -310,11 +618,34 @@ static void IRAM_ATTR spi_ready(spi_transaction_t *trans)
         disp = lv_refr_get_disp_refreshing();
 #endif
 
+        /* Before LVGL is told, so the next flush can't start first */
+        if (flush_done_cb) {
+            flush_done_cb();
+        }
+
         lv_disp_flush_ready(disp->driver);
     }
 
+    /* Polled and synchronous transactions are not counted, their caller waits for them */
+    if (!(flags & (DISP_SPI_SEND_POLLING | DISP_SPI_SEND_SYNCHRONOUS))) {
+        TaskHandle_t waiter = NULL;
+
+        portENTER_CRITICAL_ISR(&trans_lock);
+        trans_done++;
+        if ((trans_waiter != NULL) && ((int32_t) (trans_done - trans_wait_count) >= 0)) {
+            waiter = trans_waiter;
+            trans_waiter = NULL;
+        }
+        portEXIT_CRITICAL_ISR(&trans_lock);
+
+        if (waiter != NULL) {
+            BaseType_t higher_prio_woken = pdFALSE;
+            vTaskNotifyGiveIndexedFromISR(waiter, DISP_SPI_NOTIFY_INDEX, &higher_prio_woken);
+            portYIELD_FROM_ISR(higher_prio_woken);
+        }
+    }
+
     if (chained_post_cb) {
         chained_post_cb(trans);
     }
 }
-
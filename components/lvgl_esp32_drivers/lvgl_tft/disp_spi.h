@@ -20,6 +20,8 @@ extern "C" {
 /*********************
  *      DEFINES
  *********************/
+/* Longest register disp_spi_read_reg() reads on a full-duplex bus */
+#define DISP_SPI_READ_REG_MAX   8
 
 /**********************
  *      TYPEDEFS
@@ -40,8 +42,23 @@ typedef enum _disp_spi_send_flag_t {
     DISP_SPI_MODE_QIO           = 0x00000800, 
     DISP_SPI_MODE_DIOQIO_ADDR   = 0x00001000, 
 	DISP_SPI_VARIABLE_DUMMY		= 0x00002000,
+    DISP_SPI_DC_CMD             = 0x00004000, /* D/C low from the pre transaction callback */
+    DISP_SPI_DC_DATA            = 0x00008000, /* D/C high from the pre transaction callback */
 } disp_spi_send_flag_t;
 
+/* MIPI DCS address window of the controller, see disp_spi_send_window() */
+typedef struct {
+    int dc_io;          /* D/C pin, low for commands */
+    uint8_t caset;      /* Column address set */
+    uint8_t raset;      /* Row (page) address set */
+    uint8_t ramwr;      /* Memory write */
+    uint16_t x_offset;  /* Added to the columns, for panels smaller than the controller's memory */
+    uint16_t y_offset;  /* Added to the rows */
+} disp_spi_window_t;
+
+/* Called from the SPI ISR once a flush has been sent, must be in IRAM */
+typedef void (*disp_spi_flush_done_cb_t)(void);
+
 
 /**********************
  * GLOBAL PROTOTYPES
@@ -60,9 +77,31 @@ void disp_spi_remove_device();
 void disp_spi_transaction(const uint8_t *data, size_t length,
     disp_spi_send_flag_t flags, uint8_t *out, uint64_t addr, uint8_t dummy_bits);
 
+/* Reads a MIPI DCS register: the command with D/C low, dummy_bits, then length bytes into out.
+   out must hold at least 4 bytes, see above. On a full-duplex bus length is up to DISP_SPI_READ_REG_MAX
+   and dummy_bits up to 8, and the controller's SDO must be wired to the bus MISO. */
+void disp_spi_read_reg(int dc_io, uint8_t cmd, uint8_t *out, size_t length, uint8_t dummy_bits);
+
+/* Prebuilds the window transactions, once at controller init */
+void disp_spi_set_window(const disp_spi_window_t *window);
+
+/* Queues CASET, RASET, RAMWR and the colors as one chain and returns at once.
+   The colors are a flush, LVGL is told from the SPI ISR when they are sent. */
+void disp_spi_send_window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+    const uint8_t *colors, size_t length);
+
+/* As disp_spi_send_window() for colors the DMA can't read, e.g. in PSRAM. The window's rows
+   are stride bytes apart in src and go out through the internal RAM bounce buffers. Only
+   signals a flush when flush is set. Needs DISP_BOUNCE_BUF_SIZE. */
+void disp_spi_send_window_rows(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+    const uint8_t *src, size_t stride, bool flush);
+
 void disp_wait_for_pending_transactions(void);
+/* Sleeps until the last queued flush has been sent */
+void disp_spi_wait_for_flush(void);
 void disp_spi_acquire(void);
 void disp_spi_release(void);
+void disp_spi_set_flush_done_cb(disp_spi_flush_done_cb_t cb);
 
 static inline void disp_spi_send_data(uint8_t *data, size_t length) {
     disp_spi_transaction(data, length, DISP_SPI_SEND_POLLING, NULL, 0, 0);
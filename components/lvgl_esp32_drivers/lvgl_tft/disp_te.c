@@ -0,0 +1,203 @@
+/**
+ * @file disp_te.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "disp_te.h"
+
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+
+#include <stdbool.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define TAG "disp_te"
+
+/******************************************************************************
+ * Notes about the tearing effect line
+ *
+ * After TEON the controller pulses its TE output at the start of every
+ * vertical blanking. The scan out of the frame memory starts after the pulse
+ * and reaches the last line one panel frame later, so the time since the last
+ * pulse tells which line is being scanned out. The frame time is measured from
+ * the pulses themselves, as it depends on the controller's frame rate control
+ * and its oscillator.
+ *
+ * A frame does not tear if its lines are written after the scan out has read
+ * them for the previous frame and before it reads them again for this one.
+ * Writing from the pulse on meets the first condition as long as the scan out
+ * is faster than the SPI bus, and the second as long as the frame is written
+ * within two panel frames. disp_te_wait_area() holds back a flush whose first
+ * line the scan out has not passed yet, so the strips chase the scan line
+ * whatever order they are flushed in.
+ *
+ * The scan out runs along the controller's rows, which MADCTL maps onto the
+ * screen, see disp_te_set_madctl().
+ *
+ *****************************************************************************/
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MADCTL_MY               0x80    /* Row address order */
+#define MADCTL_MV               0x20    /* Row and column exchange */
+#define MADCTL_ML               0x10    /* Vertical refresh order */
+
+/* Pulses further apart than this are not a frame */
+#define TE_FRAME_US_MIN         5000
+#define TE_FRAME_US_MAX         50000
+
+/* Consecutive periods off the estimate before it is measured again */
+#define TE_OUTLIERS_MAX         4
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void IRAM_ATTR te_isr(void *arg);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static portMUX_TYPE te_lock = portMUX_INITIALIZER_UNLOCKED;
+static int64_t te_last;         /* time of the last pulse */
+static uint32_t te_frame;       /* smoothed pulse period, 0 until measured */
+static uint8_t te_outliers;
+static disp_te_cb_t te_cb;
+
+static bool scan_along_x;       /* the controller's rows are screen columns */
+static bool scan_reversed;      /* the scan runs from the last row to the first */
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+void disp_te_init(void)
+{
+    ESP_LOGI(TAG, "Tearing effect input on GPIO %d", CONFIG_LV_DISP_PIN_TE);
+
+    gpio_config_t io_conf = {
+        .pin_bit_mask = 1ULL << CONFIG_LV_DISP_PIN_TE,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_ENABLE,
+        .intr_type = GPIO_INTR_POSEDGE,
+    };
+    ESP_ERROR_CHECK(gpio_config(&io_conf));
+
+    /* The touch driver may have installed the service already */
+    esp_err_t ret = gpio_install_isr_service(0);
+    ESP_ERROR_CHECK((ESP_ERR_INVALID_STATE == ret) ? ESP_OK : ret);
+    ESP_ERROR_CHECK(gpio_isr_handler_add(CONFIG_LV_DISP_PIN_TE, te_isr, NULL));
+}
+
+void disp_te_set_cb(disp_te_cb_t cb)
+{
+    portENTER_CRITICAL(&te_lock);
+    te_cb = cb;
+    portEXIT_CRITICAL(&te_lock);
+}
+
+void disp_te_set_madctl(uint8_t madctl)
+{
+    scan_along_x = (madctl & MADCTL_MV) != 0;
+    scan_reversed = ((madctl & MADCTL_MY) != 0) != ((madctl & MADCTL_ML) != 0);
+}
+
+uint32_t disp_te_frame_us(void)
+{
+    portENTER_CRITICAL(&te_lock);
+    uint32_t frame = te_frame;
+    portEXIT_CRITICAL(&te_lock);
+
+    return frame;
+}
+
+int64_t disp_te_last_us(void)
+{
+    portENTER_CRITICAL(&te_lock);
+    int64_t last = te_last;
+    portEXIT_CRITICAL(&te_lock);
+
+    return last;
+}
+
+void disp_te_wait_area(lv_disp_drv_t * drv, const lv_area_t * area)
+{
+    portENTER_CRITICAL(&te_lock);
+    int64_t last = te_last;
+    uint32_t frame = te_frame;
+    portEXIT_CRITICAL(&te_lock);
+
+    if (frame == 0) {
+        return;
+    }
+
+    int32_t lines = scan_along_x ? drv->hor_res : drv->ver_res;
+    int32_t first = scan_along_x ? area->x1 : area->y1;
+
+    if (scan_reversed) {
+        first = lines - 1 - (scan_along_x ? area->x2 : area->y2);
+    }
+
+    /* A stale pulse means the scan is past the area already, or the panel sleeps */
+    int64_t ready = last + ((int64_t) frame * first) / lines;
+    int64_t wait = ready - esp_timer_get_time();
+
+    if ((wait <= 0) || (wait >= frame)) {
+        return;
+    }
+
+    /* Whole ticks are slept so other tasks can run, vTaskDelay(n) returns
+     * after n - 1 to n ticks and never overshoots. Only the rest is spun. */
+    TickType_t ticks = (TickType_t) (wait / (portTICK_PERIOD_MS * 1000));
+
+    if (ticks > 0) {
+        vTaskDelay(ticks);
+        wait = ready - esp_timer_get_time();
+    }
+
+    if (wait > 0) {
+        esp_rom_delay_us((uint32_t) wait);
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+static void IRAM_ATTR te_isr(void *arg)
+{
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL_ISR(&te_lock);
+
+    int64_t period = now - te_last;
+    te_last = now;
+
+    if ((period >= TE_FRAME_US_MIN) && (period <= TE_FRAME_US_MAX)) {
+        if ((te_frame == 0) || (te_outliers >= TE_OUTLIERS_MAX)) {
+            te_frame = (uint32_t) period;
+            te_outliers = 0;
+        } else if ((period * 4 > te_frame * 3) && (period * 4 < te_frame * 5)) {
+            /* Smoothed over about eight frames */
+            te_frame += ((int32_t) period - (int32_t) te_frame) / 8;
+            te_outliers = 0;
+        } else {
+            /* Missed pulses, or the frame rate was changed */
+            te_outliers++;
+        }
+    }
+
+    disp_te_cb_t cb = te_cb;
+
+    portEXIT_CRITICAL_ISR(&te_lock);
+
+    if (cb) {
+        cb();
+    }
+}
@@ -0,0 +1,56 @@
+/**
+ * @file disp_te.h
+ *
+ */
+
+#ifndef DISP_TE_H
+#define DISP_TE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+
+#ifdef LV_LVGL_H_INCLUDE_SIMPLE
+#include "lvgl.h"
+#else
+#include "lvgl/lvgl.h"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+/* Tearing effect line on (TEON), MIPI DCS */
+#define DISP_TE_CMD_TEON        0x35
+/* TEON parameter, pulse on the vertical blanking only */
+#define DISP_TE_MODE_VBLANK     0x00
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* Called from the TE ISR at the start of every panel frame, must be in IRAM */
+typedef void (*disp_te_cb_t)(void);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void disp_te_init(void);
+void disp_te_set_cb(disp_te_cb_t cb);
+void disp_te_set_madctl(uint8_t madctl);
+uint32_t disp_te_frame_us(void);
+int64_t disp_te_last_us(void);
+void disp_te_wait_area(lv_disp_drv_t * drv, const lv_area_t * area);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*DISP_TE_H*/
@@ -16,6 +16,7 @@
  *      INCLUDES
  *********************/
 #include "hx8357.h"
+#include "disp_driver.h"
 #include "disp_spi.h"
 #include "driver/gpio.h"
 #include <esp_log.h>
@@ -310,3 +311,9 @@ static void hx8357_send_color(void * data, uint16_t length)
 	gpio_set_level(HX8357_DC, 1);   /*Data mode*/
 	disp_spi_send_colors(data, length);
 }
+
+DISP_DRIVER_REGISTER(hx8357) = {
+    .name = "HX8357",
+    .init = hx8357_init,
+    .flush = hx8357_flush,
+};
@@ -35,6 +35,7 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 #include "freertos/task.h"
 
 #include "il3820.h"
+#include "disp_driver.h"
 
 /*********************
  *      DEFINES
@@ -412,3 +413,11 @@ static void il3820_clear_cntlr_mem(uint8_t ram_cmd, bool update)
 	il3820_update_display();
     }
 }
+
+DISP_DRIVER_REGISTER(il3820) = {
+    .name = "IL3820",
+    .init = il3820_init,
+    .flush = il3820_flush,
+    .rounder = il3820_rounder,
+    .set_px = il3820_set_px_cb,
+};
@@ -7,7 +7,11 @@
  *      INCLUDES
  *********************/
 #include "ili9341.h"
+#include "disp_driver.h"
 #include "disp_spi.h"
+#if defined CONFIG_LV_DISP_USE_TE
+#include "disp_te.h"
+#endif
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
@@ -32,11 +36,12 @@ typedef struct {
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static bool ili9341_probe(void);
 static void ili9341_set_orientation(uint8_t orientation);
+static void ili9341_set_madctl(uint8_t madctl);
 
 static void ili9341_send_cmd(uint8_t cmd);
 static void ili9341_send_data(void * data, uint16_t length);
-static void ili9341_send_color(void * data, uint16_t length);
 
 /**********************
  *  STATIC VARIABLES
@@ -108,6 +113,14 @@ void ili9341_init(void)
 
 	ESP_LOGI(TAG, "Initialization.");
 
+	const disp_spi_window_t window = {
+		.dc_io = ILI9341_DC,
+		.caset = 0x2A,
+		.raset = 0x2B,
+		.ramwr = 0x2C,
+	};
+	disp_spi_set_window(&window);
+
 	//Send all the commands
 	uint16_t cmd = 0;
 	while (ili_init_cmds[cmd].databytes!=0xff) {
@@ -119,6 +132,12 @@ void ili9341_init(void)
 		cmd++;
 	}
 
+#if defined CONFIG_LV_DISP_USE_TE
+	uint8_t te_mode = DISP_TE_MODE_VBLANK;
+	ili9341_send_cmd(DISP_TE_CMD_TEON);
+	ili9341_send_data(&te_mode, 1);
+#endif
+
 	ili9341_enable_backlight(true);
 
         ili9341_set_orientation(CONFIG_LV_DISPLAY_ORIENTATION);
@@ -133,31 +152,10 @@ void ili9341_init(void)
 
 void ili9341_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_map)
 {
-	uint8_t data[4];
-
-	/*Column addresses*/
-	ili9341_send_cmd(0x2A);
-	data[0] = (area->x1 >> 8) & 0xFF;
-	data[1] = area->x1 & 0xFF;
-	data[2] = (area->x2 >> 8) & 0xFF;
-	data[3] = area->x2 & 0xFF;
-	ili9341_send_data(data, 4);
-
-	/*Page addresses*/
-	ili9341_send_cmd(0x2B);
-	data[0] = (area->y1 >> 8) & 0xFF;
-	data[1] = area->y1 & 0xFF;
-	data[2] = (area->y2 >> 8) & 0xFF;
-	data[3] = area->y2 & 0xFF;
-	ili9341_send_data(data, 4);
-
-	/*Memory write*/
-	ili9341_send_cmd(0x2C);
-
-
 	uint32_t size = lv_area_get_width(area) * lv_area_get_height(area);
 
-	ili9341_send_color((void*)color_map, size * 2);
+	/*Column and page addresses, memory write and the colors, queued as one chain*/
+	disp_spi_send_window(area->x1, area->y1, area->x2, area->y2, (uint8_t *) color_map, size * 2);
 }
 
 void ili9341_enable_backlight(bool backlight)
@@ -194,6 +192,14 @@ void ili9341_sleep_out()
  *   STATIC FUNCTIONS
  **********************/
 
+static bool ili9341_probe(void)
+{
+    /* RDID4 (D3h): a dummy byte, then the IC version and model, 00h 93h 41h */
+    uint8_t id[4] = {0};
+    disp_spi_read_reg(ILI9341_DC, 0xD3, id, 4, 0);
+
+    return (id[2] == 0x93) && (id[3] == 0x41);
+}
 
 static void ili9341_send_cmd(uint8_t cmd)
 {
@@ -209,13 +215,6 @@ static void ili9341_send_data(void * data, uint16_t length)
     disp_spi_send_data(data, length);
 }
 
-static void ili9341_send_color(void * data, uint16_t length)
-{
-    disp_wait_for_pending_transactions();
-    gpio_set_level(ILI9341_DC, 1);   /*Data mode*/
-    disp_spi_send_colors(data, length);
-}
-
 static void ili9341_set_orientation(uint8_t orientation)
 {
     // ESP_ASSERT(orientation < 4);
@@ -236,6 +235,32 @@ static void ili9341_set_orientation(uint8_t orientation)
 
     ESP_LOGI(TAG, "0x36 command value: 0x%02X", data[orientation]);
 
+    ili9341_set_madctl(data[orientation]);
+}
+
+static void ili9341_set_madctl(uint8_t madctl)
+{
     ili9341_send_cmd(0x36);
-    ili9341_send_data((void *) &data[orientation], 1);
+    ili9341_send_data(&madctl, 1);
+
+    disp_driver_madctl_written(madctl);
+}
+
+static void ili9341_sleep(bool sleep)
+{
+    if (sleep) {
+        ili9341_sleep_in();
+    } else {
+        ili9341_sleep_out();
+    }
 }
+
+DISP_DRIVER_REGISTER(ili9341) = {
+    .name = "ILI9341",
+    .probe = ili9341_probe,
+    .init = ili9341_init,
+    .flush = ili9341_flush,
+    .sleep = ili9341_sleep,
+    .set_orientation = ili9341_set_orientation,
+    .set_madctl = ili9341_set_madctl,
+};
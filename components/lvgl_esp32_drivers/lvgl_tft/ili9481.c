@@ -6,6 +6,7 @@
  *      INCLUDES
  *********************/
 #include "ili9481.h"
+#include "disp_driver.h"
 #include "disp_spi.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
@@ -35,6 +36,7 @@ typedef struct {
  **********************/
 
 static void ili9481_set_orientation(uint8_t orientation);
+static void ili9481_set_madctl(uint8_t madctl);
 static void ili9481_send_cmd(uint8_t cmd);
 static void ili9481_send_data(void * data, uint16_t length);
 static void ili9481_send_color(void * data, uint16_t length);
@@ -219,6 +221,21 @@ static void ili9481_set_orientation(uint8_t orientation)
     ESP_LOGI(TAG, "Display orientation: %s", orientation_str[orientation]);
 
     uint8_t data[] = {0x48, 0x4B, 0x28, 0x2B};
+    ili9481_set_madctl(data[orientation]);
+}
+
+static void ili9481_set_madctl(uint8_t madctl)
+{
     ili9481_send_cmd(ILI9481_CMD_MEMORY_ACCESS_CONTROL);
-    ili9481_send_data((void *) &data[orientation], 1);
+    ili9481_send_data(&madctl, 1);
+
+    disp_driver_madctl_written(madctl);
 }
+
+DISP_DRIVER_REGISTER(ili9481) = {
+    .name = "ILI9481",
+    .init = ili9481_init,
+    .flush = ili9481_flush,
+    .set_orientation = ili9481_set_orientation,
+    .set_madctl = ili9481_set_madctl,
+};
@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include "ili9486.h"
+#include "disp_driver.h"
 #include "disp_spi.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
@@ -33,6 +34,7 @@ typedef struct {
  *  STATIC PROTOTYPES
  **********************/
 static void ili9486_set_orientation(uint8_t orientation);
+static void ili9486_set_madctl(uint8_t madctl);
 
 static void ili9486_send_cmd(uint8_t cmd);
 static void ili9486_send_data(void * data, uint16_t length);
@@ -209,6 +211,21 @@ static void ili9486_set_orientation(uint8_t orientation)
 
     ESP_LOGI(TAG, "0x36 command value: 0x%02X", data[orientation]);
 
+    ili9486_set_madctl(data[orientation]);
+}
+
+static void ili9486_set_madctl(uint8_t madctl)
+{
     ili9486_send_cmd(0x36);
-    ili9486_send_data((void *) &data[orientation], 1);
+    ili9486_send_data(&madctl, 1);
+
+    disp_driver_madctl_written(madctl);
 }
+
+DISP_DRIVER_REGISTER(ili9486) = {
+    .name = "ILI9486",
+    .init = ili9486_init,
+    .flush = ili9486_flush,
+    .set_orientation = ili9486_set_orientation,
+    .set_madctl = ili9486_set_madctl,
+};
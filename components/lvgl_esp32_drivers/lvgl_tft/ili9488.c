@@ -6,6 +6,7 @@
  *      INCLUDES
  *********************/
 #include "ili9488.h"
+#include "disp_driver.h"
 #include "disp_spi.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
@@ -34,6 +35,7 @@ typedef struct {
  *  STATIC PROTOTYPES
  **********************/
 static void ili9488_set_orientation(uint8_t orientation);
+static void ili9488_set_madctl(uint8_t madctl);
 
 static void ili9488_send_cmd(uint8_t cmd);
 static void ili9488_send_data(void * data, uint16_t length);
@@ -228,6 +230,21 @@ static void ili9488_set_orientation(uint8_t orientation)
 
     ESP_LOGI(TAG, "0x36 command value: 0x%02X", data[orientation]);
 
+    ili9488_set_madctl(data[orientation]);
+}
+
+static void ili9488_set_madctl(uint8_t madctl)
+{
     ili9488_send_cmd(0x36);
-    ili9488_send_data((void *) &data[orientation], 1);
+    ili9488_send_data(&madctl, 1);
+
+    disp_driver_madctl_written(madctl);
 }
+
+DISP_DRIVER_REGISTER(ili9488) = {
+    .name = "ILI9488",
+    .init = ili9488_init,
+    .flush = ili9488_flush,
+    .set_orientation = ili9488_set_orientation,
+    .set_madctl = ili9488_set_madctl,
+};
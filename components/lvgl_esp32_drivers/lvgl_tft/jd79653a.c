@@ -33,6 +33,7 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 
 #include "disp_spi.h"
 #include "jd79653a.h"
+#include "disp_driver.h"
 
 #define TAG "lv_jd79653a"
 
@@ -480,3 +481,11 @@ void jd79653a_init()
 
     ESP_LOGI(TAG, "Panel is up!");
 }
+
+DISP_DRIVER_REGISTER(jd79653a) = {
+    .name = "JD79653A",
+    .init = jd79653a_init,
+    .flush = jd79653a_lv_fb_flush,
+    .rounder = jd79653a_lv_rounder_cb,
+    .set_px = jd79653a_lv_set_fb_cb,
+};
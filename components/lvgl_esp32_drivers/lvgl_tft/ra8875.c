@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include "ra8875.h"
+#include "disp_driver.h"
 #include "disp_spi.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
@@ -363,3 +364,19 @@ static void ra8875_send_buffer(uint8_t * data, size_t length, bool signal_flush)
                           | (RA8875_MODE_DATA_WRITE);          // Data write mode
     disp_spi_transaction(data, length, flags, NULL, prefix, 0);
 }
+
+static void ra8875_sleep(bool sleep)
+{
+    if (sleep) {
+        ra8875_sleep_in();
+    } else {
+        ra8875_sleep_out();
+    }
+}
+
+DISP_DRIVER_REGISTER(ra8875) = {
+    .name = "RA8875",
+    .init = ra8875_init,
+    .flush = ra8875_flush,
+    .sleep = ra8875_sleep,
+};
@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include "sh1107.h"
+#include "disp_driver.h"
 #include "disp_spi.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
@@ -216,3 +217,21 @@ static void sh1107_send_color(void * data, uint16_t length)
     gpio_set_level(SH1107_DC, 1);   /*Data mode*/
     disp_spi_send_colors(data, length);
 }
+
+static void sh1107_sleep(bool sleep)
+{
+    if (sleep) {
+        sh1107_sleep_in();
+    } else {
+        sh1107_sleep_out();
+    }
+}
+
+DISP_DRIVER_REGISTER(sh1107) = {
+    .name = "SH1107",
+    .init = sh1107_init,
+    .flush = sh1107_flush,
+    .rounder = sh1107_rounder,
+    .set_px = sh1107_set_px_cb,
+    .sleep = sh1107_sleep,
+};
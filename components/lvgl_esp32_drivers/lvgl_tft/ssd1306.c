@@ -19,6 +19,7 @@
 #include "lvgl_i2c_conf.h"
 
 #include "ssd1306.h"
+#include "disp_driver.h"
 
 /*********************
  *      DEFINES
@@ -254,3 +255,21 @@ static uint8_t send_pixels(lv_disp_drv_t *disp_drv, void *color_buffer, size_t b
 
     return ESP_OK == err ? 0 : 1;
 }
+
+static void ssd1306_sleep(bool sleep)
+{
+    if (sleep) {
+        ssd1306_sleep_in();
+    } else {
+        ssd1306_sleep_out();
+    }
+}
+
+DISP_DRIVER_REGISTER(ssd1306) = {
+    .name = "SSD1306",
+    .init = ssd1306_init,
+    .flush = ssd1306_flush,
+    .rounder = ssd1306_rounder,
+    .set_px = ssd1306_set_px_cb,
+    .sleep = ssd1306_sleep,
+};
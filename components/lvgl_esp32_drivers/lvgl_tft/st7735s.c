@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include "st7735s.h"
+#include "disp_driver.h"
 #include "disp_spi.h"
 #include "driver/i2c.h"
 #include "driver/gpio.h"
@@ -38,6 +39,7 @@ static void st7735s_send_cmd(uint8_t cmd);
 static void st7735s_send_data(void * data, uint16_t length);
 static void st7735s_send_color(void * data, uint16_t length);
 static void st7735s_set_orientation(uint8_t orientation);
+static void st7735s_set_madctl(uint8_t madctl);
 static void i2c_master_init();
 static void axp192_write_byte(uint8_t addr, uint8_t data);
 static void axp192_init();
@@ -211,8 +213,15 @@ static void st7735s_set_orientation(uint8_t orientation)
 
     ESP_LOGD(TAG, "0x36 command value: 0x%02X", data[orientation]);
 
+    st7735s_set_madctl(data[orientation]);
+}
+
+static void st7735s_set_madctl(uint8_t madctl)
+{
     st7735s_send_cmd(ST7735_MADCTL);
-    st7735s_send_data((void *) &data[orientation], 1);
+    st7735s_send_data(&madctl, 1);
+
+    disp_driver_madctl_written(madctl);
 }
 
 static void i2c_master_init()
@@ -267,3 +276,21 @@ static void axp192_sleep_out()
 {
 	axp192_write_byte(0x12, 0x4d);
 }
+
+static void st7735s_sleep(bool sleep)
+{
+    if (sleep) {
+        st7735s_sleep_in();
+    } else {
+        st7735s_sleep_out();
+    }
+}
+
+DISP_DRIVER_REGISTER(st7735s) = {
+    .name = "ST7735S",
+    .init = st7735s_init,
+    .flush = st7735s_flush,
+    .sleep = st7735s_sleep,
+    .set_orientation = st7735s_set_orientation,
+    .set_madctl = st7735s_set_madctl,
+};
@@ -11,8 +11,12 @@
 #include "esp_log.h"
 
 #include "st7789.h"
+#include "disp_driver.h"
 
 #include "disp_spi.h"
+#if defined CONFIG_LV_DISP_USE_TE
+#include "disp_te.h"
+#endif
 #include "driver/gpio.h"
 
 /*********************
@@ -33,11 +37,12 @@ typedef struct {
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static bool st7789_probe(void);
 static void st7789_set_orientation(uint8_t orientation);
+static void st7789_set_madctl(uint8_t madctl);
 
 static void st7789_send_cmd(uint8_t cmd);
 static void st7789_send_data(void *data, uint16_t length);
-static void st7789_send_color(void *data, uint16_t length);
 
 /**********************
  *  STATIC VARIABLES
@@ -87,6 +92,24 @@ void st7789_init(void)
         {0, {0}, 0xff},
     };
 
+    const disp_spi_window_t window = {
+        .dc_io = ST7789_DC,
+        .caset = ST7789_CASET,
+        .raset = ST7789_RASET,
+        .ramwr = ST7789_RAMWR,
+#if (CONFIG_LV_TFT_DISPLAY_OFFSETS)
+        .x_offset = CONFIG_LV_TFT_DISPLAY_X_OFFSET,
+        .y_offset = CONFIG_LV_TFT_DISPLAY_Y_OFFSET,
+#elif (LV_HOR_RES_MAX == 240) && (LV_VER_RES_MAX == 240)
+#if (CONFIG_LV_DISPLAY_ORIENTATION_PORTRAIT)
+        .x_offset = 80,
+#elif (CONFIG_LV_DISPLAY_ORIENTATION_LANDSCAPE_INVERTED)
+        .y_offset = 80,
+#endif
+#endif
+    };
+    disp_spi_set_window(&window);
+
     //Initialize non-SPI GPIOs
     gpio_reset_pin(ST7789_DC);
     gpio_set_direction(ST7789_DC, GPIO_MODE_OUTPUT);
@@ -124,6 +147,12 @@ void st7789_init(void)
         cmd++;
     }
 
+#if defined CONFIG_LV_DISP_USE_TE
+    uint8_t te_mode = DISP_TE_MODE_VBLANK;
+    st7789_send_cmd(ST7789_TEON);
+    st7789_send_data(&te_mode, 1);
+#endif
+
     st7789_enable_backlight(true);
 
     st7789_set_orientation(CONFIG_LV_DISPLAY_ORIENTATION);
@@ -150,57 +179,25 @@ void st7789_enable_backlight(bool backlight)
  * account that gap, this is not necessary in all orientations. */
 void st7789_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_map)
 {
-    uint8_t data[4] = {0};
-
-    uint16_t offsetx1 = area->x1;
-    uint16_t offsetx2 = area->x2;
-    uint16_t offsety1 = area->y1;
-    uint16_t offsety2 = area->y2;
-
-#if (CONFIG_LV_TFT_DISPLAY_OFFSETS)
-    offsetx1 += CONFIG_LV_TFT_DISPLAY_X_OFFSET;
-    offsetx2 += CONFIG_LV_TFT_DISPLAY_X_OFFSET;
-    offsety1 += CONFIG_LV_TFT_DISPLAY_Y_OFFSET;
-    offsety2 += CONFIG_LV_TFT_DISPLAY_Y_OFFSET;
-
-#elif (LV_HOR_RES_MAX == 240) && (LV_VER_RES_MAX == 240)
-#if (CONFIG_LV_DISPLAY_ORIENTATION_PORTRAIT)
-    offsetx1 += 80;
-    offsetx2 += 80;
-#elif (CONFIG_LV_DISPLAY_ORIENTATION_LANDSCAPE_INVERTED)
-    offsety1 += 80;
-    offsety2 += 80;
-#endif
-#endif
-
-    /*Column addresses*/
-    st7789_send_cmd(ST7789_CASET);
-    data[0] = (offsetx1 >> 8) & 0xFF;
-    data[1] = offsetx1 & 0xFF;
-    data[2] = (offsetx2 >> 8) & 0xFF;
-    data[3] = offsetx2 & 0xFF;
-    st7789_send_data(data, 4);
-
-    /*Page addresses*/
-    st7789_send_cmd(ST7789_RASET);
-    data[0] = (offsety1 >> 8) & 0xFF;
-    data[1] = offsety1 & 0xFF;
-    data[2] = (offsety2 >> 8) & 0xFF;
-    data[3] = offsety2 & 0xFF;
-    st7789_send_data(data, 4);
-
-    /*Memory write*/
-    st7789_send_cmd(ST7789_RAMWR);
-
     uint32_t size = lv_area_get_width(area) * lv_area_get_height(area);
 
-    st7789_send_color((void*)color_map, size * 2);
-
+    /*Column and row addresses, memory write and the colors, queued as one chain.
+      The panel offsets are added by disp_spi.*/
+    disp_spi_send_window(area->x1, area->y1, area->x2, area->y2, (uint8_t *) color_map, size * 2);
 }
 
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+static bool st7789_probe(void)
+{
+    /* RDDID: manufacturer, version and driver IDs after a dummy clock, 85h 85h 52h */
+    uint8_t id[4] = {0};
+    disp_spi_read_reg(ST7789_DC, ST7789_RDDID, id, 3, 1);
+
+    return (id[0] == 0x85) && (id[2] == 0x52);
+}
+
 static void st7789_send_cmd(uint8_t cmd)
 {
     disp_wait_for_pending_transactions();
@@ -215,13 +212,6 @@ static void st7789_send_data(void * data, uint16_t length)
     disp_spi_send_data(data, length);
 }
 
-static void st7789_send_color(void * data, uint16_t length)
-{
-    disp_wait_for_pending_transactions();
-    gpio_set_level(ST7789_DC, 1);
-    disp_spi_send_colors(data, length);
-}
-
 static void st7789_set_orientation(uint8_t orientation)
 {
     // ESP_ASSERT(orientation < 4);
@@ -243,6 +233,22 @@ static void st7789_set_orientation(uint8_t orientation)
 
     ESP_LOGI(TAG, "0x36 command value: 0x%02X", data[orientation]);
 
+    st7789_set_madctl(data[orientation]);
+}
+
+static void st7789_set_madctl(uint8_t madctl)
+{
     st7789_send_cmd(ST7789_MADCTL);
-    st7789_send_data((void *) &data[orientation], 1);
+    st7789_send_data(&madctl, 1);
+
+    disp_driver_madctl_written(madctl);
 }
+
+DISP_DRIVER_REGISTER(st7789) = {
+    .name = "ST7789",
+    .probe = st7789_probe,
+    .init = st7789_init,
+    .flush = st7789_flush,
+    .set_orientation = st7789_set_orientation,
+    .set_madctl = st7789_set_madctl,
+};
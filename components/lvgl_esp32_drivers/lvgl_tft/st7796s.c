@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include "st7796s.h"
+#include "disp_driver.h"
 #include "disp_spi.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
@@ -34,6 +35,7 @@ typedef struct
  *  STATIC PROTOTYPES
  **********************/
 static void st7796s_set_orientation(uint8_t orientation);
+static void st7796s_set_madctl(uint8_t madctl);
 
 static void st7796s_send_cmd(uint8_t cmd);
 static void st7796s_send_data(void *data, uint16_t length);
@@ -237,6 +239,31 @@ static void st7796s_set_orientation(uint8_t orientation)
 
 	ESP_LOGI(TAG, "0x36 command value: 0x%02X", data[orientation]);
 
+	st7796s_set_madctl(data[orientation]);
+}
+
+static void st7796s_set_madctl(uint8_t madctl)
+{
 	st7796s_send_cmd(0x36);
-	st7796s_send_data((void *)&data[orientation], 1);
+	st7796s_send_data(&madctl, 1);
+
+	disp_driver_madctl_written(madctl);
 }
+
+static void st7796s_sleep(bool sleep)
+{
+    if (sleep) {
+        st7796s_sleep_in();
+    } else {
+        st7796s_sleep_out();
+    }
+}
+
+DISP_DRIVER_REGISTER(st7796s) = {
+    .name = "ST7796S",
+    .init = st7796s_init,
+    .flush = st7796s_flush,
+    .sleep = st7796s_sleep,
+    .set_orientation = st7796s_set_orientation,
+    .set_madctl = st7796s_set_madctl,
+};
@@ -266,3 +266,11 @@ void uc8151d_init()
     uc8151d_panel_init();
     ESP_LOGI(TAG, "Panel initialised");
 }
+
+DISP_DRIVER_REGISTER(uc8151d) = {
+    .name = "UC8151D",
+    .init = uc8151d_init,
+    .flush = uc8151d_lv_fb_flush,
+    .rounder = uc8151d_lv_rounder_cb,
+    .set_px = uc8151d_lv_set_fb_cb,
+};
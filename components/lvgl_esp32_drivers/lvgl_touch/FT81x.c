@@ -14,6 +14,7 @@
 #include <stddef.h>
 
 #include "FT81x.h"
+#include "touch_driver.h"
 
 #include "../lvgl_tft/EVE.h"
 #include "../lvgl_tft/EVE_commands.h"
@@ -80,3 +81,8 @@ void FT81x_read(lv_indev_drv_t * drv, lv_indev_data_t * data)
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+TOUCH_DRIVER_REGISTER(ft81x) = {
+    .name = "FT81x",
+    .read = FT81x_read,
+};
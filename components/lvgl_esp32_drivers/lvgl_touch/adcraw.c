@@ -3,6 +3,7 @@
  */
 
 #include "adcraw.h"
+#include "touch_driver.h"
 #include "esp_system.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
@@ -319,3 +320,9 @@ void adcraw_read(lv_indev_drv_t * drv, lv_indev_data_t * data)
 	}
 }
 #endif //CONFIG_LV_TOUCH_CONTROLLER_ADCRAW
+
+TOUCH_DRIVER_REGISTER(adcraw) = {
+    .name = "ADCRAW",
+    .init = adcraw_init,
+    .read = adcraw_read,
+};
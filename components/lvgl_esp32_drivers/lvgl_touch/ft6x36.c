@@ -26,7 +26,9 @@
 #include <lvgl/lvgl.h>
 #endif
 #include "ft6x36.h"
+#include "touch_driver.h"
 #include "tp_i2c.h"
+#include "i2c_bus.h"
 #include "../lvgl_i2c_conf.h"
 
 #define TAG "FT6X36"
@@ -35,21 +37,20 @@
 ft6x36_status_t ft6x36_status;
 uint8_t current_dev_addr;       // set during init
 
-esp_err_t ft6x06_i2c_read8(uint8_t slave_addr, uint8_t register_addr, uint8_t *data_buf) {
-    i2c_cmd_handle_t i2c_cmd = i2c_cmd_link_create();
-
-    i2c_master_start(i2c_cmd);
-    i2c_master_write_byte(i2c_cmd, (slave_addr << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(i2c_cmd, register_addr, I2C_MASTER_ACK);
-
-    i2c_master_start(i2c_cmd);
-    i2c_master_write_byte(i2c_cmd, (slave_addr << 1) | I2C_MASTER_READ, true);
+/* Touch reads are latency critical, they jump ahead of queued sensor reads on the shared bus. */
+static esp_err_t ft6x36_i2c_read(uint8_t slave_addr, uint8_t register_addr, uint8_t *data_buf, size_t len) {
+    i2c_bus_op_t op = {
+        .address = slave_addr,
+        .p_write = &register_addr,
+        .write_len = 1,
+        .p_read = data_buf,
+        .read_len = len,
+    };
+    return i2c_bus_transfer(TOUCH_I2C_PORT, &op, 1, I2C_BUS_PRIO_HIGH);
+}
 
-    i2c_master_read_byte(i2c_cmd, data_buf, I2C_MASTER_NACK);
-    i2c_master_stop(i2c_cmd);
-    esp_err_t ret = i2c_master_cmd_begin(TOUCH_I2C_PORT, i2c_cmd, 1000 / portTICK_PERIOD_MS);
-    i2c_cmd_link_delete(i2c_cmd);
-    return ret;
+esp_err_t ft6x06_i2c_read8(uint8_t slave_addr, uint8_t register_addr, uint8_t *data_buf) {
+    return ft6x36_i2c_read(slave_addr, register_addr, data_buf, 1);
 }
 
 /**
@@ -119,67 +120,29 @@ void ft6x06_init(uint16_t dev_addr) {
   * @param  data: Store data here
   */
 void ft6x36_read(lv_indev_drv_t *drv, lv_indev_data_t *data) {
-    uint8_t data_xy[4];        // 2 bytes X | 2 bytes Y
-    uint8_t touch_pnt_cnt;        // Number of detected touch points
+    uint8_t data_xy[5];         // touch point count | 2 bytes X | 2 bytes Y
     static int16_t last_x = 0;  // 12bit pixel value
     static int16_t last_y = 0;  // 12bit pixel value
 
-    ft6x06_i2c_read8(current_dev_addr, FT6X36_TD_STAT_REG, &touch_pnt_cnt);
-    if (touch_pnt_cnt != 1) {    // ignore no touch & multi touch
-        data->point.x = last_x;
-        data->point.y = last_y;
-        data->state = LV_INDEV_STATE_REL;
-        return;
-    }
-
-    // Read X value
-    i2c_cmd_handle_t i2c_cmd = i2c_cmd_link_create();
-
-    i2c_master_start(i2c_cmd);
-    i2c_master_write_byte(i2c_cmd, (current_dev_addr << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(i2c_cmd, FT6X36_P1_XH_REG, I2C_MASTER_ACK);
-
-    i2c_master_start(i2c_cmd);
-    i2c_master_write_byte(i2c_cmd, (current_dev_addr << 1) | I2C_MASTER_READ, true);
-
-    i2c_master_read_byte(i2c_cmd, &data_xy[0], I2C_MASTER_ACK);     // reads FT6X36_P1_XH_REG
-    i2c_master_read_byte(i2c_cmd, &data_xy[1], I2C_MASTER_NACK);    // reads FT6X36_P1_XL_REG
-    i2c_master_stop(i2c_cmd);
-    esp_err_t ret = i2c_master_cmd_begin(TOUCH_I2C_PORT, i2c_cmd, 1000 / portTICK_PERIOD_MS);
-    i2c_cmd_link_delete(i2c_cmd);
+    // TD_STAT and the first touch point registers are contiguous, read them in one bus transaction
+    esp_err_t ret = ft6x36_i2c_read(current_dev_addr, FT6X36_TD_STAT_REG, data_xy, sizeof(data_xy));
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Error getting X coordinates: %s", esp_err_to_name(ret));
+        ESP_LOGE(TAG, "Error getting coordinates: %s", esp_err_to_name(ret));
         data->point.x = last_x;
         data->point.y = last_y;
         data->state = LV_INDEV_STATE_REL;   // no touch detected
         return;
     }
 
-    // Read Y value
-    i2c_cmd = i2c_cmd_link_create();
-
-    i2c_master_start(i2c_cmd);
-    i2c_master_write_byte(i2c_cmd, (current_dev_addr << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(i2c_cmd, FT6X36_P1_YH_REG, I2C_MASTER_ACK);
-
-    i2c_master_start(i2c_cmd);
-    i2c_master_write_byte(i2c_cmd, (current_dev_addr << 1) | I2C_MASTER_READ, true);
-
-    i2c_master_read_byte(i2c_cmd, &data_xy[2], I2C_MASTER_ACK);     // reads FT6X36_P1_YH_REG
-    i2c_master_read_byte(i2c_cmd, &data_xy[3], I2C_MASTER_NACK);    // reads FT6X36_P1_YL_REG
-    i2c_master_stop(i2c_cmd);
-    ret = i2c_master_cmd_begin(TOUCH_I2C_PORT, i2c_cmd, 1000 / portTICK_PERIOD_MS);
-    i2c_cmd_link_delete(i2c_cmd);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Error getting Y coordinates: %s", esp_err_to_name(ret));
+    if ((data_xy[0] & FT6X36_TD_STAT_MASK) != 1) {    // ignore no touch & multi touch
         data->point.x = last_x;
         data->point.y = last_y;
-        data->state = LV_INDEV_STATE_REL;   // no touch detected
+        data->state = LV_INDEV_STATE_REL;
         return;
     }
 
-    last_x = ((data_xy[0] & FT6X36_MSB_MASK) << 8) | (data_xy[1] & FT6X36_LSB_MASK);
-    last_y = ((data_xy[2] & FT6X36_MSB_MASK) << 8) | (data_xy[3] & FT6X36_LSB_MASK);
+    last_x = ((data_xy[1] & FT6X36_MSB_MASK) << 8) | (data_xy[2] & FT6X36_LSB_MASK);
+    last_y = ((data_xy[3] & FT6X36_MSB_MASK) << 8) | (data_xy[4] & FT6X36_LSB_MASK);
 
 #if CONFIG_LV_FT6X36_SWAPXY
     int16_t swap_buf = last_x;
@@ -197,3 +160,14 @@ void ft6x36_read(lv_indev_drv_t *drv, lv_indev_data_t *data) {
     data->state = LV_INDEV_STATE_PR;
     ESP_LOGV(TAG, "X=%u Y=%u", data->point.x, data->point.y);
 }
+
+static void ft6x36_init_default(void)
+{
+    ft6x06_init(FT6236_I2C_SLAVE_ADDR);
+}
+
+TOUCH_DRIVER_REGISTER(ft6x36) = {
+    .name = "FT6X06",
+    .init = ft6x36_init_default,
+    .read = ft6x36_read,
+};
@@ -12,6 +12,7 @@
 #include <stddef.h>
 
 #include "ra8875_touch.h"
+#include "touch_driver.h"
 
 #include "../lvgl_tft/ra8875.h"
 
@@ -176,3 +177,9 @@ static void ra8875_corr(int * x, int * y)
     (*y) = (LV_VER_RES-1) - (*y);
 #endif
 }
+
+TOUCH_DRIVER_REGISTER(ra8875_touch) = {
+    .name = "RA8875",
+    .init = ra8875_touch_init,
+    .read = ra8875_touch_read,
+};
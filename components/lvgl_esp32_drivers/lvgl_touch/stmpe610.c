@@ -6,6 +6,7 @@
  *      INCLUDES
  *********************/
 #include "stmpe610.h"
+#include "touch_driver.h"
 #include "esp_system.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
@@ -237,3 +238,8 @@ static void adjust_data(int16_t * x, int16_t * y)
 
 }
 
+TOUCH_DRIVER_REGISTER(stmpe610) = {
+    .name = "STMPE610",
+    .init = stmpe610_init,
+    .read = stmpe610_read,
+};
@@ -6,40 +6,80 @@
 #include "tp_spi.h"
 #include "tp_i2c.h"
 
+#include <string.h>
+
+#include "esp_log.h"
+#include "nvs.h"
+
+#include "../lvgl_tft/disp_driver.h"
+
+#define TAG "touch_driver"
+
+#define TOUCH_DRIVER_NAME_LEN 16
+
+extern const touch_driver_t _touch_driver_desc_start;
+extern const touch_driver_t _touch_driver_desc_end;
+
+static const touch_driver_t *active;
+
+static const touch_driver_t *touch_driver_from_nvs(void);
 
 void touch_driver_init(void)
 {
-#if defined (CONFIG_LV_TOUCH_CONTROLLER_XPT2046)
-    xpt2046_init();
-#elif defined (CONFIG_LV_TOUCH_CONTROLLER_FT6X06)
-    ft6x06_init(FT6236_I2C_SLAVE_ADDR);
-#elif defined (CONFIG_LV_TOUCH_CONTROLLER_STMPE610)
-    stmpe610_init();
-#elif defined (CONFIG_LV_TOUCH_CONTROLLER_ADCRAW)
-    adcraw_init();
-#elif defined (CONFIG_LV_TOUCH_CONTROLLER_FT81X)
-    /* nothing to do */
-#elif defined (CONFIG_LV_TOUCH_CONTROLLER_RA8875)
-    ra8875_touch_init();
-#endif
+    const touch_driver_t *first = &_touch_driver_desc_start;
+    const touch_driver_t *last = &_touch_driver_desc_end;
+
+    if (first == last) {
+        return;
+    }
+
+    active = (last - first == 1) ? first : touch_driver_from_nvs();
+
+    if (active == NULL) {
+        active = first;
+    }
+
+    ESP_LOGI(TAG, "Touch controller: %s", active->name);
+
+    if (active->init) {
+        active->init();
+    }
 }
 
 void touch_driver_read(lv_indev_drv_t *drv, lv_indev_data_t *data)
 {
+    if (active) {
+        active->read(drv, data);
 
-#if defined (CONFIG_LV_TOUCH_CONTROLLER_XPT2046)
-    xpt2046_read(drv, data);
-#elif defined (CONFIG_LV_TOUCH_CONTROLLER_FT6X06)
-    ft6x36_read(drv, data);
-#elif defined (CONFIG_LV_TOUCH_CONTROLLER_STMPE610)
-    stmpe610_read(drv, data);
-#elif defined (CONFIG_LV_TOUCH_CONTROLLER_ADCRAW)
-    adcraw_read(drv, data);
-#elif defined (CONFIG_LV_TOUCH_CONTROLLER_FT81X)
-    FT81x_read(drv, data);
-#elif defined (CONFIG_LV_TOUCH_CONTROLLER_RA8875)
-    ra8875_touch_read(drv, data);
-#endif
-
+        /* Calibrated for the orientation chosen in menuconfig */
+        disp_driver_rotate_point((drv->disp != NULL) ? drv->disp->driver : NULL, &data->point);
+    }
 }
 
+static const touch_driver_t *touch_driver_from_nvs(void)
+{
+    nvs_handle_t nvs;
+    char name[TOUCH_DRIVER_NAME_LEN];
+    size_t length = sizeof(name);
+
+    if (nvs_open(DISP_DRIVER_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return NULL;
+    }
+
+    esp_err_t ret = nvs_get_str(nvs, TOUCH_DRIVER_NVS_KEY, name, &length);
+    nvs_close(nvs);
+
+    if (ret != ESP_OK) {
+        return NULL;
+    }
+
+    for (const touch_driver_t *drv = &_touch_driver_desc_start; drv < &_touch_driver_desc_end; drv++) {
+        if (strcmp(drv->name, name) == 0) {
+            return drv;
+        }
+    }
+
+    ESP_LOGW(TAG, "Controller %s from NVS is not linked in", name);
+
+    return NULL;
+}
@@ -20,30 +20,37 @@ extern "C" {
 #include "lvgl/lvgl.h"
 #endif
 
-#if defined (CONFIG_LV_TOUCH_CONTROLLER_XPT2046)
-#include "xpt2046.h"
-#elif defined (CONFIG_LV_TOUCH_CONTROLLER_FT6X06)
-#include "ft6x36.h"
-#elif defined (CONFIG_LV_TOUCH_CONTROLLER_STMPE610)
-#include "stmpe610.h"
-#elif defined (CONFIG_LV_TOUCH_CONTROLLER_ADCRAW)
-#include "adcraw.h"
-#elif defined (CONFIG_LV_TOUCH_CONTROLLER_FT81X)
-#include "FT81x.h"
-#elif defined (CONFIG_LV_TOUCH_CONTROLLER_RA8875)
-#include "ra8875_touch.h"
-#endif
-
 /*********************
 *      DEFINES
 *********************/
+/* NVS key of the touch controller name, in the display's namespace, see disp_driver.h */
+#define TOUCH_DRIVER_NVS_KEY "touch"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* Touch controller driver, init is NULL if the controller needs none */
+typedef struct {
+    const char *name;
+    void (*init)(void);
+    void (*read)(lv_indev_drv_t *drv, lv_indev_data_t *data);
+} touch_driver_t;
 
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
+/* Picks the controller, from NVS or the first one linked in, and initializes it */
 void touch_driver_init(void);
 void touch_driver_read(lv_indev_drv_t *drv, lv_indev_data_t *data);
 
+/**********************
+ *      MACROS
+ **********************/
+/* Registers a touch controller at link time, as DISP_DRIVER_REGISTER() */
+#define TOUCH_DRIVER_REGISTER(id) \
+    static const touch_driver_t id##_touch_driver \
+        __attribute__((used, aligned(4), section(".touch_driver_desc")))
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include "xpt2046.h"
+#include "touch_driver.h"
 #include "esp_system.h"
 #include "esp_log.h"
 #include "driver/gpio.h"
@@ -215,3 +216,9 @@ static void xpt2046_avg(int16_t * x, int16_t * y)
     (*x) = (int32_t)x_sum / avg_last;
     (*y) = (int32_t)y_sum / avg_last;
 }
+
+TOUCH_DRIVER_REGISTER(xpt2046) = {
+    .name = "XPT2046",
+    .init = xpt2046_init,
+    .read = xpt2046_read,
+};
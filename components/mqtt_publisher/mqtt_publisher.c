@@ -0,0 +1,552 @@
+/**
+ * @file mqtt_publisher.c
+ *
+ * @brief This file decouples producers from the network. Publishing only copies the message into a bounded outbox, so
+ * a sensor loop never waits on the broker. A dedicated task hands messages to the MQTT client with the non-blocking
+ * esp_mqtt_client_enqueue() while the client is connected, keeping at most inflight_max QoS 1 messages unacknowledged,
+ * so the client's own outbox stays small too. When the broker is away the outbox fills up to its byte and message
+ * limits and then drops either the newest or the oldest messages, which keeps memory bounded during any outage.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "mqtt_publisher.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+/* Matches the client's own outbox expiry, a message not acknowledged by then will not be. */
+#define INFLIGHT_TIMEOUT_MS (30000U)
+
+/* Wakeup period while messages are inflight, only needed to expire lost acknowledgements. */
+#define INFLIGHT_CHECK_MS (1000U)
+
+/* Slot reserved for the message being enqueued, its msg_id is not known yet. */
+#define INFLIGHT_RESERVED (-1)
+
+#define RECORD_ALIGN(X) (((X) + 3U) & ~(size_t)3U)
+
+#define MQTT_PUBLISHER_TASK_STACK_SIZE (3U * 1024U)
+/* Below the MQTT client task, which does the actual sending. */
+#define MQTT_PUBLISHER_TASK_PRIORITY (4U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Outbox record header, followed by the NUL terminated topic and the payload.
+ *
+ */
+typedef struct
+{
+    uint16_t size; /* Whole record, aligned. */
+    uint16_t len;  /* Payload. */
+    uint8_t  topic_len;
+    uint8_t  qos;
+} _record_t;
+
+/**
+ * @brief Unacknowledged QoS 1 message.
+ *
+ */
+typedef struct
+{
+    int     msg_id; /* 0 when the slot is free, INFLIGHT_RESERVED while the message is being enqueued. */
+    int64_t sent_us;
+} _inflight_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Publisher task.
+ *
+ * @param [in] p_parameter This is the parameter that is passed to the task.
+ */
+static void _mqtt_publisher_task(void *p_parameter);
+
+/**
+ * @brief Hands outbox messages to the client while the inflight window allows it.
+ */
+static void _outbox_drain(void);
+
+/**
+ * @brief Returns the offset a record of the given size can be written at, or -1 if it does not fit now. Must be
+ * called with the outbox locked.
+ */
+static int32_t _outbox_reserve(size_t size);
+
+/**
+ * @brief Removes the oldest record. Must be called with the outbox locked.
+ */
+static void _outbox_pop(void);
+
+/**
+ * @brief Reserves an inflight slot for the message about to be enqueued.
+ *
+ * @return Slot index, -1 if none is free.
+ */
+static int32_t _inflight_reserve(void);
+
+/**
+ * @brief Records the msg_id of the reserved slot, or frees it if the acknowledgement came first or msg_id is negative.
+ */
+static void _inflight_commit(int32_t slot, int msg_id);
+
+/**
+ * @brief Frees the inflight slot of an acknowledged message, or every slot that timed out if msg_id is 0.
+ */
+static void _inflight_release(int msg_id, int64_t now_us);
+
+/**
+ * @brief Returns the number of used inflight slots.
+ */
+static uint8_t _inflight_count(void);
+
+/**
+ * @brief Client event handler, runs in the MQTT client task.
+ */
+static void _mqtt_event_handler(void *p_arg, esp_event_base_t event_base, int32_t event_id, void *p_event_data);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "MQTT_PUBLISHER";
+
+static mqtt_publisher_config_t  _config;
+static esp_mqtt_client_handle_t p_client         = NULL;
+static TaskHandle_t             p_publisher_task = NULL;
+static SemaphoreHandle_t        p_outbox_mutex   = NULL;
+static bool                     _b_is_started    = false;
+static volatile bool            _b_is_connected  = false;
+
+/* Outbox ring. Records never wrap, a record that does not fit before the end starts at offset 0 and the data region
+ * then ends at _outbox_end. */
+static uint8_t *p_outbox      = NULL;
+static size_t   _outbox_head  = 0U;
+static size_t   _outbox_tail  = 0U;
+static size_t   _outbox_end   = 0U;
+static uint16_t _outbox_count = 0U;
+static size_t   _outbox_bytes = 0U;
+
+/* Private copy of the record being handed over, so the outbox is not locked while the client is. */
+static uint8_t *p_tx_buf = NULL;
+
+static portMUX_TYPE _inflight_lock = portMUX_INITIALIZER_UNLOCKED;
+static _inflight_t  _inflight[MQTT_PUBLISHER_INFLIGHT_MAX];
+/* Acknowledgement without a slot while one is reserved, the client may deliver it before enqueue returns. */
+static int          _inflight_early_ack = 0;
+
+static mqtt_publisher_stats_t _stats;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t mqtt_publisher_init(const mqtt_publisher_config_t *p_config)
+{
+    if((NULL == p_config) || (NULL == p_config->p_broker_uri) || (sizeof(_record_t) >= p_config->outbox_size) ||
+       (UINT16_MAX < p_config->outbox_size) || (0U == p_config->outbox_msgs_max) || (0U == p_config->inflight_max) ||
+       (MQTT_PUBLISHER_INFLIGHT_MAX < p_config->inflight_max) || (MQTT_PUBLISHER_DROP_COUNT <= p_config->policy))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(NULL != p_client)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    _config        = *p_config;
+    _outbox_end    = _config.outbox_size;
+    p_outbox       = malloc(_config.outbox_size);
+    p_tx_buf       = malloc(_config.outbox_size);
+    p_outbox_mutex = xSemaphoreCreateMutex();
+
+    if((NULL == p_outbox) || (NULL == p_tx_buf) || (NULL == p_outbox_mutex))
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    const esp_mqtt_client_config_t mqtt_config = {
+        .broker.address.uri = _config.p_broker_uri,
+    };
+
+    p_client = esp_mqtt_client_init(&mqtt_config);
+    if(NULL == p_client)
+    {
+        return ESP_FAIL;
+    }
+
+    esp_err_t esp_err = esp_mqtt_client_register_event(p_client, ESP_EVENT_ANY_ID, _mqtt_event_handler, NULL);
+
+    if((ESP_OK == esp_err) && (pdPASS != xTaskCreate(&_mqtt_publisher_task, "mqtt_pub_task", MQTT_PUBLISHER_TASK_STACK_SIZE,
+                                                      NULL, MQTT_PUBLISHER_TASK_PRIORITY, &p_publisher_task)))
+    {
+        esp_err = ESP_ERR_NO_MEM;
+    }
+
+    if(ESP_OK != esp_err)
+    {
+        ESP_LOGE(TAG, "Init failed: %s", esp_err_to_name(esp_err));
+    }
+
+    return esp_err;
+}
+
+esp_err_t mqtt_publisher_start(void)
+{
+    if(NULL == p_client)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if(!_b_is_started)
+    {
+        _b_is_started = true;
+        return esp_mqtt_client_start(p_client);
+    }
+
+    /* Fails harmlessly when the client is connected or already connecting. */
+    (void)esp_mqtt_client_reconnect(p_client);
+
+    return ESP_OK;
+}
+
+esp_err_t mqtt_publisher_publish(const char *p_topic, const void *p_payload, size_t len, uint8_t qos)
+{
+    if((NULL == p_topic) || ((NULL == p_payload) && (0U != len)) || (1U < qos))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(NULL == p_outbox_mutex)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    size_t topic_len = strlen(p_topic);
+    size_t size      = RECORD_ALIGN(sizeof(_record_t) + topic_len + 1U + len);
+
+    if((UINT8_MAX < topic_len) || (_config.outbox_size < size))
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    xSemaphoreTake(p_outbox_mutex, portMAX_DELAY);
+
+    int32_t offset = _outbox_reserve(size);
+
+    while((0 > offset) && (MQTT_PUBLISHER_DROP_OLDEST == _config.policy) && (0U < _outbox_count))
+    {
+        _outbox_pop();
+        _stats.dropped++;
+        offset = _outbox_reserve(size);
+    }
+
+    if(0 <= offset)
+    {
+        _record_t *p_record = (_record_t *)&p_outbox[offset];
+        p_record->size      = (uint16_t)size;
+        p_record->len       = (uint16_t)len;
+        p_record->topic_len = (uint8_t)topic_len;
+        p_record->qos       = qos;
+
+        char *p_record_topic = (char *)&p_record[1];
+        (void)memcpy(p_record_topic, p_topic, topic_len + 1U);
+        (void)memcpy(&p_record_topic[topic_len + 1U], p_payload, len);
+
+        _outbox_count++;
+        _outbox_bytes += size;
+        _stats.queued++;
+        _stats.outbox_msgs_peak = (_outbox_count > _stats.outbox_msgs_peak) ? _outbox_count : _stats.outbox_msgs_peak;
+    }
+    else
+    {
+        _stats.dropped++;
+    }
+
+    xSemaphoreGive(p_outbox_mutex);
+
+    if(0 > offset)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    (void)xTaskNotifyGive(p_publisher_task);
+
+    return ESP_OK;
+}
+
+esp_mqtt_client_handle_t mqtt_publisher_get_client(void)
+{
+    return p_client;
+}
+
+void mqtt_publisher_get_stats(mqtt_publisher_stats_t *p_stats)
+{
+    if(NULL != p_stats)
+    {
+        *p_stats                = _stats;
+        p_stats->outbox_msgs    = _outbox_count;
+        p_stats->outbox_bytes   = (uint32_t)_outbox_bytes;
+        p_stats->inflight       = _inflight_count();
+        p_stats->b_is_connected = _b_is_connected;
+    }
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _mqtt_publisher_task(void *p_parameter)
+{
+    for(;;)
+    {
+        /* Woken by new messages, acknowledgements and connects. */
+        (void)ulTaskNotifyTake(pdTRUE, (0U < _inflight_count()) ? pdMS_TO_TICKS(INFLIGHT_CHECK_MS) : portMAX_DELAY);
+
+        _inflight_release(0, esp_timer_get_time());
+
+        if(_b_is_connected)
+        {
+            _outbox_drain();
+        }
+    }
+}
+
+static void _outbox_drain(void)
+{
+    for(;;)
+    {
+        xSemaphoreTake(p_outbox_mutex, portMAX_DELAY);
+
+        const _record_t *p_record = (const _record_t *)&p_outbox[_outbox_tail];
+        bool b_can_send = (0U < _outbox_count) && ((0U == p_record->qos) || (_inflight_count() < _config.inflight_max));
+
+        if(b_can_send)
+        {
+            (void)memcpy(p_tx_buf, p_record, p_record->size);
+            _outbox_pop();
+        }
+
+        xSemaphoreGive(p_outbox_mutex);
+
+        if(!b_can_send)
+        {
+            return;
+        }
+
+        const _record_t *p_tx    = (const _record_t *)p_tx_buf;
+        const char      *p_topic = (const char *)&p_tx[1];
+
+        /* Reserved before the enqueue, the acknowledgement can arrive before the msg_id is returned. */
+        int32_t slot = (0U < p_tx->qos) ? _inflight_reserve() : -1;
+
+        /* Only stores the message, the client task does the sending. */
+        int msg_id = esp_mqtt_client_enqueue(p_client, p_topic, &p_topic[p_tx->topic_len + 1U], p_tx->len, p_tx->qos,
+                                             0, true);
+
+        if(0 <= slot)
+        {
+            _inflight_commit(slot, msg_id);
+        }
+
+        if(0 > msg_id)
+        {
+            xSemaphoreTake(p_outbox_mutex, portMAX_DELAY);
+            _stats.dropped++;
+            xSemaphoreGive(p_outbox_mutex);
+            ESP_LOGW(TAG, "Client rejected a message on %s", p_topic);
+            return;
+        }
+
+        _stats.sent++;
+    }
+}
+
+static int32_t _outbox_reserve(size_t size)
+{
+    if(0U == _outbox_count)
+    {
+        _outbox_head = 0U;
+        _outbox_tail = 0U;
+        _outbox_end  = _config.outbox_size;
+    }
+
+    if(_config.outbox_msgs_max <= _outbox_count)
+    {
+        return -1;
+    }
+
+    if((0U == _outbox_count) || (_outbox_head > _outbox_tail))
+    {
+        if(size <= (_config.outbox_size - _outbox_head))
+        {
+            size_t offset = _outbox_head;
+            _outbox_head += size;
+            return (int32_t)offset;
+        }
+
+        if((0U < _outbox_count) && (size <= _outbox_tail))
+        {
+            /* Wrap, the unused end is not part of the data region until the reader passes it. */
+            _outbox_end  = _outbox_head;
+            _outbox_head = size;
+            return 0;
+        }
+
+        return -1;
+    }
+
+    /* Wrapped, free space lies between head and tail. */
+    if(size <= (_outbox_tail - _outbox_head))
+    {
+        size_t offset = _outbox_head;
+        _outbox_head += size;
+        return (int32_t)offset;
+    }
+
+    return -1;
+}
+
+static void _outbox_pop(void)
+{
+    const _record_t *p_record = (const _record_t *)&p_outbox[_outbox_tail];
+
+    _outbox_bytes -= p_record->size;
+    _outbox_tail += p_record->size;
+    _outbox_count--;
+
+    if(_outbox_tail >= _outbox_end)
+    {
+        _outbox_tail = 0U;
+        _outbox_end  = _config.outbox_size;
+    }
+}
+
+static int32_t _inflight_reserve(void)
+{
+    int32_t reserved = -1;
+
+    portENTER_CRITICAL(&_inflight_lock);
+
+    for(uint8_t slot = 0U; slot < MQTT_PUBLISHER_INFLIGHT_MAX; slot++)
+    {
+        if(0 == _inflight[slot].msg_id)
+        {
+            _inflight[slot].msg_id  = INFLIGHT_RESERVED;
+            _inflight[slot].sent_us = esp_timer_get_time();
+            _inflight_early_ack     = 0;
+            reserved                = (int32_t)slot;
+            break;
+        }
+    }
+
+    portEXIT_CRITICAL(&_inflight_lock);
+
+    return reserved;
+}
+
+static void _inflight_commit(int32_t slot, int msg_id)
+{
+    portENTER_CRITICAL(&_inflight_lock);
+
+    if(0 > msg_id)
+    {
+        _inflight[slot].msg_id = 0;
+    }
+    else if(msg_id == _inflight_early_ack)
+    {
+        _inflight[slot].msg_id = 0;
+        _stats.acked++;
+    }
+    else
+    {
+        _inflight[slot].msg_id = msg_id;
+    }
+
+    _inflight_early_ack = 0;
+
+    portEXIT_CRITICAL(&_inflight_lock);
+}
+
+static void _inflight_release(int msg_id, int64_t now_us)
+{
+    bool b_is_found = false;
+
+    portENTER_CRITICAL(&_inflight_lock);
+
+    for(uint8_t slot = 0U; slot < MQTT_PUBLISHER_INFLIGHT_MAX; slot++)
+    {
+        if((0 == _inflight[slot].msg_id) || (INFLIGHT_RESERVED == _inflight[slot].msg_id))
+        {
+            continue;
+        }
+
+        if(msg_id == _inflight[slot].msg_id)
+        {
+            _inflight[slot].msg_id = 0;
+            _stats.acked++;
+            b_is_found             = true;
+        }
+        else if((0 == msg_id) && ((now_us - _inflight[slot].sent_us) >= (INFLIGHT_TIMEOUT_MS * 1000)))
+        {
+            _inflight[slot].msg_id = 0;
+            _stats.expired++;
+        }
+        else
+        {
+            /* Still waiting. */
+        }
+    }
+
+    if((0 != msg_id) && !b_is_found)
+    {
+        /* Kept for _inflight_commit(), the message it acknowledges may still be reserving its slot. */
+        _inflight_early_ack = msg_id;
+    }
+
+    portEXIT_CRITICAL(&_inflight_lock);
+}
+
+static uint8_t _inflight_count(void)
+{
+    uint8_t count = 0U;
+
+    for(uint8_t slot = 0U; slot < MQTT_PUBLISHER_INFLIGHT_MAX; slot++)
+    {
+        count += (0 != _inflight[slot].msg_id) ? 1U : 0U;
+    }
+
+    return count;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
+static void _mqtt_event_handler(void *p_arg, esp_event_base_t event_base, int32_t event_id, void *p_event_data)
+{
+    esp_mqtt_event_handle_t p_event = (esp_mqtt_event_handle_t)p_event_data;
+
+    switch((esp_mqtt_event_id_t)event_id)
+    {
+        case MQTT_EVENT_CONNECTED:
+            _b_is_connected = true;
+            (void)xTaskNotifyGive(p_publisher_task);
+            break;
+
+        case MQTT_EVENT_DISCONNECTED:
+            /* Unacknowledged messages stay in the client's outbox and are resent after the reconnect. */
+            _b_is_connected = false;
+            break;
+
+        case MQTT_EVENT_PUBLISHED:
+            _inflight_release(p_event->msg_id, esp_timer_get_time());
+            (void)xTaskNotifyGive(p_publisher_task);
+            break;
+
+        default:
+            break;
+    }
+
+    if(NULL != _config.p_event_cb)
+    {
+        _config.p_event_cb(p_event, _config.p_cb_arg);
+    }
+}
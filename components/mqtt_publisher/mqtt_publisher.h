@@ -0,0 +1,142 @@
+/**
+ * @file mqtt_publisher.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __MQTT_PUBLISHER_C__
+#define __MQTT_PUBLISHER_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include "mqtt_client.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+/* Upper bound for the configurable QoS 1 inflight window. */
+#define MQTT_PUBLISHER_INFLIGHT_MAX (8U)
+
+/**
+ * @brief Default configuration: 8 KiB / 32 message outbox, 4 unacknowledged QoS 1 messages, newest dropped.
+ *
+ */
+#define MQTT_PUBLISHER_CONFIG_DEFAULT()                                                                              \
+    {                                                                                                                \
+        .p_broker_uri = NULL, .outbox_size = 8U * 1024U, .outbox_msgs_max = 32U, .inflight_max = 4U,                \
+        .policy = MQTT_PUBLISHER_DROP_NEWEST, .p_event_cb = NULL, .p_cb_arg = NULL,                                  \
+    }
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Enums hold what happens to a message that does not fit into the outbox.
+ *
+ */
+typedef enum
+{
+    MQTT_PUBLISHER_DROP_NEWEST, /* The new message is rejected, e.g. when the caller keeps its own backlog. */
+    MQTT_PUBLISHER_DROP_OLDEST, /* Oldest messages are evicted until the new one fits. */
+
+    MQTT_PUBLISHER_DROP_COUNT
+} mqtt_publisher_policy_t;
+
+/**
+ * @brief Callback invoked for every MQTT client event. It runs in the MQTT client task.
+ *
+ * @param [in] p_event Client event.
+ * @param [in] p_arg   User argument from the config.
+ */
+typedef void (*mqtt_publisher_event_cb_t)(esp_mqtt_event_handle_t p_event, void *p_arg);
+
+/**
+ * @brief Publisher configuration.
+ *
+ */
+typedef struct
+{
+    const char               *p_broker_uri;
+    size_t                    outbox_size;     /* Bytes of topics and payloads held while the broker is unreachable. */
+    uint16_t                  outbox_msgs_max;
+    uint8_t                   inflight_max;    /* Unacknowledged QoS 1 messages, up to MQTT_PUBLISHER_INFLIGHT_MAX. */
+    mqtt_publisher_policy_t   policy;
+    mqtt_publisher_event_cb_t p_event_cb;      /* Optional. */
+    void                     *p_cb_arg;        /* Optional. */
+} mqtt_publisher_config_t;
+
+/**
+ * @brief Publisher counters.
+ *
+ */
+typedef struct
+{
+    uint32_t queued;
+    uint32_t sent;     /* Handed over to the client. */
+    uint32_t acked;    /* QoS 1 messages acknowledged by the broker. */
+    uint32_t dropped;  /* Rejected or evicted by the outbox policy. */
+    uint32_t expired;  /* QoS 1 messages never acknowledged. */
+    uint16_t outbox_msgs;
+    uint16_t outbox_msgs_peak;
+    uint32_t outbox_bytes;
+    uint8_t  inflight;
+    bool     b_is_connected;
+} mqtt_publisher_stats_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function allocates the outbox, creates the MQTT client and starts the task that moves messages from the
+ * outbox to the client. The client connects on mqtt_publisher_start().
+ *
+ * @param [in] p_config Publisher configuration.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t mqtt_publisher_init(const mqtt_publisher_config_t *p_config);
+
+/**
+ * @brief The function connects the client on the first call and reconnects right away, skipping the client's
+ * reconnect timeout, on later calls. Meant to be called whenever the network comes up.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t mqtt_publisher_start(void);
+
+/**
+ * @brief The function copies a message into the outbox and returns without touching the network. It can be called
+ * before the client is connected.
+ *
+ * @param [in] p_topic   Topic.
+ * @param [in] p_payload Payload.
+ * @param [in] len       Payload length in bytes.
+ * @param [in] qos       0 or 1.
+ *
+ * @return esp_err_t ESP_OK if queued, ESP_ERR_NO_MEM if rejected by the outbox policy, fail otherwise.
+ */
+esp_err_t mqtt_publisher_publish(const char *p_topic, const void *p_payload, size_t len, uint8_t qos);
+
+/**
+ * @brief The function returns the client handle, e.g. for subscriptions, or NULL before init.
+ *
+ * @return esp_mqtt_client_handle_t Client handle.
+ */
+esp_mqtt_client_handle_t mqtt_publisher_get_client(void);
+
+/**
+ * @brief The function copies current publisher counters.
+ *
+ * @param [out] p_stats Destination for the counters.
+ */
+void mqtt_publisher_get_stats(mqtt_publisher_stats_t *p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __MQTT_PUBLISHER_C__
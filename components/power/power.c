@@ -0,0 +1,294 @@
+/**
+ * @file power.c
+ *
+ * @brief This file selects between the performance and the low power operating mode. In low power mode the CPU clock
+ * scales down and the chip light-sleeps whenever all tasks are blocked, while the sensors keep filling the telemetry
+ * ring. The radio, the largest consumer by far, is turned on only once per period to flush what was collected and is
+ * turned off again as soon as the flush is done. Time is accounted per power state so the effect can be checked
+ * against a current meter. The average current in the report is only an estimate from typical per-state currents,
+ * how long the CPU actually light-slept is measured by esp_pm with CONFIG_PM_PROFILING only.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "power.h"
+#include "wifi_manager.h"
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define POWER_CPU_FREQ_MAX_MHZ (160)
+/* XTAL frequency, the lowest the APB can run at while Wi-Fi is on. */
+#define POWER_CPU_FREQ_MIN_MHZ (40)
+
+/* How often the flush callback is polled while the radio is on. */
+#define POWER_FLUSH_POLL_MS (100U)
+/* Radio stays on this much longer after the flush, so QoS 1 acknowledgements can come in. */
+#define POWER_FLUSH_LINGER_MS (300U)
+
+/* Typical ESP32 module currents, only used to estimate the average. Calibrate against a meter. */
+#define POWER_CURRENT_RADIO_ON_UA  (45000U)
+#define POWER_CURRENT_RADIO_OFF_UA (2500U)
+
+#define POWER_TASK_STACK_SIZE (2U * 1024U)
+#define POWER_TASK_PRIORITY   (3U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Duty-cycles the radio in low power mode.
+ *
+ * @param [in] p_parameter This is the parameter that is passed to the task.
+ */
+static void _power_task(void *p_parameter);
+
+/**
+ * @brief Keeps the radio on until the flush callback reports everything sent or the window ends.
+ */
+static void _flush_window(void);
+
+/**
+ * @brief Turns the radio on or off and, once the Wi-Fi manager took the request, accounts the elapsed time to the
+ * state that ends.
+ *
+ * @return esp_err_t ESP_OK if the state was applied, fail otherwise.
+ */
+static esp_err_t _state_set(power_state_t state);
+
+/**
+ * @brief Enables DFS and automatic light sleep.
+ */
+static esp_err_t _pm_configure(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "POWER";
+
+static const uint32_t _state_current_ua[POWER_STATE_COUNT] = {
+    [POWER_STATE_RADIO_ON]  = POWER_CURRENT_RADIO_ON_UA,
+    [POWER_STATE_RADIO_OFF] = POWER_CURRENT_RADIO_OFF_UA,
+};
+
+static const char *const _state_name[POWER_STATE_COUNT] = {
+    [POWER_STATE_RADIO_ON]  = "radio on",
+    [POWER_STATE_RADIO_OFF] = "radio off",
+};
+
+static power_config_t _config;
+static TaskHandle_t   p_power_task = NULL;
+
+static portMUX_TYPE  _report_lock    = portMUX_INITIALIZER_UNLOCKED;
+static power_state_t _state          = POWER_STATE_RADIO_ON;
+static int64_t       _state_since_us = 0;
+static uint64_t      _state_us[POWER_STATE_COUNT];
+static uint32_t      _radio_wakeups  = 0U;
+static uint32_t      _last_window_ms = 0U;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t power_init(const power_config_t *p_config)
+{
+    if((NULL == p_config) || (POWER_MODE_COUNT <= p_config->mode) ||
+       ((POWER_MODE_LOW_POWER == p_config->mode) && ((0U == p_config->radio_period_ms) || (0U == p_config->radio_window_ms))))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(NULL != p_power_task)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    _config         = *p_config;
+    _state_since_us = esp_timer_get_time();
+
+    if(POWER_MODE_PERFORMANCE == _config.mode)
+    {
+        /* Radio on for good, nothing to schedule. */
+        return ESP_OK;
+    }
+
+    esp_err_t esp_err = _pm_configure();
+
+    if(ESP_OK == esp_err)
+    {
+        /* Modem wakes only for DTIM beacons, light sleep needs it to sleep at all. */
+        esp_err = esp_wifi_set_ps(WIFI_PS_MIN_MODEM);
+    }
+
+    if((ESP_OK == esp_err) &&
+       (pdPASS != xTaskCreate(&_power_task, "power_task", POWER_TASK_STACK_SIZE, NULL, POWER_TASK_PRIORITY, &p_power_task)))
+    {
+        esp_err = ESP_ERR_NO_MEM;
+    }
+
+    if(ESP_OK != esp_err)
+    {
+        ESP_LOGE(TAG, "Init failed: %s", esp_err_to_name(esp_err));
+    }
+
+    return esp_err;
+}
+
+void power_get_report(power_report_t *p_report)
+{
+    if(NULL == p_report)
+    {
+        return;
+    }
+
+    int64_t  now_us   = esp_timer_get_time();
+    uint64_t total_ms = 0U;
+    uint64_t charge   = 0U; /* uA * ms */
+
+    portENTER_CRITICAL(&_report_lock);
+
+    for(uint8_t state = 0U; state < POWER_STATE_COUNT; state++)
+    {
+        uint64_t state_us = _state_us[state] + ((state == _state) ? (uint64_t)(now_us - _state_since_us) : 0U);
+
+        p_report->state_ms[state] = state_us / 1000U;
+        total_ms += p_report->state_ms[state];
+        charge += p_report->state_ms[state] * _state_current_ua[state];
+    }
+
+    p_report->mode           = _config.mode;
+    p_report->radio_wakeups  = _radio_wakeups;
+    p_report->last_window_ms = _last_window_ms;
+
+    portEXIT_CRITICAL(&_report_lock);
+
+    p_report->est_current_ua = (0U < total_ms) ? (uint32_t)(charge / total_ms) : 0U;
+}
+
+void power_report_print(void)
+{
+    power_report_t report;
+    power_get_report(&report);
+
+    uint64_t total_ms = 0U;
+    for(uint8_t state = 0U; state < POWER_STATE_COUNT; state++)
+    {
+        total_ms += report.state_ms[state];
+    }
+
+    printf("Power report, %s mode:\n", (POWER_MODE_LOW_POWER == report.mode) ? "low power" : "performance");
+
+    for(uint8_t state = 0U; state < POWER_STATE_COUNT; state++)
+    {
+        printf("  %-10s %10llu ms %5.1f %%\n", _state_name[state], (unsigned long long)report.state_ms[state],
+               (0U < total_ms) ? (100.0f * (float)report.state_ms[state] / (float)total_ms) : 0.0f);
+    }
+
+    printf("  %lu radio wakeups, last window %lu ms\n", (unsigned long)report.radio_wakeups,
+           (unsigned long)report.last_window_ms);
+    printf("  ~%lu uA average, estimated from typical per-state currents\n", (unsigned long)report.est_current_ua);
+
+#if CONFIG_PM_PROFILING
+    /* Time per CPU frequency and light sleep, as measured by esp_pm itself. */
+    (void)esp_pm_dump_locks(stdout);
+#else
+    printf("  Light sleep and CPU frequency time not measured, enable CONFIG_PM_PROFILING\n");
+#endif
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _power_task(void *p_parameter)
+{
+    for(;;)
+    {
+        /* The radio is on at boot, so the task starts with a flush window. A state the Wi-Fi manager did not take
+         * is retried on the next pass, the accounting always follows the radio. */
+        if(POWER_STATE_RADIO_ON == _state)
+        {
+            _flush_window();
+            (void)_state_set(POWER_STATE_RADIO_OFF);
+        }
+
+        if(POWER_STATE_RADIO_OFF == _state)
+        {
+            /* Sensors keep filling the telemetry ring meanwhile. */
+            vTaskDelay(pdMS_TO_TICKS(_config.radio_period_ms));
+            (void)_state_set(POWER_STATE_RADIO_ON);
+        }
+    }
+}
+
+static void _flush_window(void)
+{
+    int64_t  window_start_us = esp_timer_get_time();
+    uint32_t elapsed_ms      = 0U;
+
+    while((elapsed_ms < _config.radio_window_ms) &&
+          ((NULL == _config.p_is_flushed_cb) || !_config.p_is_flushed_cb(_config.p_cb_arg)))
+    {
+        vTaskDelay(pdMS_TO_TICKS(POWER_FLUSH_POLL_MS));
+        elapsed_ms += POWER_FLUSH_POLL_MS;
+    }
+
+    if(elapsed_ms < _config.radio_window_ms)
+    {
+        vTaskDelay(pdMS_TO_TICKS(POWER_FLUSH_LINGER_MS));
+    }
+    else
+    {
+        ESP_LOGW(TAG, "Flush did not finish within %lu ms", (unsigned long)_config.radio_window_ms);
+    }
+
+    portENTER_CRITICAL(&_report_lock);
+    _last_window_ms = (uint32_t)((esp_timer_get_time() - window_start_us) / 1000);
+    portEXIT_CRITICAL(&_report_lock);
+}
+
+static esp_err_t _state_set(power_state_t state)
+{
+    esp_err_t esp_err = wifi_manager_set_radio(POWER_STATE_RADIO_ON == state);
+
+    if(ESP_OK != esp_err)
+    {
+        ESP_LOGW(TAG, "Radio stays %s: %s", _state_name[_state], esp_err_to_name(esp_err));
+        return esp_err;
+    }
+
+    int64_t now_us = esp_timer_get_time();
+
+    portENTER_CRITICAL(&_report_lock);
+
+    _state_us[_state] += (uint64_t)(now_us - _state_since_us);
+    _state_since_us = now_us;
+    _state          = state;
+    _radio_wakeups += (POWER_STATE_RADIO_ON == state) ? 1U : 0U;
+
+    portEXIT_CRITICAL(&_report_lock);
+
+    return ESP_OK;
+}
+
+static esp_err_t _pm_configure(void)
+{
+#if CONFIG_PM_ENABLE
+    esp_pm_config_esp32_t pm_config = {
+        .max_freq_mhz = POWER_CPU_FREQ_MAX_MHZ,
+        .min_freq_mhz = POWER_CPU_FREQ_MIN_MHZ,
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+        .light_sleep_enable = true,
+#endif
+    };
+
+    return esp_pm_configure(&pm_config);
+#else
+    /* The radio is still duty-cycled, only the CPU keeps its clock. */
+    ESP_LOGW(TAG, "CONFIG_PM_ENABLE is not set, DFS and light sleep are not available");
+    return ESP_OK;
+#endif
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
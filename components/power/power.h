@@ -0,0 +1,113 @@
+/**
+ * @file power.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __POWER_C__
+#define __POWER_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Enums hold operating modes.
+ *
+ */
+typedef enum
+{
+    POWER_MODE_PERFORMANCE, /* Fixed CPU clock, radio always on. */
+    POWER_MODE_LOW_POWER,   /* DFS, light sleep, DTIM modem sleep and a duty-cycled radio. */
+
+    POWER_MODE_COUNT
+} power_mode_t;
+
+/**
+ * @brief Enums hold power states time is accounted to.
+ *
+ */
+typedef enum
+{
+    POWER_STATE_RADIO_ON,  /* Connecting or flushing, modem sleeps between DTIM beacons. */
+    POWER_STATE_RADIO_OFF, /* Only sensors run, the CPU light-sleeps when idle. */
+
+    POWER_STATE_COUNT
+} power_state_t;
+
+/**
+ * @brief Callback polled while the radio is on. Returning true ends the radio window early.
+ *
+ * @param [in] p_arg User argument from the config.
+ *
+ * @return true once everything buffered was sent.
+ */
+typedef bool (*power_is_flushed_cb_t)(void *p_arg);
+
+/**
+ * @brief Power manager configuration.
+ *
+ */
+typedef struct
+{
+    power_mode_t          mode;
+    uint32_t              radio_period_ms; /* Low power only: the radio is turned on this often. */
+    uint32_t              radio_window_ms; /* Low power only: longest the radio stays on per wakeup. */
+    power_is_flushed_cb_t p_is_flushed_cb; /* Optional, without it every window lasts radio_window_ms. */
+    void                 *p_cb_arg;        /* Optional. */
+} power_config_t;
+
+/**
+ * @brief Time spent per power state since boot.
+ *
+ */
+typedef struct
+{
+    power_mode_t mode;
+    uint64_t     state_ms[POWER_STATE_COUNT];
+    uint32_t     radio_wakeups;
+    uint32_t     last_window_ms; /* How long the radio stayed on during the last wakeup. */
+    uint32_t     est_current_ua; /* Average, estimated from state times and typical per-state currents, not measured. */
+} power_report_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function applies the operating mode. In low power mode it enables DFS and automatic light sleep, puts
+ * the modem to DTIM sleep and starts the task that turns the radio on only to flush telemetry. Wi-Fi manager must be
+ * initialized before.
+ *
+ * @param [in] p_config Power manager configuration.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t power_init(const power_config_t *p_config);
+
+/**
+ * @brief The function fills the time spent per power state, including the state currently active.
+ *
+ * @param [out] p_report Destination for the report.
+ */
+void power_get_report(power_report_t *p_report);
+
+/**
+ * @brief The function prints the report to the console, together with the esp_pm per-mode profile when
+ * CONFIG_PM_PROFILING is enabled.
+ */
+void power_report_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __POWER_C__
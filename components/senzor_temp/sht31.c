@@ -0,0 +1,322 @@
+/**
+ * @file sht31.c
+ *
+ * @brief This file is the SHT31 temperature and humidity sensor driver. The sensor runs in periodic acquisition mode
+ * and an esp_timer queues a fetch on the shared I2C bus for each finished measurement, so nobody ever waits for a
+ * conversion inside the driver.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "sht31.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdbool.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define SHT31_CMD_FETCH_DATA (0xE000U)
+#define SHT31_CMD_BREAK      (0x3093U)
+#define SHT31_CMD_SOFT_RESET (0x30A2U)
+
+#define SHT31_DATA_SIZE (6U)
+
+/* Time the sensor needs to return to idle after a break or soft reset command. */
+#define SHT31_IDLE_DELAY_MS (2U)
+
+#define SHT31_CRC_POLYNOMIAL (0x31U)
+#define SHT31_CRC_INIT       (0xFFU)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Periodic mode command and matching fetch period.
+ *
+ */
+typedef struct
+{
+    uint16_t command;
+    uint32_t period_ms;
+} _sht31_rate_info_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Writes one 16 bit command to the sensor.
+ */
+static esp_err_t _write_command(uint16_t command);
+
+/**
+ * @brief Checks CRCs and converts raw fetch data into a sample.
+ */
+static esp_err_t _decode(const uint8_t *p_data, sht31_sample_t *p_sample);
+
+/**
+ * @brief Checks the CRC of one 16 bit word followed by its CRC byte.
+ */
+static bool _is_crc_valid(const uint8_t *p_data);
+
+/**
+ * @brief Periodic fetch timer callback. It only queues the fetch on the bus.
+ *
+ * @param [in] p_arg The argument of the timer.
+ */
+static void _fetch_timer_cb(void *p_arg);
+
+/**
+ * @brief Completion of the queued fetch, runs in the I2C bus task.
+ */
+static void _fetch_done_cb(esp_err_t result, void *p_arg);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "SHT31";
+
+/* High repeatability commands, see the datasheet table "Measurement Commands for Periodic Data Acquisition Mode". */
+static const _sht31_rate_info_t _rate_info[SHT31_RATE_COUNT] = {
+    [SHT31_RATE_0_5_MPS] = { .command = 0x2032U, .period_ms = 2000U },
+    [SHT31_RATE_1_MPS]   = { .command = 0x2130U, .period_ms = 1000U },
+    [SHT31_RATE_2_MPS]   = { .command = 0x2236U, .period_ms = 500U },
+    [SHT31_RATE_4_MPS]   = { .command = 0x2334U, .period_ms = 250U },
+    [SHT31_RATE_10_MPS]  = { .command = 0x2737U, .period_ms = 100U },
+    [SHT31_RATE_ART]     = { .command = 0x2B32U, .period_ms = 250U },
+};
+
+static const uint8_t _fetch_command[2] = { (uint8_t)(SHT31_CMD_FETCH_DATA >> 8), (uint8_t)(SHT31_CMD_FETCH_DATA & 0xFFU) };
+
+static sht31_config_t     _config;
+static bool               _b_is_initialized = false;
+static esp_timer_handle_t p_fetch_timer     = NULL;
+
+/* Buffer of the queued fetch, owned by the bus task while _b_fetch_pending is set. */
+static uint8_t       _fetch_data[SHT31_DATA_SIZE];
+static volatile bool _b_fetch_pending = false;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t sht31_init(const sht31_config_t *p_config)
+{
+    if((NULL == p_config) || (SHT31_RATE_COUNT <= p_config->rate))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(_b_is_initialized)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    _config = *p_config;
+
+    esp_err_t esp_err = i2c_bus_init(_config.port, &_config.bus);
+
+    if(ESP_OK == esp_err)
+    {
+        /* The sensor may still be in periodic mode after a warm reset of the MCU. */
+        (void)_write_command(SHT31_CMD_SOFT_RESET);
+        vTaskDelay(pdMS_TO_TICKS(SHT31_IDLE_DELAY_MS) + 1U);
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        const esp_timer_create_args_t timer_args = { .callback = &_fetch_timer_cb, .name = "sht31_fetch" };
+        esp_err                                  = esp_timer_create(&timer_args, &p_fetch_timer);
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        _b_is_initialized = true;
+        esp_err           = sht31_set_rate(_config.rate);
+    }
+
+    if(ESP_OK != esp_err)
+    {
+        ESP_LOGE(TAG, "Init failed: %s", esp_err_to_name(esp_err));
+    }
+
+    return esp_err;
+}
+
+esp_err_t sht31_deinit(void)
+{
+    if(!_b_is_initialized)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    (void)esp_timer_stop(p_fetch_timer);
+
+    /* Let a fetch that is already queued finish before its buffer goes away. */
+    while(_b_fetch_pending)
+    {
+        vTaskDelay(1U);
+    }
+
+    (void)esp_timer_delete(p_fetch_timer);
+    p_fetch_timer     = NULL;
+    _b_is_initialized = false;
+
+    return _write_command(SHT31_CMD_BREAK);
+}
+
+esp_err_t sht31_set_rate(sht31_rate_t rate)
+{
+    if(SHT31_RATE_COUNT <= rate)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(!_b_is_initialized)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    (void)esp_timer_stop(p_fetch_timer);
+
+    /* A new periodic command is only accepted from idle state. */
+    esp_err_t esp_err = _write_command(SHT31_CMD_BREAK);
+    vTaskDelay(pdMS_TO_TICKS(SHT31_IDLE_DELAY_MS) + 1U);
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = _write_command(_rate_info[rate].command);
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        _config.rate = rate;
+        esp_err      = esp_timer_start_periodic(p_fetch_timer, _rate_info[rate].period_ms * 1000U);
+    }
+
+    return esp_err;
+}
+
+esp_err_t sht31_fetch(sht31_sample_t *p_sample)
+{
+    if(NULL == p_sample)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(!_b_is_initialized)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint8_t      data[SHT31_DATA_SIZE];
+    i2c_bus_op_t op = {
+        .address   = _config.address,
+        .p_write   = _fetch_command,
+        .write_len = sizeof(_fetch_command),
+        .p_read    = data,
+        .read_len  = sizeof(data),
+    };
+
+    esp_err_t esp_err = i2c_bus_transfer(_config.port, &op, 1U, I2C_BUS_PRIO_NORMAL);
+
+    if(ESP_FAIL == esp_err)
+    {
+        /* The sensor NACKs the read header when no new measurement is available. */
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    return (ESP_OK == esp_err) ? _decode(data, p_sample) : esp_err;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static esp_err_t _write_command(uint16_t command)
+{
+    uint8_t      data[2] = { (uint8_t)(command >> 8), (uint8_t)(command & 0xFFU) };
+    i2c_bus_op_t op      = { .address = _config.address, .p_write = data, .write_len = sizeof(data) };
+
+    return i2c_bus_transfer(_config.port, &op, 1U, I2C_BUS_PRIO_LOW);
+}
+
+static esp_err_t _decode(const uint8_t *p_data, sht31_sample_t *p_sample)
+{
+    if(!_is_crc_valid(&p_data[0]) || !_is_crc_valid(&p_data[3]))
+    {
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    uint16_t raw_temp = (uint16_t)((p_data[0] << 8) | p_data[1]);
+    uint16_t raw_humi = (uint16_t)((p_data[3] << 8) | p_data[4]);
+
+    p_sample->temp         = -45.0f + (175.0f * (float)raw_temp / 65535.0f);
+    p_sample->humi         = 100.0f * (float)raw_humi / 65535.0f;
+    p_sample->timestamp_ms = (uint32_t)(esp_timer_get_time() / 1000);
+
+    return ESP_OK;
+}
+
+static bool _is_crc_valid(const uint8_t *p_data)
+{
+    uint8_t crc = SHT31_CRC_INIT;
+
+    for(uint8_t i = 0U; i < 2U; i++)
+    {
+        crc ^= p_data[i];
+        for(uint8_t bit = 0U; bit < 8U; bit++)
+        {
+            crc = (crc & 0x80U) ? (uint8_t)((crc << 1) ^ SHT31_CRC_POLYNOMIAL) : (uint8_t)(crc << 1);
+        }
+    }
+
+    return crc == p_data[2];
+}
+
+static void _fetch_timer_cb(void *p_arg)
+{
+    (void)p_arg;
+
+    if(_b_fetch_pending)
+    {
+        /* The bus is congested, skip this period instead of piling up fetches. */
+        return;
+    }
+
+    i2c_bus_transaction_t trans = {
+        .ops = { {
+            .address   = _config.address,
+            .p_write   = _fetch_command,
+            .write_len = sizeof(_fetch_command),
+            .p_read    = _fetch_data,
+            .read_len  = sizeof(_fetch_data),
+        } },
+        .op_count  = 1U,
+        .prio      = I2C_BUS_PRIO_NORMAL,
+        .p_done_cb = _fetch_done_cb,
+        .p_arg     = NULL,
+    };
+
+    _b_fetch_pending = true;
+
+    if(ESP_OK != i2c_bus_submit(_config.port, &trans))
+    {
+        _b_fetch_pending = false;
+    }
+}
+
+static void _fetch_done_cb(esp_err_t result, void *p_arg)
+{
+    (void)p_arg;
+
+    sht31_sample_t sample;
+
+    if((ESP_OK == result) && (ESP_OK == _decode(_fetch_data, &sample)))
+    {
+        if(NULL != _config.p_sample_cb)
+        {
+            _config.p_sample_cb(&sample, _config.p_cb_arg);
+        }
+
+        if(NULL != _config.p_sample_queue)
+        {
+            (void)xQueueSend(_config.p_sample_queue, &sample, 0U);
+        }
+    }
+
+    _b_fetch_pending = false;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -1,100 +1,133 @@
-#include "esp_log.h"
-#include "driver/i2c.h"
+/**
+ * @file sht31.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
 
-static i2c_port_t i2c_port = I2C_NUM_0;
+#ifndef __SHT31_C__
+#define __SHT31_C__
 
-#define SDA_IO_NUM 22;
-#define SCL_IO_NUM 21;
+#ifdef __cplusplus
+extern "C" {
+#endif
 
-#define I2C_MASTER_TX_BUF_DISABLE 0
-#define I2C_MASTER_RX_BUF_DISABLE 0
-#define WRITE_BIT                 I2C_MASTER_WRITE
-#define READ_BIT                  I2C_MASTER_READ
-#define ACK_CHECK_EN              0x1
-#define ACK_CHECK_DIS             0x0
-#define ACK_VAL                   0x0
-#define NACK_VAL                  0x1
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include "i2c_bus.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include <stdint.h>
 
-static esp_err_t sht31_init(void)
+//---------------------------------- MACROS -----------------------------------
+#define SHT31_I2C_ADDRESS_DEFAULT (0x44U)
+
+#define SHT31_BUS_SPEED_100KHZ (100000U)
+#define SHT31_BUS_SPEED_400KHZ (400000U)
+
+/**
+ * @brief Default configuration of the board sensor: I2C_NUM_0 on SDA 22 / SCL 21, 400 kHz, 1 measurement per second.
+ *
+ */
+#define SHT31_CONFIG_DEFAULT()                                                                                       \
+    {                                                                                                                \
+        .port = I2C_NUM_0, .bus = { .sda_io = 22, .scl_io = 21, .clk_speed_hz = SHT31_BUS_SPEED_400KHZ },           \
+        .address = SHT31_I2C_ADDRESS_DEFAULT, .rate = SHT31_RATE_1_MPS, .p_sample_cb = NULL, .p_cb_arg = NULL,       \
+        .p_sample_queue = NULL,                                                                                      \
+    }
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Enums hold periodic acquisition rates (measurements per second).
+ *
+ */
+typedef enum
 {
-    i2c_config_t conf;
-    conf.mode             = I2C_MODE_MASTER;
-    conf.sda_io_num       = SDA_IO_NUM;
-    conf.sda_pullup_en    = GPIO_PULLUP_ENABLE;
-    conf.scl_io_num       = SCL_IO_NUM;
-    conf.scl_pullup_en    = GPIO_PULLUP_ENABLE;
-    conf.master.clk_speed = 10000;
-    i2c_param_config(i2c_port, &conf);
-    return i2c_driver_install(i2c_port, conf.mode, I2C_MASTER_RX_BUF_DISABLE, I2C_MASTER_TX_BUF_DISABLE, 0);
-}
+    SHT31_RATE_0_5_MPS,
+    SHT31_RATE_1_MPS,
+    SHT31_RATE_2_MPS,
+    SHT31_RATE_4_MPS,
+    SHT31_RATE_10_MPS,
+    SHT31_RATE_ART, /* Accelerated response time, 4 measurements per second. */
+
+    SHT31_RATE_COUNT
+} sht31_rate_t;
 
-static uint8_t sht31_crc(uint8_t *data)
+/**
+ * @brief One measurement.
+ *
+ */
+typedef struct
 {
+    float    temp;         /* Degrees Celsius. */
+    float    humi;         /* Relative humidity in percent. */
+    uint32_t timestamp_ms; /* Milliseconds since boot when the sample was fetched. */
+} sht31_sample_t;
 
-    uint8_t crc = 0xff;
-    int     i, j;
-    for(i = 0; i < 2; i++)
-    {
-        crc ^= data[i];
-        for(j = 0; j < 8; j++)
-        {
-            if(crc & 0x80)
-            {
-                crc <<= 1;
-                crc ^= 0x131;
-            }
-            else
-                crc <<= 1;
-        }
-    }
-    return crc;
-}
+/**
+ * @brief Callback invoked for every fetched sample. It runs in the I2C bus task and must not block.
+ *
+ * @param [in] p_sample Fetched sample.
+ * @param [in] p_arg    User argument from the config.
+ */
+typedef void (*sht31_sample_cb_t)(const sht31_sample_t *p_sample, void *p_arg);
 
-static esp_err_t sht31_read_temp_humi(float *temp, float *humi)
+/**
+ * @brief Driver configuration.
+ *
+ */
+typedef struct
 {
-    // See http://wiki.seeedstudio.com/Grove-TempAndHumi_Sensor-SHT31/
-    // Write 0x00 to address 0x24
-    unsigned char    data_wr[] = { 0x24, 0x00 };
-    i2c_cmd_handle_t cmd       = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (0x44 << 1) | WRITE_BIT, ACK_CHECK_EN);
-    i2c_master_write(cmd, data_wr, sizeof(data_wr), ACK_CHECK_EN);
-    i2c_master_stop(cmd);
-    esp_err_t ret = i2c_master_cmd_begin(i2c_port, cmd, 1000 / portTICK_PERIOD_MS);
-    if(ret != ESP_OK)
-    {
-        return ret;
-    }
-    i2c_cmd_link_delete(cmd);
-
-    // Delay 20 ms
-    vTaskDelay(2);
-
-    // Read 6 bytes
-    cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (0x44 << 1) | READ_BIT, ACK_CHECK_EN);
-    size_t   size    = 6;
-    uint8_t *data_rd = malloc(size);
-    if(size > 1)
-    {
-        i2c_master_read(cmd, data_rd, size - 1, ACK_VAL);
-    }
-    i2c_master_read_byte(cmd, data_rd + size - 1, NACK_VAL);
-    i2c_master_stop(cmd);
-    ret = i2c_master_cmd_begin(i2c_port, cmd, 1000 / portTICK_PERIOD_MS);
-    if(ret != ESP_OK)
-    {
-        return ret;
-    }
-    i2c_cmd_link_delete(cmd);
+    i2c_port_t        port;
+    i2c_bus_config_t  bus; /* Used only if the bus is not initialized yet. */
+    uint8_t           address;
+    sht31_rate_t      rate;
+    sht31_sample_cb_t p_sample_cb;    /* Optional. */
+    void             *p_cb_arg;       /* Optional. */
+    QueueHandle_t     p_sample_queue; /* Optional, holds sht31_sample_t items. Samples are dropped when it is full. */
+} sht31_config_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function joins the shared I2C bus, puts the sensor into periodic acquisition mode and starts delivering
+ * samples through the callback and/or the queue from the config.
+ *
+ * @param [in] p_config Driver configuration.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t sht31_init(const sht31_config_t *p_config);
 
-    // check error
-    if(data_rd[2] != sht31_crc(data_rd) || data_rd[5] != sht31_crc(data_rd + 3))
-        return ESP_ERR_INVALID_CRC;
+/**
+ * @brief The function stops periodic acquisition.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t sht31_deinit(void);
 
-    *temp = -45 + (175 * (float)(data_rd[0] * 256 + data_rd[1]) / 65535.0);
-    *humi = 100 * (float)(data_rd[3] * 256 + data_rd[4]) / 65535.0;
+/**
+ * @brief The function changes the periodic acquisition rate.
+ *
+ * @param [in] rate New rate.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t sht31_set_rate(sht31_rate_t rate);
+
+/**
+ * @brief The function fetches the latest periodic measurement. It never waits for a conversion.
+ *
+ * @param [out] p_sample Fetched sample.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND if no new measurement is ready, ESP_ERR_INVALID_CRC on
+ * corrupted data, fail otherwise.
+ */
+esp_err_t sht31_fetch(sht31_sample_t *p_sample);
+
+#ifdef __cplusplus
+}
+#endif
 
-    return ESP_OK;
-}
\ No newline at end of file
+#endif // __SHT31_C__
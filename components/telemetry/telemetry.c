@@ -0,0 +1,524 @@
+/**
+ * @file telemetry.c
+ *
+ * @brief This file implements the store-and-forward telemetry pipeline. Samples are pushed into a fixed size ring at
+ * the sensor rate and a separate publisher task packs them into batches. While the broker is unreachable the
+ * publisher spills full batches to NVS and replays them in order once the link is back.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "telemetry.h"
+#include "telemetry_encoder.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include <stdio.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define TELEMETRY_TASK_STACK_SIZE (4 * 1024)
+#define TELEMETRY_TASK_PRIORITY   (4U)
+
+/* Once the ring is this full and the link is down, batches are moved to flash. */
+#define TELEMETRY_SPILL_THRESHOLD (TELEMETRY_RING_SIZE / 2U)
+
+/* Number of batches that fit into the spill area. The oldest one is overwritten when full. */
+#define TELEMETRY_SPILL_BLOCKS (24U)
+
+#define TELEMETRY_NVS_NAMESPACE "telemetry"
+#define TELEMETRY_NVS_KEY_HEAD  "head"
+#define TELEMETRY_NVS_KEY_TAIL  "tail"
+
+/* Bit of the topic in a sent mask. */
+#define TELEMETRY_TOPIC_BIT(index) ((uint8_t)(1U << (index)))
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Publisher task. Drains the spill area and the ring while the link is up and spills the ring otherwise.
+ *
+ * @param [in] p_parameter This is the parameter that is passed to the task.
+ */
+static void _telemetry_task(void *p_parameter);
+
+/**
+ * @brief Copies up to max_count oldest samples out of the ring without removing them.
+ *
+ * @return Number of samples copied.
+ */
+static uint16_t _ring_peek(telemetry_sample_t *p_samples, uint16_t max_count);
+
+/**
+ * @brief Removes count oldest samples from the ring.
+ */
+static void _ring_pop(uint16_t count);
+
+/**
+ * @brief Returns the number of samples currently stored in the ring.
+ */
+static uint16_t _ring_level(void);
+
+/**
+ * @brief Encodes and publishes one batch on every topic that has not accepted it yet.
+ *
+ * @param [in]     p_samples   Samples of the batch.
+ * @param [in]     count       Number of samples in the batch.
+ * @param [in,out] p_sent_mask Topics that already accepted the batch, updated with the ones accepting it now.
+ *
+ * @return true once every topic accepted the batch.
+ */
+static bool _publish_batch(const telemetry_sample_t *p_samples, uint16_t count, uint8_t *p_sent_mask);
+
+/**
+ * @brief Adds amount to one of the pipeline counters. The counters are read by telemetry_get_stats() from other tasks.
+ */
+static void _stats_add(uint32_t *p_counter, uint32_t amount);
+
+static esp_err_t _spill_open(void);
+static esp_err_t _spill_write(const telemetry_sample_t *p_samples, uint16_t count, uint8_t sent_mask);
+static esp_err_t _spill_read_oldest(telemetry_sample_t *p_samples, uint16_t *p_count, uint8_t *p_sent_mask);
+static esp_err_t _spill_mark_oldest(uint8_t sent_mask);
+static esp_err_t _spill_drop_oldest(void);
+static void      _spill_block_key(uint32_t index, char *p_key, size_t key_size);
+static void      _spill_mask_key(uint32_t index, char *p_key, size_t key_size);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "TELEMETRY";
+
+static telemetry_config_t _config;
+static TaskHandle_t       p_telemetry_task = NULL;
+static portMUX_TYPE       _ring_lock       = portMUX_INITIALIZER_UNLOCKED;
+
+static telemetry_sample_t _ring[TELEMETRY_RING_SIZE];
+static uint16_t           _ring_head  = 0U;
+static uint16_t           _ring_count = 0U;
+/* Oldest samples overwritten since the last _ring_peek(), they may have been among the peeked ones. */
+static uint16_t           _ring_overwritten = 0U;
+
+/* Scratch batch and encode buffer owned by the publisher task. */
+static telemetry_sample_t _batch[TELEMETRY_BATCH_SIZE_MAX];
+static uint8_t            _payload[TELEMETRY_PAYLOAD_SIZE_MAX];
+
+/* Ring batch held in _batch until every topic accepted it. It is retried as is instead of peeking the ring again, so
+ * the topics that already accepted it are skipped and no topic gets the same samples twice. */
+static uint16_t _ring_batch_count     = 0U;
+static uint8_t  _ring_batch_sent_mask = 0U;
+
+static volatile bool _b_link_up = false;
+
+static nvs_handle_t _spill_nvs;
+static bool         _b_spill_ready = false;
+static uint32_t     _spill_head    = 0U; /* Index of the next block to write. */
+static uint32_t     _spill_tail    = 0U; /* Index of the oldest stored block. */
+
+static telemetry_stats_t _stats;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t telemetry_init(const telemetry_config_t *p_config)
+{
+    if((NULL == p_config) || (NULL == p_config->p_publish_cb) || (0U == p_config->topic_count) ||
+       (TELEMETRY_TOPICS_MAX < p_config->topic_count) || (0U == p_config->batch_size) || (TELEMETRY_BATCH_SIZE_MAX < p_config->batch_size))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for(uint8_t i = 0U; i < p_config->topic_count; i++)
+    {
+        if((NULL == p_config->topics[i].p_topic) || (TELEMETRY_FORMAT_COUNT <= p_config->topics[i].format))
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    if(NULL != p_telemetry_task)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    _config = *p_config;
+
+    if(ESP_OK != _spill_open())
+    {
+        /* The pipeline still works without flash, samples are only lost on long outages. */
+        ESP_LOGW(TAG, "Spill area not available");
+    }
+
+    if(pdPASS != xTaskCreate(&_telemetry_task, "telemetry_task", TELEMETRY_TASK_STACK_SIZE, NULL, TELEMETRY_TASK_PRIORITY, &p_telemetry_task))
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t telemetry_push(const telemetry_sample_t *p_sample)
+{
+    if(NULL == p_sample)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool b_notify = false;
+
+    taskENTER_CRITICAL(&_ring_lock);
+    _ring[_ring_head] = *p_sample;
+    _ring_head        = (_ring_head + 1U) % TELEMETRY_RING_SIZE;
+
+    if(TELEMETRY_RING_SIZE == _ring_count)
+    {
+        /* Ring is full, the oldest sample has just been overwritten. */
+        _stats.dropped++;
+        if(UINT16_MAX > _ring_overwritten)
+        {
+            _ring_overwritten++;
+        }
+    }
+    else
+    {
+        _ring_count++;
+    }
+    _stats.pushed++;
+
+    b_notify = (_ring_count == _config.batch_size) || (_ring_count == TELEMETRY_SPILL_THRESHOLD);
+    taskEXIT_CRITICAL(&_ring_lock);
+
+    if(b_notify && (NULL != p_telemetry_task))
+    {
+        xTaskNotifyGive(p_telemetry_task);
+    }
+
+    return ESP_OK;
+}
+
+void telemetry_set_link_state(bool b_is_up)
+{
+    _b_link_up = b_is_up;
+
+    if(b_is_up && (NULL != p_telemetry_task))
+    {
+        /* Start the replay right away instead of waiting for the next flush period. */
+        xTaskNotifyGive(p_telemetry_task);
+    }
+}
+
+void telemetry_get_stats(telemetry_stats_t *p_stats)
+{
+    if(NULL != p_stats)
+    {
+        taskENTER_CRITICAL(&_ring_lock);
+        *p_stats              = _stats;
+        p_stats->ring_level   = _ring_count;
+        p_stats->spill_blocks = (uint16_t)(_spill_head - _spill_tail);
+        taskEXIT_CRITICAL(&_ring_lock);
+    }
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _telemetry_task(void *p_parameter)
+{
+    (void)p_parameter;
+
+    for(;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(_config.flush_period_ms));
+
+        if(_b_link_up)
+        {
+            /* Spilled batches are older than anything in the ring, replay them first to keep the order. */
+            while(_b_link_up && (_spill_head != _spill_tail))
+            {
+                uint16_t count     = 0U;
+                uint8_t  sent_mask = 0U;
+
+                if(ESP_OK != _spill_read_oldest(_batch, &count, &sent_mask))
+                {
+                    /* Corrupted or missing block, skip it so the replay can not get stuck. */
+                    (void)_spill_drop_oldest();
+                    continue;
+                }
+
+                uint8_t stored_mask = sent_mask;
+
+                if(!_publish_batch(_batch, count, &sent_mask))
+                {
+                    if(stored_mask != sent_mask)
+                    {
+                        /* Remember the topics that took the block, also across a reboot. */
+                        (void)_spill_mark_oldest(sent_mask);
+                    }
+                    break;
+                }
+
+                (void)_spill_drop_oldest();
+                _stats_add(&_stats.replayed, count);
+            }
+
+            while(_b_link_up && (_spill_head == _spill_tail) && ((0U < _ring_batch_count) || (0U < _ring_level())))
+            {
+                if(0U == _ring_batch_count)
+                {
+                    _ring_batch_count     = _ring_peek(_batch, _config.batch_size);
+                    _ring_batch_sent_mask = 0U;
+                }
+
+                if(!_publish_batch(_batch, _ring_batch_count, &_ring_batch_sent_mask))
+                {
+                    break;
+                }
+
+                _ring_pop(_ring_batch_count);
+                _ring_batch_count = 0U;
+            }
+        }
+        else if(_b_spill_ready)
+        {
+            /* A partly published ring batch goes first, together with the topics that already took it. */
+            while(!_b_link_up && ((0U < _ring_batch_count) || (TELEMETRY_SPILL_THRESHOLD <= _ring_level())))
+            {
+                if(0U == _ring_batch_count)
+                {
+                    _ring_batch_count     = _ring_peek(_batch, _config.batch_size);
+                    _ring_batch_sent_mask = 0U;
+                }
+
+                if(ESP_OK != _spill_write(_batch, _ring_batch_count, _ring_batch_sent_mask))
+                {
+                    break;
+                }
+
+                _ring_pop(_ring_batch_count);
+                _stats_add(&_stats.spilled, _ring_batch_count);
+                _ring_batch_count = 0U;
+            }
+        }
+    }
+}
+
+static uint16_t _ring_peek(telemetry_sample_t *p_samples, uint16_t max_count)
+{
+    taskENTER_CRITICAL(&_ring_lock);
+    uint16_t count = (_ring_count < max_count) ? _ring_count : max_count;
+    uint16_t tail  = (uint16_t)((_ring_head + TELEMETRY_RING_SIZE - _ring_count) % TELEMETRY_RING_SIZE);
+
+    for(uint16_t i = 0U; i < count; i++)
+    {
+        p_samples[i] = _ring[(tail + i) % TELEMETRY_RING_SIZE];
+    }
+    _ring_overwritten = 0U;
+    taskEXIT_CRITICAL(&_ring_lock);
+
+    return count;
+}
+
+static void _ring_pop(uint16_t count)
+{
+    taskENTER_CRITICAL(&_ring_lock);
+    /* Peeked samples the producer has overwritten in the meantime are gone already, the ring still holds the rest. */
+    uint16_t remaining = (_ring_overwritten < count) ? (uint16_t)(count - _ring_overwritten) : (uint16_t)0U;
+
+    _ring_count       = (remaining < _ring_count) ? (uint16_t)(_ring_count - remaining) : (uint16_t)0U;
+    _ring_overwritten = 0U;
+    taskEXIT_CRITICAL(&_ring_lock);
+}
+
+static uint16_t _ring_level(void)
+{
+    taskENTER_CRITICAL(&_ring_lock);
+    uint16_t count = _ring_count;
+    taskEXIT_CRITICAL(&_ring_lock);
+
+    return count;
+}
+
+static bool _publish_batch(const telemetry_sample_t *p_samples, uint16_t count, uint8_t *p_sent_mask)
+{
+    for(uint8_t i = 0U; i < _config.topic_count; i++)
+    {
+        if(0U != (*p_sent_mask & TELEMETRY_TOPIC_BIT(i)))
+        {
+            continue;
+        }
+
+        size_t    len     = 0U;
+        esp_err_t esp_err = telemetry_encode((telemetry_format_t)_config.topics[i].format, p_samples, count, _payload,
+                                             sizeof(_payload), &len);
+
+        if(ESP_OK != esp_err)
+        {
+            /* The batch can never fit, retrying would block the pipeline forever. */
+            ESP_LOGE(TAG, "Encoding failed: %s", esp_err_to_name(esp_err));
+            _stats_add(&_stats.dropped, count);
+            return true;
+        }
+
+        if(!_config.p_publish_cb(_config.topics[i].p_topic, _payload, len, _config.p_publish_arg))
+        {
+            return false;
+        }
+
+        *p_sent_mask |= TELEMETRY_TOPIC_BIT(i);
+    }
+
+    _stats_add(&_stats.published, count);
+
+    return true;
+}
+
+static void _stats_add(uint32_t *p_counter, uint32_t amount)
+{
+    taskENTER_CRITICAL(&_ring_lock);
+    *p_counter += amount;
+    taskEXIT_CRITICAL(&_ring_lock);
+}
+
+static esp_err_t _spill_open(void)
+{
+    esp_err_t esp_err = nvs_open(TELEMETRY_NVS_NAMESPACE, NVS_READWRITE, &_spill_nvs);
+
+    if(ESP_OK == esp_err)
+    {
+        /* Missing keys simply mean an empty spill area. */
+        (void)nvs_get_u32(_spill_nvs, TELEMETRY_NVS_KEY_HEAD, &_spill_head);
+        (void)nvs_get_u32(_spill_nvs, TELEMETRY_NVS_KEY_TAIL, &_spill_tail);
+
+        if((_spill_head - _spill_tail) > TELEMETRY_SPILL_BLOCKS)
+        {
+            _spill_head = 0U;
+            _spill_tail = 0U;
+        }
+
+        _b_spill_ready = true;
+        ESP_LOGI(TAG, "%lu spilled batches pending", (unsigned long)(_spill_head - _spill_tail));
+    }
+
+    return esp_err;
+}
+
+static esp_err_t _spill_write(const telemetry_sample_t *p_samples, uint16_t count, uint8_t sent_mask)
+{
+    char key[NVS_KEY_NAME_MAX_SIZE];
+
+    if(TELEMETRY_SPILL_BLOCKS <= (_spill_head - _spill_tail))
+    {
+        /* Spill area full, the oldest batch gives way to the newest one. */
+        size_t size = 0U;
+        _spill_block_key(_spill_tail, key, sizeof(key));
+        if(ESP_OK == nvs_get_blob(_spill_nvs, key, NULL, &size))
+        {
+            _stats_add(&_stats.dropped, (uint32_t)(size / sizeof(telemetry_sample_t)));
+        }
+        (void)_spill_drop_oldest();
+    }
+
+    _spill_block_key(_spill_head, key, sizeof(key));
+    esp_err_t esp_err = nvs_set_blob(_spill_nvs, key, p_samples, count * sizeof(telemetry_sample_t));
+
+    _spill_mask_key(_spill_head, key, sizeof(key));
+    if((ESP_OK == esp_err) && (0U != sent_mask))
+    {
+        esp_err = nvs_set_u8(_spill_nvs, key, sent_mask);
+    }
+    else
+    {
+        /* A block without a mask has not been taken by any topic yet. */
+        (void)nvs_erase_key(_spill_nvs, key);
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = nvs_set_u32(_spill_nvs, TELEMETRY_NVS_KEY_HEAD, _spill_head + 1U);
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = nvs_commit(_spill_nvs);
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        _spill_head++;
+    }
+    else
+    {
+        ESP_LOGW(TAG, "Spill failed: %s", esp_err_to_name(esp_err));
+    }
+
+    return esp_err;
+}
+
+static esp_err_t _spill_read_oldest(telemetry_sample_t *p_samples, uint16_t *p_count, uint8_t *p_sent_mask)
+{
+    char   key[NVS_KEY_NAME_MAX_SIZE];
+    size_t size = TELEMETRY_BATCH_SIZE_MAX * sizeof(telemetry_sample_t);
+
+    _spill_block_key(_spill_tail, key, sizeof(key));
+    esp_err_t esp_err = nvs_get_blob(_spill_nvs, key, p_samples, &size);
+
+    if((ESP_OK == esp_err) && (0U != (size % sizeof(telemetry_sample_t))))
+    {
+        esp_err = ESP_ERR_INVALID_SIZE;
+    }
+
+    *p_count = (ESP_OK == esp_err) ? (uint16_t)(size / sizeof(telemetry_sample_t)) : 0U;
+
+    /* A missing mask means no topic has taken the block yet. */
+    *p_sent_mask = 0U;
+    _spill_mask_key(_spill_tail, key, sizeof(key));
+    (void)nvs_get_u8(_spill_nvs, key, p_sent_mask);
+
+    return esp_err;
+}
+
+static esp_err_t _spill_mark_oldest(uint8_t sent_mask)
+{
+    char key[NVS_KEY_NAME_MAX_SIZE];
+
+    _spill_mask_key(_spill_tail, key, sizeof(key));
+    esp_err_t esp_err = nvs_set_u8(_spill_nvs, key, sent_mask);
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = nvs_commit(_spill_nvs);
+    }
+
+    return esp_err;
+}
+
+static esp_err_t _spill_drop_oldest(void)
+{
+    char key[NVS_KEY_NAME_MAX_SIZE];
+
+    _spill_block_key(_spill_tail, key, sizeof(key));
+    (void)nvs_erase_key(_spill_nvs, key);
+    _spill_mask_key(_spill_tail, key, sizeof(key));
+    (void)nvs_erase_key(_spill_nvs, key);
+    _spill_tail++;
+
+    esp_err_t esp_err = nvs_set_u32(_spill_nvs, TELEMETRY_NVS_KEY_TAIL, _spill_tail);
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = nvs_commit(_spill_nvs);
+    }
+
+    return esp_err;
+}
+
+static void _spill_block_key(uint32_t index, char *p_key, size_t key_size)
+{
+    (void)snprintf(p_key, key_size, "blk%02lu", (unsigned long)(index % TELEMETRY_SPILL_BLOCKS));
+}
+
+static void _spill_mask_key(uint32_t index, char *p_key, size_t key_size)
+{
+    (void)snprintf(p_key, key_size, "msk%02lu", (unsigned long)(index % TELEMETRY_SPILL_BLOCKS));
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,139 @@
+/**
+ * @file telemetry.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __TELEMETRY_C__
+#define __TELEMETRY_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+/* Number of samples the in-RAM ring can hold. */
+#define TELEMETRY_RING_SIZE (64U)
+
+/* Maximum number of samples packed into one published message. */
+#define TELEMETRY_BATCH_SIZE_MAX (16U)
+
+/* Maximum number of topics every batch is published on. */
+#define TELEMETRY_TOPICS_MAX (2U)
+
+/* Size of the static buffer a batch is encoded into. */
+#define TELEMETRY_PAYLOAD_SIZE_MAX (2048U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief One telemetry sample as produced by the sensor task.
+ *
+ */
+typedef struct
+{
+    uint32_t timestamp_ms; /* Milliseconds since boot. */
+    float    temp;
+    float    humi;
+    float    acc_x;
+    float    acc_y;
+    float    acc_z;
+} telemetry_sample_t;
+
+/**
+ * @brief Callback used by the publisher to put one batch on the wire.
+ *
+ * @param [in] p_topic   Topic the batch is published on.
+ * @param [in] p_payload Encoded batch.
+ * @param [in] len       Length of the encoded batch in bytes.
+ * @param [in] p_arg     User argument from the config.
+ *
+ * @return true if the batch was accepted by the transport, false otherwise.
+ */
+typedef bool (*telemetry_publish_cb_t)(const char *p_topic, const uint8_t *p_payload, size_t len, void *p_arg);
+
+/**
+ * @brief Topic a batch is published on, together with the payload format used for it.
+ *
+ */
+typedef struct
+{
+    const char *p_topic;
+    uint8_t     format; /* One of telemetry_format_t from telemetry_encoder.h. */
+} telemetry_topic_t;
+
+/**
+ * @brief Telemetry pipeline configuration.
+ *
+ */
+typedef struct
+{
+    telemetry_topic_t      topics[TELEMETRY_TOPICS_MAX];
+    uint8_t                topic_count;
+    telemetry_publish_cb_t p_publish_cb;
+    void                  *p_publish_arg;
+    uint16_t               batch_size;      /* Samples per message, up to TELEMETRY_BATCH_SIZE_MAX. */
+    uint32_t               flush_period_ms; /* Partial batches are flushed at least this often. */
+} telemetry_config_t;
+
+/**
+ * @brief Pipeline counters.
+ *
+ */
+typedef struct
+{
+    uint32_t pushed;
+    uint32_t published;
+    uint32_t dropped;
+    uint32_t spilled;
+    uint32_t replayed;
+    uint16_t ring_level;
+    uint16_t spill_blocks;
+} telemetry_stats_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function initializes the telemetry pipeline and starts the publisher task.
+ *
+ * @param [in] p_config Pipeline configuration.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t telemetry_init(const telemetry_config_t *p_config);
+
+/**
+ * @brief The function unblockingly stores one sample into the ring. When the ring is full the oldest sample is dropped.
+ *
+ * @param [in] p_sample Sample to be stored.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t telemetry_push(const telemetry_sample_t *p_sample);
+
+/**
+ * @brief The function informs the pipeline whether the broker is reachable.
+ *
+ * @param [in] b_is_up true when the broker connection is up.
+ */
+void telemetry_set_link_state(bool b_is_up);
+
+/**
+ * @brief The function copies current pipeline counters.
+ *
+ * @param [out] p_stats Destination for the counters.
+ */
+void telemetry_get_stats(telemetry_stats_t *p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TELEMETRY_C__
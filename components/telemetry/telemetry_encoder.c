@@ -0,0 +1,204 @@
+/**
+ * @file telemetry_encoder.c
+ *
+ * @brief This file serializes telemetry samples straight into a caller provided buffer. There is a compact JSON
+ * mode for human readable topics and a fixed little-endian binary mode for bandwidth constrained ones. Neither mode
+ * touches the heap and both keep full float precision.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "telemetry_encoder.h"
+#include "json_writer.h"
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Output cursor over the caller buffer.
+ *
+ */
+typedef struct
+{
+    uint8_t *p_buf;
+    size_t   size;
+    size_t   len;
+    bool     b_overflow;
+} _writer_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+static esp_err_t _encode_json(_writer_t *p_writer, const telemetry_sample_t *p_samples, uint16_t count);
+static esp_err_t _encode_binary(_writer_t *p_writer, const telemetry_sample_t *p_samples, uint16_t count);
+
+static void _put_char(_writer_t *p_writer, char c);
+static void _put_str(_writer_t *p_writer, const char *p_str);
+static void _put_uint(_writer_t *p_writer, uint64_t value, uint8_t min_digits);
+static void _put_float(_writer_t *p_writer, float value);
+static void _put_u32_le(_writer_t *p_writer, uint32_t value);
+static void _put_f32_le(_writer_t *p_writer, float value);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t telemetry_encode(telemetry_format_t format, const telemetry_sample_t *p_samples, uint16_t count, uint8_t *p_buf,
+                           size_t buf_size, size_t *p_len)
+{
+    if((NULL == p_samples) || (NULL == p_buf) || (NULL == p_len))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    _writer_t writer  = { .p_buf = p_buf, .size = buf_size, .len = 0U, .b_overflow = false };
+    esp_err_t esp_err = ESP_ERR_INVALID_ARG;
+
+    switch(format)
+    {
+        case TELEMETRY_FORMAT_JSON:
+            esp_err = _encode_json(&writer, p_samples, count);
+            break;
+
+        case TELEMETRY_FORMAT_BINARY:
+            esp_err = _encode_binary(&writer, p_samples, count);
+            break;
+
+        default:
+            break;
+    }
+
+    if((ESP_OK == esp_err) && writer.b_overflow)
+    {
+        esp_err = ESP_ERR_INVALID_SIZE;
+    }
+
+    *p_len = (ESP_OK == esp_err) ? writer.len : 0U;
+
+    return esp_err;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static esp_err_t _encode_json(_writer_t *p_writer, const telemetry_sample_t *p_samples, uint16_t count)
+{
+    _put_char(p_writer, '[');
+
+    for(uint16_t i = 0U; i < count; i++)
+    {
+        if(0U != i)
+        {
+            _put_char(p_writer, ',');
+        }
+
+        _put_str(p_writer, "{\"ts\":");
+        _put_uint(p_writer, p_samples[i].timestamp_ms, 1U);
+        _put_str(p_writer, ",\"temp\":");
+        _put_float(p_writer, p_samples[i].temp);
+        _put_str(p_writer, ",\"hum\":");
+        _put_float(p_writer, p_samples[i].humi);
+        _put_str(p_writer, ",\"acc\":{\"x\":");
+        _put_float(p_writer, p_samples[i].acc_x);
+        _put_str(p_writer, ",\"y\":");
+        _put_float(p_writer, p_samples[i].acc_y);
+        _put_str(p_writer, ",\"z\":");
+        _put_float(p_writer, p_samples[i].acc_z);
+        _put_str(p_writer, "}}");
+    }
+
+    _put_char(p_writer, ']');
+
+    return ESP_OK;
+}
+
+static esp_err_t _encode_binary(_writer_t *p_writer, const telemetry_sample_t *p_samples, uint16_t count)
+{
+    if(UINT8_MAX < count)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    _put_char(p_writer, (char)TELEMETRY_BINARY_SCHEMA_VERSION);
+    _put_char(p_writer, (char)count);
+
+    for(uint16_t i = 0U; i < count; i++)
+    {
+        _put_u32_le(p_writer, p_samples[i].timestamp_ms);
+        _put_f32_le(p_writer, p_samples[i].temp);
+        _put_f32_le(p_writer, p_samples[i].humi);
+        _put_f32_le(p_writer, p_samples[i].acc_x);
+        _put_f32_le(p_writer, p_samples[i].acc_y);
+        _put_f32_le(p_writer, p_samples[i].acc_z);
+    }
+
+    return ESP_OK;
+}
+
+static void _put_char(_writer_t *p_writer, char c)
+{
+    if(p_writer->len < p_writer->size)
+    {
+        p_writer->p_buf[p_writer->len++] = (uint8_t)c;
+    }
+    else
+    {
+        p_writer->b_overflow = true;
+    }
+}
+
+static void _put_str(_writer_t *p_writer, const char *p_str)
+{
+    while('\0' != *p_str)
+    {
+        _put_char(p_writer, *p_str++);
+    }
+}
+
+static void _put_uint(_writer_t *p_writer, uint64_t value, uint8_t min_digits)
+{
+    char    digits[20];
+    uint8_t count = 0U;
+
+    do
+    {
+        digits[count++] = (char)('0' + (value % 10U));
+        value /= 10U;
+    } while((0U != value) && (count < sizeof(digits)));
+
+    while(count < min_digits)
+    {
+        digits[count++] = '0';
+    }
+
+    while(0U != count)
+    {
+        _put_char(p_writer, digits[--count]);
+    }
+}
+
+static void _put_float(_writer_t *p_writer, float value)
+{
+    char text[JSON_WRITER_FLOAT_SIZE];
+
+    (void)json_writer_float_format(value, text);
+    _put_str(p_writer, text);
+}
+
+static void _put_u32_le(_writer_t *p_writer, uint32_t value)
+{
+    _put_char(p_writer, (char)(value & 0xFFU));
+    _put_char(p_writer, (char)((value >> 8) & 0xFFU));
+    _put_char(p_writer, (char)((value >> 16) & 0xFFU));
+    _put_char(p_writer, (char)((value >> 24) & 0xFFU));
+}
+
+static void _put_f32_le(_writer_t *p_writer, float value)
+{
+    uint32_t bits = 0U;
+
+    memcpy(&bits, &value, sizeof(bits));
+    _put_u32_le(p_writer, bits);
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,63 @@
+/**
+ * @file telemetry_encoder.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __TELEMETRY_ENCODER_C__
+#define __TELEMETRY_ENCODER_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "telemetry.h"
+
+//---------------------------------- MACROS -----------------------------------
+/* Version byte that opens every binary payload. Bump it whenever the record layout changes. */
+#define TELEMETRY_BINARY_SCHEMA_VERSION (1U)
+
+/* Binary payload: [version:u8][count:u8] followed by count records. */
+#define TELEMETRY_BINARY_HEADER_SIZE (2U)
+
+/* Binary record: [timestamp_ms:u32][temp:f32][humi:f32][acc_x:f32][acc_y:f32][acc_z:f32], all little-endian. */
+#define TELEMETRY_BINARY_RECORD_SIZE (24U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Enums hold supported payload formats.
+ *
+ */
+typedef enum
+{
+    TELEMETRY_FORMAT_JSON,   /* Compact JSON array of sample objects. */
+    TELEMETRY_FORMAT_BINARY, /* Versioned fixed little-endian records. */
+
+    TELEMETRY_FORMAT_COUNT
+} telemetry_format_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function serializes samples into a caller provided buffer. It does not use the heap.
+ *
+ * @param [in]  format    Payload format.
+ * @param [in]  p_samples Samples to be encoded.
+ * @param [in]  count     Number of samples.
+ * @param [out] p_buf     Destination buffer.
+ * @param [in]  buf_size  Size of the destination buffer.
+ * @param [out] p_len     Number of bytes written. JSON output is not NUL terminated.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_SIZE if the buffer is too small, fail otherwise.
+ */
+esp_err_t telemetry_encode(telemetry_format_t format, const telemetry_sample_t *p_samples, uint16_t count, uint8_t *p_buf,
+                           size_t buf_size, size_t *p_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TELEMETRY_ENCODER_C__
@@ -0,0 +1,256 @@
+/**
+ * @file tictactoe.c
+ *
+ * @brief This file implements the tic-tac-toe rules. Each player's cells are a 9-bit mask, so a move is one OR and a
+ * win check compares the mover's mask against the precomputed lines through the cell just played, at most four. The
+ * computer opponent takes openings from a table in flash, where a search would be the most expensive, and searches
+ * the remaining positions with alpha-beta pruned minimax on the bitboards.
+ *
+ * A move travels as two bytes, the sequence number and the cell, so a remote opponent can drop duplicates and spot
+ * lost moves without any other state.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "tictactoe.h"
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define TICTACTOE_BOARD_FULL  ((uint16_t)((1U << TICTACTOE_CELLS) - 1U))
+#define TICTACTOE_CELL_LINES  (4U)
+#define TICTACTOE_CELL_CENTER (4U)
+
+#define TICTACTOE_CELL_MASK(X) ((uint16_t)(1U << (X)))
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Returns the line through cell the board completes, 0 if none.
+ */
+static uint16_t _line_find(uint16_t board, uint8_t cell);
+
+/**
+ * @brief Scores the position for the player on turn, own, after the opponent played last_cell.
+ *
+ * @return int8_t Positive for a win, the sooner the higher, negative for a loss, 0 for a draw.
+ */
+static int8_t _negamax(uint16_t own, uint16_t other, uint8_t last_cell, int8_t alpha, int8_t beta);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+/* Rows, columns and diagonals through each cell, 0 terminated. */
+static const uint16_t _cell_lines[TICTACTOE_CELLS][TICTACTOE_CELL_LINES] = {
+    {0x007U, 0x049U, 0x111U, 0U},
+    {0x007U, 0x092U, 0U, 0U},
+    {0x007U, 0x124U, 0x054U, 0U},
+    {0x038U, 0x049U, 0U, 0U},
+    {0x038U, 0x092U, 0x111U, 0x054U},
+    {0x038U, 0x124U, 0U, 0U},
+    {0x1C0U, 0x049U, 0x054U, 0U},
+    {0x1C0U, 0x092U, 0U, 0U},
+    {0x1C0U, 0x124U, 0x111U, 0U},
+};
+
+/* Search order: center, corners, edges. Strong moves first make the pruning cut early. */
+static const uint8_t _move_order[TICTACTOE_CELLS] = {4U, 0U, 2U, 6U, 8U, 1U, 3U, 5U, 7U};
+
+/* Perfect reply to the first move, indexed by its cell: the center, or a corner if the center is taken. */
+static const uint8_t _opening_replies[TICTACTOE_CELLS] = {4U, 4U, 4U, 4U, 0U, 4U, 4U, 4U, 4U};
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+void tictactoe_reset(tictactoe_t *p_game)
+{
+    memset(p_game, 0, sizeof(*p_game));
+    p_game->state = TICTACTOE_STATE_PLAYING;
+}
+
+esp_err_t tictactoe_play(tictactoe_t *p_game, uint8_t cell)
+{
+    if(TICTACTOE_STATE_PLAYING != p_game->state)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if((TICTACTOE_CELLS <= cell) || (0U != ((p_game->board[0] | p_game->board[1]) & TICTACTOE_CELL_MASK(cell))))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    tictactoe_player_t player = tictactoe_turn(p_game);
+
+    p_game->board[player] |= TICTACTOE_CELL_MASK(cell);
+    p_game->log[p_game->moves++] = cell;
+    p_game->win_line             = _line_find(p_game->board[player], cell);
+
+    if(0U != p_game->win_line)
+    {
+        p_game->state = TICTACTOE_STATE_WON;
+    }
+    else if(TICTACTOE_CELLS == p_game->moves)
+    {
+        p_game->state = TICTACTOE_STATE_DRAW;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t tictactoe_undo(tictactoe_t *p_game)
+{
+    if(0U == p_game->moves)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint8_t cell = p_game->log[--p_game->moves];
+
+    /* The player on turn after the undo made the move. */
+    p_game->board[tictactoe_turn(p_game)] &= (uint16_t)~TICTACTOE_CELL_MASK(cell);
+    p_game->state    = TICTACTOE_STATE_PLAYING;
+    p_game->win_line = 0U;
+
+    return ESP_OK;
+}
+
+tictactoe_player_t tictactoe_turn(const tictactoe_t *p_game)
+{
+    return (0U == (p_game->moves & 1U)) ? TICTACTOE_PLAYER_X : TICTACTOE_PLAYER_O;
+}
+
+tictactoe_player_t tictactoe_cell_owner(const tictactoe_t *p_game, uint8_t cell)
+{
+    for(uint8_t player = 0U; (TICTACTOE_CELLS > cell) && (player < TICTACTOE_PLAYER_COUNT); player++)
+    {
+        if(0U != (p_game->board[player] & TICTACTOE_CELL_MASK(cell)))
+        {
+            return (tictactoe_player_t)player;
+        }
+    }
+
+    return TICTACTOE_PLAYER_COUNT;
+}
+
+esp_err_t tictactoe_best_move(const tictactoe_t *p_game, uint8_t *p_cell)
+{
+    if(TICTACTOE_STATE_PLAYING != p_game->state)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if(0U == p_game->moves)
+    {
+        *p_cell = TICTACTOE_CELL_CENTER;
+        return ESP_OK;
+    }
+
+    if(1U == p_game->moves)
+    {
+        *p_cell = _opening_replies[p_game->log[0]];
+        return ESP_OK;
+    }
+
+    tictactoe_player_t player = tictactoe_turn(p_game);
+    uint16_t           own    = p_game->board[player];
+    uint16_t           other  = p_game->board[player ^ 1U];
+    int8_t             best   = -INT8_MAX;
+
+    for(uint8_t index = 0U; index < TICTACTOE_CELLS; index++)
+    {
+        uint8_t cell = _move_order[index];
+
+        if(0U != ((own | other) & TICTACTOE_CELL_MASK(cell)))
+        {
+            continue;
+        }
+
+        /* Only a strictly better move replaces the first one found, so the search order breaks ties. */
+        int8_t score = (int8_t)-_negamax(other, own | TICTACTOE_CELL_MASK(cell), cell, -INT8_MAX, (int8_t)-best);
+        if(score > best)
+        {
+            best    = score;
+            *p_cell = cell;
+        }
+    }
+
+    return ESP_OK;
+}
+
+void tictactoe_msg_encode(uint8_t seq, uint8_t cell, uint8_t *p_msg)
+{
+    p_msg[0] = seq;
+    p_msg[1] = cell;
+}
+
+esp_err_t tictactoe_msg_decode(const uint8_t *p_msg, size_t len, uint8_t *p_seq, uint8_t *p_cell)
+{
+    if((TICTACTOE_MSG_SIZE != len) || ((TICTACTOE_CELLS <= p_msg[1]) && (TICTACTOE_CELL_NEW_GAME != p_msg[1])) ||
+       ((TICTACTOE_CELLS <= p_msg[0]) && (TICTACTOE_SEQ_ANY != p_msg[0])))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *p_seq  = p_msg[0];
+    *p_cell = p_msg[1];
+
+    return ESP_OK;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static uint16_t _line_find(uint16_t board, uint8_t cell)
+{
+    const uint16_t *p_lines = _cell_lines[cell];
+
+    for(uint8_t line = 0U; (line < TICTACTOE_CELL_LINES) && (0U != p_lines[line]); line++)
+    {
+        if(p_lines[line] == (board & p_lines[line]))
+        {
+            return p_lines[line];
+        }
+    }
+
+    return 0U;
+}
+
+static int8_t _negamax(uint16_t own, uint16_t other, uint8_t last_cell, int8_t alpha, int8_t beta)
+{
+    uint16_t empty = (uint16_t)(~(own | other) & TICTACTOE_BOARD_FULL);
+
+    if(0U != _line_find(other, last_cell))
+    {
+        /* Lost, later losses score better. */
+        return (int8_t)(-1 - __builtin_popcount(empty));
+    }
+
+    if(0U == empty)
+    {
+        return 0;
+    }
+
+    for(uint8_t index = 0U; index < TICTACTOE_CELLS; index++)
+    {
+        uint8_t cell = _move_order[index];
+
+        if(0U == (empty & TICTACTOE_CELL_MASK(cell)))
+        {
+            continue;
+        }
+
+        int8_t score = (int8_t)-_negamax(other, own | TICTACTOE_CELL_MASK(cell), cell, (int8_t)-beta, (int8_t)-alpha);
+        if(score > alpha)
+        {
+            alpha = score;
+        }
+
+        if(alpha >= beta)
+        {
+            break;
+        }
+    }
+
+    return alpha;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,157 @@
+/**
+ * @file tictactoe.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __TICTACTOE_C__
+#define __TICTACTOE_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+/* Cells are numbered row by row, 0 top left to 8 bottom right. */
+#define TICTACTOE_CELLS (9U)
+
+/* Move message: the sequence number, i.e. moves played before this one, followed by the cell. */
+#define TICTACTOE_MSG_SIZE (2U)
+
+/* Cell of a message that starts a new game, sent with sequence number 0. */
+#define TICTACTOE_CELL_NEW_GAME (0xFFU)
+
+/* Sequence number of a move that applies to whatever turn the game is at, e.g. typed by hand. */
+#define TICTACTOE_SEQ_ANY (0xFFU)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Enums hold players. X always moves first.
+ *
+ */
+typedef enum
+{
+    TICTACTOE_PLAYER_X,
+    TICTACTOE_PLAYER_O,
+
+    TICTACTOE_PLAYER_COUNT
+} tictactoe_player_t;
+
+/**
+ * @brief Enums hold game states.
+ *
+ */
+typedef enum
+{
+    TICTACTOE_STATE_PLAYING,
+    TICTACTOE_STATE_WON, /* The player who made the last move won. */
+    TICTACTOE_STATE_DRAW,
+
+    TICTACTOE_STATE_COUNT
+} tictactoe_state_t;
+
+/**
+ * @brief Game state. Every field is derived from the move log, the bitboards only make checks cheap.
+ *
+ */
+typedef struct
+{
+    uint16_t          board[TICTACTOE_PLAYER_COUNT]; /* Bit n set: the player holds cell n. */
+    uint8_t           log[TICTACTOE_CELLS];          /* Cells in the order they were played. */
+    uint8_t           moves;
+    tictactoe_state_t state;
+    uint16_t          win_line; /* Cells of the winning line, 0 unless won. */
+} tictactoe_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function clears the board.
+ *
+ * @param [out] p_game Game.
+ */
+void tictactoe_reset(tictactoe_t *p_game);
+
+/**
+ * @brief The function plays a move for the player on turn and checks only the lines through that cell.
+ *
+ * @param [in,out] p_game Game.
+ * @param [in]     cell   Cell, 0 - 8.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if the game is over, ESP_ERR_INVALID_ARG if the cell is
+ * out of range or taken.
+ */
+esp_err_t tictactoe_play(tictactoe_t *p_game, uint8_t cell);
+
+/**
+ * @brief The function takes back the last move.
+ *
+ * @param [in,out] p_game Game.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if no move was played.
+ */
+esp_err_t tictactoe_undo(tictactoe_t *p_game);
+
+/**
+ * @brief The function returns the player on turn.
+ *
+ * @param [in] p_game Game.
+ *
+ * @return tictactoe_player_t Player on turn.
+ */
+tictactoe_player_t tictactoe_turn(const tictactoe_t *p_game);
+
+/**
+ * @brief The function returns who holds a cell.
+ *
+ * @param [in] p_game Game.
+ * @param [in] cell   Cell, 0 - 8.
+ *
+ * @return tictactoe_player_t Owner, TICTACTOE_PLAYER_COUNT if the cell is empty.
+ */
+tictactoe_player_t tictactoe_cell_owner(const tictactoe_t *p_game, uint8_t cell);
+
+/**
+ * @brief The function finds a perfect move for the player on turn: openings come from a table, later positions are
+ * searched with minimax.
+ *
+ * @param [in]  p_game Game.
+ * @param [out] p_cell Best cell.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if the game is over.
+ */
+esp_err_t tictactoe_best_move(const tictactoe_t *p_game, uint8_t *p_cell);
+
+/**
+ * @brief The function encodes a move message.
+ *
+ * @param [in]  seq   Sequence number.
+ * @param [in]  cell  Cell or TICTACTOE_CELL_NEW_GAME.
+ * @param [out] p_msg TICTACTOE_MSG_SIZE bytes.
+ */
+void tictactoe_msg_encode(uint8_t seq, uint8_t cell, uint8_t *p_msg);
+
+/**
+ * @brief The function decodes a move message.
+ *
+ * @param [in]  p_msg  Message.
+ * @param [in]  len    Message length in bytes.
+ * @param [out] p_seq  Sequence number.
+ * @param [out] p_cell Cell or TICTACTOE_CELL_NEW_GAME.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if the message is malformed.
+ */
+esp_err_t tictactoe_msg_decode(const uint8_t *p_msg, size_t len, uint8_t *p_seq, uint8_t *p_cell);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TICTACTOE_C__
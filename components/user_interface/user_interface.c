@@ -11,6 +11,8 @@
 //--------------------------------- INCLUDES ----------------------------------
 #include "user_interface.h"
 #include "led.h"
+#include "led_pattern.h"
+#include "button.h"
 #include "gui.h"
 #include "gui_app.h"
 #include "freertos/FreeRTOS.h"
@@ -30,19 +32,45 @@
  */
 static void _user_interface_task(void *p_parameter);
 
+/**
+ * @brief Posts button gestures to the user interface queue. It runs in the button task.
+ *
+ * @param [in] p_event Recognized gesture.
+ * @param [in] p_arg   Unused.
+ */
+static void _button_event_cb(const button_event_t *p_event, void *p_arg);
+
 //------------------------- STATIC DATA & CONSTANTS ---------------------------
 static TaskHandle_t p_user_interface_task = NULL;
 
+static user_interface_app_handler_t p_app_handler = NULL;
+
+static const user_interface_event_t _button_events[BUTTON_COUNT][BUTTON_EVENT_COUNT] = {
+    [BUTTON_1] = {
+        [BUTTON_EVENT_SHORT_PRESS]  = USER_INTERFACE_EVENT_BUTTON_1_SHORT_PRESS,
+        [BUTTON_EVENT_LONG_PRESS]   = USER_INTERFACE_EVENT_BUTTON_1_LONG_PRESS,
+        [BUTTON_EVENT_DOUBLE_PRESS] = USER_INTERFACE_EVENT_BUTTON_1_DOUBLE_PRESS,
+    },
+    [BUTTON_2] = {
+        [BUTTON_EVENT_SHORT_PRESS]  = USER_INTERFACE_EVENT_BUTTON_2_SHORT_PRESS,
+        [BUTTON_EVENT_LONG_PRESS]   = USER_INTERFACE_EVENT_BUTTON_2_LONG_PRESS,
+        [BUTTON_EVENT_DOUBLE_PRESS] = USER_INTERFACE_EVENT_BUTTON_2_DOUBLE_PRESS,
+    },
+};
+
 //------------------------------- GLOBAL DATA ---------------------------------
 QueueHandle_t p_user_interface_queue = NULL;
 
 //------------------------------ PUBLIC FUNCTIONS -----------------------------
-void user_interface_init(void)
+void user_interface_init(user_interface_app_handler_t p_handler)
 {
-    led_init(LED_BLUE);
+    p_app_handler = p_handler;
+
+    led_pattern_init();
     gui_init();
 
-    p_user_interface_queue = xQueueCreate(USER_INTERFACE_QUEUE_SIZE, sizeof(gui_app_event_t));
+    /* Items are USER_INTERFACE_MSG() words, a bare gui_app_event_t is a message without an argument. */
+    p_user_interface_queue = xQueueCreate(USER_INTERFACE_QUEUE_SIZE, sizeof(uint32_t));
     if(p_user_interface_queue == NULL)
     {
         printf("User interface queue was not initialized successfully\n");
@@ -54,21 +82,42 @@ void user_interface_init(void)
         printf("User interface task was not initialized successfully\n");
         return;
     }
+
+    if(ESP_OK != button_init(_button_event_cb, NULL))
+    {
+        printf("Buttons were not initialized successfully\n");
+        return;
+    }
+}
+
+esp_err_t user_interface_post(user_interface_event_t event, uint16_t arg)
+{
+    if(p_user_interface_queue == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint32_t msg = USER_INTERFACE_MSG(event, arg);
+
+    return (pdTRUE == xQueueSend(p_user_interface_queue, &msg, 0U)) ? ESP_OK : ESP_ERR_TIMEOUT;
 }
 
 //---------------------------- PRIVATE FUNCTIONS ------------------------------
 static void _user_interface_task(void *p_parameter)
 {
-    gui_app_event_t gui_event;
+    uint32_t msg;
 
     for(;;)
     {
         /* Blockingly wait on an event. */
-        if((p_user_interface_queue != NULL) && (xQueueReceive(p_user_interface_queue, &gui_event, portMAX_DELAY) == pdTRUE))
+        if((p_user_interface_queue != NULL) && (xQueueReceive(p_user_interface_queue, &msg, portMAX_DELAY) == pdTRUE))
         {
-            printf("GUI event received %d\n", gui_event);
+            user_interface_event_t event = (user_interface_event_t)USER_INTERFACE_MSG_EVENT(msg);
+            uint16_t               arg   = USER_INTERFACE_MSG_ARG(msg);
 
-            switch(gui_event)
+            printf("UI event received %d\n", event);
+
+            switch((int)event)
             {
                 case GUI_APP_EVENT_BUTTON_LED_ON_PRESSED:
                     led_on(LED_BLUE);
@@ -77,6 +126,46 @@ static void _user_interface_task(void *p_parameter)
                 case GUI_APP_EVENT_BUTTON_LED_OFF_PRESSED:
                     led_off(LED_BLUE);
                     break;
+
+                case USER_INTERFACE_EVENT_BUTTON_1_SHORT_PRESS:
+                    led_pattern_play(LED_PATTERN_SOS, LED_PATTERN_CHANNELS_ALL, LED_PATTERN_PRIO_HIGH);
+                    break;
+
+                case USER_INTERFACE_EVENT_BUTTON_2_SHORT_PRESS:
+                    led_pattern_stop(LED_PATTERN_CHANNELS_ALL, LED_PATTERN_PRIO_HIGH);
+                    break;
+
+                case USER_INTERFACE_EVENT_REMOTE_LED:
+                    (void)led_set_masked((uint8_t)(arg & 0xFFU), (uint8_t)(arg >> 8U));
+                    break;
+
+                case USER_INTERFACE_EVENT_REMOTE_BUZZER:
+                    if(USER_INTERFACE_BUZZER_OFF == arg)
+                    {
+                        led_pattern_stop(LED_PATTERN_CHANNEL_MASK(LED_PATTERN_CHANNEL_BUZZER), LED_PATTERN_PRIO_NORMAL);
+                    }
+                    else
+                    {
+                        led_pattern_play((led_pattern_t)arg, LED_PATTERN_CHANNEL_MASK(LED_PATTERN_CHANNEL_BUZZER),
+                                         LED_PATTERN_PRIO_NORMAL);
+                    }
+                    break;
+
+                case USER_INTERFACE_EVENT_REMOTE_MOVE:
+                    (void)gui_app_game_remote_move((uint8_t)(arg >> 8U), (uint8_t)(arg & 0xFFU));
+                    break;
+
+                case USER_INTERFACE_EVENT_BUTTON_1_LONG_PRESS:
+                case USER_INTERFACE_EVENT_BUTTON_1_DOUBLE_PRESS:
+                case USER_INTERFACE_EVENT_BUTTON_2_LONG_PRESS:
+                case USER_INTERFACE_EVENT_BUTTON_2_DOUBLE_PRESS:
+                case USER_INTERFACE_EVENT_REMOTE_RATE:
+                    if(NULL != p_app_handler)
+                    {
+                        p_app_handler(event, arg);
+                    }
+                    break;
+
                 default:
                     printf("Uknown GUI event\n");
                     break;
@@ -85,4 +174,11 @@ static void _user_interface_task(void *p_parameter)
     }
 }
 
+static void _button_event_cb(const button_event_t *p_event, void *p_arg)
+{
+    (void)p_arg;
+
+    (void)user_interface_post(_button_events[p_event->button][p_event->type], 0U);
+}
+
 //---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -15,18 +15,71 @@ extern "C" {
 #endif
 
 //--------------------------------- INCLUDES ----------------------------------
+#include "gui_app.h"
+#include "led_pattern.h"
+#include "esp_err.h"
+#include <stdint.h>
 
 //---------------------------------- MACROS -----------------------------------
+/* Queue items are 32 bits wide: the event in the lower half and its argument, if any, in the upper half. */
+#define USER_INTERFACE_MSG(EVENT, ARG) ((uint32_t)(EVENT) | ((uint32_t)(ARG) << 16U))
+#define USER_INTERFACE_MSG_EVENT(MSG)  ((uint16_t)((MSG) & 0xFFFFU))
+#define USER_INTERFACE_MSG_ARG(MSG)    ((uint16_t)((MSG) >> 16U))
+
+/* Argument of USER_INTERFACE_EVENT_REMOTE_LED: LEDs to be written and those of them to be turned on. */
+#define USER_INTERFACE_LED_ARG(MASK, ON_MASK) ((uint16_t)((uint16_t)(MASK) | ((uint16_t)(ON_MASK) << 8U)))
+
+/* Argument of USER_INTERFACE_EVENT_REMOTE_BUZZER that stops the buzzer. */
+#define USER_INTERFACE_BUZZER_OFF ((uint16_t)LED_PATTERN_COUNT)
 
 //-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Enums hold hardware button and remote command events. They share p_user_interface_queue with
+ * gui_app_event_t, so they are numbered after it.
+ *
+ */
+typedef enum
+{
+    USER_INTERFACE_EVENT_BUTTON_1_SHORT_PRESS = GUI_APP_EVENT_COUNT,
+    USER_INTERFACE_EVENT_BUTTON_1_LONG_PRESS,
+    USER_INTERFACE_EVENT_BUTTON_1_DOUBLE_PRESS,
+    USER_INTERFACE_EVENT_BUTTON_2_SHORT_PRESS,
+    USER_INTERFACE_EVENT_BUTTON_2_LONG_PRESS,
+    USER_INTERFACE_EVENT_BUTTON_2_DOUBLE_PRESS,
+    USER_INTERFACE_EVENT_REMOTE_LED,    /* Argument from USER_INTERFACE_LED_ARG(). */
+    USER_INTERFACE_EVENT_REMOTE_BUZZER, /* Argument is a led_pattern_t or USER_INTERFACE_BUZZER_OFF. */
+    USER_INTERFACE_EVENT_REMOTE_MOVE,   /* Argument is the cell in the low and the sequence number in the high byte. */
+    USER_INTERFACE_EVENT_REMOTE_RATE,   /* Argument is a sht31_rate_t. */
+
+    USER_INTERFACE_EVENT_COUNT
+} user_interface_event_t;
+
+/**
+ * @brief Application handler for button and remote events. It runs in the user interface task.
+ *
+ * @param [in] event Button or remote event.
+ * @param [in] arg   Event argument, 0 for button events.
+ */
+typedef void (*user_interface_app_handler_t)(user_interface_event_t event, uint16_t arg);
 
 //---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
 /**
  * @brief The function initialized user interface that will act as a glue code,
  * connecting GUI, buttons and LEDs.
  *
+ * @param [in] p_handler Optional handler for button and remote events the user interface does not consume itself.
+ */
+void user_interface_init(user_interface_app_handler_t p_handler);
+
+/**
+ * @brief The function unblockingly posts an event to the user interface queue. It can be called from any task.
+ *
+ * @param [in] event Event to be posted.
+ * @param [in] arg   Event argument.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE before init, ESP_ERR_TIMEOUT if the queue is full.
  */
-void user_interface_init(void);
+esp_err_t user_interface_post(user_interface_event_t event, uint16_t arg);
 
 #ifdef __cplusplus
 }
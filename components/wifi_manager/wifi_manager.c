@@ -0,0 +1,918 @@
+/**
+ * @file wifi_manager.c
+ *
+ * @brief This file keeps the Wi-Fi station connected. A single task owns the connection state; Wi-Fi events, the
+ * retry timer and provisioning requests are posted to it. After a power cycle the station joins the access point it
+ * used last, straight from the channel and BSSID cached in NVS, so no scan is needed. A failed fast connect falls
+ * back to one scan that ranks the stored networks by RSSI, and when none of them answers the next attempt is
+ * scheduled with exponential backoff and jitter instead of spinning the radio.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "wifi_manager.h"
+#include "esp_event.h"
+#include "esp_log.h"
+#include "esp_netif.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "nvs.h"
+#include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <stdio.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define WIFI_MANAGER_NVS_NAMESPACE    ("wifi_mgr")
+#define WIFI_MANAGER_NVS_KEY_NETWORKS ("networks")
+#define WIFI_MANAGER_NVS_KEY_CACHE    ("cache")
+
+/* Retry delays double from BACKOFF_BASE_MS up to BACKOFF_MAX_MS, the actual delay is drawn from the upper half. */
+#define BACKOFF_BASE_MS   (500U)
+#define BACKOFF_MAX_MS    (60000U)
+#define BACKOFF_SHIFT_MAX (7U)
+
+#define SCAN_RECORDS_MAX (16U)
+
+#define WIFI_MANAGER_QUEUE_SIZE (8U)
+
+#define WIFI_MANAGER_TASK_STACK_SIZE (4U * 1024U)
+#define WIFI_MANAGER_TASK_PRIORITY   (5U)
+
+#define PROVISION_UART          (UART_NUM_0)
+#define PROVISION_UART_BUF_SIZE (256U)
+#define PROVISION_LINE_SIZE     (128U)
+
+#define PROVISION_TASK_STACK_SIZE (3U * 1024U)
+/* Typing is slow, anything else may go first. */
+#define PROVISION_TASK_PRIORITY (1U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Enums hold requests handled by the manager task.
+ *
+ */
+typedef enum
+{
+    _MSG_STA_START,
+    _MSG_STA_DISCONNECTED,
+    _MSG_SCAN_DONE,
+    _MSG_GOT_IP,
+    _MSG_RETRY,
+    _MSG_ADD_NETWORK,
+    _MSG_CLEAR_NETWORKS,
+    _MSG_RADIO_ON,
+    _MSG_RADIO_OFF,
+} _wifi_manager_msg_type_t;
+
+/**
+ * @brief Request posted to the manager task.
+ *
+ */
+typedef struct
+{
+    _wifi_manager_msg_type_t type;
+    wifi_manager_network_t   network; /* Only for _MSG_ADD_NETWORK. */
+} _wifi_manager_msg_t;
+
+/**
+ * @brief Stored networks, kept in NVS as one blob. Index 0 is the most recently provisioned one.
+ *
+ */
+typedef struct
+{
+    uint8_t                count;
+    wifi_manager_network_t networks[WIFI_MANAGER_NETWORKS_MAX];
+} _wifi_manager_store_t;
+
+/**
+ * @brief Access point of the last successful connection, kept in NVS.
+ *
+ */
+typedef struct
+{
+    uint8_t network; /* Index into the store. */
+    uint8_t channel;
+    uint8_t bssid[6];
+} _wifi_manager_cache_t;
+
+/**
+ * @brief Access point found by a scan for one of the stored networks.
+ *
+ */
+typedef struct
+{
+    uint8_t network;
+    uint8_t channel;
+    int8_t  rssi;
+    uint8_t bssid[6];
+} _wifi_manager_candidate_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Manager task.
+ *
+ * @param [in] p_parameter This is the parameter that is passed to the task.
+ */
+static void _wifi_manager_task(void *p_parameter);
+
+/**
+ * @brief Starts a new attempt series: the cached access point if there is one, a scan otherwise.
+ */
+static void _connect_start(void);
+
+/**
+ * @brief Tries the next scanned candidate, or schedules a retry when there is none left.
+ */
+static void _connect_next(void);
+
+/**
+ * @brief Configures the station for one access point and connects.
+ */
+static void _connect_to(uint8_t network, uint8_t channel, const uint8_t *p_bssid);
+
+/**
+ * @brief Ranks the stored networks found by the last scan by RSSI.
+ */
+static void _scan_done(void);
+
+/**
+ * @brief Stores the access point of the new connection in the cache, if it changed.
+ */
+static void _connected(void);
+
+/**
+ * @brief Schedules the next attempt series with exponential backoff and jitter.
+ */
+static void _retry_schedule(void);
+
+/**
+ * @brief Starts or stops the Wi-Fi driver.
+ */
+static void _radio_set(bool b_is_on);
+
+/**
+ * @brief Applies a provisioning request to the store.
+ */
+static void _networks_update(const _wifi_manager_msg_t *p_msg);
+
+/**
+ * @brief Reads the store and the cache from NVS.
+ */
+static void _nvs_load(void);
+
+/**
+ * @brief Writes the store to NVS.
+ */
+static void _nvs_store_save(void);
+
+/**
+ * @brief Writes the cache to NVS, or erases it if it is not valid.
+ */
+static void _nvs_cache_save(void);
+
+/**
+ * @brief Reports a state change through the callback.
+ */
+static void _state_set(wifi_manager_state_t state);
+
+/**
+ * @brief Posts a request to the manager task.
+ */
+static esp_err_t _msg_post(const _wifi_manager_msg_t *p_msg);
+
+/**
+ * @brief Retry timer callback, runs in the esp_timer task.
+ */
+static void _retry_timer_cb(void *p_arg);
+
+/**
+ * @brief Serial provisioning task, reads console lines:
+ *        wifi add <ssid> [password]
+ *        wifi clear
+ *
+ * @param [in] p_parameter This is the parameter that is passed to the task.
+ */
+static void _provision_task(void *p_parameter);
+
+/**
+ * @brief Parses one console line.
+ */
+static void _provision_line_parse(char *p_line);
+
+/**
+ * @brief Wi-Fi and IP event handler, runs in the default event loop task.
+ */
+static void _event_handler(void *p_arg, esp_event_base_t event_base, int32_t event_id, void *p_event_data);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "WIFI_MANAGER";
+
+static QueueHandle_t           p_msg_queue        = NULL;
+static esp_timer_handle_t      p_retry_timer      = NULL;
+static wifi_manager_state_cb_t p_wifi_manager_cb  = NULL;
+static void                   *p_wifi_manager_arg = NULL;
+static nvs_handle_t            _nvs;
+
+static _wifi_manager_store_t _store;
+static _wifi_manager_cache_t _cache;
+static bool                  _b_is_cache_valid = false;
+
+static wifi_ap_record_t          _scan_records[SCAN_RECORDS_MAX];
+static _wifi_manager_candidate_t _candidates[WIFI_MANAGER_NETWORKS_MAX];
+static uint8_t                   _candidate_count = 0U;
+static uint8_t                   _candidate_next  = 0U;
+
+static uint8_t _network           = 0U; /* Network of the current attempt. */
+static bool    _b_is_connected    = false;
+static bool    _b_is_fast_connect = false; /* Current attempt uses the cache. */
+static bool    _b_is_scanning     = false;
+static bool    _b_is_radio_off    = false;
+static uint8_t _retry_count       = 0U;
+static int64_t _series_start_us   = 0;
+
+static wifi_manager_stats_t _stats;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t wifi_manager_init(const wifi_manager_config_t *p_config)
+{
+    if(NULL == p_config)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(NULL != p_msg_queue)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    p_wifi_manager_cb  = p_config->p_state_cb;
+    p_wifi_manager_arg = p_config->p_cb_arg;
+
+    p_msg_queue = xQueueCreate(WIFI_MANAGER_QUEUE_SIZE, sizeof(_wifi_manager_msg_t));
+    if(NULL == p_msg_queue)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t esp_err = nvs_open(WIFI_MANAGER_NVS_NAMESPACE, NVS_READWRITE, &_nvs);
+
+    if(ESP_OK == esp_err)
+    {
+        _nvs_load();
+
+        if((0U == _store.count) && (NULL != p_config->p_default_network))
+        {
+            _store.networks[0] = *p_config->p_default_network;
+            _store.count       = 1U;
+            _nvs_store_save();
+        }
+
+        const esp_timer_create_args_t timer_args = {
+            .callback = &_retry_timer_cb,
+            .name     = "wifi_retry",
+        };
+        esp_err = esp_timer_create(&timer_args, &p_retry_timer);
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = esp_netif_init();
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        /* Someone else may own the default loop already. */
+        esp_err = esp_event_loop_create_default();
+        esp_err = (ESP_ERR_INVALID_STATE == esp_err) ? ESP_OK : esp_err;
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        (void)esp_netif_create_default_wifi_sta();
+
+        wifi_init_config_t init_config = WIFI_INIT_CONFIG_DEFAULT();
+        esp_err                        = esp_wifi_init(&init_config);
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        /* Credentials and the cache live in our own namespace, the driver would only rewrite flash on every connect. */
+        esp_err = esp_wifi_set_storage(WIFI_STORAGE_RAM);
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &_event_handler, NULL, NULL);
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &_event_handler, NULL, NULL);
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        if(pdPASS != xTaskCreate(&_wifi_manager_task, "wifi_manager_task", WIFI_MANAGER_TASK_STACK_SIZE, NULL,
+                                 WIFI_MANAGER_TASK_PRIORITY, NULL))
+        {
+            esp_err = ESP_ERR_NO_MEM;
+        }
+    }
+
+    if((ESP_OK == esp_err) && p_config->b_is_serial_provisioning)
+    {
+        esp_err = uart_driver_install(PROVISION_UART, PROVISION_UART_BUF_SIZE, 0, 0, NULL, 0);
+
+        if((ESP_OK == esp_err) && (pdPASS != xTaskCreate(&_provision_task, "provision_task", PROVISION_TASK_STACK_SIZE,
+                                                          NULL, PROVISION_TASK_PRIORITY, NULL)))
+        {
+            esp_err = ESP_ERR_NO_MEM;
+        }
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = esp_wifi_set_mode(WIFI_MODE_STA);
+    }
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = esp_wifi_start();
+    }
+
+    if(ESP_OK != esp_err)
+    {
+        ESP_LOGE(TAG, "Init failed: %s", esp_err_to_name(esp_err));
+    }
+
+    return esp_err;
+}
+
+esp_err_t wifi_manager_add_network(const char *p_ssid, const char *p_password)
+{
+    if((NULL == p_ssid) || (0U == strlen(p_ssid)) || (WIFI_MANAGER_SSID_SIZE <= strlen(p_ssid)) ||
+       ((NULL != p_password) && (WIFI_MANAGER_PASSWORD_SIZE <= strlen(p_password))))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    _wifi_manager_msg_t msg = { .type = _MSG_ADD_NETWORK };
+    (void)strcpy(msg.network.ssid, p_ssid);
+    (void)strcpy(msg.network.password, (NULL != p_password) ? p_password : "");
+
+    return _msg_post(&msg);
+}
+
+esp_err_t wifi_manager_clear_networks(void)
+{
+    _wifi_manager_msg_t msg = { .type = _MSG_CLEAR_NETWORKS };
+
+    return _msg_post(&msg);
+}
+
+esp_err_t wifi_manager_set_radio(bool b_is_on)
+{
+    _wifi_manager_msg_t msg = { .type = b_is_on ? _MSG_RADIO_ON : _MSG_RADIO_OFF };
+
+    return _msg_post(&msg);
+}
+
+void wifi_manager_get_stats(wifi_manager_stats_t *p_stats)
+{
+    if(NULL != p_stats)
+    {
+        *p_stats = _stats;
+    }
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _wifi_manager_task(void *p_parameter)
+{
+    _wifi_manager_msg_t msg;
+
+    for(;;)
+    {
+        if(pdTRUE != xQueueReceive(p_msg_queue, &msg, portMAX_DELAY))
+        {
+            continue;
+        }
+
+        /* Events still in flight from before the radio was stopped. */
+        if(_b_is_radio_off && (_MSG_ADD_NETWORK != msg.type) && (_MSG_CLEAR_NETWORKS != msg.type) &&
+           (_MSG_RADIO_ON != msg.type))
+        {
+            continue;
+        }
+
+        switch(msg.type)
+        {
+            case _MSG_STA_START:
+            case _MSG_RETRY:
+                _connect_start();
+                break;
+
+            case _MSG_SCAN_DONE:
+                _b_is_scanning = false;
+                _scan_done();
+                break;
+
+            case _MSG_GOT_IP:
+                _connected();
+                break;
+
+            case _MSG_STA_DISCONNECTED:
+                if(_b_is_connected)
+                {
+                    /* The access point we just lost is the cached one, which makes it the best first guess. */
+                    _b_is_connected = false;
+                    _retry_count    = 0U;
+                    _state_set(WIFI_MANAGER_STATE_DISCONNECTED);
+                    _connect_start();
+                }
+                else if(_b_is_fast_connect)
+                {
+                    /* The access point moved or is gone, find the stored networks again. */
+                    _stats.failures++;
+                    _b_is_fast_connect = false;
+                    _b_is_cache_valid  = false;
+                    _connect_start();
+                }
+                else if(!_b_is_scanning)
+                {
+                    _stats.failures++;
+                    _connect_next();
+                }
+                else
+                {
+                    /* Not attempting anything. */
+                }
+                break;
+
+            case _MSG_ADD_NETWORK:
+            case _MSG_CLEAR_NETWORKS:
+                _networks_update(&msg);
+                break;
+
+            case _MSG_RADIO_ON:
+            case _MSG_RADIO_OFF:
+                _radio_set(_MSG_RADIO_ON == msg.type);
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+static void _connect_start(void)
+{
+    (void)esp_timer_stop(p_retry_timer);
+
+    if(0U == _retry_count)
+    {
+        _series_start_us = esp_timer_get_time();
+    }
+
+    if(0U == _store.count)
+    {
+        ESP_LOGW(TAG, "No network stored, waiting for provisioning");
+        _state_set(WIFI_MANAGER_STATE_PROVISIONING);
+        return;
+    }
+
+    _state_set(WIFI_MANAGER_STATE_CONNECTING);
+
+    if(_b_is_cache_valid && (_cache.network < _store.count))
+    {
+        _b_is_fast_connect = true;
+        _connect_to(_cache.network, _cache.channel, _cache.bssid);
+        return;
+    }
+
+    /* Passive scanning would not make it faster, dwell per channel is the cost either way. */
+    wifi_scan_config_t scan_config = {
+        .show_hidden = true,
+        .scan_type   = WIFI_SCAN_TYPE_ACTIVE,
+    };
+
+    _candidate_count = 0U;
+    _candidate_next  = 0U;
+
+    if(ESP_OK == esp_wifi_scan_start(&scan_config, false))
+    {
+        _b_is_scanning = true;
+        _stats.scans++;
+    }
+    else
+    {
+        _retry_schedule();
+    }
+}
+
+static void _connect_next(void)
+{
+    if(_candidate_next < _candidate_count)
+    {
+        const _wifi_manager_candidate_t *p_candidate = &_candidates[_candidate_next];
+
+        _candidate_next++;
+        _connect_to(p_candidate->network, p_candidate->channel, p_candidate->bssid);
+    }
+    else
+    {
+        _retry_schedule();
+    }
+}
+
+static void _connect_to(uint8_t network, uint8_t channel, const uint8_t *p_bssid)
+{
+    const wifi_manager_network_t *p_network = &_store.networks[network];
+
+    wifi_config_t wifi_config = {
+        .sta = {
+            /* A known channel and BSSID turn the connect scan into a single probe. */
+            .scan_method        = WIFI_FAST_SCAN,
+            .bssid_set          = true,
+            .channel            = channel,
+            .threshold.authmode = (0U == strlen(p_network->password)) ? WIFI_AUTH_OPEN : WIFI_AUTH_WPA2_PSK,
+            .sae_pwe_h2e        = WPA3_SAE_PWE_BOTH,
+        },
+    };
+
+    /* The driver fields are not NUL terminated when full. */
+    (void)strncpy((char *)wifi_config.sta.ssid, p_network->ssid, sizeof(wifi_config.sta.ssid));
+    (void)strncpy((char *)wifi_config.sta.password, p_network->password, sizeof(wifi_config.sta.password));
+    (void)memcpy(wifi_config.sta.bssid, p_bssid, sizeof(wifi_config.sta.bssid));
+
+    _network = network;
+
+    ESP_LOGI(TAG, "Connecting to %s on channel %u%s", p_network->ssid, channel, _b_is_fast_connect ? " (cached)" : "");
+
+    esp_err_t esp_err = esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = esp_wifi_connect();
+    }
+
+    if(ESP_OK != esp_err)
+    {
+        /* No disconnect event follows a connect that was not started. */
+        ESP_LOGW(TAG, "Connect failed: %s", esp_err_to_name(esp_err));
+        _b_is_fast_connect = false;
+        _retry_schedule();
+    }
+}
+
+static void _scan_done(void)
+{
+    uint16_t record_count = SCAN_RECORDS_MAX;
+
+    if(ESP_OK != esp_wifi_scan_get_ap_records(&record_count, _scan_records))
+    {
+        record_count = 0U;
+    }
+
+    /* Keep the strongest access point of every stored network. */
+    for(uint16_t record = 0U; record < record_count; record++)
+    {
+        const wifi_ap_record_t *p_record = &_scan_records[record];
+
+        for(uint8_t network = 0U; network < _store.count; network++)
+        {
+            if(0 != strncmp((const char *)p_record->ssid, _store.networks[network].ssid, WIFI_MANAGER_SSID_SIZE))
+            {
+                continue;
+            }
+
+            uint8_t candidate = 0U;
+            while((candidate < _candidate_count) && (network != _candidates[candidate].network))
+            {
+                candidate++;
+            }
+
+            if((candidate == _candidate_count) || (p_record->rssi > _candidates[candidate].rssi))
+            {
+                _candidates[candidate].network = network;
+                _candidates[candidate].channel = p_record->primary;
+                _candidates[candidate].rssi    = p_record->rssi;
+                (void)memcpy(_candidates[candidate].bssid, p_record->bssid, sizeof(_candidates[candidate].bssid));
+                _candidate_count = (candidate == _candidate_count) ? (_candidate_count + 1U) : _candidate_count;
+            }
+        }
+    }
+
+    /* Strongest first, there are at most WIFI_MANAGER_NETWORKS_MAX of them. */
+    for(uint8_t i = 1U; i < _candidate_count; i++)
+    {
+        _wifi_manager_candidate_t candidate = _candidates[i];
+        uint8_t                   j         = i;
+
+        while((0U < j) && (_candidates[j - 1U].rssi < candidate.rssi))
+        {
+            _candidates[j] = _candidates[j - 1U];
+            j--;
+        }
+        _candidates[j] = candidate;
+    }
+
+    ESP_LOGI(TAG, "Scan found %u of %u stored networks", _candidate_count, _store.count);
+
+    _connect_next();
+}
+
+static void _connected(void)
+{
+    wifi_ap_record_t ap_info;
+
+    _stats.connects++;
+    _stats.fast_connects += _b_is_fast_connect ? 1U : 0U;
+    _stats.last_connect_ms = (uint32_t)((esp_timer_get_time() - _series_start_us) / 1000);
+
+    _b_is_connected    = true;
+    _b_is_fast_connect = false;
+    _retry_count       = 0U;
+
+    if(ESP_OK == esp_wifi_sta_get_ap_info(&ap_info))
+    {
+        bool b_is_same = _b_is_cache_valid && (_network == _cache.network) && (ap_info.primary == _cache.channel) &&
+                         (0 == memcmp(ap_info.bssid, _cache.bssid, sizeof(_cache.bssid)));
+
+        /* Flash is written only when the access point changed, not on every connect. */
+        if(!b_is_same)
+        {
+            _cache.network = _network;
+            _cache.channel = ap_info.primary;
+            (void)memcpy(_cache.bssid, ap_info.bssid, sizeof(_cache.bssid));
+            _b_is_cache_valid = true;
+            _nvs_cache_save();
+        }
+    }
+
+    ESP_LOGI(TAG, "Connected in %lu ms", (unsigned long)_stats.last_connect_ms);
+    _state_set(WIFI_MANAGER_STATE_CONNECTED);
+}
+
+static void _retry_schedule(void)
+{
+    uint8_t  shift      = (_retry_count < BACKOFF_SHIFT_MAX) ? _retry_count : BACKOFF_SHIFT_MAX;
+    uint32_t ceiling_ms = BACKOFF_BASE_MS << shift;
+    ceiling_ms          = (ceiling_ms < BACKOFF_MAX_MS) ? ceiling_ms : BACKOFF_MAX_MS;
+
+    /* Jitter keeps a room full of boards from hammering a rebooted access point in lockstep. */
+    uint32_t delay_ms = (ceiling_ms / 2U) + (esp_random() % ((ceiling_ms / 2U) + 1U));
+
+    _retry_count = (_retry_count < UINT8_MAX) ? (_retry_count + 1U) : _retry_count;
+
+    ESP_LOGI(TAG, "Retry %u in %lu ms", _retry_count, (unsigned long)delay_ms);
+    _state_set(WIFI_MANAGER_STATE_DISCONNECTED);
+
+    (void)esp_timer_stop(p_retry_timer);
+    (void)esp_timer_start_once(p_retry_timer, (uint64_t)delay_ms * 1000U);
+}
+
+static void _radio_set(bool b_is_on)
+{
+    if(b_is_on == !_b_is_radio_off)
+    {
+        return;
+    }
+
+    _b_is_radio_off = !b_is_on;
+
+    if(b_is_on)
+    {
+        /* STA_START kicks off a new attempt series. */
+        _retry_count = 0U;
+        (void)esp_wifi_start();
+        return;
+    }
+
+    (void)esp_timer_stop(p_retry_timer);
+    (void)esp_wifi_stop();
+
+    _b_is_scanning     = false;
+    _b_is_fast_connect = false;
+
+    if(_b_is_connected)
+    {
+        _b_is_connected = false;
+        _state_set(WIFI_MANAGER_STATE_DISCONNECTED);
+    }
+}
+
+static void _networks_update(const _wifi_manager_msg_t *p_msg)
+{
+    if(_MSG_CLEAR_NETWORKS == p_msg->type)
+    {
+        (void)memset(&_store, 0, sizeof(_store));
+        _b_is_cache_valid = false;
+        _nvs_store_save();
+        _nvs_cache_save();
+        ESP_LOGI(TAG, "Networks cleared");
+        return;
+    }
+
+    uint8_t network = 0U;
+    while((network < _store.count) && (0 != strcmp(_store.networks[network].ssid, p_msg->network.ssid)))
+    {
+        network++;
+    }
+
+    /* A new network goes to the front, pushing the oldest one out when the store is full. */
+    if(network == _store.count)
+    {
+        network = (_store.count < WIFI_MANAGER_NETWORKS_MAX) ? _store.count : (WIFI_MANAGER_NETWORKS_MAX - 1U);
+        _store.count = (_store.count < WIFI_MANAGER_NETWORKS_MAX) ? (_store.count + 1U) : _store.count;
+    }
+
+    (void)memmove(&_store.networks[1], &_store.networks[0], network * sizeof(_store.networks[0]));
+    _store.networks[0] = p_msg->network;
+
+    /* Indices moved, the cached access point could now point at another network. */
+    _b_is_cache_valid = false;
+    _nvs_store_save();
+    _nvs_cache_save();
+
+    ESP_LOGI(TAG, "Network %s stored", p_msg->network.ssid);
+
+    if(!_b_is_connected && !_b_is_scanning && !_b_is_radio_off)
+    {
+        _retry_count = 0U;
+        _connect_start();
+    }
+}
+
+static void _nvs_load(void)
+{
+    size_t size = sizeof(_store);
+
+    if((ESP_OK != nvs_get_blob(_nvs, WIFI_MANAGER_NVS_KEY_NETWORKS, &_store, &size)) || (sizeof(_store) != size) ||
+       (WIFI_MANAGER_NETWORKS_MAX < _store.count))
+    {
+        (void)memset(&_store, 0, sizeof(_store));
+    }
+
+    size              = sizeof(_cache);
+    _b_is_cache_valid = (ESP_OK == nvs_get_blob(_nvs, WIFI_MANAGER_NVS_KEY_CACHE, &_cache, &size)) &&
+                        (sizeof(_cache) == size) && (_cache.network < _store.count);
+
+    ESP_LOGI(TAG, "%u stored networks, cached access point %s", _store.count, _b_is_cache_valid ? "valid" : "none");
+}
+
+static void _nvs_store_save(void)
+{
+    esp_err_t esp_err = nvs_set_blob(_nvs, WIFI_MANAGER_NVS_KEY_NETWORKS, &_store, sizeof(_store));
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = nvs_commit(_nvs);
+    }
+
+    if(ESP_OK != esp_err)
+    {
+        ESP_LOGW(TAG, "Saving networks failed: %s", esp_err_to_name(esp_err));
+    }
+}
+
+static void _nvs_cache_save(void)
+{
+    esp_err_t esp_err = _b_is_cache_valid ? nvs_set_blob(_nvs, WIFI_MANAGER_NVS_KEY_CACHE, &_cache, sizeof(_cache))
+                                          : nvs_erase_key(_nvs, WIFI_MANAGER_NVS_KEY_CACHE);
+
+    esp_err = (ESP_ERR_NVS_NOT_FOUND == esp_err) ? ESP_OK : esp_err;
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = nvs_commit(_nvs);
+    }
+
+    if(ESP_OK != esp_err)
+    {
+        ESP_LOGW(TAG, "Saving cache failed: %s", esp_err_to_name(esp_err));
+    }
+}
+
+static void _state_set(wifi_manager_state_t state)
+{
+    if(NULL != p_wifi_manager_cb)
+    {
+        p_wifi_manager_cb(state, p_wifi_manager_arg);
+    }
+}
+
+static esp_err_t _msg_post(const _wifi_manager_msg_t *p_msg)
+{
+    if(NULL == p_msg_queue)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return (pdTRUE == xQueueSend(p_msg_queue, p_msg, 0)) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+static void _retry_timer_cb(void *p_arg)
+{
+    _wifi_manager_msg_t msg = { .type = _MSG_RETRY };
+
+    (void)_msg_post(&msg);
+}
+
+static void _provision_task(void *p_parameter)
+{
+    static char line[PROVISION_LINE_SIZE];
+    size_t      len = 0U;
+    uint8_t     c;
+
+    for(;;)
+    {
+        if(1 != uart_read_bytes(PROVISION_UART, &c, 1U, portMAX_DELAY))
+        {
+            continue;
+        }
+
+        if(('\r' == c) || ('\n' == c))
+        {
+            line[len] = '\0';
+            _provision_line_parse(line);
+            len = 0U;
+        }
+        else if(len < (sizeof(line) - 1U))
+        {
+            line[len] = (char)c;
+            len++;
+        }
+        else
+        {
+            /* Overlong line, the tail is dropped and the command rejected by the parser. */
+        }
+    }
+}
+
+static void _provision_line_parse(char *p_line)
+{
+    char *p_save     = NULL;
+    char *p_command  = strtok_r(p_line, " ", &p_save);
+    char *p_action   = strtok_r(NULL, " ", &p_save);
+    char *p_ssid     = strtok_r(NULL, " ", &p_save);
+    char *p_password = strtok_r(NULL, " ", &p_save);
+
+    if((NULL == p_command) || (0 != strcmp(p_command, "wifi")) || (NULL == p_action))
+    {
+        return;
+    }
+
+    esp_err_t esp_err = ESP_ERR_INVALID_ARG;
+
+    if(0 == strcmp(p_action, "add"))
+    {
+        esp_err = wifi_manager_add_network(p_ssid, p_password);
+    }
+    else if(0 == strcmp(p_action, "clear"))
+    {
+        esp_err = wifi_manager_clear_networks();
+    }
+    else
+    {
+        /* Unknown action. */
+    }
+
+    printf("wifi %s: %s\n", p_action, esp_err_to_name(esp_err));
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
+static void _event_handler(void *p_arg, esp_event_base_t event_base, int32_t event_id, void *p_event_data)
+{
+    _wifi_manager_msg_t msg = { 0 };
+
+    if((WIFI_EVENT == event_base) && (WIFI_EVENT_STA_START == event_id))
+    {
+        msg.type = _MSG_STA_START;
+    }
+    else if((WIFI_EVENT == event_base) && (WIFI_EVENT_STA_DISCONNECTED == event_id))
+    {
+        msg.type = _MSG_STA_DISCONNECTED;
+    }
+    else if((WIFI_EVENT == event_base) && (WIFI_EVENT_SCAN_DONE == event_id))
+    {
+        msg.type = _MSG_SCAN_DONE;
+    }
+    else if((IP_EVENT == event_base) && (IP_EVENT_STA_GOT_IP == event_id))
+    {
+        msg.type = _MSG_GOT_IP;
+    }
+    else
+    {
+        return;
+    }
+
+    (void)_msg_post(&msg);
+}
@@ -0,0 +1,137 @@
+/**
+ * @file wifi_manager.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __WIFI_MANAGER_C__
+#define __WIFI_MANAGER_C__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+/* Maximum number of networks kept in NVS. */
+#define WIFI_MANAGER_NETWORKS_MAX (4U)
+
+#define WIFI_MANAGER_SSID_SIZE     (33U)
+#define WIFI_MANAGER_PASSWORD_SIZE (65U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Enums hold connection states reported through the state callback.
+ *
+ */
+typedef enum
+{
+    WIFI_MANAGER_STATE_CONNECTING,
+    WIFI_MANAGER_STATE_CONNECTED,    /* Station got an IP address. */
+    WIFI_MANAGER_STATE_DISCONNECTED, /* Link lost or no stored network in range, retrying with backoff. */
+    WIFI_MANAGER_STATE_PROVISIONING, /* No network stored, waiting for credentials. */
+
+    WIFI_MANAGER_STATE_COUNT
+} wifi_manager_state_t;
+
+/**
+ * @brief Credentials of one network.
+ *
+ */
+typedef struct
+{
+    char ssid[WIFI_MANAGER_SSID_SIZE];
+    char password[WIFI_MANAGER_PASSWORD_SIZE]; /* Empty for open networks. */
+} wifi_manager_network_t;
+
+/**
+ * @brief Callback invoked on every state change. It runs in the manager task.
+ *
+ * @param [in] state New state.
+ * @param [in] p_arg User argument from the config.
+ */
+typedef void (*wifi_manager_state_cb_t)(wifi_manager_state_t state, void *p_arg);
+
+/**
+ * @brief Manager configuration.
+ *
+ */
+typedef struct
+{
+    wifi_manager_state_cb_t       p_state_cb;               /* Optional. */
+    void                         *p_cb_arg;                 /* Optional. */
+    const wifi_manager_network_t *p_default_network;        /* Optional, stored when NVS holds no network yet. */
+    bool                          b_is_serial_provisioning; /* Accept "wifi ..." commands on the console UART. */
+} wifi_manager_config_t;
+
+/**
+ * @brief Manager counters.
+ *
+ */
+typedef struct
+{
+    uint32_t connects;        /* Successful connections. */
+    uint32_t fast_connects;   /* Connections made from the cached channel and BSSID, without a scan. */
+    uint32_t scans;
+    uint32_t failures;        /* Connection attempts that did not get an IP address. */
+    uint32_t last_connect_ms; /* From the start of the last attempt series to the IP address. */
+} wifi_manager_stats_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief The function brings up the Wi-Fi station and starts the task that keeps it connected to the best stored
+ * network. NVS must be initialized before.
+ *
+ * @param [in] p_config Manager configuration.
+ *
+ * @return esp_err_t ESP_OK on success, fail otherwise.
+ */
+esp_err_t wifi_manager_init(const wifi_manager_config_t *p_config);
+
+/**
+ * @brief The function stores network credentials in NVS, replacing a network with the same SSID, and retries right
+ * away if the station is not connected.
+ *
+ * @param [in] p_ssid     Network name.
+ * @param [in] p_password Network password, NULL or empty for open networks.
+ *
+ * @return esp_err_t ESP_OK if the request was queued, fail otherwise.
+ */
+esp_err_t wifi_manager_add_network(const char *p_ssid, const char *p_password);
+
+/**
+ * @brief The function erases all stored networks and the cached access point. The current connection is kept.
+ *
+ * @return esp_err_t ESP_OK if the request was queued, fail otherwise.
+ */
+esp_err_t wifi_manager_clear_networks(void);
+
+/**
+ * @brief The function turns the radio on or off. While it is off no attempt is made and no retry timer runs; turning
+ * it back on reconnects right away, from the cached access point when possible.
+ *
+ * @param [in] b_is_on true to turn the radio on.
+ *
+ * @return esp_err_t ESP_OK if the request was queued, fail otherwise.
+ */
+esp_err_t wifi_manager_set_radio(bool b_is_on);
+
+/**
+ * @brief The function copies current manager counters.
+ *
+ * @param [out] p_stats Destination for the counters.
+ */
+void wifi_manager_get_stats(wifi_manager_stats_t *p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __WIFI_MANAGER_C__
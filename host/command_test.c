@@ -0,0 +1,248 @@
+/**
+ * @file command_test.c
+ *
+ * @brief Checks how the move command tells the two byte binary move message from a move typed as text. Every byte
+ * pair is sent whole and in two pieces to the command topic, and the event argument posted to the user interface is
+ * compared with what the tic-tac-toe message decoder and the text rules give. The user interface and the MQTT
+ * subscribe call are replaced here, so nothing else of the application runs.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "command.h"
+#include "tictactoe.h"
+#include "user_interface.h"
+#include "esp_log.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define STATION    "test"
+#define MOVE_TOPIC "WES/" STATION "/cmd/move"
+
+#define CHECK(COND) _check((COND), #COND, __LINE__)
+
+#define ARRAY_SIZE(X) (sizeof(X) / sizeof((X)[0]))
+
+/* Event argument of a move, as documented for USER_INTERFACE_EVENT_REMOTE_MOVE. */
+#define MOVE_ARG(SEQ, CELL) ((uint16_t)(((uint16_t)(SEQ) << 8U) | (uint16_t)(CELL)))
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Text payload and the argument it has to post.
+ *
+ */
+typedef struct
+{
+    const char *p_payload;
+    bool        b_is_valid;
+    uint16_t    arg;
+} _text_case_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+static void _check(bool b_is_ok, const char *p_cond, int line);
+
+/**
+ * @brief Sends a payload to the move topic in pieces of at most piece_len bytes.
+ *
+ * @return true if a move was posted, its argument is stored to p_arg.
+ */
+static bool _move_send(const char *p_payload, size_t len, size_t piece_len, uint16_t *p_arg);
+
+static void _binary_check(void);
+static void _text_check(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const _text_case_t _text_cases[] = {
+    {"0", true, MOVE_ARG(TICTACTOE_SEQ_ANY, 0U)},
+    {"8", true, MOVE_ARG(TICTACTOE_SEQ_ANY, 8U)},
+    {"4\n", true, MOVE_ARG(TICTACTOE_SEQ_ANY, 4U)}, /* Two bytes, but '4' is no sequence number. */
+    {"4\r\n", true, MOVE_ARG(TICTACTOE_SEQ_ANY, 4U)},
+    {" 7 ", true, MOVE_ARG(TICTACTOE_SEQ_ANY, 7U)},
+    {"new", true, MOVE_ARG(0U, TICTACTOE_CELL_NEW_GAME)},
+    {"new\n", true, MOVE_ARG(0U, TICTACTOE_CELL_NEW_GAME)},
+    {"9", false, 0U},
+    {"44", false, 0U},
+    {"4 5", false, 0U},
+    {"-1", false, 0U},
+    {"New", false, 0U},
+    {"newgame", false, 0U},
+    {"", false, 0U},
+    {" ", false, 0U},
+};
+
+static uint32_t _failures = 0U;
+static uint32_t _checks   = 0U;
+
+/* Last event the command module posted. */
+static bool                   _b_is_posted = false;
+static user_interface_event_t _posted_event;
+static uint16_t               _posted_arg;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+int main(int argc, char **argv)
+{
+    if(1 < argc)
+    {
+        fprintf(stderr, "usage: %s\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Malformed payloads are expected here, their warnings are not. */
+    esp_log_level_set("*", ESP_LOG_ERROR);
+
+    if(ESP_OK != command_init(STATION))
+    {
+        fprintf(stderr, "command_init failed\n");
+        return EXIT_FAILURE;
+    }
+
+    _binary_check();
+    _text_check();
+
+    command_stats_t stats;
+    command_get_stats(&stats);
+    CHECK(stats.received == (stats.dispatched + stats.rejected));
+    CHECK(0U == stats.oversized);
+
+    printf("command: %u checks, %u moves dispatched, %u rejected, %u failed\n", (unsigned)_checks,
+           (unsigned)stats.dispatched, (unsigned)stats.rejected, (unsigned)_failures);
+
+    return (0U == _failures) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+esp_err_t user_interface_post(user_interface_event_t event, uint16_t arg)
+{
+    _b_is_posted  = true;
+    _posted_event = event;
+    _posted_arg   = arg;
+
+    return ESP_OK;
+}
+
+int esp_mqtt_client_subscribe(esp_mqtt_client_handle_t client, const char *p_topic, int qos)
+{
+    return 0;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _check(bool b_is_ok, const char *p_cond, int line)
+{
+    _checks++;
+
+    if(!b_is_ok)
+    {
+        fprintf(stderr, "command_test.c:%d: %s\n", line, p_cond);
+        _failures++;
+    }
+}
+
+static bool _move_send(const char *p_payload, size_t len, size_t piece_len, uint16_t *p_arg)
+{
+    char             topic[] = MOVE_TOPIC;
+    char             data[COMMAND_PAYLOAD_SIZE_MAX];
+    esp_mqtt_event_t event   = {
+          .event_id       = MQTT_EVENT_DATA,
+          .total_data_len = (int)len,
+    };
+
+    (void)memcpy(data, p_payload, len);
+    _b_is_posted = false;
+
+    /* An empty payload still arrives as one event. */
+    size_t offset = 0U;
+    do
+    {
+        size_t piece = ((len - offset) < piece_len) ? (len - offset) : piece_len;
+
+        /* Only the first piece carries the topic. */
+        event.topic               = (0U == offset) ? topic : NULL;
+        event.topic_len           = (0U == offset) ? (int)strlen(topic) : 0;
+        event.data                = &data[offset];
+        event.data_len            = (int)piece;
+        event.current_data_offset = (int)offset;
+        command_handle_event(&event);
+
+        offset += piece;
+    } while(offset < len);
+
+    if(_b_is_posted)
+    {
+        CHECK(USER_INTERFACE_EVENT_REMOTE_MOVE == _posted_event);
+        *p_arg = _posted_arg;
+    }
+
+    return _b_is_posted;
+}
+
+static void _binary_check(void)
+{
+    /* Every byte pair, so text that happens to be two bytes long is covered as well. */
+    for(uint32_t pair = 0U; pair <= UINT16_MAX; pair++)
+    {
+        uint8_t msg[TICTACTOE_MSG_SIZE];
+        uint8_t seq;
+        uint8_t cell;
+
+        tictactoe_msg_encode((uint8_t)(pair >> 8U), (uint8_t)pair, msg);
+        if(ESP_OK != tictactoe_msg_decode(msg, sizeof(msg), &seq, &cell))
+        {
+            continue;
+        }
+
+        for(size_t piece_len = 1U; piece_len <= sizeof(msg); piece_len++)
+        {
+            uint16_t arg      = 0U;
+            bool     b_posted = _move_send((const char *)msg, sizeof(msg), piece_len, &arg);
+
+            CHECK(b_posted && (MOVE_ARG(seq, cell) == arg));
+        }
+    }
+
+    /* The decoder's range checks are what keep text out of the binary path, text uses neither range. */
+    for(uint32_t byte = 0x20U; byte < 0x7FU; byte++)
+    {
+        uint8_t seq;
+        uint8_t cell;
+        uint8_t msg[TICTACTOE_MSG_SIZE] = {(uint8_t)byte, (uint8_t)'\n'};
+
+        CHECK(ESP_ERR_INVALID_ARG == tictactoe_msg_decode(msg, sizeof(msg), &seq, &cell));
+    }
+
+    /* A binary move that is one byte short or long is no move at all. */
+    const uint8_t short_msg[] = {0x00U};
+    const uint8_t long_msg[]  = {0x00U, 0x04U, 0x00U};
+    uint16_t      arg;
+
+    CHECK(!_move_send((const char *)short_msg, sizeof(short_msg), sizeof(short_msg), &arg));
+    CHECK(!_move_send((const char *)long_msg, sizeof(long_msg), sizeof(long_msg), &arg));
+}
+
+static void _text_check(void)
+{
+    for(size_t index = 0U; index < ARRAY_SIZE(_text_cases); index++)
+    {
+        const _text_case_t *p_case = &_text_cases[index];
+        size_t              len    = strlen(p_case->p_payload);
+
+        for(size_t piece_len = 1U; piece_len <= ((0U == len) ? 1U : len); piece_len++)
+        {
+            uint16_t arg      = 0U;
+            bool     b_posted = _move_send(p_case->p_payload, len, piece_len, &arg);
+
+            if(p_case->b_is_valid != b_posted)
+            {
+                fprintf(stderr, "\"%s\" in %u byte pieces %s\n", p_case->p_payload, (unsigned)piece_len,
+                        b_posted ? "was taken" : "was rejected");
+            }
+            CHECK(p_case->b_is_valid == b_posted);
+            CHECK(!b_posted || (p_case->arg == arg));
+        }
+    }
+}
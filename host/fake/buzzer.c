@@ -0,0 +1,48 @@
+/**
+ * @file buzzer.c
+ *
+ * @brief Host stand-in for the buzzer driver, it stays silent.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "buzzer.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static atomic_bool _b_is_on = false;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t buzzer_init(void)
+{
+    return buzzer_off();
+}
+
+esp_err_t buzzer_on(void)
+{
+    atomic_store(&_b_is_on, true);
+
+    return ESP_OK;
+}
+
+esp_err_t buzzer_off(void)
+{
+    atomic_store(&_b_is_on, false);
+
+    return ESP_OK;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
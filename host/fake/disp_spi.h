@@ -0,0 +1,33 @@
+/**
+ * @file disp_spi.h
+ *
+ * @brief Host stand-in for the lvgl_esp32_drivers header of the same name. Only the flush done hook exists, there is
+ * no SPI bus. See lvgl_helpers.c.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_DISP_SPI_H__
+#define __HOST_DISP_SPI_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+/* Called in ISR context once a flush has been written to the framebuffer. */
+typedef void (*disp_spi_flush_done_cb_t)(void);
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+void disp_spi_set_flush_done_cb(disp_spi_flush_done_cb_t cb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_DISP_SPI_H__
@@ -0,0 +1,88 @@
+/**
+ * @file led.c
+ *
+ * @brief Host stand-in for the LED driver. Levels are only stored, fades jump to their target.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "led.h"
+#include <stdatomic.h>
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static atomic_uchar _levels[LED_COUNT];
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t led_init(led_t led)
+{
+    return led_set_level(led, 0U);
+}
+
+esp_err_t led_on(led_t led)
+{
+    return led_set_level(led, LED_LEVEL_MAX);
+}
+
+esp_err_t led_off(led_t led)
+{
+    return led_set_level(led, 0U);
+}
+
+esp_err_t led_set_all(uint8_t on_mask)
+{
+    return led_set_masked(LED_MASK_ALL, on_mask);
+}
+
+esp_err_t led_set_masked(uint8_t mask, uint8_t on_mask)
+{
+    for(uint8_t led = 0U; led < LED_COUNT; led++)
+    {
+        if(0U != (mask & LED_MASK(led)))
+        {
+            atomic_store(&_levels[led], (0U != (on_mask & LED_MASK(led))) ? LED_LEVEL_MAX : 0U);
+        }
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t led_set_level(led_t led, uint8_t level)
+{
+    if(LED_COUNT <= led)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    atomic_store(&_levels[led], level);
+
+    return ESP_OK;
+}
+
+esp_err_t led_fade(led_t led, uint8_t level, uint32_t time_ms)
+{
+    (void)time_ms;
+
+    return led_set_level(led, level);
+}
+
+esp_err_t led_set_rgb(uint8_t red, uint8_t green, uint8_t blue)
+{
+    (void)led_set_level(LED_RED, red);
+    (void)led_set_level(LED_GREEN, green);
+
+    return led_set_level(LED_BLUE, blue);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,167 @@
+/**
+ * @file lis2dh12.c
+ *
+ * @brief Host stand-in for the LIS2DH12 driver. A task wakes up at the FIFO watermark period, synthesizes the samples
+ * the sensor would have measured since the last wakeup, at most a FIFO full, and runs them through the real feature
+ * extractor, so the vibration pipeline costs what it costs on the target.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "lis2dh12.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include <math.h>
+#include <stdbool.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define LIS2DH12_FIFO_WATERMARK (LIS2DH12_FIFO_SIZE / 2U)
+
+#define LIS2DH12_TASK_STACK_SIZE (3U * 1024U)
+#define LIS2DH12_TASK_PRIORITY   (5U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief One vibration component of the synthetic signal.
+ *
+ */
+typedef struct
+{
+    acc_axis_t axis;
+    float      freq_hz;
+    float      ampl_g;
+} _tone_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Feeds the samples due since the last call into the feature extractor.
+ */
+static void _fifo_drain(void);
+
+static void _lis2dh12_task(void *p_parameter);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const float _rate_hz[LIS2DH12_ODR_COUNT] = {
+    [LIS2DH12_ODR_100HZ]  = 100.0f,
+    [LIS2DH12_ODR_200HZ]  = 200.0f,
+    [LIS2DH12_ODR_400HZ]  = 400.0f,
+    [LIS2DH12_ODR_1344HZ] = 1344.0f,
+};
+
+/* Board lying flat on a motor mount. */
+static const _tone_t _tones[] = {
+    { .axis = ACC_AXIS_X, .freq_hz = 50.0f, .ampl_g = 0.05f },
+    { .axis = ACC_AXIS_Y, .freq_hz = 120.0f, .ampl_g = 0.02f },
+    { .axis = ACC_AXIS_Z, .freq_hz = 30.0f, .ampl_g = 0.03f },
+};
+
+static lis2dh12_config_t _config;
+static bool              _b_is_initialized = false;
+static lis2dh12_stats_t  _stats;
+
+/* Owned by the driver task. */
+static acc_features_ctx_t _features_ctx;
+static uint64_t           _sample_index = 0U;
+static int64_t            _start_us     = 0;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t lis2dh12_init(const lis2dh12_config_t *p_config)
+{
+    if((NULL == p_config) || (LIS2DH12_ODR_COUNT <= p_config->odr) || (LIS2DH12_RANGE_COUNT <= p_config->range))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(_b_is_initialized)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    _config = *p_config;
+    acc_features_init(&_features_ctx, _rate_hz[_config.odr]);
+    _start_us = esp_timer_get_time();
+
+    if(pdPASS != xTaskCreate(&_lis2dh12_task, "lis2dh12_task", LIS2DH12_TASK_STACK_SIZE, NULL,
+                             LIS2DH12_TASK_PRIORITY, NULL))
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    _b_is_initialized = true;
+
+    return ESP_OK;
+}
+
+void lis2dh12_get_stats(lis2dh12_stats_t *p_stats)
+{
+    *p_stats = _stats;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _fifo_drain(void)
+{
+    float    rate_hz = _rate_hz[_config.odr];
+    uint64_t due     = (uint64_t)(((double)(esp_timer_get_time() - _start_us) * rate_hz) / 1e6);
+    uint64_t count   = due - _sample_index;
+
+    if(LIS2DH12_FIFO_SIZE < count)
+    {
+        /* The oldest samples were overwritten in stream mode. */
+        _stats.overruns++;
+        _sample_index = due - LIS2DH12_FIFO_SIZE;
+        count         = LIS2DH12_FIFO_SIZE;
+    }
+
+    acc_features_t features;
+
+    for(uint64_t i = 0U; i < count; i++, _sample_index++)
+    {
+        float t                      = (float)((double)_sample_index / rate_hz);
+        float sample[ACC_AXIS_COUNT] = { 0.0f, 0.0f, 1.0f };
+
+        for(size_t tone = 0U; tone < (sizeof(_tones) / sizeof(_tones[0])); tone++)
+        {
+            sample[_tones[tone].axis] += _tones[tone].ampl_g * sinf(2.0f * (float)M_PI * _tones[tone].freq_hz * t);
+        }
+
+        if(acc_features_add(&_features_ctx, sample, &features))
+        {
+            features.timestamp_ms = (uint32_t)(esp_timer_get_time() / 1000);
+            _stats.windows++;
+
+            if(NULL != _config.p_features_cb)
+            {
+                _config.p_features_cb(&features, _config.p_cb_arg);
+            }
+
+            if(NULL != _config.p_features_queue)
+            {
+                (void)xQueueSend(_config.p_features_queue, &features, 0U);
+            }
+        }
+    }
+
+    _stats.samples += (uint32_t)count;
+    _stats.bursts++;
+}
+
+static void _lis2dh12_task(void *p_parameter)
+{
+    (void)p_parameter;
+
+    uint32_t   watermark_ms = (uint32_t)((1000.0f * (float)LIS2DH12_FIFO_WATERMARK) / _rate_hz[_config.odr]);
+    TickType_t wait_ticks   = pdMS_TO_TICKS(watermark_ms);
+    wait_ticks              = (0U == wait_ticks) ? 1U : wait_ticks;
+
+    for(;;)
+    {
+        vTaskDelay(wait_ticks);
+        _fifo_drain();
+    }
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
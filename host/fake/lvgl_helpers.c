@@ -0,0 +1,146 @@
+/**
+ * @file lvgl_helpers.c
+ *
+ * @brief Host display and touch drivers. A flush copies the area into a framebuffer in memory, byte order and all, and
+ * completes from ISR context like the SPI transfer done interrupt on the target. Flush times therefore measure the
+ * copy, not the wire. The touch panel reports what host_touch_set() last set and pulls the pen interrupt pin low
+ * while pressed, as the XPT2046 does.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "lvgl_helpers.h"
+#include "disp_spi.h"
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "host.h"
+#include <stdio.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#if defined(CONFIG_LV_TOUCH_DETECT_IRQ) || defined(CONFIG_LV_TOUCH_DETECT_IRQ_PRESSURE)
+#define TOUCH_IRQ_IO (CONFIG_LV_TOUCH_PIN_IRQ)
+#endif
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static portMUX_TYPE _touch_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static lv_color_t _fb[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+
+static disp_spi_flush_done_cb_t p_flush_done_cb = NULL;
+
+static bool    _b_is_pressed = false;
+static int16_t _touch_x      = 0;
+static int16_t _touch_y      = 0;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+void lvgl_driver_init(void)
+{
+#ifdef TOUCH_IRQ_IO
+    /* Pulled up, the panel pulls it low on pen down. */
+    const gpio_config_t io_conf = {
+        .pin_bit_mask = 1ULL << TOUCH_IRQ_IO,
+        .mode         = GPIO_MODE_INPUT,
+        .pull_up_en   = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type    = GPIO_INTR_DISABLE,
+    };
+    (void)gpio_config(&io_conf);
+#endif
+}
+
+void disp_driver_flush(lv_disp_drv_t *p_drv, const lv_area_t *p_area, lv_color_t *p_color_map)
+{
+    lv_coord_t width = lv_area_get_width(p_area);
+
+    for(lv_coord_t y = p_area->y1; y <= p_area->y2; y++)
+    {
+        memcpy(&_fb[(y * LV_HOR_RES_MAX) + p_area->x1], p_color_map, width * sizeof(lv_color_t));
+        p_color_map += width;
+    }
+
+    /* The transfer done interrupt. */
+    host_isr_enter();
+    if(NULL != p_flush_done_cb)
+    {
+        p_flush_done_cb();
+    }
+    lv_disp_flush_ready(p_drv);
+    host_isr_exit();
+}
+
+void disp_driver_wait(lv_disp_drv_t *p_drv)
+{
+    /* Flushes are done by the time disp_driver_flush() returns. */
+    (void)p_drv;
+}
+
+void disp_spi_set_flush_done_cb(disp_spi_flush_done_cb_t cb)
+{
+    p_flush_done_cb = cb;
+}
+
+void touch_driver_read(lv_indev_drv_t *p_drv, lv_indev_data_t *p_data)
+{
+    (void)p_drv;
+
+    portENTER_CRITICAL(&_touch_lock);
+    p_data->state   = _b_is_pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+    p_data->point.x = _touch_x;
+    p_data->point.y = _touch_y;
+    portEXIT_CRITICAL(&_touch_lock);
+}
+
+void host_touch_set(bool b_is_pressed, int16_t x, int16_t y)
+{
+    portENTER_CRITICAL(&_touch_lock);
+    _b_is_pressed = b_is_pressed;
+    _touch_x      = x;
+    _touch_y      = y;
+    portEXIT_CRITICAL(&_touch_lock);
+
+#ifdef TOUCH_IRQ_IO
+    host_gpio_input(TOUCH_IRQ_IO, b_is_pressed ? 0 : 1);
+#endif
+}
+
+const void *host_fb_get(uint16_t *p_width, uint16_t *p_height)
+{
+    *p_width  = LV_HOR_RES_MAX;
+    *p_height = LV_VER_RES_MAX;
+
+    return _fb;
+}
+
+esp_err_t host_fb_write_ppm(const char *p_path)
+{
+    FILE *p_file = fopen(p_path, "wb");
+    if(NULL == p_file)
+    {
+        return ESP_FAIL;
+    }
+
+    fprintf(p_file, "P6\n%d %d\n255\n", LV_HOR_RES_MAX, LV_VER_RES_MAX);
+
+    for(size_t px = 0U; px < (sizeof(_fb) / sizeof(_fb[0])); px++)
+    {
+        /* lv_color_to32() undoes LV_COLOR_16_SWAP. */
+        lv_color32_t  color  = { .full = lv_color_to32(_fb[px]) };
+        const uint8_t rgb[3] = { color.ch.red, color.ch.green, color.ch.blue };
+        (void)fwrite(rgb, sizeof(rgb), 1U, p_file);
+    }
+
+    return (0 == fclose(p_file)) ? ESP_OK : ESP_FAIL;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,45 @@
+/**
+ * @file lvgl_helpers.h
+ *
+ * @brief Host stand-in for the lvgl_esp32_drivers header of the same name. The display is a framebuffer in memory
+ * and the touch panel is driven by host_touch_set(). See lvgl_helpers.c.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_LVGL_HELPERS_H__
+#define __HOST_LVGL_HELPERS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "sdkconfig.h"
+#include "lvgl.h"
+#include <stdbool.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define LV_HOR_RES_MAX (CONFIG_LV_HOR_RES_MAX)
+#define LV_VER_RES_MAX (CONFIG_LV_VER_RES_MAX)
+
+/* Same as for the ILI9341 on the target. */
+#define DISP_BUF_SIZE (LV_HOR_RES_MAX * 40)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+void lvgl_driver_init(void);
+
+void disp_driver_flush(lv_disp_drv_t *p_drv, const lv_area_t *p_area, lv_color_t *p_color_map);
+
+void disp_driver_wait(lv_disp_drv_t *p_drv);
+
+void touch_driver_read(lv_indev_drv_t *p_drv, lv_indev_data_t *p_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_LVGL_HELPERS_H__
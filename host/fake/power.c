@@ -0,0 +1,62 @@
+/**
+ * @file power.c
+ *
+ * @brief Host stand-in for the power manager. There is no radio to switch off or CPU to sleep, so the whole run counts
+ * as radio on in either mode and no current is estimated.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "power.h"
+#include "esp_timer.h"
+#include <stdio.h>
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static power_mode_t _mode     = POWER_MODE_PERFORMANCE;
+static int64_t      _start_us = 0;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t power_init(const power_config_t *p_config)
+{
+    if((NULL == p_config) || (POWER_MODE_COUNT <= p_config->mode))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    _mode     = p_config->mode;
+    _start_us = esp_timer_get_time();
+
+    return ESP_OK;
+}
+
+void power_get_report(power_report_t *p_report)
+{
+    *p_report = (power_report_t){
+        .mode = _mode,
+        .state_ms = { [POWER_STATE_RADIO_ON] = (uint64_t)((esp_timer_get_time() - _start_us) / 1000) },
+    };
+}
+
+void power_report_print(void)
+{
+    power_report_t report;
+    power_get_report(&report);
+
+    printf("Power report, %s mode (host, radio always on):\n",
+           (POWER_MODE_LOW_POWER == report.mode) ? "low power" : "performance");
+    printf("  %-10s %10llu ms\n", "radio on", (unsigned long long)report.state_ms[POWER_STATE_RADIO_ON]);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
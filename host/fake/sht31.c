@@ -0,0 +1,195 @@
+/**
+ * @file sht31.c
+ *
+ * @brief Host stand-in for the SHT31 driver. An esp_timer produces a slowly drifting synthetic sample at the
+ * configured rate, or at the period set by host_sht31_set_period_us() for throughput runs, and hands it over the same
+ * way the driver does.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "sht31.h"
+#include "host.h"
+#include "esp_timer.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define SHT31_TEMP_MEAN (22.0f)
+#define SHT31_TEMP_AMPL (3.0f)
+#define SHT31_HUMI_MEAN (45.0f)
+#define SHT31_HUMI_AMPL (10.0f)
+#define SHT31_DRIFT_S   (600.0f)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Synthesizes the sample the sensor would measure now.
+ */
+static void _measure(sht31_sample_t *p_sample);
+
+/**
+ * @brief (Re)starts the timer at the current period.
+ */
+static esp_err_t _timer_restart(void);
+
+static void _sample_timer_cb(void *p_arg);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const uint32_t _period_ms[SHT31_RATE_COUNT] = {
+    [SHT31_RATE_0_5_MPS] = 2000U, [SHT31_RATE_1_MPS] = 1000U, [SHT31_RATE_2_MPS] = 500U,
+    [SHT31_RATE_4_MPS] = 250U,    [SHT31_RATE_10_MPS] = 100U, [SHT31_RATE_ART] = 250U,
+};
+
+static sht31_config_t     _config;
+static bool               _b_is_initialized = false;
+static esp_timer_handle_t p_sample_timer    = NULL;
+
+static atomic_uint _period_us_override = 0U;
+static atomic_uint _produced           = 0U;
+static atomic_uint _dropped            = 0U;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t sht31_init(const sht31_config_t *p_config)
+{
+    if((NULL == p_config) || (SHT31_RATE_COUNT <= p_config->rate))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(_b_is_initialized)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    _config = *p_config;
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = &_sample_timer_cb,
+        .name     = "sht31",
+    };
+
+    esp_err_t esp_err = esp_timer_create(&timer_args, &p_sample_timer);
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = _timer_restart();
+    }
+
+    _b_is_initialized = (ESP_OK == esp_err);
+
+    return esp_err;
+}
+
+esp_err_t sht31_deinit(void)
+{
+    if(!_b_is_initialized)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    (void)esp_timer_stop(p_sample_timer);
+    (void)esp_timer_delete(p_sample_timer);
+    p_sample_timer    = NULL;
+    _b_is_initialized = false;
+
+    return ESP_OK;
+}
+
+esp_err_t sht31_set_rate(sht31_rate_t rate)
+{
+    if(SHT31_RATE_COUNT <= rate)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(!_b_is_initialized)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    _config.rate = rate;
+
+    return _timer_restart();
+}
+
+esp_err_t sht31_fetch(sht31_sample_t *p_sample)
+{
+    if(NULL == p_sample)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(!_b_is_initialized)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    _measure(p_sample);
+
+    return ESP_OK;
+}
+
+void host_sht31_set_period_us(uint32_t period_us)
+{
+    atomic_store(&_period_us_override, period_us);
+
+    if(_b_is_initialized)
+    {
+        (void)_timer_restart();
+    }
+}
+
+void host_sht31_get_stats(host_sensor_stats_t *p_stats)
+{
+    p_stats->produced = atomic_load(&_produced);
+    p_stats->dropped  = atomic_load(&_dropped);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _measure(sht31_sample_t *p_sample)
+{
+    int64_t now_us = esp_timer_get_time();
+    float   phase  = (2.0f * (float)M_PI * (float)now_us) / (SHT31_DRIFT_S * 1e6f);
+
+    p_sample->temp         = SHT31_TEMP_MEAN + (SHT31_TEMP_AMPL * sinf(phase));
+    p_sample->humi         = SHT31_HUMI_MEAN - (SHT31_HUMI_AMPL * sinf(phase));
+    p_sample->timestamp_ms = (uint32_t)(now_us / 1000);
+}
+
+static esp_err_t _timer_restart(void)
+{
+    uint32_t period_us = atomic_load(&_period_us_override);
+    period_us          = (0U == period_us) ? (_period_ms[_config.rate] * 1000U) : period_us;
+
+    (void)esp_timer_stop(p_sample_timer);
+
+    return esp_timer_start_periodic(p_sample_timer, period_us);
+}
+
+static void _sample_timer_cb(void *p_arg)
+{
+    (void)p_arg;
+    sht31_sample_t sample;
+
+    _measure(&sample);
+    atomic_fetch_add(&_produced, 1U);
+
+    if(NULL != _config.p_sample_cb)
+    {
+        _config.p_sample_cb(&sample, _config.p_cb_arg);
+    }
+
+    if((NULL != _config.p_sample_queue) && (pdTRUE != xQueueSend(_config.p_sample_queue, &sample, 0U)))
+    {
+        atomic_fetch_add(&_dropped, 1U);
+    }
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,126 @@
+/**
+ * @file wifi_manager.c
+ *
+ * @brief Host stand-in for the Wi-Fi manager. The station "connects" a short while after init, from an esp_timer
+ * callback as the IP event would arrive on the target. Turning the radio off takes the MQTT broker link down with it.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "wifi_manager.h"
+#include "esp_timer.h"
+#include "host.h"
+#include <stdatomic.h>
+
+//---------------------------------- MACROS -----------------------------------
+/* Typical fast connect on the target, from the cached channel and BSSID. */
+#define WIFI_CONNECT_US (300000U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+static void _state_set(wifi_manager_state_t state);
+static void _connect_timer_cb(void *p_arg);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static wifi_manager_config_t _config;
+static esp_timer_handle_t    p_connect_timer  = NULL;
+static int64_t               _attempt_us      = 0;
+static atomic_uint           _connects        = 0U;
+static atomic_uint           _last_connect_ms = 0U;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t wifi_manager_init(const wifi_manager_config_t *p_config)
+{
+    if(NULL == p_config)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(NULL != p_connect_timer)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    _config = *p_config;
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = &_connect_timer_cb,
+        .name     = "wifi_connect",
+    };
+
+    esp_err_t esp_err = esp_timer_create(&timer_args, &p_connect_timer);
+
+    if(ESP_OK == esp_err)
+    {
+        esp_err = wifi_manager_set_radio(true);
+    }
+
+    return esp_err;
+}
+
+esp_err_t wifi_manager_add_network(const char *p_ssid, const char *p_password)
+{
+    return ((NULL == p_ssid) || (NULL == p_password)) ? ESP_ERR_INVALID_ARG : ESP_OK;
+}
+
+esp_err_t wifi_manager_clear_networks(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t wifi_manager_set_radio(bool b_is_on)
+{
+    if(NULL == p_connect_timer)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    (void)esp_timer_stop(p_connect_timer);
+
+    if(!b_is_on)
+    {
+        host_mqtt_set_link(false);
+        _state_set(WIFI_MANAGER_STATE_DISCONNECTED);
+        return ESP_OK;
+    }
+
+    _attempt_us = esp_timer_get_time();
+    _state_set(WIFI_MANAGER_STATE_CONNECTING);
+
+    return esp_timer_start_once(p_connect_timer, WIFI_CONNECT_US);
+}
+
+void wifi_manager_get_stats(wifi_manager_stats_t *p_stats)
+{
+    *p_stats = (wifi_manager_stats_t){
+        .connects        = atomic_load(&_connects),
+        .fast_connects   = atomic_load(&_connects),
+        .last_connect_ms = atomic_load(&_last_connect_ms),
+    };
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _state_set(wifi_manager_state_t state)
+{
+    if(NULL != _config.p_state_cb)
+    {
+        _config.p_state_cb(state, _config.p_cb_arg);
+    }
+}
+
+static void _connect_timer_cb(void *p_arg)
+{
+    (void)p_arg;
+
+    atomic_fetch_add(&_connects, 1U);
+    atomic_store(&_last_connect_ms, (unsigned)((esp_timer_get_time() - _attempt_us) / 1000));
+    host_mqtt_set_link(true);
+    _state_set(WIFI_MANAGER_STATE_CONNECTED);
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
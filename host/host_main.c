@@ -0,0 +1,220 @@
+/**
+ * @file host_main.c
+ *
+ * @brief Runs the application on the host for a fixed time, cycles through the screens and prints the counters of
+ * each pipeline. Options:
+ *   --seconds <n>    Run time, 10 s by default.
+ *   --sample-hz <n>  SHT31 samples per second instead of the configured rate.
+ *   --fb <path>      Writes the last frame as a PPM image.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "gui.h"
+#include "gui_perf.h"
+#include "gui_screen.h"
+#include "host.h"
+#include "lis2dh12.h"
+#include "lvgl_helpers.h"
+#include "mqtt_publisher.h"
+#include "telemetry.h"
+#include "wifi_manager.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define RUN_TIME_S_DEFAULT  (10U)
+#define SCREEN_PERIOD_MS    (1000U)
+#define GUI_CALL_TIMEOUT_MS (1000U)
+#define MAIN_STACK_SIZE     (3584U)
+#define JSON_SIZE           (512U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+static void    _main_task(void *p_arg);
+static void    _screen_show(void *p_arg);
+static uint8_t _screen_count(void);
+static void    _tap(void);
+static void    _report_print(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "HOST";
+
+//------------------------------- GLOBAL DATA ---------------------------------
+extern void app_main(void);
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+int main(int argc, char **argv)
+{
+    uint32_t    run_time_s = RUN_TIME_S_DEFAULT;
+    uint32_t    sample_hz  = 0U;
+    const char *p_fb_path  = NULL;
+
+    for(int arg = 1; arg < argc; arg++)
+    {
+        if((0 == strcmp(argv[arg], "--seconds")) && ((arg + 1) < argc))
+        {
+            run_time_s = (uint32_t)strtoul(argv[++arg], NULL, 10);
+        }
+        else if((0 == strcmp(argv[arg], "--sample-hz")) && ((arg + 1) < argc))
+        {
+            sample_hz = (uint32_t)strtoul(argv[++arg], NULL, 10);
+        }
+        else if((0 == strcmp(argv[arg], "--fb")) && ((arg + 1) < argc))
+        {
+            p_fb_path = argv[++arg];
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--seconds <n>] [--sample-hz <n>] [--fb <path>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if(0U != sample_hz)
+    {
+        host_sht31_set_period_us(1000000U / sample_hz);
+    }
+
+    /* As on the target, app_main() runs in a task of its own and never returns. */
+    if(pdPASS != xTaskCreate(_main_task, "main", MAIN_STACK_SIZE, NULL, 1U, NULL))
+    {
+        return EXIT_FAILURE;
+    }
+
+    /* Lets the application come up before the screens are switched. */
+    vTaskDelay(pdMS_TO_TICKS(SCREEN_PERIOD_MS));
+
+    uint8_t       screens = _screen_count();
+    uint8_t       screen  = 0U;
+    const int64_t end_us  = esp_timer_get_time() + ((int64_t)run_time_s * 1000000LL);
+
+    while(esp_timer_get_time() < end_us)
+    {
+        if(0U != screens)
+        {
+            screen = (screen + 1U) % screens;
+            if(ESP_OK != gui_post_sync(_screen_show, &screen, GUI_CALL_TIMEOUT_MS))
+            {
+                ESP_LOGW(TAG, "Screen %u not shown.", screen);
+            }
+        }
+        _tap();
+        vTaskDelay(pdMS_TO_TICKS(SCREEN_PERIOD_MS));
+    }
+
+    _report_print();
+
+    if((NULL != p_fb_path) && gui_lock(GUI_CALL_TIMEOUT_MS))
+    {
+        esp_err_t err = host_fb_write_ppm(p_fb_path);
+        gui_unlock();
+        if(ESP_OK != err)
+        {
+            ESP_LOGE(TAG, "Framebuffer not written to %s.", p_fb_path);
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* The application tasks never end, exit() takes them down. */
+    return EXIT_SUCCESS;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _main_task(void *p_arg)
+{
+    (void)p_arg;
+
+    app_main();
+    vTaskDelete(NULL);
+}
+
+static void _screen_show(void *p_arg)
+{
+    (void)gui_screen_show(*(const uint8_t *)p_arg, LV_SCR_LOAD_ANIM_NONE);
+}
+
+static uint8_t _screen_count(void)
+{
+    gui_screen_stats_t stats;
+    uint8_t            count = 0U;
+
+    while((count < GUI_SCREEN_MAX) && (ESP_OK == gui_screen_get_stats(count, &stats)))
+    {
+        count++;
+    }
+
+    return count;
+}
+
+static void _tap(void)
+{
+    /* Held for a few input reads, in the middle of the screen. */
+    host_touch_set(true, LV_HOR_RES_MAX / 2, LV_VER_RES_MAX / 2);
+    vTaskDelay(pdMS_TO_TICKS(100U));
+    host_touch_set(false, LV_HOR_RES_MAX / 2, LV_VER_RES_MAX / 2);
+}
+
+static void _report_print(void)
+{
+    host_sensor_stats_t     sht31_stats;
+    lis2dh12_stats_t        lis2dh12_stats;
+    telemetry_stats_t       telemetry_stats;
+    mqtt_publisher_stats_t  mqtt_stats;
+    wifi_manager_stats_t    wifi_stats;
+    host_mqtt_topic_stats_t topic_stats[HOST_MQTT_TOPICS_MAX];
+    gui_perf_stats_t        gui_stats;
+    static char             json[JSON_SIZE];
+    size_t                  json_len;
+
+    /* Since boot, the rates include the start-up. */
+    const double run_time_s = (double)esp_timer_get_time() / 1000000.0;
+
+    host_sht31_get_stats(&sht31_stats);
+    lis2dh12_get_stats(&lis2dh12_stats);
+    telemetry_get_stats(&telemetry_stats);
+    mqtt_publisher_get_stats(&mqtt_stats);
+    wifi_manager_get_stats(&wifi_stats);
+    uint8_t topics = host_mqtt_get_stats(topic_stats, HOST_MQTT_TOPICS_MAX);
+
+    printf("\n--- %.1f s ---\n", run_time_s);
+    printf("sht31:     %lu samples (%.1f/s), %lu dropped\n", (unsigned long)sht31_stats.produced,
+           sht31_stats.produced / run_time_s, (unsigned long)sht31_stats.dropped);
+    printf("lis2dh12:  %lu samples, %lu bursts, %lu windows, %lu overruns\n", (unsigned long)lis2dh12_stats.samples,
+           (unsigned long)lis2dh12_stats.bursts, (unsigned long)lis2dh12_stats.windows,
+           (unsigned long)lis2dh12_stats.overruns);
+    printf("telemetry: %lu pushed, %lu published, %lu dropped, %lu spilled, ring %u\n",
+           (unsigned long)telemetry_stats.pushed, (unsigned long)telemetry_stats.published,
+           (unsigned long)telemetry_stats.dropped, (unsigned long)telemetry_stats.spilled, telemetry_stats.ring_level);
+    printf("wifi:      %lu connects in %lu ms\n", (unsigned long)wifi_stats.connects,
+           (unsigned long)wifi_stats.last_connect_ms);
+    printf("mqtt:      %lu queued, %lu sent, %lu acked, %lu dropped, outbox peak %u\n", (unsigned long)mqtt_stats.queued,
+           (unsigned long)mqtt_stats.sent, (unsigned long)mqtt_stats.acked, (unsigned long)mqtt_stats.dropped,
+           mqtt_stats.outbox_msgs_peak);
+
+    for(uint8_t topic = 0U; topic < topics; topic++)
+    {
+        printf("broker:    %-28s %6lu msgs %8llu B, latency avg %lu us max %lu us\n", topic_stats[topic].topic,
+               (unsigned long)topic_stats[topic].msgs, (unsigned long long)topic_stats[topic].bytes,
+               (unsigned long)(topic_stats[topic].latency_us_total / topic_stats[topic].msgs),
+               (unsigned long)topic_stats[topic].latency_us_max);
+    }
+
+    if((ESP_OK == gui_perf_get(&gui_stats, false)) &&
+       (ESP_OK == gui_perf_to_json(&gui_stats, json, sizeof(json), &json_len)))
+    {
+        printf("gui:       %.*s\n", (int)json_len, json);
+    }
+
+    gui_screen_report_print();
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
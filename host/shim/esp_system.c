@@ -0,0 +1,132 @@
+/**
+ * @file esp_system.c
+ *
+ * @brief Host error names, ESP_ERROR_CHECK() failures, logging and restart.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define ARRAY_SIZE(X) (sizeof(X) / sizeof((X)[0]))
+
+#define ERR_ENTRY(X) { (X), #X }
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef struct
+{
+    esp_err_t   code;
+    const char *p_name;
+} _err_name_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const _err_name_t _err_names[] = {
+    ERR_ENTRY(ESP_OK),
+    ERR_ENTRY(ESP_FAIL),
+    ERR_ENTRY(ESP_ERR_NO_MEM),
+    ERR_ENTRY(ESP_ERR_INVALID_ARG),
+    ERR_ENTRY(ESP_ERR_INVALID_STATE),
+    ERR_ENTRY(ESP_ERR_INVALID_SIZE),
+    ERR_ENTRY(ESP_ERR_NOT_FOUND),
+    ERR_ENTRY(ESP_ERR_NOT_SUPPORTED),
+    ERR_ENTRY(ESP_ERR_TIMEOUT),
+    ERR_ENTRY(ESP_ERR_INVALID_RESPONSE),
+    ERR_ENTRY(ESP_ERR_INVALID_CRC),
+    ERR_ENTRY(ESP_ERR_INVALID_VERSION),
+    ERR_ENTRY(ESP_ERR_NOT_FINISHED),
+    ERR_ENTRY(ESP_ERR_NVS_NOT_INITIALIZED),
+    ERR_ENTRY(ESP_ERR_NVS_NOT_FOUND),
+    ERR_ENTRY(ESP_ERR_NVS_READ_ONLY),
+    ERR_ENTRY(ESP_ERR_NVS_INVALID_HANDLE),
+    ERR_ENTRY(ESP_ERR_NVS_KEY_TOO_LONG),
+    ERR_ENTRY(ESP_ERR_NVS_INVALID_LENGTH),
+    ERR_ENTRY(ESP_ERR_NVS_NO_FREE_PAGES),
+    ERR_ENTRY(ESP_ERR_NVS_NEW_VERSION_FOUND),
+};
+
+static atomic_int _log_level = CONFIG_LOG_DEFAULT_LEVEL;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+const char *esp_err_to_name(esp_err_t code)
+{
+    for(size_t idx = 0U; idx < ARRAY_SIZE(_err_names); idx++)
+    {
+        if(code == _err_names[idx].code)
+        {
+            return _err_names[idx].p_name;
+        }
+    }
+
+    return "UNKNOWN ERROR";
+}
+
+void _esp_error_check_failed(esp_err_t code, const char *p_file, int line, const char *p_function,
+                             const char *p_expression)
+{
+    fprintf(stderr, "ESP_ERROR_CHECK failed: esp_err_t 0x%x (%s) at %s:%d\nfunc: %s\nexpression: %s\n", (unsigned)code,
+            esp_err_to_name(code), p_file, line, p_function, p_expression);
+    abort();
+}
+
+void esp_restart(void)
+{
+    fflush(stdout);
+    exit(EXIT_FAILURE);
+}
+
+uint32_t esp_get_free_heap_size(void)
+{
+    return 0U;
+}
+
+uint32_t esp_get_minimum_free_heap_size(void)
+{
+    return 0U;
+}
+
+void esp_log_level_set(const char *p_tag, esp_log_level_t level)
+{
+    if(0 == strcmp("*", p_tag))
+    {
+        atomic_store(&_log_level, (int)level);
+    }
+}
+
+void esp_log_write(esp_log_level_t level, const char *p_tag, const char *p_format, ...)
+{
+    (void)p_tag;
+
+    if((int)level > atomic_load(&_log_level))
+    {
+        return;
+    }
+
+    va_list args;
+    va_start(args, p_format);
+    (void)vfprintf(stdout, p_format, args);
+    va_end(args);
+}
+
+uint32_t esp_log_timestamp(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000LL);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,270 @@
+/**
+ * @file esp_timer.c
+ *
+ * @brief Host esp_timer. Armed timers sit in a list sorted by alarm time, a dispatch task sleeps until the first one
+ * is due and runs its callback without holding the list lock, so callbacks may start and stop timers. As on the
+ * target, one slow callback delays all others.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define TIMER_TASK_STACK_SIZE (4096U)
+#define TIMER_TASK_PRIORITY   (22U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+struct esp_timer
+{
+    esp_timer_cb_t    p_cb;
+    void             *p_arg;
+    int64_t           alarm_us;
+    uint64_t          period_us; /* 0 for one-shot timers. */
+    bool              b_is_armed;
+    struct esp_timer *p_next;
+};
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Takes the boot time and sets up the list lock.
+ */
+static void _init(void) __attribute__((constructor));
+
+/**
+ * @brief Starts the dispatch task on first use.
+ */
+static void _task_start(void);
+
+static void _timer_task(void *p_parameter);
+
+/**
+ * @brief Inserts an armed timer by alarm time, after timers due at the same time. Caller holds the lock.
+ */
+static void _insert(esp_timer_handle_t p_timer);
+
+/**
+ * @brief Unlinks a timer if it is armed. Caller holds the lock.
+ */
+static void _remove(esp_timer_handle_t p_timer);
+
+static esp_err_t _start(esp_timer_handle_t p_timer, uint64_t timeout_us, uint64_t period_us);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static struct timespec _boot;
+static pthread_mutex_t _mutex;
+static pthread_cond_t  _cond;
+static pthread_once_t  _task_once = PTHREAD_ONCE_INIT;
+
+static esp_timer_handle_t p_armed = NULL;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+int64_t esp_timer_get_time(void)
+{
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((int64_t)(now.tv_sec - _boot.tv_sec) * 1000000LL) + ((now.tv_nsec - _boot.tv_nsec) / 1000L);
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *p_args, esp_timer_handle_t *p_handle)
+{
+    if((NULL == p_args) || (NULL == p_args->callback) || (NULL == p_handle))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_timer_handle_t p_timer = calloc(1U, sizeof(*p_timer));
+    if(NULL == p_timer)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    p_timer->p_cb  = p_args->callback;
+    p_timer->p_arg = p_args->arg;
+    (void)pthread_once(&_task_once, _task_start);
+
+    *p_handle = p_timer;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    return _start(timer, timeout_us, 0U);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us)
+{
+    return (0U == period_us) ? ESP_ERR_INVALID_ARG : _start(timer, period_us, period_us);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if(NULL == timer)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    (void)pthread_mutex_lock(&_mutex);
+    esp_err_t esp_err = timer->b_is_armed ? ESP_OK : ESP_ERR_INVALID_STATE;
+    _remove(timer);
+    (void)pthread_mutex_unlock(&_mutex);
+
+    return esp_err;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    if(NULL == timer)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(esp_timer_is_active(timer))
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    free(timer);
+
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+    (void)pthread_mutex_lock(&_mutex);
+    bool b_is_armed = timer->b_is_armed;
+    (void)pthread_mutex_unlock(&_mutex);
+
+    return b_is_armed;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _init(void)
+{
+    (void)clock_gettime(CLOCK_MONOTONIC, &_boot);
+
+    pthread_condattr_t cond_attr;
+    (void)pthread_condattr_init(&cond_attr);
+    (void)pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    (void)pthread_cond_init(&_cond, &cond_attr);
+    (void)pthread_condattr_destroy(&cond_attr);
+    (void)pthread_mutex_init(&_mutex, NULL);
+}
+
+static void _task_start(void)
+{
+    if(pdPASS != xTaskCreate(&_timer_task, "esp_timer", TIMER_TASK_STACK_SIZE, NULL, TIMER_TASK_PRIORITY, NULL))
+    {
+        abort();
+    }
+}
+
+static void _timer_task(void *p_parameter)
+{
+    (void)p_parameter;
+
+    (void)pthread_mutex_lock(&_mutex);
+
+    for(;;)
+    {
+        if(NULL == p_armed)
+        {
+            (void)pthread_cond_wait(&_cond, &_mutex);
+            continue;
+        }
+
+        int64_t now_us = esp_timer_get_time();
+
+        if(p_armed->alarm_us > now_us)
+        {
+            /* Absolute, so a wakeup for a newly armed timer does not stretch the wait. */
+            int64_t         alarm_ns = (p_armed->alarm_us * 1000LL) + _boot.tv_nsec;
+            struct timespec deadline = {
+                .tv_sec  = _boot.tv_sec + (time_t)(alarm_ns / 1000000000LL),
+                .tv_nsec = (long)(alarm_ns % 1000000000LL),
+            };
+            (void)pthread_cond_timedwait(&_cond, &_mutex, &deadline);
+            continue;
+        }
+
+        esp_timer_handle_t p_timer = p_armed;
+        _remove(p_timer);
+
+        if(0U < p_timer->period_us)
+        {
+            p_timer->alarm_us += (int64_t)p_timer->period_us;
+            _insert(p_timer);
+        }
+
+        (void)pthread_mutex_unlock(&_mutex);
+        p_timer->p_cb(p_timer->p_arg);
+        (void)pthread_mutex_lock(&_mutex);
+    }
+}
+
+static void _insert(esp_timer_handle_t p_timer)
+{
+    esp_timer_handle_t *pp_link = &p_armed;
+
+    while((NULL != *pp_link) && ((*pp_link)->alarm_us <= p_timer->alarm_us))
+    {
+        pp_link = &(*pp_link)->p_next;
+    }
+
+    p_timer->p_next     = *pp_link;
+    *pp_link            = p_timer;
+    p_timer->b_is_armed = true;
+}
+
+static void _remove(esp_timer_handle_t p_timer)
+{
+    for(esp_timer_handle_t *pp_link = &p_armed; NULL != *pp_link; pp_link = &(*pp_link)->p_next)
+    {
+        if(p_timer == *pp_link)
+        {
+            *pp_link = p_timer->p_next;
+            break;
+        }
+    }
+
+    p_timer->p_next     = NULL;
+    p_timer->b_is_armed = false;
+}
+
+static esp_err_t _start(esp_timer_handle_t p_timer, uint64_t timeout_us, uint64_t period_us)
+{
+    if(NULL == p_timer)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    (void)pthread_mutex_lock(&_mutex);
+
+    /* ESP-IDF refuses to start an armed timer. */
+    if(p_timer->b_is_armed)
+    {
+        (void)pthread_mutex_unlock(&_mutex);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    p_timer->alarm_us  = esp_timer_get_time() + (int64_t)timeout_us;
+    p_timer->period_us = period_us;
+    _insert(p_timer);
+    (void)pthread_cond_signal(&_cond);
+    (void)pthread_mutex_unlock(&_mutex);
+
+    return ESP_OK;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
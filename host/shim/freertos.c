@@ -0,0 +1,677 @@
+/**
+ * @file freertos.c
+ *
+ * @brief This file maps the FreeRTOS API the application uses onto POSIX threads. A task is a detached thread on a
+ * painted stack, so high-water marks are measured the way FreeRTOS does it. A queue is a ring under a mutex with a
+ * condition variable per direction, a semaphore is a queue without items and a task notification is a value under
+ * the task's own mutex. Timeouts run on CLOCK_MONOTONIC. Priorities and cores are ignored: the host has enough cores
+ * for every task, so benchmarks measure the work done rather than how one core would schedule it. All critical
+ * sections share one recursive mutex, which host ISRs run under as well.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "host.h"
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+//---------------------------------- MACROS -----------------------------------
+/* Host code takes more stack than the target, 64-bit pointers and glibc's printf mostly. */
+#define HOST_STACK_SCALE (4U)
+#define HOST_STACK_EXTRA (64U * 1024U)
+#define HOST_STACK_PAINT (0xA5U)
+
+#define HOST_TASK_NAME_SIZE (16U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Task.
+ *
+ */
+struct tskTaskControlBlock
+{
+    TaskFunction_t  p_fn;
+    void           *p_arg;
+    char            name[HOST_TASK_NAME_SIZE];
+    uint8_t        *p_stack; /* NULL for threads not started by xTaskCreate(). */
+    size_t          stack_size;
+    pthread_mutex_t notify_mutex;
+    pthread_cond_t  notify_cond;
+    uint32_t        notify_value;
+    bool            b_notify_pending;
+};
+
+/**
+ * @brief Queue or semaphore.
+ *
+ */
+struct QueueDefinition
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t  not_empty;
+    pthread_cond_t  not_full;
+    uint8_t        *p_items; /* NULL for semaphores. */
+    UBaseType_t     length;
+    UBaseType_t     item_size;
+    UBaseType_t     head;
+    UBaseType_t     count;
+};
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Sets up the critical section lock and the monotonic condition variable attribute.
+ */
+static void _init(void) __attribute__((constructor));
+
+/**
+ * @brief Thread entry of a task.
+ */
+static void *_task_entry(void *p_arg);
+
+/**
+ * @brief Initializes the notification state of a task.
+ */
+static void _task_init(TaskHandle_t p_task, const char *p_name);
+
+/**
+ * @brief Returns the calling task, adopting threads not started by xTaskCreate().
+ */
+static TaskHandle_t _self(void);
+
+/**
+ * @brief Converts a timeout in ticks into an absolute CLOCK_MONOTONIC deadline.
+ */
+static void _deadline(TickType_t ticks, struct timespec *p_deadline);
+
+/**
+ * @brief Waits on a condition variable until signalled or the deadline passes.
+ *
+ * @return false on timeout.
+ */
+static bool _wait(pthread_cond_t *p_cond, pthread_mutex_t *p_mutex, TickType_t ticks,
+                  const struct timespec *p_deadline);
+
+static QueueHandle_t _queue_create(UBaseType_t length, UBaseType_t item_size, UBaseType_t count);
+static void          _queue_copy_in(QueueHandle_t p_queue, const void *p_item, BaseType_t position);
+static BaseType_t    _queue_receive(QueueHandle_t p_queue, void *p_item, TickType_t ticks, bool b_is_peek);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static pthread_mutex_t    _critical_mutex;
+static pthread_condattr_t _cond_attr;
+
+static __thread TaskHandle_t p_self       = NULL;
+static __thread int          _isr_nesting = 0;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+void vPortEnterCritical(void)
+{
+    (void)pthread_mutex_lock(&_critical_mutex);
+}
+
+void vPortExitCritical(void)
+{
+    (void)pthread_mutex_unlock(&_critical_mutex);
+}
+
+BaseType_t xPortInIsrContext(void)
+{
+    return (0 < _isr_nesting) ? pdTRUE : pdFALSE;
+}
+
+void host_isr_enter(void)
+{
+    vPortEnterCritical();
+    _isr_nesting++;
+}
+
+void host_isr_exit(void)
+{
+    _isr_nesting--;
+    vPortExitCritical();
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t p_fn, const char *p_name, uint32_t stack_size, void *p_arg,
+                                   UBaseType_t priority, TaskHandle_t *p_handle, BaseType_t core)
+{
+    (void)priority;
+    (void)core;
+
+    TaskHandle_t p_task = calloc(1U, sizeof(*p_task));
+    if(NULL == p_task)
+    {
+        return pdFAIL;
+    }
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = (((size_t)stack_size * HOST_STACK_SCALE) + HOST_STACK_EXTRA + page - 1U) & ~(page - 1U);
+
+    if(0 != posix_memalign((void **)&p_task->p_stack, page, size))
+    {
+        free(p_task);
+        return pdFAIL;
+    }
+
+    memset(p_task->p_stack, HOST_STACK_PAINT, size);
+    p_task->stack_size = size;
+    p_task->p_fn       = p_fn;
+    p_task->p_arg      = p_arg;
+    _task_init(p_task, p_name);
+
+    /* FreeRTOS writes the handle before the task can run, tasks rely on it. */
+    if(NULL != p_handle)
+    {
+        *p_handle = p_task;
+    }
+
+    pthread_attr_t attr;
+    pthread_t      thread;
+    (void)pthread_attr_init(&attr);
+    (void)pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    (void)pthread_attr_setstack(&attr, p_task->p_stack, size);
+
+    int err = pthread_create(&thread, &attr, _task_entry, p_task);
+    (void)pthread_attr_destroy(&attr);
+
+    if(0 != err)
+    {
+        if(NULL != p_handle)
+        {
+            *p_handle = NULL;
+        }
+        free(p_task->p_stack);
+        free(p_task);
+        return pdFAIL;
+    }
+
+    (void)pthread_setname_np(thread, p_task->name);
+
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if((NULL != task) && (_self() != task))
+    {
+        fprintf(stderr, "vTaskDelete() of another task is not supported on the host\n");
+        abort();
+    }
+
+    /* The stack stays allocated, the thread is still running on it. */
+    pthread_exit(NULL);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    if(0U == ticks)
+    {
+        (void)sched_yield();
+        return;
+    }
+
+    struct timespec deadline;
+    _deadline(ticks, &deadline);
+
+    while(EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL))
+    {
+    }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)((esp_timer_get_time() / 1000LL) / portTICK_PERIOD_MS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return _self();
+}
+
+const char *pcTaskGetName(TaskHandle_t task)
+{
+    return (NULL == task) ? _self()->name : task->name;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    TaskHandle_t p_task = (NULL == task) ? _self() : task;
+
+    if(NULL == p_task->p_stack)
+    {
+        return 0U;
+    }
+
+    /* The stack grows down, the paint left at its bottom was never touched. */
+    size_t untouched = 0U;
+    while((untouched < p_task->stack_size) && (HOST_STACK_PAINT == p_task->p_stack[untouched]))
+    {
+        untouched++;
+    }
+
+    return (UBaseType_t)untouched;
+}
+
+BaseType_t xTaskGenericNotify(TaskHandle_t task, uint32_t value, eNotifyAction action, uint32_t *p_prev_value)
+{
+    BaseType_t ret = pdPASS;
+
+    (void)pthread_mutex_lock(&task->notify_mutex);
+
+    if(NULL != p_prev_value)
+    {
+        *p_prev_value = task->notify_value;
+    }
+
+    switch(action)
+    {
+        case eSetBits:
+            task->notify_value |= value;
+            break;
+
+        case eIncrement:
+            task->notify_value++;
+            break;
+
+        case eSetValueWithOverwrite:
+            task->notify_value = value;
+            break;
+
+        case eSetValueWithoutOverwrite:
+            if(task->b_notify_pending)
+            {
+                ret = pdFAIL;
+            }
+            else
+            {
+                task->notify_value = value;
+            }
+            break;
+
+        case eNoAction:
+        default:
+            break;
+    }
+
+    task->b_notify_pending = true;
+    (void)pthread_cond_broadcast(&task->notify_cond);
+    (void)pthread_mutex_unlock(&task->notify_mutex);
+
+    return ret;
+}
+
+BaseType_t xTaskGenericNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, uint32_t *p_prev_value,
+                                     BaseType_t *p_higher_prio_woken)
+{
+    if(NULL != p_higher_prio_woken)
+    {
+        *p_higher_prio_woken = pdTRUE;
+    }
+
+    return xTaskGenericNotify(task, value, action, p_prev_value);
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *p_value, TickType_t ticks)
+{
+    TaskHandle_t    p_task = _self();
+    struct timespec deadline;
+    BaseType_t      ret = pdTRUE;
+
+    _deadline(ticks, &deadline);
+    (void)pthread_mutex_lock(&p_task->notify_mutex);
+
+    if(!p_task->b_notify_pending)
+    {
+        p_task->notify_value &= ~clear_on_entry;
+    }
+
+    while(!p_task->b_notify_pending)
+    {
+        if((0U == ticks) || !_wait(&p_task->notify_cond, &p_task->notify_mutex, ticks, &deadline))
+        {
+            ret = pdFALSE;
+            break;
+        }
+    }
+
+    if(NULL != p_value)
+    {
+        *p_value = p_task->notify_value;
+    }
+
+    if(pdTRUE == ret)
+    {
+        p_task->notify_value &= ~clear_on_exit;
+    }
+
+    p_task->b_notify_pending = false;
+    (void)pthread_mutex_unlock(&p_task->notify_mutex);
+
+    return ret;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t b_clear_on_exit, TickType_t ticks)
+{
+    TaskHandle_t    p_task = _self();
+    struct timespec deadline;
+
+    _deadline(ticks, &deadline);
+    (void)pthread_mutex_lock(&p_task->notify_mutex);
+
+    while((0U == p_task->notify_value) && (0U != ticks) &&
+          _wait(&p_task->notify_cond, &p_task->notify_mutex, ticks, &deadline))
+    {
+    }
+
+    uint32_t value = p_task->notify_value;
+    if(0U != value)
+    {
+        p_task->notify_value = b_clear_on_exit ? 0U : (value - 1U);
+    }
+
+    p_task->b_notify_pending = false;
+    (void)pthread_mutex_unlock(&p_task->notify_mutex);
+
+    return value;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    return _queue_create(length, item_size, 0U);
+}
+
+QueueHandle_t xQueueCreateCountingSemaphore(UBaseType_t max_count, UBaseType_t initial_count)
+{
+    return _queue_create(max_count, 0U, initial_count);
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    if(NULL == queue)
+    {
+        return;
+    }
+
+    (void)pthread_cond_destroy(&queue->not_full);
+    (void)pthread_cond_destroy(&queue->not_empty);
+    (void)pthread_mutex_destroy(&queue->mutex);
+    free(queue->p_items);
+    free(queue);
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue)
+{
+    (void)pthread_mutex_lock(&queue->mutex);
+    queue->head  = 0U;
+    queue->count = 0U;
+    (void)pthread_cond_broadcast(&queue->not_full);
+    (void)pthread_mutex_unlock(&queue->mutex);
+
+    return pdPASS;
+}
+
+BaseType_t xQueueGenericSend(QueueHandle_t queue, const void *p_item, TickType_t ticks, BaseType_t position)
+{
+    struct timespec deadline;
+
+    _deadline(ticks, &deadline);
+    (void)pthread_mutex_lock(&queue->mutex);
+
+    while((queueOVERWRITE != position) && (queue->count >= queue->length))
+    {
+        if((0U == ticks) || !_wait(&queue->not_full, &queue->mutex, ticks, &deadline))
+        {
+            (void)pthread_mutex_unlock(&queue->mutex);
+            return errQUEUE_FULL;
+        }
+    }
+
+    _queue_copy_in(queue, p_item, position);
+    (void)pthread_cond_broadcast(&queue->not_empty);
+    (void)pthread_mutex_unlock(&queue->mutex);
+
+    return pdPASS;
+}
+
+BaseType_t xQueueGenericSendFromISR(QueueHandle_t queue, const void *p_item, BaseType_t *p_higher_prio_woken,
+                                    BaseType_t position)
+{
+    BaseType_t ret = xQueueGenericSend(queue, p_item, 0U, position);
+
+    if((pdPASS == ret) && (NULL != p_higher_prio_woken))
+    {
+        *p_higher_prio_woken = pdTRUE;
+    }
+
+    return ret;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *p_item, TickType_t ticks)
+{
+    return _queue_receive(queue, p_item, ticks, false);
+}
+
+BaseType_t xQueueReceiveFromISR(QueueHandle_t queue, void *p_item, BaseType_t *p_higher_prio_woken)
+{
+    BaseType_t ret = _queue_receive(queue, p_item, 0U, false);
+
+    if((pdPASS == ret) && (NULL != p_higher_prio_woken))
+    {
+        *p_higher_prio_woken = pdTRUE;
+    }
+
+    return ret;
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *p_item, TickType_t ticks)
+{
+    return _queue_receive(queue, p_item, ticks, true);
+}
+
+BaseType_t xQueueSemaphoreTake(QueueHandle_t queue, TickType_t ticks)
+{
+    return _queue_receive(queue, NULL, ticks, false);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    (void)pthread_mutex_lock(&queue->mutex);
+    UBaseType_t count = queue->count;
+    (void)pthread_mutex_unlock(&queue->mutex);
+
+    return count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue)
+{
+    (void)pthread_mutex_lock(&queue->mutex);
+    UBaseType_t spaces = queue->length - queue->count;
+    (void)pthread_mutex_unlock(&queue->mutex);
+
+    return spaces;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _init(void)
+{
+    pthread_mutexattr_t mutex_attr;
+    (void)pthread_mutexattr_init(&mutex_attr);
+    (void)pthread_mutexattr_settype(&mutex_attr, PTHREAD_MUTEX_RECURSIVE);
+    (void)pthread_mutex_init(&_critical_mutex, &mutex_attr);
+    (void)pthread_mutexattr_destroy(&mutex_attr);
+
+    (void)pthread_condattr_init(&_cond_attr);
+    (void)pthread_condattr_setclock(&_cond_attr, CLOCK_MONOTONIC);
+}
+
+static void *_task_entry(void *p_arg)
+{
+    TaskHandle_t p_task = (TaskHandle_t)p_arg;
+
+    p_self = p_task;
+    p_task->p_fn(p_task->p_arg);
+
+    fprintf(stderr, "Task %s returned\n", p_task->name);
+    abort();
+
+    return NULL;
+}
+
+static void _task_init(TaskHandle_t p_task, const char *p_name)
+{
+    (void)snprintf(p_task->name, sizeof(p_task->name), "%s", (NULL != p_name) ? p_name : "");
+    (void)pthread_mutex_init(&p_task->notify_mutex, NULL);
+    (void)pthread_cond_init(&p_task->notify_cond, &_cond_attr);
+}
+
+static TaskHandle_t _self(void)
+{
+    if(NULL == p_self)
+    {
+        p_self = calloc(1U, sizeof(*p_self));
+        if(NULL == p_self)
+        {
+            abort();
+        }
+        _task_init(p_self, "host");
+    }
+
+    return p_self;
+}
+
+static void _deadline(TickType_t ticks, struct timespec *p_deadline)
+{
+    (void)clock_gettime(CLOCK_MONOTONIC, p_deadline);
+
+    if(portMAX_DELAY == ticks)
+    {
+        return;
+    }
+
+    uint64_t ns = (uint64_t)ticks * portTICK_PERIOD_MS * 1000000ULL;
+    ns += (uint64_t)p_deadline->tv_nsec;
+
+    p_deadline->tv_sec += (time_t)(ns / 1000000000ULL);
+    p_deadline->tv_nsec = (long)(ns % 1000000000ULL);
+}
+
+static bool _wait(pthread_cond_t *p_cond, pthread_mutex_t *p_mutex, TickType_t ticks,
+                  const struct timespec *p_deadline)
+{
+    if(portMAX_DELAY == ticks)
+    {
+        (void)pthread_cond_wait(p_cond, p_mutex);
+        return true;
+    }
+
+    return ETIMEDOUT != pthread_cond_timedwait(p_cond, p_mutex, p_deadline);
+}
+
+static QueueHandle_t _queue_create(UBaseType_t length, UBaseType_t item_size, UBaseType_t count)
+{
+    if((0U == length) || (count > length))
+    {
+        return NULL;
+    }
+
+    QueueHandle_t p_queue = calloc(1U, sizeof(*p_queue));
+    if(NULL == p_queue)
+    {
+        return NULL;
+    }
+
+    if(0U < item_size)
+    {
+        p_queue->p_items = malloc((size_t)length * item_size);
+        if(NULL == p_queue->p_items)
+        {
+            free(p_queue);
+            return NULL;
+        }
+    }
+
+    p_queue->length    = length;
+    p_queue->item_size = item_size;
+    p_queue->count     = count;
+    (void)pthread_mutex_init(&p_queue->mutex, NULL);
+    (void)pthread_cond_init(&p_queue->not_empty, &_cond_attr);
+    (void)pthread_cond_init(&p_queue->not_full, &_cond_attr);
+
+    return p_queue;
+}
+
+static void _queue_copy_in(QueueHandle_t p_queue, const void *p_item, BaseType_t position)
+{
+    UBaseType_t slot;
+
+    if((queueOVERWRITE == position) && (p_queue->count >= p_queue->length))
+    {
+        /* Meant for single item mailboxes: the newest item is replaced. */
+        slot = (p_queue->head + p_queue->count - 1U) % p_queue->length;
+    }
+    else if(queueSEND_TO_FRONT == position)
+    {
+        p_queue->head = (p_queue->head + p_queue->length - 1U) % p_queue->length;
+        slot          = p_queue->head;
+        p_queue->count++;
+    }
+    else
+    {
+        slot = (p_queue->head + p_queue->count) % p_queue->length;
+        p_queue->count++;
+    }
+
+    if(NULL != p_queue->p_items)
+    {
+        memcpy(&p_queue->p_items[(size_t)slot * p_queue->item_size], p_item, p_queue->item_size);
+    }
+}
+
+static BaseType_t _queue_receive(QueueHandle_t p_queue, void *p_item, TickType_t ticks, bool b_is_peek)
+{
+    struct timespec deadline;
+
+    _deadline(ticks, &deadline);
+    (void)pthread_mutex_lock(&p_queue->mutex);
+
+    while(0U == p_queue->count)
+    {
+        if((0U == ticks) || !_wait(&p_queue->not_empty, &p_queue->mutex, ticks, &deadline))
+        {
+            (void)pthread_mutex_unlock(&p_queue->mutex);
+            return errQUEUE_EMPTY;
+        }
+    }
+
+    if((NULL != p_queue->p_items) && (NULL != p_item))
+    {
+        memcpy(p_item, &p_queue->p_items[(size_t)p_queue->head * p_queue->item_size], p_queue->item_size);
+    }
+
+    if(!b_is_peek)
+    {
+        p_queue->head = (p_queue->head + 1U) % p_queue->length;
+        p_queue->count--;
+        (void)pthread_cond_broadcast(&p_queue->not_full);
+    }
+
+    (void)pthread_mutex_unlock(&p_queue->mutex);
+
+    return pdPASS;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
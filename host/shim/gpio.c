@@ -0,0 +1,278 @@
+/**
+ * @file gpio.c
+ *
+ * @brief Host GPIO driver. Each pin holds a level set by host_gpio_input() and runs its handler, in ISR context, on a
+ * matching edge. Level interrupts fire once when the level is entered, they are not retriggered while it is held.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "host.h"
+#include <stdbool.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define GPIO_IS_VALID(PIN) ((0 <= (PIN)) && (GPIO_PIN_COUNT > (PIN)))
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef struct
+{
+    int             level;
+    gpio_mode_t     mode;
+    gpio_int_type_t intr_type;
+    bool            b_is_intr_enabled;
+    gpio_isr_t      p_isr;
+    void           *p_arg;
+} _pin_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Checks whether a level change triggers the pin's interrupt type.
+ */
+static bool _is_triggered(gpio_int_type_t intr_type, int old_level, int new_level);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+
+static _pin_t _pins[GPIO_PIN_COUNT];
+static bool   _b_is_isr_service = false;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t gpio_config(const gpio_config_t *p_config)
+{
+    if((NULL == p_config) || (0U != (p_config->pin_bit_mask >> GPIO_PIN_COUNT)))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&_lock);
+    for(int pin = 0; pin < GPIO_PIN_COUNT; pin++)
+    {
+        if(0U != (p_config->pin_bit_mask & (1ULL << pin)))
+        {
+            _pins[pin].mode              = p_config->mode;
+            _pins[pin].intr_type         = p_config->intr_type;
+            _pins[pin].b_is_intr_enabled = (GPIO_INTR_DISABLE != p_config->intr_type);
+            _pins[pin].level             = (GPIO_PULLUP_ENABLE == p_config->pull_up_en) ? 1 : _pins[pin].level;
+        }
+    }
+    portEXIT_CRITICAL(&_lock);
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t pin)
+{
+    if(!GPIO_IS_VALID(pin))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&_lock);
+    _pins[pin] = (_pin_t){ .level = 1, .mode = GPIO_MODE_INPUT };
+    portEXIT_CRITICAL(&_lock);
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_direction(gpio_num_t pin, gpio_mode_t mode)
+{
+    if(!GPIO_IS_VALID(pin))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&_lock);
+    _pins[pin].mode = mode;
+    portEXIT_CRITICAL(&_lock);
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level)
+{
+    if(!GPIO_IS_VALID(pin))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* Outputs loop back, as if read through GPIO_MODE_INPUT_OUTPUT. */
+    host_gpio_input(pin, (0U != level) ? 1 : 0);
+
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t pin)
+{
+    if(!GPIO_IS_VALID(pin))
+    {
+        return 0;
+    }
+
+    portENTER_CRITICAL(&_lock);
+    int level = _pins[pin].level;
+    portEXIT_CRITICAL(&_lock);
+
+    return level;
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t pin, gpio_int_type_t intr_type)
+{
+    if(!GPIO_IS_VALID(pin) || (GPIO_INTR_MAX <= intr_type))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&_lock);
+    _pins[pin].intr_type = intr_type;
+    portEXIT_CRITICAL(&_lock);
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t pin)
+{
+    if(!GPIO_IS_VALID(pin))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&_lock);
+    _pins[pin].b_is_intr_enabled = true;
+    portEXIT_CRITICAL(&_lock);
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t pin)
+{
+    if(!GPIO_IS_VALID(pin))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&_lock);
+    _pins[pin].b_is_intr_enabled = false;
+    portEXIT_CRITICAL(&_lock);
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags)
+{
+    (void)intr_alloc_flags;
+    esp_err_t esp_err = ESP_OK;
+
+    portENTER_CRITICAL(&_lock);
+    if(_b_is_isr_service)
+    {
+        esp_err = ESP_ERR_INVALID_STATE;
+    }
+    _b_is_isr_service = true;
+    portEXIT_CRITICAL(&_lock);
+
+    return esp_err;
+}
+
+void gpio_uninstall_isr_service(void)
+{
+    portENTER_CRITICAL(&_lock);
+    _b_is_isr_service = false;
+    portEXIT_CRITICAL(&_lock);
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t pin, gpio_isr_t p_isr, void *p_arg)
+{
+    if(!GPIO_IS_VALID(pin))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t esp_err = ESP_OK;
+
+    portENTER_CRITICAL(&_lock);
+    if(_b_is_isr_service)
+    {
+        _pins[pin].p_isr             = p_isr;
+        _pins[pin].p_arg             = p_arg;
+        _pins[pin].b_is_intr_enabled = true;
+    }
+    else
+    {
+        esp_err = ESP_ERR_INVALID_STATE;
+    }
+    portEXIT_CRITICAL(&_lock);
+
+    return esp_err;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t pin)
+{
+    if(!GPIO_IS_VALID(pin))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&_lock);
+    _pins[pin].p_isr = NULL;
+    _pins[pin].p_arg = NULL;
+    portEXIT_CRITICAL(&_lock);
+
+    return ESP_OK;
+}
+
+void host_gpio_input(int pin, int level)
+{
+    if(!GPIO_IS_VALID(pin))
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&_lock);
+
+    _pin_t *p_pin     = &_pins[pin];
+    int     old_level = p_pin->level;
+    p_pin->level      = level;
+
+    if(_b_is_isr_service && p_pin->b_is_intr_enabled && (NULL != p_pin->p_isr) &&
+       _is_triggered(p_pin->intr_type, old_level, level))
+    {
+        host_isr_enter();
+        p_pin->p_isr(p_pin->p_arg);
+        host_isr_exit();
+    }
+
+    portEXIT_CRITICAL(&_lock);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static bool _is_triggered(gpio_int_type_t intr_type, int old_level, int new_level)
+{
+    switch(intr_type)
+    {
+        case GPIO_INTR_POSEDGE:
+            return (0 == old_level) && (0 != new_level);
+
+        case GPIO_INTR_NEGEDGE:
+            return (0 != old_level) && (0 == new_level);
+
+        case GPIO_INTR_ANYEDGE:
+            return old_level != new_level;
+
+        case GPIO_INTR_LOW_LEVEL:
+            return (0 != old_level) && (0 == new_level);
+
+        case GPIO_INTR_HIGH_LEVEL:
+            return (0 == old_level) && (0 != new_level);
+
+        default:
+            return false;
+    }
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,95 @@
+/**
+ * @file gpio.h
+ *
+ * @brief Host stand-in for the ESP-IDF header of the same name. Pins hold a level set by the host and run their ISR when
+ * it changes. See gpio.c.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_DRIVER_GPIO_H__
+#define __HOST_DRIVER_GPIO_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include "esp_intr_alloc.h"
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define GPIO_PIN_COUNT (40)
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef int gpio_num_t;
+
+typedef enum
+{
+    GPIO_MODE_DISABLE,
+    GPIO_MODE_INPUT,
+    GPIO_MODE_OUTPUT,
+    GPIO_MODE_OUTPUT_OD,
+    GPIO_MODE_INPUT_OUTPUT_OD,
+    GPIO_MODE_INPUT_OUTPUT,
+} gpio_mode_t;
+
+typedef enum
+{
+    GPIO_PULLUP_DISABLE,
+    GPIO_PULLUP_ENABLE
+} gpio_pullup_t;
+
+typedef enum
+{
+    GPIO_PULLDOWN_DISABLE,
+    GPIO_PULLDOWN_ENABLE
+} gpio_pulldown_t;
+
+typedef enum
+{
+    GPIO_INTR_DISABLE,
+    GPIO_INTR_POSEDGE,
+    GPIO_INTR_NEGEDGE,
+    GPIO_INTR_ANYEDGE,
+    GPIO_INTR_LOW_LEVEL,
+    GPIO_INTR_HIGH_LEVEL,
+    GPIO_INTR_MAX,
+} gpio_int_type_t;
+
+typedef struct
+{
+    uint64_t        pin_bit_mask;
+    gpio_mode_t     mode;
+    gpio_pullup_t   pull_up_en;
+    gpio_pulldown_t pull_down_en;
+    gpio_int_type_t intr_type;
+} gpio_config_t;
+
+typedef void (*gpio_isr_t)(void *p_arg);
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+esp_err_t gpio_config(const gpio_config_t *p_config);
+esp_err_t gpio_reset_pin(gpio_num_t pin);
+esp_err_t gpio_set_direction(gpio_num_t pin, gpio_mode_t mode);
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level);
+int       gpio_get_level(gpio_num_t pin);
+esp_err_t gpio_set_intr_type(gpio_num_t pin, gpio_int_type_t intr_type);
+esp_err_t gpio_intr_enable(gpio_num_t pin);
+esp_err_t gpio_intr_disable(gpio_num_t pin);
+
+/**
+ * @brief Fails with ESP_ERR_INVALID_STATE when already installed, as in ESP-IDF.
+ */
+esp_err_t gpio_install_isr_service(int intr_alloc_flags);
+void      gpio_uninstall_isr_service(void);
+esp_err_t gpio_isr_handler_add(gpio_num_t pin, gpio_isr_t p_isr, void *p_arg);
+esp_err_t gpio_isr_handler_remove(gpio_num_t pin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_DRIVER_GPIO_H__
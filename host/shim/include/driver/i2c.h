@@ -0,0 +1,37 @@
+/**
+ * @file i2c.h
+ *
+ * @brief Host stand-in for the ESP-IDF header of the same name. Only the types the sensor headers name, the sensors are
+ * faked on the host.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_DRIVER_I2C_H__
+#define __HOST_DRIVER_I2C_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+
+//---------------------------------- MACROS -----------------------------------
+#define I2C_NUM_MAX (2)
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef enum
+{
+    I2C_NUM_0,
+    I2C_NUM_1,
+} i2c_port_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_DRIVER_I2C_H__
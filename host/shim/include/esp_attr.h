@@ -0,0 +1,35 @@
+/**
+ * @file esp_attr.h
+ *
+ * @brief Host stand-in for the ESP-IDF header of the same name. Placement attributes have no meaning on the host.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_ESP_ATTR_H__
+#define __HOST_ESP_ATTR_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+
+//---------------------------------- MACROS -----------------------------------
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define EXT_RAM_BSS_ATTR
+#define WORD_ALIGNED_ATTR __attribute__((aligned(4)))
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_ESP_ATTR_H__
@@ -0,0 +1,71 @@
+/**
+ * @file esp_err.h
+ *
+ * @brief Host stand-in for the ESP-IDF header of the same name. Codes match ESP-IDF, so logged values read the same as on
+ * the target.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_ESP_ERR_H__
+#define __HOST_ESP_ERR_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define ESP_OK                    (0)
+#define ESP_FAIL                  (-1)
+#define ESP_ERR_NO_MEM            (0x101)
+#define ESP_ERR_INVALID_ARG       (0x102)
+#define ESP_ERR_INVALID_STATE     (0x103)
+#define ESP_ERR_INVALID_SIZE      (0x104)
+#define ESP_ERR_NOT_FOUND         (0x105)
+#define ESP_ERR_NOT_SUPPORTED     (0x106)
+#define ESP_ERR_TIMEOUT           (0x107)
+#define ESP_ERR_INVALID_RESPONSE  (0x108)
+#define ESP_ERR_INVALID_CRC       (0x109)
+#define ESP_ERR_INVALID_VERSION   (0x10A)
+#define ESP_ERR_NOT_FINISHED      (0x10C)
+
+#define ESP_ERR_NVS_BASE              (0x1100)
+#define ESP_ERR_NVS_NOT_INITIALIZED   (ESP_ERR_NVS_BASE + 0x01)
+#define ESP_ERR_NVS_NOT_FOUND         (ESP_ERR_NVS_BASE + 0x02)
+#define ESP_ERR_NVS_READ_ONLY         (ESP_ERR_NVS_BASE + 0x04)
+#define ESP_ERR_NVS_INVALID_HANDLE    (ESP_ERR_NVS_BASE + 0x07)
+#define ESP_ERR_NVS_KEY_TOO_LONG      (ESP_ERR_NVS_BASE + 0x09)
+#define ESP_ERR_NVS_INVALID_LENGTH    (ESP_ERR_NVS_BASE + 0x0c)
+#define ESP_ERR_NVS_NO_FREE_PAGES     (ESP_ERR_NVS_BASE + 0x0d)
+#define ESP_ERR_NVS_NEW_VERSION_FOUND (ESP_ERR_NVS_BASE + 0x10)
+
+#define ESP_ERROR_CHECK(X)                                                                                       \
+    do                                                                                                           \
+    {                                                                                                            \
+        esp_err_t _esp_err = (X);                                                                                \
+        if(ESP_OK != _esp_err)                                                                                   \
+        {                                                                                                        \
+            _esp_error_check_failed(_esp_err, __FILE__, __LINE__, __func__, #X);                                 \
+        }                                                                                                        \
+    } while(0)
+
+#define ESP_ERROR_CHECK_WITHOUT_ABORT(X) (X)
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef int esp_err_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+const char *esp_err_to_name(esp_err_t code);
+
+void _esp_error_check_failed(esp_err_t code, const char *p_file, int line, const char *p_function,
+                             const char *p_expression) __attribute__((noreturn));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_ESP_ERR_H__
@@ -0,0 +1,40 @@
+/**
+ * @file esp_event.h
+ *
+ * @brief Host stand-in for the ESP-IDF header of the same name. Only the types are provided, nothing posts to the default
+ * event loop on the host.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_ESP_EVENT_H__
+#define __HOST_ESP_EVENT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define ESP_EVENT_ANY_ID ((int32_t)-1)
+
+#define ESP_EVENT_DECLARE_BASE(ID) extern esp_event_base_t const ID
+#define ESP_EVENT_DEFINE_BASE(ID)  esp_event_base_t const ID = #ID
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef const char *esp_event_base_t;
+
+typedef void (*esp_event_handler_t)(void *p_arg, esp_event_base_t event_base, int32_t event_id,
+                                    void *p_event_data);
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_ESP_EVENT_H__
@@ -0,0 +1,30 @@
+/**
+ * @file esp_freertos_hooks.h
+ *
+ * @brief Host stand-in for the ESP-IDF header of the same name. No hooks are called on the host.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_ESP_FREERTOS_HOOKS_H__
+#define __HOST_ESP_FREERTOS_HOOKS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_ESP_FREERTOS_HOOKS_H__
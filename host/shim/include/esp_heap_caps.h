@@ -0,0 +1,44 @@
+/**
+ * @file esp_heap_caps.h
+ *
+ * @brief Host stand-in for the ESP-IDF header of the same name. All capabilities map onto malloc().
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_ESP_HEAP_CAPS_H__
+#define __HOST_ESP_HEAP_CAPS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdlib.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define MALLOC_CAP_EXEC     (1U << 0)
+#define MALLOC_CAP_32BIT    (1U << 1)
+#define MALLOC_CAP_8BIT     (1U << 2)
+#define MALLOC_CAP_DMA      (1U << 3)
+#define MALLOC_CAP_SPIRAM   (1U << 10)
+#define MALLOC_CAP_INTERNAL (1U << 11)
+#define MALLOC_CAP_DEFAULT  (1U << 12)
+
+#define heap_caps_malloc(SIZE, CAPS)      ((void)(CAPS), malloc(SIZE))
+#define heap_caps_calloc(N, SIZE, CAPS)   ((void)(CAPS), calloc((N), (SIZE)))
+#define heap_caps_realloc(P, SIZE, CAPS)  ((void)(CAPS), realloc((P), (SIZE)))
+#define heap_caps_free(P)                 free(P)
+#define heap_caps_get_free_size(CAPS)     ((void)(CAPS), (size_t)0)
+#define heap_caps_get_largest_free_block(CAPS) ((void)(CAPS), (size_t)0)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_ESP_HEAP_CAPS_H__
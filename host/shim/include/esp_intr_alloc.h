@@ -0,0 +1,34 @@
+/**
+ * @file esp_intr_alloc.h
+ *
+ * @brief Host stand-in for the ESP-IDF header of the same name.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_ESP_INTR_ALLOC_H__
+#define __HOST_ESP_INTR_ALLOC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+
+//---------------------------------- MACROS -----------------------------------
+#define ESP_INTR_FLAG_LEVEL1 (1U << 1)
+#define ESP_INTR_FLAG_LEVEL2 (1U << 2)
+#define ESP_INTR_FLAG_LEVEL3 (1U << 3)
+#define ESP_INTR_FLAG_SHARED (1U << 8)
+#define ESP_INTR_FLAG_IRAM   (1U << 10)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_ESP_INTR_ALLOC_H__
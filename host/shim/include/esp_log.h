@@ -0,0 +1,57 @@
+/**
+ * @file esp_log.h
+ *
+ * @brief Host stand-in for the ESP-IDF header of the same name. Lines go to stdout in the ESP-IDF format. Only the "*"
+ * level of esp_log_level_set() is honoured.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_ESP_LOG_H__
+#define __HOST_ESP_LOG_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "sdkconfig.h"
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define ESP_LOG_LINE(LETTER, FMT) #LETTER " (%u) %s: " FMT "\n"
+
+#define ESP_LOG_LEVEL(LEVEL, LETTER, TAG, FMT, ...)                                                               \
+    esp_log_write((LEVEL), (TAG), ESP_LOG_LINE(LETTER, FMT), (unsigned)esp_log_timestamp(), (TAG), ##__VA_ARGS__)
+
+#define ESP_LOGE(TAG, FMT, ...) ESP_LOG_LEVEL(ESP_LOG_ERROR, E, TAG, FMT, ##__VA_ARGS__)
+#define ESP_LOGW(TAG, FMT, ...) ESP_LOG_LEVEL(ESP_LOG_WARN, W, TAG, FMT, ##__VA_ARGS__)
+#define ESP_LOGI(TAG, FMT, ...) ESP_LOG_LEVEL(ESP_LOG_INFO, I, TAG, FMT, ##__VA_ARGS__)
+#define ESP_LOGD(TAG, FMT, ...) ESP_LOG_LEVEL(ESP_LOG_DEBUG, D, TAG, FMT, ##__VA_ARGS__)
+#define ESP_LOGV(TAG, FMT, ...) ESP_LOG_LEVEL(ESP_LOG_VERBOSE, V, TAG, FMT, ##__VA_ARGS__)
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef enum
+{
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+void esp_log_level_set(const char *p_tag, esp_log_level_t level);
+
+void esp_log_write(esp_log_level_t level, const char *p_tag, const char *p_format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+uint32_t esp_log_timestamp(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_ESP_LOG_H__
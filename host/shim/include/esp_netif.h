@@ -0,0 +1,31 @@
+/**
+ * @file esp_netif.h
+ *
+ * @brief Host stand-in for the ESP-IDF header of the same name. The network interface belongs to the Wi-Fi manager, which
+ * is faked on the host.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_ESP_NETIF_H__
+#define __HOST_ESP_NETIF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_ESP_NETIF_H__
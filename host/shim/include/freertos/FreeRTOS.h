@@ -0,0 +1,79 @@
+/**
+ * @file FreeRTOS.h
+ *
+ * @brief Host stand-in for the ESP-IDF FreeRTOS header of the same name. See freertos.c.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_FREERTOS_H__
+#define __HOST_FREERTOS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "sdkconfig.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE  ((BaseType_t)1)
+#define pdFAIL  (pdFALSE)
+#define pdPASS  (pdTRUE)
+
+#define errQUEUE_EMPTY ((BaseType_t)0)
+#define errQUEUE_FULL  ((BaseType_t)0)
+
+#define configTICK_RATE_HZ   (CONFIG_FREERTOS_HZ)
+#define configMAX_PRIORITIES (25)
+
+#define portMAX_DELAY       ((TickType_t)0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS  ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(X)    ((TickType_t)(((uint64_t)(X) * configTICK_RATE_HZ) / 1000U))
+#define pdTICKS_TO_MS(X)    ((uint32_t)(((uint64_t)(X) * 1000U) / configTICK_RATE_HZ))
+#define tskNO_AFFINITY      (0x7FFFFFFF)
+#define tskIDLE_PRIORITY    (0U)
+
+/* One lock stands for all spinlocks, as if everything ran on a single core. ISRs run holding it too. */
+#define portMUX_INITIALIZER_UNLOCKED   { 0 }
+#define portENTER_CRITICAL(MUX)        ((void)(MUX), vPortEnterCritical())
+#define portEXIT_CRITICAL(MUX)         ((void)(MUX), vPortExitCritical())
+#define portENTER_CRITICAL_ISR(MUX)    portENTER_CRITICAL(MUX)
+#define portEXIT_CRITICAL_ISR(MUX)     portEXIT_CRITICAL(MUX)
+#define portENTER_CRITICAL_SAFE(MUX)   portENTER_CRITICAL(MUX)
+#define portEXIT_CRITICAL_SAFE(MUX)    portEXIT_CRITICAL(MUX)
+#define taskENTER_CRITICAL(MUX)        portENTER_CRITICAL(MUX)
+#define taskEXIT_CRITICAL(MUX)         portEXIT_CRITICAL(MUX)
+#define portYIELD_FROM_ISR(B_WOKEN)    ((void)(B_WOKEN))
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef int           BaseType_t;
+typedef unsigned int  UBaseType_t;
+typedef uint32_t      TickType_t;
+typedef uint8_t       StackType_t;
+
+typedef struct
+{
+    int unused;
+} portMUX_TYPE;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+void vPortEnterCritical(void);
+void vPortExitCritical(void);
+
+/**
+ * @brief Returns pdTRUE while a host ISR runs, see host_gpio_input().
+ */
+BaseType_t xPortInIsrContext(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_FREERTOS_H__
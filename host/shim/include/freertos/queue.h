@@ -0,0 +1,59 @@
+/**
+ * @file queue.h
+ *
+ * @brief Host stand-in for the ESP-IDF FreeRTOS header of the same name. See freertos.c.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_FREERTOS_QUEUE_H__
+#define __HOST_FREERTOS_QUEUE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "freertos/FreeRTOS.h"
+
+//---------------------------------- MACROS -----------------------------------
+#define queueSEND_TO_BACK  ((BaseType_t)0)
+#define queueSEND_TO_FRONT ((BaseType_t)1)
+#define queueOVERWRITE     ((BaseType_t)2)
+
+#define xQueueSend(QUEUE, P_ITEM, TICKS)        xQueueGenericSend((QUEUE), (P_ITEM), (TICKS), queueSEND_TO_BACK)
+#define xQueueSendToBack(QUEUE, P_ITEM, TICKS)  xQueueGenericSend((QUEUE), (P_ITEM), (TICKS), queueSEND_TO_BACK)
+#define xQueueSendToFront(QUEUE, P_ITEM, TICKS) xQueueGenericSend((QUEUE), (P_ITEM), (TICKS), queueSEND_TO_FRONT)
+#define xQueueOverwrite(QUEUE, P_ITEM)          xQueueGenericSend((QUEUE), (P_ITEM), 0U, queueOVERWRITE)
+
+#define xQueueSendFromISR(QUEUE, P_ITEM, P_WOKEN) \
+    xQueueGenericSendFromISR((QUEUE), (P_ITEM), (P_WOKEN), queueSEND_TO_BACK)
+#define xQueueSendToBackFromISR(QUEUE, P_ITEM, P_WOKEN) \
+    xQueueGenericSendFromISR((QUEUE), (P_ITEM), (P_WOKEN), queueSEND_TO_BACK)
+#define xQueueOverwriteFromISR(QUEUE, P_ITEM, P_WOKEN) \
+    xQueueGenericSendFromISR((QUEUE), (P_ITEM), (P_WOKEN), queueOVERWRITE)
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef struct QueueDefinition *QueueHandle_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+void          vQueueDelete(QueueHandle_t queue);
+BaseType_t    xQueueReset(QueueHandle_t queue);
+
+BaseType_t xQueueGenericSend(QueueHandle_t queue, const void *p_item, TickType_t ticks, BaseType_t position);
+BaseType_t xQueueGenericSendFromISR(QueueHandle_t queue, const void *p_item, BaseType_t *p_higher_prio_woken,
+                                    BaseType_t position);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *p_item, TickType_t ticks);
+BaseType_t xQueueReceiveFromISR(QueueHandle_t queue, void *p_item, BaseType_t *p_higher_prio_woken);
+BaseType_t xQueuePeek(QueueHandle_t queue, void *p_item, TickType_t ticks);
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_FREERTOS_QUEUE_H__
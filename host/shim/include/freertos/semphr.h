@@ -0,0 +1,54 @@
+/**
+ * @file semphr.h
+ *
+ * @brief Host stand-in for the ESP-IDF FreeRTOS header of the same name. Semaphores are queues without items, as in
+ * FreeRTOS. Mutexes have no owner and no priority inheritance. See freertos.c.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_FREERTOS_SEMPHR_H__
+#define __HOST_FREERTOS_SEMPHR_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+//---------------------------------- MACROS -----------------------------------
+#define xSemaphoreCreateBinary()            xQueueCreateCountingSemaphore(1U, 0U)
+#define xSemaphoreCreateMutex()             xQueueCreateCountingSemaphore(1U, 1U)
+#define xSemaphoreCreateCounting(MAX, INIT) xQueueCreateCountingSemaphore((MAX), (INIT))
+
+/* The static buffer is not used, the semaphore is allocated and freed by vSemaphoreDelete(). */
+#define xSemaphoreCreateBinaryStatic(P_BUF) ((void)(P_BUF), xSemaphoreCreateBinary())
+#define xSemaphoreCreateMutexStatic(P_BUF)  ((void)(P_BUF), xSemaphoreCreateMutex())
+
+#define xSemaphoreTake(SEM, TICKS)           xQueueSemaphoreTake((SEM), (TICKS))
+#define xSemaphoreGive(SEM)                  xQueueGenericSend((SEM), NULL, 0U, queueSEND_TO_BACK)
+#define xSemaphoreGiveFromISR(SEM, P_WOKEN)  xQueueGenericSendFromISR((SEM), NULL, (P_WOKEN), queueSEND_TO_BACK)
+#define xSemaphoreTakeFromISR(SEM, P_WOKEN)  xQueueReceiveFromISR((SEM), NULL, (P_WOKEN))
+#define uxSemaphoreGetCount(SEM)             uxQueueMessagesWaiting(SEM)
+#define vSemaphoreDelete(SEM)                vQueueDelete(SEM)
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef QueueHandle_t SemaphoreHandle_t;
+
+typedef struct
+{
+    void *p_unused;
+} StaticSemaphore_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+QueueHandle_t xQueueCreateCountingSemaphore(UBaseType_t max_count, UBaseType_t initial_count);
+BaseType_t    xQueueSemaphoreTake(QueueHandle_t queue, TickType_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_FREERTOS_SEMPHR_H__
@@ -0,0 +1,77 @@
+/**
+ * @file task.h
+ *
+ * @brief Host stand-in for the ESP-IDF FreeRTOS header of the same name. See freertos.c.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_FREERTOS_TASK_H__
+#define __HOST_FREERTOS_TASK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "freertos/FreeRTOS.h"
+
+//---------------------------------- MACROS -----------------------------------
+#define xTaskCreate(FN, NAME, STACK, ARG, PRIO, P_HANDLE) \
+    xTaskCreatePinnedToCore((FN), (NAME), (STACK), (ARG), (PRIO), (P_HANDLE), tskNO_AFFINITY)
+
+#define xTaskNotify(TASK, VALUE, ACTION) xTaskGenericNotify((TASK), (VALUE), (ACTION), NULL)
+#define xTaskNotifyGive(TASK)            xTaskGenericNotify((TASK), 0U, eIncrement, NULL)
+#define xTaskNotifyFromISR(TASK, VALUE, ACTION, P_WOKEN) \
+    xTaskGenericNotifyFromISR((TASK), (VALUE), (ACTION), NULL, (P_WOKEN))
+#define vTaskNotifyGiveFromISR(TASK, P_WOKEN) \
+    ((void)xTaskGenericNotifyFromISR((TASK), 0U, eIncrement, NULL, (P_WOKEN)))
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef struct tskTaskControlBlock *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *p_arg);
+
+typedef enum
+{
+    eNoAction,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite,
+    eSetValueWithoutOverwrite,
+} eNotifyAction;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Starts a thread. Priority and core are ignored, the stack is a multiple of the requested size since host
+ * code needs more of it.
+ */
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t p_fn, const char *p_name, uint32_t stack_size, void *p_arg,
+                                   UBaseType_t priority, TaskHandle_t *p_handle, BaseType_t core);
+
+/**
+ * @brief Only a task deleting itself is supported.
+ */
+void vTaskDelete(TaskHandle_t task);
+
+void         vTaskDelay(TickType_t ticks);
+TickType_t   xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+const char  *pcTaskGetName(TaskHandle_t task);
+
+/**
+ * @brief Returns the stack never touched, in bytes of the host stack.
+ */
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+BaseType_t xTaskGenericNotify(TaskHandle_t task, uint32_t value, eNotifyAction action, uint32_t *p_prev_value);
+BaseType_t xTaskGenericNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, uint32_t *p_prev_value,
+                                     BaseType_t *p_higher_prio_woken);
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *p_value, TickType_t ticks);
+uint32_t   ulTaskNotifyTake(BaseType_t b_clear_on_exit, TickType_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_FREERTOS_TASK_H__
@@ -0,0 +1,99 @@
+/**
+ * @file host.h
+ *
+ * @brief Hooks into the host stand-ins. The application never includes this, only the fakes and host_main.c do, to
+ * drive inputs and read back what the hardware would have shown.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_H__
+#define __HOST_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define HOST_MQTT_TOPIC_SIZE   (64U)
+#define HOST_MQTT_TOPICS_MAX   (16U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief What the broker received on one topic.
+ */
+typedef struct
+{
+    char     topic[HOST_MQTT_TOPIC_SIZE];
+    uint32_t msgs;
+    uint64_t bytes;
+    uint32_t latency_us_max; /* From esp_mqtt_client_enqueue() to the broker. */
+    uint64_t latency_us_total;
+} host_mqtt_topic_stats_t;
+
+typedef struct
+{
+    uint32_t produced; /* Samples the fake sensor measured. */
+    uint32_t dropped;  /* Samples lost because the queue was full. */
+} host_sensor_stats_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Brackets code that stands for an interrupt: xPortInIsrContext() is true and critical sections are held.
+ */
+void host_isr_enter(void);
+void host_isr_exit(void);
+
+/**
+ * @brief Drives an input pin, running its ISR if the edge matches the configured interrupt type.
+ */
+void host_gpio_input(int pin, int level);
+
+/**
+ * @brief Presses or releases the touch panel, the pen interrupt pin follows.
+ */
+void host_touch_set(bool b_is_pressed, int16_t x, int16_t y);
+
+/**
+ * @brief Returns the in-memory framebuffer, in lv_color_t as the display controller would have received it.
+ */
+const void *host_fb_get(uint16_t *p_width, uint16_t *p_height);
+
+/**
+ * @brief Writes the framebuffer as a binary PPM image.
+ */
+esp_err_t host_fb_write_ppm(const char *p_path);
+
+/**
+ * @brief Overrides the SHT31 measurement period, 0 returns to the configured rate.
+ */
+void host_sht31_set_period_us(uint32_t period_us);
+void host_sht31_get_stats(host_sensor_stats_t *p_stats);
+
+/**
+ * @brief Brings the broker connection up or down, the client reports it with CONNECTED and DISCONNECTED events.
+ */
+void host_mqtt_set_link(bool b_is_up);
+
+/**
+ * @brief Publishes from the broker side, e.g. a command for the application.
+ */
+esp_err_t host_mqtt_inject(const char *p_topic, const void *p_payload, size_t len);
+
+/**
+ * @brief Copies per-topic broker counters and returns how many topics were copied.
+ */
+uint8_t host_mqtt_get_stats(host_mqtt_topic_stats_t *p_stats, uint8_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_H__
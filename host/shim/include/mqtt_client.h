@@ -0,0 +1,120 @@
+/**
+ * @file mqtt_client.h
+ *
+ * @brief Host stand-in for the ESP-MQTT header of the same name. The client talks to a broker inside the process, see
+ * mqtt_client.c. Only the configuration fields the stand-in reads are declared.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_MQTT_CLIENT_H__
+#define __HOST_MQTT_CLIENT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include "esp_event.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef struct esp_mqtt_client *esp_mqtt_client_handle_t;
+
+typedef enum esp_mqtt_event_id_t
+{
+    MQTT_EVENT_ANY = -1,
+    MQTT_EVENT_ERROR = 0,
+    MQTT_EVENT_CONNECTED,
+    MQTT_EVENT_DISCONNECTED,
+    MQTT_EVENT_SUBSCRIBED,
+    MQTT_EVENT_UNSUBSCRIBED,
+    MQTT_EVENT_PUBLISHED,
+    MQTT_EVENT_DATA,
+    MQTT_EVENT_BEFORE_CONNECT,
+    MQTT_EVENT_DELETED,
+} esp_mqtt_event_id_t;
+
+typedef enum esp_mqtt_error_type_t
+{
+    MQTT_ERROR_TYPE_NONE = 0,
+    MQTT_ERROR_TYPE_TCP_TRANSPORT,
+    MQTT_ERROR_TYPE_CONNECTION_REFUSED,
+    MQTT_ERROR_TYPE_SUBSCRIBE_FAILED,
+} esp_mqtt_error_type_t;
+
+typedef struct esp_mqtt_error_codes
+{
+    esp_err_t             esp_tls_last_esp_err;
+    int                   esp_tls_stack_err;
+    int                   esp_tls_cert_verify_flags;
+    esp_mqtt_error_type_t error_type;
+    int                   connect_return_code;
+    int                   esp_transport_sock_errno;
+} esp_mqtt_error_codes_t;
+
+typedef struct esp_mqtt_event_t
+{
+    esp_mqtt_event_id_t      event_id;
+    esp_mqtt_client_handle_t client;
+    char                    *data;
+    int                      data_len;
+    int                      total_data_len;
+    int                      current_data_offset;
+    char                    *topic;
+    int                      topic_len;
+    int                      msg_id;
+    int                      session_present;
+    esp_mqtt_error_codes_t  *error_handle;
+    bool                     retain;
+    int                      qos;
+    bool                     dup;
+} esp_mqtt_event_t;
+
+typedef esp_mqtt_event_t *esp_mqtt_event_handle_t;
+
+typedef struct esp_mqtt_client_config_t
+{
+    struct
+    {
+        struct
+        {
+            const char *uri;
+            const char *hostname;
+            uint32_t    port;
+        } address;
+    } broker;
+    struct
+    {
+        int size; /* Incoming payloads above it arrive in several DATA events, 1024 if 0. */
+    } buffer;
+} esp_mqtt_client_config_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t *p_config);
+
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t client, esp_mqtt_event_id_t event,
+                                         esp_event_handler_t p_handler, void *p_arg);
+
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t client);
+esp_err_t esp_mqtt_client_reconnect(esp_mqtt_client_handle_t client);
+esp_err_t esp_mqtt_client_disconnect(esp_mqtt_client_handle_t client);
+esp_err_t esp_mqtt_client_stop(esp_mqtt_client_handle_t client);
+
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t client, const char *p_topic, const char *p_data, int len, int qos,
+                            int retain);
+int esp_mqtt_client_enqueue(esp_mqtt_client_handle_t client, const char *p_topic, const char *p_data, int len, int qos,
+                            int retain, bool b_store);
+int esp_mqtt_client_subscribe(esp_mqtt_client_handle_t client, const char *p_topic, int qos);
+int esp_mqtt_client_unsubscribe(esp_mqtt_client_handle_t client, const char *p_topic);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_MQTT_CLIENT_H__
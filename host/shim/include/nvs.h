@@ -0,0 +1,59 @@
+/**
+ * @file nvs.h
+ *
+ * @brief Host stand-in for the ESP-IDF header of the same name. The store lives in memory for the life of the process. See
+ * nvs.c.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __HOST_NVS_H__
+#define __HOST_NVS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define NVS_KEY_NAME_MAX_SIZE (16U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef uint32_t nvs_handle_t;
+
+typedef enum
+{
+    NVS_READONLY,
+    NVS_READWRITE
+} nvs_open_mode_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+esp_err_t nvs_open(const char *p_namespace, nvs_open_mode_t mode, nvs_handle_t *p_handle);
+void      nvs_close(nvs_handle_t handle);
+esp_err_t nvs_commit(nvs_handle_t handle);
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *p_key);
+esp_err_t nvs_erase_all(nvs_handle_t handle);
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char *p_key, uint8_t value);
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char *p_key, uint8_t *p_value);
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *p_key, uint32_t value);
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *p_key, uint32_t *p_value);
+esp_err_t nvs_set_str(nvs_handle_t handle, const char *p_key, const char *p_value);
+esp_err_t nvs_get_str(nvs_handle_t handle, const char *p_key, char *p_value, size_t *p_len);
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *p_key, const void *p_value, size_t len);
+
+/**
+ * @brief With p_value NULL only the size is returned, as in ESP-IDF.
+ */
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *p_key, void *p_value, size_t *p_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_NVS_H__
@@ -0,0 +1,694 @@
+/**
+ * @file mqtt_client.c
+ *
+ * @brief Host ESP-MQTT client wired to a broker inside the process. Each client has a task that owns its connection:
+ * calls post commands to it, the task sends them to the broker and dispatches events, as the ESP-MQTT task does. The
+ * broker acknowledges QoS 1 and 2 at once, counts messages, bytes and latency per topic and routes them to matching
+ * subscriptions, splitting payloads above the client's buffer size across DATA events. Sessions are clean, so
+ * subscriptions are dropped on disconnect. While the link is down messages wait in the client outbox.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "mqtt_client.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "host.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define MQTT_CLIENTS_MAX       (4U)
+#define MQTT_SUBSCRIPTIONS_MAX (16U)
+#define MQTT_BUFFER_SIZE       (1024)
+#define MQTT_CMD_QUEUE_SIZE    (64U)
+
+#define MQTT_TASK_STACK_SIZE (6U * 1024U)
+#define MQTT_TASK_PRIORITY   (5U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef enum
+{
+    _CMD_CONNECT,
+    _CMD_LINK_DOWN,
+    _CMD_PUBLISH,
+    _CMD_SUBSCRIBE,
+    _CMD_UNSUBSCRIBE,
+    _CMD_DATA,
+} _cmd_type_t;
+
+/**
+ * @brief Command posted to a client task. The topic and then the payload follow the header.
+ *
+ */
+typedef struct _cmd
+{
+    _cmd_type_t  type;
+    int          msg_id;
+    int          qos;
+    int64_t      enqueue_us;
+    size_t       topic_len;
+    size_t       len;
+    struct _cmd *p_next; /* Outbox link. */
+    char         buf[];
+} _cmd_t;
+
+struct esp_mqtt_client
+{
+    esp_event_handler_t p_handler;
+    void               *p_handler_arg;
+    esp_mqtt_event_id_t handler_event;
+    int                 buffer_size;
+    QueueHandle_t       p_cmd_queue;
+    atomic_bool         b_is_started;
+    atomic_bool         b_is_connected;
+    _cmd_t             *p_outbox_head; /* Owned by the client task. */
+    _cmd_t             *p_outbox_tail;
+    char               *p_subscriptions[MQTT_SUBSCRIPTIONS_MAX]; /* Under the broker lock. */
+};
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+static void _client_task(void *p_parameter);
+
+/**
+ * @brief Allocates a command holding a copy of the topic and payload.
+ */
+static _cmd_t *_cmd_new(_cmd_type_t type, const char *p_topic, const void *p_data, size_t len);
+
+/**
+ * @brief Posts a command to the client task, freeing it if the queue is full.
+ */
+static bool _cmd_post(esp_mqtt_client_handle_t p_client, _cmd_t *p_cmd);
+
+static void _connect(esp_mqtt_client_handle_t p_client);
+static void _disconnect(esp_mqtt_client_handle_t p_client);
+
+/**
+ * @brief Hands a message to the broker and dispatches its acknowledgement.
+ */
+static void _send(esp_mqtt_client_handle_t p_client, _cmd_t *p_cmd);
+
+/**
+ * @brief Counts a message on its topic and posts it to every client with a matching subscription.
+ */
+static void _broker_route(const char *p_topic, const void *p_data, size_t len, int64_t enqueue_us);
+
+/**
+ * @brief Delivers a message as one or more DATA events.
+ */
+static void _deliver(esp_mqtt_client_handle_t p_client, const _cmd_t *p_cmd);
+
+/**
+ * @brief Matches a topic against a filter with + and # wildcards.
+ */
+static bool _topic_match(const char *p_filter, const char *p_topic);
+
+static void _dispatch(esp_mqtt_client_handle_t p_client, esp_mqtt_event_t *p_event);
+static int  _msg_id_next(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "mqtt_host";
+
+static const char MQTT_EVENTS[] = "MQTT_EVENTS";
+
+static pthread_mutex_t _broker_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static esp_mqtt_client_handle_t _clients[MQTT_CLIENTS_MAX];
+static host_mqtt_topic_stats_t  _topic_stats[HOST_MQTT_TOPICS_MAX];
+static uint8_t                  _topic_count = 0U;
+static bool                     _b_is_link_up = true;
+
+static atomic_int _msg_id = 0;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t *p_config)
+{
+    if(NULL == p_config)
+    {
+        return NULL;
+    }
+
+    esp_mqtt_client_handle_t p_client = calloc(1U, sizeof(*p_client));
+    if(NULL == p_client)
+    {
+        return NULL;
+    }
+
+    p_client->buffer_size   = (0 < p_config->buffer.size) ? p_config->buffer.size : MQTT_BUFFER_SIZE;
+    p_client->handler_event = MQTT_EVENT_ANY;
+    p_client->p_cmd_queue   = xQueueCreate(MQTT_CMD_QUEUE_SIZE, sizeof(_cmd_t *));
+
+    bool b_is_added = false;
+
+    (void)pthread_mutex_lock(&_broker_mutex);
+    for(uint8_t idx = 0U; !b_is_added && (idx < MQTT_CLIENTS_MAX); idx++)
+    {
+        if(NULL == _clients[idx])
+        {
+            _clients[idx] = p_client;
+            b_is_added    = true;
+        }
+    }
+    (void)pthread_mutex_unlock(&_broker_mutex);
+
+    if(!b_is_added || (NULL == p_client->p_cmd_queue) ||
+       (pdPASS != xTaskCreate(&_client_task, "mqtt_task", MQTT_TASK_STACK_SIZE, p_client, MQTT_TASK_PRIORITY, NULL)))
+    {
+        ESP_LOGE(TAG, "Client not created");
+        return NULL;
+    }
+
+    return p_client;
+}
+
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t client, esp_mqtt_event_id_t event,
+                                         esp_event_handler_t p_handler, void *p_arg)
+{
+    if((NULL == client) || (NULL == p_handler))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    client->p_handler     = p_handler;
+    client->p_handler_arg = p_arg;
+    client->handler_event = event;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t client)
+{
+    if(NULL == client)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(atomic_exchange(&client->b_is_started, true))
+    {
+        return ESP_FAIL;
+    }
+
+    return _cmd_post(client, _cmd_new(_CMD_CONNECT, "", NULL, 0U)) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_mqtt_client_reconnect(esp_mqtt_client_handle_t client)
+{
+    if((NULL == client) || !atomic_load(&client->b_is_started) || atomic_load(&client->b_is_connected))
+    {
+        return ESP_FAIL;
+    }
+
+    return _cmd_post(client, _cmd_new(_CMD_CONNECT, "", NULL, 0U)) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_mqtt_client_disconnect(esp_mqtt_client_handle_t client)
+{
+    if(NULL == client)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return _cmd_post(client, _cmd_new(_CMD_LINK_DOWN, "", NULL, 0U)) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_mqtt_client_stop(esp_mqtt_client_handle_t client)
+{
+    if(NULL == client)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    atomic_store(&client->b_is_started, false);
+
+    return esp_mqtt_client_disconnect(client);
+}
+
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t client, const char *p_topic, const char *p_data, int len, int qos,
+                            int retain)
+{
+    /* Without a connection ESP-MQTT drops QoS 0 and queues the rest, the call is not blocking here either way. */
+    if((NULL != client) && !atomic_load(&client->b_is_connected) && (0 == qos))
+    {
+        return -1;
+    }
+
+    return esp_mqtt_client_enqueue(client, p_topic, p_data, len, qos, retain, true);
+}
+
+int esp_mqtt_client_enqueue(esp_mqtt_client_handle_t client, const char *p_topic, const char *p_data, int len, int qos,
+                            int retain, bool b_store)
+{
+    (void)retain;
+
+    if((NULL == client) || (NULL == p_topic) || (0 > len) || (0 > qos) || (2 < qos))
+    {
+        return -1;
+    }
+
+    if(!b_store && !atomic_load(&client->b_is_connected))
+    {
+        return -1;
+    }
+
+    /* As in ESP-MQTT, a zero length means a string payload. */
+    size_t size = ((0 == len) && (NULL != p_data)) ? strlen(p_data) : (size_t)len;
+
+    _cmd_t *p_cmd = _cmd_new(_CMD_PUBLISH, p_topic, p_data, size);
+    if(NULL == p_cmd)
+    {
+        return -1;
+    }
+
+    p_cmd->qos    = qos;
+    p_cmd->msg_id = (0 == qos) ? 0 : _msg_id_next();
+    int msg_id    = p_cmd->msg_id;
+
+    return _cmd_post(client, p_cmd) ? msg_id : -1;
+}
+
+int esp_mqtt_client_subscribe(esp_mqtt_client_handle_t client, const char *p_topic, int qos)
+{
+    if((NULL == client) || (NULL == p_topic) || !atomic_load(&client->b_is_connected))
+    {
+        return -1;
+    }
+
+    _cmd_t *p_cmd = _cmd_new(_CMD_SUBSCRIBE, p_topic, NULL, 0U);
+    if(NULL == p_cmd)
+    {
+        return -1;
+    }
+
+    p_cmd->qos    = qos;
+    p_cmd->msg_id = _msg_id_next();
+    int msg_id    = p_cmd->msg_id;
+
+    return _cmd_post(client, p_cmd) ? msg_id : -1;
+}
+
+int esp_mqtt_client_unsubscribe(esp_mqtt_client_handle_t client, const char *p_topic)
+{
+    if((NULL == client) || (NULL == p_topic) || !atomic_load(&client->b_is_connected))
+    {
+        return -1;
+    }
+
+    _cmd_t *p_cmd = _cmd_new(_CMD_UNSUBSCRIBE, p_topic, NULL, 0U);
+    if(NULL == p_cmd)
+    {
+        return -1;
+    }
+
+    p_cmd->msg_id = _msg_id_next();
+    int msg_id    = p_cmd->msg_id;
+
+    return _cmd_post(client, p_cmd) ? msg_id : -1;
+}
+
+void host_mqtt_set_link(bool b_is_up)
+{
+    esp_mqtt_client_handle_t clients[MQTT_CLIENTS_MAX];
+
+    (void)pthread_mutex_lock(&_broker_mutex);
+    _b_is_link_up = b_is_up;
+    memcpy(clients, _clients, sizeof(clients));
+    (void)pthread_mutex_unlock(&_broker_mutex);
+
+    for(uint8_t idx = 0U; idx < MQTT_CLIENTS_MAX; idx++)
+    {
+        /* Coming back up stands in for the client's reconnect timer. */
+        if((NULL != clients[idx]) && atomic_load(&clients[idx]->b_is_started))
+        {
+            (void)_cmd_post(clients[idx], _cmd_new(b_is_up ? _CMD_CONNECT : _CMD_LINK_DOWN, "", NULL, 0U));
+        }
+    }
+}
+
+esp_err_t host_mqtt_inject(const char *p_topic, const void *p_payload, size_t len)
+{
+    if((NULL == p_topic) || ((NULL == p_payload) && (0U < len)))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    _broker_route(p_topic, p_payload, len, esp_timer_get_time());
+
+    return ESP_OK;
+}
+
+uint8_t host_mqtt_get_stats(host_mqtt_topic_stats_t *p_stats, uint8_t max)
+{
+    (void)pthread_mutex_lock(&_broker_mutex);
+    uint8_t count = (_topic_count < max) ? _topic_count : max;
+    memcpy(p_stats, _topic_stats, count * sizeof(*p_stats));
+    (void)pthread_mutex_unlock(&_broker_mutex);
+
+    return count;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _client_task(void *p_parameter)
+{
+    esp_mqtt_client_handle_t p_client = (esp_mqtt_client_handle_t)p_parameter;
+    _cmd_t                  *p_cmd;
+
+    for(;;)
+    {
+        if(pdTRUE != xQueueReceive(p_client->p_cmd_queue, &p_cmd, portMAX_DELAY))
+        {
+            continue;
+        }
+
+        switch(p_cmd->type)
+        {
+            case _CMD_CONNECT:
+                _connect(p_client);
+                break;
+
+            case _CMD_LINK_DOWN:
+                _disconnect(p_client);
+                break;
+
+            case _CMD_PUBLISH:
+                if(atomic_load(&p_client->b_is_connected))
+                {
+                    _send(p_client, p_cmd);
+                }
+                else
+                {
+                    /* Kept for the next connection. */
+                    p_cmd->p_next = NULL;
+                    if(NULL == p_client->p_outbox_tail)
+                    {
+                        p_client->p_outbox_head = p_cmd;
+                    }
+                    else
+                    {
+                        p_client->p_outbox_tail->p_next = p_cmd;
+                    }
+                    p_client->p_outbox_tail = p_cmd;
+                    p_cmd                   = NULL;
+                }
+                break;
+
+            case _CMD_SUBSCRIBE:
+            case _CMD_UNSUBSCRIBE:
+            {
+                bool b_is_sub = (_CMD_SUBSCRIBE == p_cmd->type);
+
+                (void)pthread_mutex_lock(&_broker_mutex);
+                for(uint8_t idx = 0U; idx < MQTT_SUBSCRIPTIONS_MAX; idx++)
+                {
+                    char **pp_sub = &p_client->p_subscriptions[idx];
+
+                    if(b_is_sub && (NULL == *pp_sub))
+                    {
+                        *pp_sub = strdup(p_cmd->buf);
+                        break;
+                    }
+                    if(!b_is_sub && (NULL != *pp_sub) && (0 == strcmp(*pp_sub, p_cmd->buf)))
+                    {
+                        free(*pp_sub);
+                        *pp_sub = NULL;
+                    }
+                }
+                (void)pthread_mutex_unlock(&_broker_mutex);
+
+                esp_mqtt_event_t event = {
+                    .event_id = b_is_sub ? MQTT_EVENT_SUBSCRIBED : MQTT_EVENT_UNSUBSCRIBED,
+                    .msg_id   = p_cmd->msg_id,
+                };
+                _dispatch(p_client, &event);
+                break;
+            }
+
+            case _CMD_DATA:
+                if(atomic_load(&p_client->b_is_connected))
+                {
+                    _deliver(p_client, p_cmd);
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        free(p_cmd);
+    }
+}
+
+static _cmd_t *_cmd_new(_cmd_type_t type, const char *p_topic, const void *p_data, size_t len)
+{
+    size_t  topic_len = strlen(p_topic);
+    _cmd_t *p_cmd     = malloc(sizeof(_cmd_t) + topic_len + 1U + len);
+
+    if(NULL != p_cmd)
+    {
+        *p_cmd = (_cmd_t){
+            .type       = type,
+            .enqueue_us = esp_timer_get_time(),
+            .topic_len  = topic_len,
+            .len        = len,
+        };
+        memcpy(p_cmd->buf, p_topic, topic_len + 1U);
+        if(0U < len)
+        {
+            memcpy(&p_cmd->buf[topic_len + 1U], p_data, len);
+        }
+    }
+
+    return p_cmd;
+}
+
+static bool _cmd_post(esp_mqtt_client_handle_t p_client, _cmd_t *p_cmd)
+{
+    if(NULL == p_cmd)
+    {
+        return false;
+    }
+
+    if(pdTRUE != xQueueSend(p_client->p_cmd_queue, &p_cmd, 0))
+    {
+        free(p_cmd);
+        return false;
+    }
+
+    return true;
+}
+
+static void _connect(esp_mqtt_client_handle_t p_client)
+{
+    if(!atomic_load(&p_client->b_is_started) || atomic_load(&p_client->b_is_connected))
+    {
+        return;
+    }
+
+    esp_mqtt_event_t event = { .event_id = MQTT_EVENT_BEFORE_CONNECT };
+    _dispatch(p_client, &event);
+
+    (void)pthread_mutex_lock(&_broker_mutex);
+    bool b_is_link_up = _b_is_link_up;
+    (void)pthread_mutex_unlock(&_broker_mutex);
+
+    if(!b_is_link_up)
+    {
+        esp_mqtt_error_codes_t error = {
+            .error_type               = MQTT_ERROR_TYPE_TCP_TRANSPORT,
+            .esp_transport_sock_errno = ECONNREFUSED,
+        };
+        event = (esp_mqtt_event_t){ .event_id = MQTT_EVENT_ERROR, .error_handle = &error };
+        _dispatch(p_client, &event);
+
+        event = (esp_mqtt_event_t){ .event_id = MQTT_EVENT_DISCONNECTED };
+        _dispatch(p_client, &event);
+        return;
+    }
+
+    atomic_store(&p_client->b_is_connected, true);
+    event = (esp_mqtt_event_t){ .event_id = MQTT_EVENT_CONNECTED };
+    _dispatch(p_client, &event);
+
+    while(NULL != p_client->p_outbox_head)
+    {
+        _cmd_t *p_cmd           = p_client->p_outbox_head;
+        p_client->p_outbox_head = p_cmd->p_next;
+        _send(p_client, p_cmd);
+        free(p_cmd);
+    }
+    p_client->p_outbox_tail = NULL;
+}
+
+static void _disconnect(esp_mqtt_client_handle_t p_client)
+{
+    if(!atomic_exchange(&p_client->b_is_connected, false))
+    {
+        return;
+    }
+
+    /* Clean session, the application subscribes again on CONNECTED. */
+    (void)pthread_mutex_lock(&_broker_mutex);
+    for(uint8_t idx = 0U; idx < MQTT_SUBSCRIPTIONS_MAX; idx++)
+    {
+        free(p_client->p_subscriptions[idx]);
+        p_client->p_subscriptions[idx] = NULL;
+    }
+    (void)pthread_mutex_unlock(&_broker_mutex);
+
+    esp_mqtt_event_t event = { .event_id = MQTT_EVENT_DISCONNECTED };
+    _dispatch(p_client, &event);
+}
+
+static void _send(esp_mqtt_client_handle_t p_client, _cmd_t *p_cmd)
+{
+    _broker_route(p_cmd->buf, &p_cmd->buf[p_cmd->topic_len + 1U], p_cmd->len, p_cmd->enqueue_us);
+
+    if(0 < p_cmd->qos)
+    {
+        esp_mqtt_event_t event = {
+            .event_id = MQTT_EVENT_PUBLISHED,
+            .msg_id   = p_cmd->msg_id,
+        };
+        _dispatch(p_client, &event);
+    }
+}
+
+static void _broker_route(const char *p_topic, const void *p_data, size_t len, int64_t enqueue_us)
+{
+    esp_mqtt_client_handle_t targets[MQTT_CLIENTS_MAX] = { NULL };
+    uint32_t                 latency_us                = (uint32_t)(esp_timer_get_time() - enqueue_us);
+
+    (void)pthread_mutex_lock(&_broker_mutex);
+
+    uint8_t idx = 0U;
+    while((idx < _topic_count) && (0 != strcmp(_topic_stats[idx].topic, p_topic)))
+    {
+        idx++;
+    }
+
+    if((idx == _topic_count) && (HOST_MQTT_TOPICS_MAX > _topic_count))
+    {
+        (void)snprintf(_topic_stats[idx].topic, sizeof(_topic_stats[idx].topic), "%s", p_topic);
+        _topic_count++;
+    }
+
+    if(idx < _topic_count)
+    {
+        host_mqtt_topic_stats_t *p_stats = &_topic_stats[idx];
+        p_stats->msgs++;
+        p_stats->bytes += len;
+        p_stats->latency_us_total += latency_us;
+        p_stats->latency_us_max = (latency_us > p_stats->latency_us_max) ? latency_us : p_stats->latency_us_max;
+    }
+
+    for(uint8_t client = 0U; client < MQTT_CLIENTS_MAX; client++)
+    {
+        for(uint8_t sub = 0U; (NULL != _clients[client]) && (sub < MQTT_SUBSCRIPTIONS_MAX); sub++)
+        {
+            const char *p_filter = _clients[client]->p_subscriptions[sub];
+
+            if((NULL != p_filter) && _topic_match(p_filter, p_topic))
+            {
+                targets[client] = _clients[client];
+                break;
+            }
+        }
+    }
+
+    (void)pthread_mutex_unlock(&_broker_mutex);
+
+    for(uint8_t client = 0U; client < MQTT_CLIENTS_MAX; client++)
+    {
+        if((NULL != targets[client]) && !_cmd_post(targets[client], _cmd_new(_CMD_DATA, p_topic, p_data, len)))
+        {
+            ESP_LOGW(TAG, "%s: delivery dropped", p_topic);
+        }
+    }
+}
+
+static void _deliver(esp_mqtt_client_handle_t p_client, const _cmd_t *p_cmd)
+{
+    size_t offset = 0U;
+
+    do
+    {
+        size_t chunk = p_cmd->len - offset;
+        chunk        = (chunk > (size_t)p_client->buffer_size) ? (size_t)p_client->buffer_size : chunk;
+
+        /* As in ESP-MQTT, the topic is only set on the first fragment. */
+        esp_mqtt_event_t event = {
+            .event_id            = MQTT_EVENT_DATA,
+            .client              = p_client,
+            .data                = (char *)&p_cmd->buf[p_cmd->topic_len + 1U + offset],
+            .data_len            = (int)chunk,
+            .total_data_len      = (int)p_cmd->len,
+            .current_data_offset = (int)offset,
+            .topic               = (0U == offset) ? (char *)p_cmd->buf : NULL,
+            .topic_len           = (0U == offset) ? (int)p_cmd->topic_len : 0,
+        };
+        _dispatch(p_client, &event);
+
+        offset += chunk;
+    } while(offset < p_cmd->len);
+}
+
+static bool _topic_match(const char *p_filter, const char *p_topic)
+{
+    while(('\0' != *p_filter) && ('\0' != *p_topic))
+    {
+        if('#' == *p_filter)
+        {
+            return true;
+        }
+
+        if('+' == *p_filter)
+        {
+            while(('\0' != *p_topic) && ('/' != *p_topic))
+            {
+                p_topic++;
+            }
+            p_filter++;
+            continue;
+        }
+
+        if(*p_filter != *p_topic)
+        {
+            return false;
+        }
+
+        p_filter++;
+        p_topic++;
+    }
+
+    /* "a/#" also matches "a". */
+    return ('\0' == *p_topic) && (('\0' == *p_filter) || (0 == strcmp(p_filter, "/#")) || (0 == strcmp(p_filter, "#")));
+}
+
+static void _dispatch(esp_mqtt_client_handle_t p_client, esp_mqtt_event_t *p_event)
+{
+    p_event->client = p_client;
+
+    if((NULL != p_client->p_handler) &&
+       ((MQTT_EVENT_ANY == p_client->handler_event) || (p_event->event_id == p_client->handler_event)))
+    {
+        p_client->p_handler(p_client->p_handler_arg, MQTT_EVENTS, p_event->event_id, p_event);
+    }
+}
+
+static int _msg_id_next(void)
+{
+    /* Packet identifiers are 16 bit and never 0. */
+    return (atomic_fetch_add(&_msg_id, 1) % 0xFFFF) + 1;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,389 @@
+/**
+ * @file nvs.c
+ *
+ * @brief Host NVS. Entries live in memory for the life of the process, so every run starts from an erased flash. A
+ * value read with another type than it was written with is not found, as on the target. Commits do nothing.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "nvs.h"
+#include "nvs_flash.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define NVS_NAMESPACES_MAX (16U)
+
+/* The handle is the namespace index plus one, the mode sits above it. */
+#define NVS_HANDLE(NS, MODE)    ((nvs_handle_t)(((NS) + 1U) | ((uint32_t)(MODE) << 16)))
+#define NVS_HANDLE_NS(HANDLE)   (((HANDLE) & 0xFFFFU) - 1U)
+#define NVS_HANDLE_MODE(HANDLE) ((nvs_open_mode_t)((HANDLE) >> 16))
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef enum
+{
+    _TYPE_U8,
+    _TYPE_U32,
+    _TYPE_STR,
+    _TYPE_BLOB,
+} _type_t;
+
+typedef struct _entry
+{
+    uint32_t       ns;
+    char           key[NVS_KEY_NAME_MAX_SIZE];
+    _type_t        type;
+    size_t         len;
+    uint8_t       *p_data;
+    struct _entry *p_next;
+} _entry_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Validates the handle and the key. Caller holds the lock.
+ */
+static esp_err_t _check(nvs_handle_t handle, const char *p_key, bool b_is_write);
+
+/**
+ * @brief Finds an entry in the handle's namespace. Caller holds the lock.
+ */
+static _entry_t **_find(nvs_handle_t handle, const char *p_key);
+
+static esp_err_t _set(nvs_handle_t handle, const char *p_key, _type_t type, const void *p_value, size_t len);
+
+/**
+ * @brief Reads an entry. With p_value NULL only its length is returned, otherwise *p_len must be large enough.
+ */
+static esp_err_t _get(nvs_handle_t handle, const char *p_key, _type_t type, void *p_value, size_t *p_len);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static bool      _b_is_init = false;
+static char      _namespaces[NVS_NAMESPACES_MAX][NVS_KEY_NAME_MAX_SIZE];
+static uint32_t  _namespace_count = 0U;
+static _entry_t *p_entries        = NULL;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+esp_err_t nvs_flash_init(void)
+{
+    (void)pthread_mutex_lock(&_mutex);
+    _b_is_init = true;
+    (void)pthread_mutex_unlock(&_mutex);
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    (void)pthread_mutex_lock(&_mutex);
+    while(NULL != p_entries)
+    {
+        _entry_t *p_entry = p_entries;
+        p_entries         = p_entry->p_next;
+        free(p_entry->p_data);
+        free(p_entry);
+    }
+    _b_is_init = false;
+    (void)pthread_mutex_unlock(&_mutex);
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *p_namespace, nvs_open_mode_t mode, nvs_handle_t *p_handle)
+{
+    if((NULL == p_namespace) || (NULL == p_handle))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(NVS_KEY_NAME_MAX_SIZE <= strlen(p_namespace))
+    {
+        return ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+
+    esp_err_t esp_err = ESP_OK;
+    uint32_t  ns      = 0U;
+
+    (void)pthread_mutex_lock(&_mutex);
+
+    while((ns < _namespace_count) && (0 != strcmp(_namespaces[ns], p_namespace)))
+    {
+        ns++;
+    }
+
+    if(!_b_is_init)
+    {
+        esp_err = ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    else if(ns == _namespace_count)
+    {
+        if(NVS_READONLY == mode)
+        {
+            esp_err = ESP_ERR_NVS_NOT_FOUND;
+        }
+        else if(NVS_NAMESPACES_MAX == _namespace_count)
+        {
+            esp_err = ESP_ERR_NO_MEM;
+        }
+        else
+        {
+            strcpy(_namespaces[_namespace_count++], p_namespace);
+        }
+    }
+
+    (void)pthread_mutex_unlock(&_mutex);
+
+    if(ESP_OK == esp_err)
+    {
+        *p_handle = NVS_HANDLE(ns, mode);
+    }
+
+    return esp_err;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    (void)handle;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    (void)pthread_mutex_lock(&_mutex);
+    esp_err_t esp_err = _check(handle, "", false);
+    (void)pthread_mutex_unlock(&_mutex);
+
+    return esp_err;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *p_key)
+{
+    (void)pthread_mutex_lock(&_mutex);
+
+    esp_err_t esp_err = _check(handle, p_key, true);
+
+    if(ESP_OK == esp_err)
+    {
+        _entry_t **pp_entry = _find(handle, p_key);
+
+        if(NULL == *pp_entry)
+        {
+            esp_err = ESP_ERR_NVS_NOT_FOUND;
+        }
+        else
+        {
+            _entry_t *p_entry = *pp_entry;
+            *pp_entry         = p_entry->p_next;
+            free(p_entry->p_data);
+            free(p_entry);
+        }
+    }
+
+    (void)pthread_mutex_unlock(&_mutex);
+
+    return esp_err;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle)
+{
+    (void)pthread_mutex_lock(&_mutex);
+
+    esp_err_t esp_err = _check(handle, "", true);
+
+    for(_entry_t **pp_entry = &p_entries; (ESP_OK == esp_err) && (NULL != *pp_entry);)
+    {
+        _entry_t *p_entry = *pp_entry;
+
+        if(NVS_HANDLE_NS(handle) == p_entry->ns)
+        {
+            *pp_entry = p_entry->p_next;
+            free(p_entry->p_data);
+            free(p_entry);
+        }
+        else
+        {
+            pp_entry = &p_entry->p_next;
+        }
+    }
+
+    (void)pthread_mutex_unlock(&_mutex);
+
+    return esp_err;
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char *p_key, uint8_t value)
+{
+    return _set(handle, p_key, _TYPE_U8, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char *p_key, uint8_t *p_value)
+{
+    size_t len = sizeof(*p_value);
+
+    return (NULL == p_value) ? ESP_ERR_INVALID_ARG : _get(handle, p_key, _TYPE_U8, p_value, &len);
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *p_key, uint32_t value)
+{
+    return _set(handle, p_key, _TYPE_U32, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *p_key, uint32_t *p_value)
+{
+    size_t len = sizeof(*p_value);
+
+    return (NULL == p_value) ? ESP_ERR_INVALID_ARG : _get(handle, p_key, _TYPE_U32, p_value, &len);
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, const char *p_key, const char *p_value)
+{
+    return (NULL == p_value) ? ESP_ERR_INVALID_ARG : _set(handle, p_key, _TYPE_STR, p_value, strlen(p_value) + 1U);
+}
+
+esp_err_t nvs_get_str(nvs_handle_t handle, const char *p_key, char *p_value, size_t *p_len)
+{
+    return (NULL == p_len) ? ESP_ERR_INVALID_ARG : _get(handle, p_key, _TYPE_STR, p_value, p_len);
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *p_key, const void *p_value, size_t len)
+{
+    return ((NULL == p_value) && (0U < len)) ? ESP_ERR_INVALID_ARG : _set(handle, p_key, _TYPE_BLOB, p_value, len);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *p_key, void *p_value, size_t *p_len)
+{
+    return (NULL == p_len) ? ESP_ERR_INVALID_ARG : _get(handle, p_key, _TYPE_BLOB, p_value, p_len);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static esp_err_t _check(nvs_handle_t handle, const char *p_key, bool b_is_write)
+{
+    if(!_b_is_init)
+    {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    if(NVS_HANDLE_NS(handle) >= _namespace_count)
+    {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+
+    if(NULL == p_key)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(NVS_KEY_NAME_MAX_SIZE <= strlen(p_key))
+    {
+        return ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+
+    return (b_is_write && (NVS_READONLY == NVS_HANDLE_MODE(handle))) ? ESP_ERR_NVS_READ_ONLY : ESP_OK;
+}
+
+static _entry_t **_find(nvs_handle_t handle, const char *p_key)
+{
+    _entry_t **pp_entry = &p_entries;
+
+    while((NULL != *pp_entry) &&
+          ((NVS_HANDLE_NS(handle) != (*pp_entry)->ns) || (0 != strcmp((*pp_entry)->key, p_key))))
+    {
+        pp_entry = &(*pp_entry)->p_next;
+    }
+
+    return pp_entry;
+}
+
+static esp_err_t _set(nvs_handle_t handle, const char *p_key, _type_t type, const void *p_value, size_t len)
+{
+    uint8_t *p_data = malloc((0U < len) ? len : 1U);
+    if(NULL == p_data)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    if(0U < len)
+    {
+        memcpy(p_data, p_value, len);
+    }
+
+    (void)pthread_mutex_lock(&_mutex);
+
+    esp_err_t esp_err = _check(handle, p_key, true);
+
+    if(ESP_OK == esp_err)
+    {
+        _entry_t **pp_entry = _find(handle, p_key);
+
+        if(NULL == *pp_entry)
+        {
+            *pp_entry = calloc(1U, sizeof(_entry_t));
+            if(NULL == *pp_entry)
+            {
+                esp_err = ESP_ERR_NO_MEM;
+            }
+            else
+            {
+                (*pp_entry)->ns = NVS_HANDLE_NS(handle);
+                strcpy((*pp_entry)->key, p_key);
+            }
+        }
+
+        if(ESP_OK == esp_err)
+        {
+            free((*pp_entry)->p_data);
+            (*pp_entry)->type   = type;
+            (*pp_entry)->len    = len;
+            (*pp_entry)->p_data = p_data;
+            p_data              = NULL;
+        }
+    }
+
+    (void)pthread_mutex_unlock(&_mutex);
+    free(p_data);
+
+    return esp_err;
+}
+
+static esp_err_t _get(nvs_handle_t handle, const char *p_key, _type_t type, void *p_value, size_t *p_len)
+{
+    (void)pthread_mutex_lock(&_mutex);
+
+    esp_err_t esp_err = _check(handle, p_key, false);
+
+    if(ESP_OK == esp_err)
+    {
+        const _entry_t *p_entry = *_find(handle, p_key);
+
+        if((NULL == p_entry) || (type != p_entry->type))
+        {
+            esp_err = ESP_ERR_NVS_NOT_FOUND;
+        }
+        else if(NULL == p_value)
+        {
+            *p_len = p_entry->len;
+        }
+        else if(*p_len < p_entry->len)
+        {
+            esp_err = ESP_ERR_NVS_INVALID_LENGTH;
+        }
+        else
+        {
+            memcpy(p_value, p_entry->p_data, p_entry->len);
+            *p_len = p_entry->len;
+        }
+    }
+
+    (void)pthread_mutex_unlock(&_mutex);
+
+    return esp_err;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,151 @@
+/**
+ * @file telemetry_encoder_test.c
+ *
+ * @brief Checks that every float the JSON encoder prints reads back as the very same float. Covers the fixed and the
+ * exponent notation, subnormals, the largest floats and a run of random bit patterns. Options:
+ *   --count <n>  Random floats to check, 2000000 by default.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "telemetry_encoder.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define RANDOM_COUNT_DEFAULT (2000000U)
+#define JSON_SIZE            (256U)
+
+/* Failures printed before the rest are only counted. */
+#define FAILURES_SHOWN (10U)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+static bool     _round_trips(float value);
+static uint32_t _random(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const float _edge_values[] = {
+    0.0f, -0.0f, 1.0f, -1.0f, 0.1f, 21.5f, 99.99f, 1e-5f, 9.99999e-6f, 1e9f, 999999936.0f, 2.12068006e9f,
+    4294967296.0f, 1e10f, 3.4028235e38f, FLT_MAX, -FLT_MAX, FLT_MIN, 1.1754942e-38f, 1e-45f, 1.4e-45f, 7e-45f,
+};
+
+static uint32_t _seed     = 0x2545F491U;
+static uint32_t _failures = 0U;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+int main(int argc, char **argv)
+{
+    uint32_t count = RANDOM_COUNT_DEFAULT;
+
+    for(int arg = 1; arg < argc; arg++)
+    {
+        if((0 == strcmp(argv[arg], "--count")) && ((arg + 1) < argc))
+        {
+            count = (uint32_t)strtoul(argv[++arg], NULL, 10);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--count <n>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    uint32_t checked = 0U;
+
+    for(size_t i = 0U; i < (sizeof(_edge_values) / sizeof(_edge_values[0])); i++)
+    {
+        (void)_round_trips(_edge_values[i]);
+        checked++;
+    }
+
+    /* Every power of ten and its neighbours, where the notation and the digit count change. */
+    for(int32_t exp10 = -45; exp10 <= 38; exp10++)
+    {
+        char text[16];
+
+        (void)snprintf(text, sizeof(text), "1e%d", (int)exp10);
+        float value = strtof(text, NULL);
+
+        (void)_round_trips(nextafterf(value, 0.0f));
+        (void)_round_trips(value);
+        (void)_round_trips(nextafterf(value, INFINITY));
+        checked += 3U;
+    }
+
+    /* Large magnitudes, where the exponent notation is used. */
+    for(float value = 1e9f; isfinite(value); value *= 1.0001f)
+    {
+        (void)_round_trips(value);
+        checked++;
+    }
+
+    for(uint32_t i = 0U; i < count; i++)
+    {
+        uint32_t bits = _random();
+        float    value;
+
+        (void)memcpy(&value, &bits, sizeof(value));
+
+        if(isfinite(value))
+        {
+            (void)_round_trips(value);
+            checked++;
+        }
+    }
+
+    printf("telemetry_encoder: %u floats checked, %u did not read back\n", (unsigned)checked, (unsigned)_failures);
+
+    return (0U == _failures) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static bool _round_trips(float value)
+{
+    telemetry_sample_t sample = { .timestamp_ms = 0U, .temp = value };
+    uint8_t            json[JSON_SIZE];
+    size_t             len = 0U;
+
+    if(ESP_OK != telemetry_encode(TELEMETRY_FORMAT_JSON, &sample, 1U, json, sizeof(json) - 1U, &len))
+    {
+        _failures++;
+        return false;
+    }
+
+    json[len] = '\0';
+
+    const char *p_text = strstr((const char *)json, "\"temp\":") + strlen("\"temp\":");
+    float       parsed = strtof(p_text, NULL);
+
+    bool b_is_same = (0 == memcmp(&parsed, &value, sizeof(value)));
+
+    if(!b_is_same)
+    {
+        if(FAILURES_SHOWN > _failures)
+        {
+            const char *p_end = strchr(p_text, ',');
+            fprintf(stderr, "%.9g printed as %.*s\n", (double)value, (int)(p_end - p_text), p_text);
+        }
+        _failures++;
+    }
+
+    return b_is_same;
+}
+
+static uint32_t _random(void)
+{
+    /* xorshift32, the same sequence on every run. */
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 17;
+    _seed ^= _seed << 5;
+
+    return _seed;
+}
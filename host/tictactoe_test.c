@@ -0,0 +1,245 @@
+/**
+ * @file tictactoe_test.c
+ *
+ * @brief Checks the tic-tac-toe engine: win and draw detection on every line, move and undo rules, the opening table,
+ * and that the computer opponent never loses. The last is proved by playing it against every possible sequence of
+ * opponent moves, once as X and once as O.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "tictactoe.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define CHECK(COND) _check((COND), #COND, __LINE__)
+
+#define ARRAY_SIZE(X) (sizeof(X) / sizeof((X)[0]))
+
+//-------------------------------- DATA TYPES ---------------------------------
+/**
+ * @brief Game of known outcome, cells in the order they are played.
+ *
+ */
+typedef struct
+{
+    const char       *p_moves;
+    tictactoe_state_t state;
+    uint16_t          win_line;
+} _game_case_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+static void _check(bool b_is_ok, const char *p_cond, int line);
+static void _games_check(void);
+static void _rules_check(void);
+static void _best_move_check(void);
+
+/**
+ * @brief Plays every reply of the opponent to the engine from this position on and counts the games the engine lost.
+ */
+static void _engine_play_out(tictactoe_t *p_game, tictactoe_player_t engine);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const _game_case_t _games[] = {
+    {"01342", TICTACTOE_STATE_PLAYING, 0x000U},
+    {"03142", TICTACTOE_STATE_WON, 0x007U},     /* Top row. */
+    {"30415", TICTACTOE_STATE_WON, 0x038U},     /* Middle row. */
+    {"60718", TICTACTOE_STATE_WON, 0x1C0U},     /* Bottom row. */
+    {"01326", TICTACTOE_STATE_WON, 0x049U},     /* Left column. */
+    {"10427", TICTACTOE_STATE_WON, 0x092U},     /* Middle column. */
+    {"20518", TICTACTOE_STATE_WON, 0x124U},     /* Right column. */
+    {"01428", TICTACTOE_STATE_WON, 0x111U},     /* Main diagonal. */
+    {"21436", TICTACTOE_STATE_WON, 0x054U},     /* Anti-diagonal. */
+    {"031485", TICTACTOE_STATE_WON, 0x038U},    /* O wins. */
+    {"021538", TICTACTOE_STATE_WON, 0x124U},
+    {"402635718", TICTACTOE_STATE_DRAW, 0x000U},
+    {"012345768", TICTACTOE_STATE_WON, 0x111U}, /* Won with the last cell, not a draw. */
+};
+
+static uint32_t _failures     = 0U;
+static uint32_t _checks       = 0U;
+static uint32_t _losses       = 0U;
+static uint32_t _games_played = 0U;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+int main(int argc, char **argv)
+{
+    if(1 < argc)
+    {
+        fprintf(stderr, "usage: %s\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    _games_check();
+    _rules_check();
+    _best_move_check();
+
+    printf("tictactoe: %u checks, %u games against the engine, %u failed\n", (unsigned)_checks,
+           (unsigned)_games_played, (unsigned)_failures);
+
+    return (0U == _failures) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+static void _check(bool b_is_ok, const char *p_cond, int line)
+{
+    _checks++;
+
+    if(!b_is_ok)
+    {
+        fprintf(stderr, "tictactoe_test.c:%d: %s\n", line, p_cond);
+        _failures++;
+    }
+}
+
+static void _games_check(void)
+{
+    for(size_t index = 0U; index < ARRAY_SIZE(_games); index++)
+    {
+        const _game_case_t *p_case = &_games[index];
+        tictactoe_t         game;
+        size_t              count = strlen(p_case->p_moves);
+
+        tictactoe_reset(&game);
+
+        for(size_t move = 0U; move < count; move++)
+        {
+            /* Only the last move may end the game. */
+            CHECK(TICTACTOE_STATE_PLAYING == game.state);
+            CHECK(ESP_OK == tictactoe_play(&game, (uint8_t)(p_case->p_moves[move] - '0')));
+        }
+
+        CHECK(p_case->state == game.state);
+        CHECK(p_case->win_line == game.win_line);
+        CHECK(count == game.moves);
+    }
+}
+
+static void _rules_check(void)
+{
+    tictactoe_t game;
+    uint8_t     cell = 0U;
+
+    tictactoe_reset(&game);
+    CHECK(TICTACTOE_PLAYER_X == tictactoe_turn(&game));
+    CHECK(ESP_ERR_INVALID_STATE == tictactoe_undo(&game));
+    CHECK(ESP_ERR_INVALID_ARG == tictactoe_play(&game, TICTACTOE_CELLS));
+
+    CHECK(ESP_OK == tictactoe_play(&game, 4U));
+    CHECK(TICTACTOE_PLAYER_O == tictactoe_turn(&game));
+    CHECK(TICTACTOE_PLAYER_X == tictactoe_cell_owner(&game, 4U));
+    CHECK(TICTACTOE_PLAYER_COUNT == tictactoe_cell_owner(&game, 0U));
+    CHECK(TICTACTOE_PLAYER_COUNT == tictactoe_cell_owner(&game, TICTACTOE_CELLS));
+    CHECK(ESP_ERR_INVALID_ARG == tictactoe_play(&game, 4U));
+    CHECK(1U == game.moves);
+
+    /* X wins the top row, undo reopens the game and gives the cell back. */
+    const uint8_t moves[] = {3U, 0U, 5U, 1U, 6U, 2U};
+    for(size_t move = 0U; move < ARRAY_SIZE(moves); move++)
+    {
+        (void)tictactoe_play(&game, moves[move]);
+    }
+
+    CHECK(TICTACTOE_STATE_WON == game.state);
+    CHECK(ESP_ERR_INVALID_STATE == tictactoe_play(&game, 7U));
+    CHECK(ESP_ERR_INVALID_STATE == tictactoe_best_move(&game, &cell));
+
+    CHECK(ESP_OK == tictactoe_undo(&game));
+    CHECK(TICTACTOE_STATE_PLAYING == game.state);
+    CHECK(0U == game.win_line);
+    CHECK(TICTACTOE_PLAYER_X == tictactoe_turn(&game));
+    CHECK(TICTACTOE_PLAYER_COUNT == tictactoe_cell_owner(&game, 2U));
+    CHECK(ESP_OK == tictactoe_play(&game, 2U));
+    CHECK(TICTACTOE_STATE_WON == game.state);
+}
+
+static void _best_move_check(void)
+{
+    tictactoe_t game;
+    uint8_t     cell = TICTACTOE_CELLS;
+
+    /* Openings come from the table: the center first, the center in reply, a corner if the center is taken. */
+    tictactoe_reset(&game);
+    CHECK((ESP_OK == tictactoe_best_move(&game, &cell)) && (4U == cell));
+
+    for(uint8_t first = 0U; first < TICTACTOE_CELLS; first++)
+    {
+        tictactoe_reset(&game);
+        (void)tictactoe_play(&game, first);
+        CHECK((ESP_OK == tictactoe_best_move(&game, &cell)) && (((4U == first) ? 0U : 4U) == cell));
+    }
+
+    /* X at 0 and 1, O at 4 and 5: X takes the win at 2 rather than blocking O at 3. */
+    tictactoe_reset(&game);
+    (void)tictactoe_play(&game, 0U);
+    (void)tictactoe_play(&game, 4U);
+    (void)tictactoe_play(&game, 1U);
+    (void)tictactoe_play(&game, 5U);
+    CHECK((ESP_OK == tictactoe_best_move(&game, &cell)) && (2U == cell));
+
+    /* O at 4 and 0 threatens 8, X has to block there. */
+    tictactoe_reset(&game);
+    (void)tictactoe_play(&game, 1U);
+    (void)tictactoe_play(&game, 4U);
+    (void)tictactoe_play(&game, 7U);
+    (void)tictactoe_play(&game, 0U);
+    CHECK((ESP_OK == tictactoe_best_move(&game, &cell)) && (8U == cell));
+
+    /* Perfect play on both sides is a draw. */
+    tictactoe_reset(&game);
+    while(TICTACTOE_STATE_PLAYING == game.state)
+    {
+        (void)tictactoe_best_move(&game, &cell);
+        (void)tictactoe_play(&game, cell);
+    }
+    CHECK(TICTACTOE_STATE_DRAW == game.state);
+
+    for(uint8_t engine = 0U; engine < TICTACTOE_PLAYER_COUNT; engine++)
+    {
+        tictactoe_reset(&game);
+        _engine_play_out(&game, (tictactoe_player_t)engine);
+    }
+
+    CHECK(0U == _losses);
+}
+
+static void _engine_play_out(tictactoe_t *p_game, tictactoe_player_t engine)
+{
+    if(TICTACTOE_STATE_PLAYING != p_game->state)
+    {
+        /* A won game was won by whoever moved last. */
+        if((TICTACTOE_STATE_WON == p_game->state) && (engine == tictactoe_turn(p_game)))
+        {
+            _losses++;
+        }
+        _games_played++;
+        return;
+    }
+
+    if(engine == tictactoe_turn(p_game))
+    {
+        uint8_t cell = TICTACTOE_CELLS;
+
+        CHECK(ESP_OK == tictactoe_best_move(p_game, &cell));
+        CHECK(ESP_OK == tictactoe_play(p_game, cell));
+        _engine_play_out(p_game, engine);
+        (void)tictactoe_undo(p_game);
+        return;
+    }
+
+    for(uint8_t cell = 0U; cell < TICTACTOE_CELLS; cell++)
+    {
+        if(ESP_OK == tictactoe_play(p_game, cell))
+        {
+            _engine_play_out(p_game, engine);
+            (void)tictactoe_undo(p_game);
+        }
+    }
+}
@@ -1,15 +1,27 @@
 //
 //--------------------------------- INCLUDES ----------------------------------
 #include "user_interface.h"
+#include "led_pattern.h"
+#include "telemetry.h"
+#include "telemetry_encoder.h"
+#include "wifi_manager.h"
+#include "power.h"
+#include "mqtt_publisher.h"
+#include "command.h"
+#include "tictactoe.h"
+#include "gui_screen.h"
+#include "gui_dashboard.h"
+#include "gui_perf.h"
+#include "esp_timer.h"
 #include "driver/gpio.h"
-#include "driver/ledc.h"
 
 #include <esp_event.h>
 #include <esp_log.h>
 #include <esp_netif.h>
 #include "esp_system.h"
 #include <esp_wifi.h>
-#include "senzor_temp/sht31.h"
+#include "sht31.h"
+#include "lis2dh12.h"
 #include "driver/i2c.h"
 #include "esp_system.h"
 #include "esp_wifi.h"
@@ -23,23 +35,44 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/semphr.h>
+#include <freertos/queue.h>
 
 #include <nvs_flash.h>
 #include "mqtt_client.h"
 
 #include <stdio.h>
 #include <string.h>
-#include "cJSON.h"
 
 //---------------------------------- MACROS -----------------------------------
 #define EXAMPLE_ESP_WIFI_SSID ("ZICER-guest")
 #define EXAMPLE_ESP_WIFI_PASS ("Z1c3r.10020")
 
 #define DELAY_TIME_MS (5000U)
-#define BOUNCING_MS (20U)
+
+#define SENZOR_QUEUE_SIZE (4U)
+#define VIBRATION_QUEUE_SIZE (2U)
+#define TELEMETRY_BATCH_SIZE (10U)
+#define TELEMETRY_FLUSH_PERIOD_MS (10000U)
+
+/* POWER_MODE_LOW_POWER for battery stations. */
+#define POWER_MODE (POWER_MODE_PERFORMANCE)
+/* Low power: 30 SHT31 samples at 0.5 Hz fit in the telemetry ring without spilling to flash. */
+#define POWER_RADIO_PERIOD_MS (60000U)
+#define POWER_RADIO_WINDOW_MS (10000U)
+#define POWER_REPORT_PERIOD_MS (60000U)
+#define HEALTH_MSG_SIZE (768U)
 
 #define CONFIG_BROKER_URL "mqtt://4gpc.l.time4vps.cloud"
+#define MQTT_STATION "Saturn"
 #define MQTT_TOPIC "WES/Saturn/sensors"
+#define MQTT_TOPIC_BINARY "WES/Saturn/sensors/bin"
+#define MQTT_TOPIC_VIBRATION "WES/Saturn/vibration"
+#define MQTT_TOPIC_HEALTH "WES/Saturn/health"
+/* Local tic-tac-toe moves, the opponent answers on WES/Saturn/cmd/move. */
+#define MQTT_TOPIC_GAME "WES/Saturn/game"
+
+/* GUI_APP_OPPONENT_AI or GUI_APP_OPPONENT_LOCAL to play without a remote station. */
+#define GAME_OPPONENT (GUI_APP_OPPONENT_REMOTE)
 
 #if CONFIG_ESP_WIFI_AUTH_OPEN
 #define ESP_WIFI_SCAN_AUTH_MODE_THRESHOLD WIFI_AUTH_OPEN
@@ -59,61 +92,39 @@
 #define ESP_WIFI_SCAN_AUTH_MODE_THRESHOLD WIFI_AUTH_WAPI_PSK
 #endif
 
-#define BUZZER_GPIO 2
-#define BUZZER_CHANNEL LEDC_CHANNEL_0
-#define BUZZER_FREQ_HZ 1000
-
-#define GPIO_BUTTON_1 (36U)
-#define GPIO_BUTTON_2 (32U)
-
-#define GPIO_BIT_MASK(X) ((1ULL << (X)))
-#define GPIO_LED_BLUE (14U)
-#define GPIO_LED_RED (26U)
-#define GPIO_LED_GREEN (27U)
-
-#define BUZZ_SHORT (100U)
-#define BUZZ_LONG (300U)
-
 //-------------------------------- DATA TYPES ---------------------------------
 
 //---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
 
-static void _event_handler(void *p_arg, esp_event_base_t event_base, int32_t event_id, void *p_event_data);
-static void _wifi_init_sta(void);
+static void _wifi_state_cb(wifi_manager_state_t state, void *p_arg);
 static void _wifi_init(void);
 static esp_err_t _nvs_init(void);
 
-static void _hello_task(void *p_parameter);
-static void _buzzer_task(void *p_parameter);
 static void _senzor_task(void *p_parameter);
+static void _vibration_task(void *p_parameter);
 
-static void mqtt_event_handler();
+static void mqtt_event_handler(esp_mqtt_event_handle_t event, void *p_arg);
 static void mqtt_app_start(void);
+static bool _telemetry_publish(const char *p_topic, const uint8_t *p_payload, size_t len, void *p_arg);
+static bool _telemetry_is_flushed(void *p_arg);
+static void _user_interface_handler(user_interface_event_t event, uint16_t arg);
+static void _game_move_cb(uint8_t seq, uint8_t cell, void *p_arg);
+static void _health_publish(void);
+static unsigned _stack_free(TaskHandle_t p_task);
 
-typedef void (*button_pressed_isr_t)(void *p_arg);
-static esp_err_t _button_init(uint8_t pin, button_pressed_isr_t p_isr);
-static void _btn_1_isr(void *p_arg);
-static void _btn_2_isr(void *p_arg);
-
-static void _sos_sequence();
-static void turn_on_buzzer();
-static void turn_off_buzzer();
-
-static void _led_init(uint8_t pin);
-static void _led_on(uint8_t pin);
-static void _led_off(uint8_t pin);
 
 //------------------------- STATIC DATA & CONSTANTS ---------------------------
 static const char *MQTT_TAG = "MQTT";
 static const char *WIFI_TAG = "WIFI";
+static const char *SENZOR_TAG = "SENZOR";
 
-static EventGroupHandle_t s_wifi_event_group;
-static SemaphoreHandle_t semafor;
+/* Latest accelerometer window, overwritten by the vibration task and peeked by the sensor task. */
+static QueueHandle_t p_acc_mailbox;
 
-esp_mqtt_client_handle_t client;
-esp_mqtt_client_config_t mqtt_cfg;
+/* Kept for the stack high-water marks in the health message, cleared if the task gives up. */
+static TaskHandle_t p_vibration_task = NULL;
+static TaskHandle_t p_senzor_task = NULL;
 
-TaskHandle_t xHandle = NULL;
 
 //------------------------------- GLOBAL DATA ---------------------------------
 
@@ -121,28 +132,49 @@ TaskHandle_t xHandle = NULL;
 
 void app_main(void)
 {
-    _button_init(GPIO_BUTTON_1, _btn_1_isr);
-    _button_init(GPIO_BUTTON_2, _btn_2_isr);
-
-    _led_init(GPIO_LED_BLUE);
-    _led_init(GPIO_LED_RED);
-    _led_init(GPIO_LED_GREEN);
-
-    semafor = xSemaphoreCreateBinary();
-    user_interface_init();
-    vTaskDelay(DELAY_TIME_MS / 5 / portTICK_PERIOD_MS);
+    mqtt_app_start();
+    /* Wi-Fi first, the connect runs in the background while the rest comes up. */
     _wifi_init();
+    user_interface_init(_user_interface_handler);
+    vTaskDelay(DELAY_TIME_MS / 5 / portTICK_PERIOD_MS);
 
-    int index = 0;
+    if (ESP_OK != gui_app_game_set_opponent(GAME_OPPONENT, _game_move_cb, NULL))
+    {
+        ESP_LOGW(MQTT_TAG, "Game opponent was not set.");
+    }
+
+    telemetry_config_t telemetry_config = {
+        .topics = {
+            {.p_topic = MQTT_TOPIC, .format = TELEMETRY_FORMAT_JSON},
+            {.p_topic = MQTT_TOPIC_BINARY, .format = TELEMETRY_FORMAT_BINARY},
+        },
+        .topic_count = 2U,
+        .p_publish_cb = _telemetry_publish,
+        .p_publish_arg = NULL,
+        .batch_size = TELEMETRY_BATCH_SIZE,
+        .flush_period_ms = TELEMETRY_FLUSH_PERIOD_MS,
+    };
+    ESP_ERROR_CHECK(telemetry_init(&telemetry_config));
+
+    power_config_t power_config = {
+        .mode = POWER_MODE,
+        .radio_period_ms = POWER_RADIO_PERIOD_MS,
+        .radio_window_ms = POWER_RADIO_WINDOW_MS,
+        .p_is_flushed_cb = _telemetry_is_flushed,
+        .p_cb_arg = NULL,
+    };
+    ESP_ERROR_CHECK(power_init(&power_config));
 
-    xTaskCreate(&_hello_task, "hello_task", 4 * 1024, NULL, 5, NULL);
-    xTaskCreate(&_senzor_task, "senzor_task", 2 * 1024, NULL, 5, NULL);
+    p_acc_mailbox = xQueueCreate(1, sizeof(acc_features_t));
+    xTaskCreate(&_vibration_task, "vibration_task", 3 * 1024, NULL, 5, &p_vibration_task);
+    xTaskCreate(&_senzor_task, "senzor_task", 2 * 1024, NULL, 5, &p_senzor_task);
 
     for (;;)
     {
-        printf("[%d] WiFi Example!\n", index);
-        index++;
-        vTaskDelay(DELAY_TIME_MS / portTICK_PERIOD_MS);
+        vTaskDelay(POWER_REPORT_PERIOD_MS / portTICK_PERIOD_MS);
+        power_report_print();
+        gui_screen_report_print();
+        _health_publish();
     }
 }
 
@@ -150,171 +182,255 @@ void app_main(void)
 
 static void mqtt_app_start(void)
 {
-    mqtt_cfg = (esp_mqtt_client_config_t){
-        .broker.address.uri = CONFIG_BROKER_URL,
-    };
-    client = esp_mqtt_client_init(&mqtt_cfg);
-    esp_mqtt_client_register_event(client, ESP_EVENT_ANY_ID, mqtt_event_handler, NULL);
-    esp_mqtt_client_start(client);
+    mqtt_publisher_config_t mqtt_publisher_config = MQTT_PUBLISHER_CONFIG_DEFAULT();
+    mqtt_publisher_config.p_broker_uri = CONFIG_BROKER_URL;
+    /* Telemetry keeps a rejected batch and spills it to flash, so newer data must not evict accepted batches. */
+    mqtt_publisher_config.policy = MQTT_PUBLISHER_DROP_NEWEST;
+    mqtt_publisher_config.p_event_cb = mqtt_event_handler;
+
+    ESP_ERROR_CHECK(mqtt_publisher_init(&mqtt_publisher_config));
+    /* Remote commands arrive on WES/<station>/cmd/<name>. */
+    ESP_ERROR_CHECK(command_init(MQTT_STATION));
 }
 
-static void _hello_task(void *p_parameter)
+static void _user_interface_handler(user_interface_event_t event, uint16_t arg)
 {
-    xSemaphoreTake(semafor, portMAX_DELAY);
-    mqtt_app_start();
-    for (;;)
+    switch (event)
     {
-        vTaskDelay(DELAY_TIME_MS / portTICK_PERIOD_MS);
+    case USER_INTERFACE_EVENT_REMOTE_RATE:
+        if (ESP_OK != sht31_set_rate((sht31_rate_t)arg))
+        {
+            ESP_LOGW(SENZOR_TAG, "SHT31 rate change failed.");
+        }
+        break;
+    default:
+        break;
     }
 }
 
-static void _buzzer_task(void *p_parameter)
+static void _game_move_cb(uint8_t seq, uint8_t cell, void *p_arg)
 {
-    esp_rom_gpio_pad_select_gpio(BUZZER_GPIO);
-    gpio_set_direction(BUZZER_GPIO, GPIO_MODE_OUTPUT);
-
-    ledc_timer_config_t ledc_timer = {.speed_mode = LEDC_HIGH_SPEED_MODE, .duty_resolution = LEDC_TIMER_8_BIT, .timer_num = LEDC_TIMER_0, .freq_hz = BUZZER_FREQ_HZ};
-    ledc_timer_config(&ledc_timer);
-
-    ledc_channel_config_t ledc_channel = {
-        .gpio_num = BUZZER_GPIO,
-        .speed_mode = LEDC_HIGH_SPEED_MODE,
-        .channel = BUZZER_CHANNEL,
-        .intr_type = LEDC_INTR_DISABLE,
-        .timer_sel = LEDC_TIMER_0,
-        .duty = 0 // Duty cycle (0-255), adjust as needed
-    };
-    ledc_channel_config(&ledc_channel);
+    (void)p_arg;
 
-    for (;;)
-    {
-        _sos_sequence();
-        vTaskDelay(1000 / portTICK_PERIOD_MS);
-    }
+    uint8_t msg[TICTACTOE_MSG_SIZE];
+    tictactoe_msg_encode(seq, cell, msg);
+
+    /* QoS 1, the opponent drops redelivered moves by their sequence number. */
+    (void)mqtt_publisher_publish(MQTT_TOPIC_GAME, msg, sizeof(msg), 1);
 }
 
-static void _senzor_task(void *p_parameter)
+static void _health_publish(void)
 {
-    sht31_init();
-    float temp, humi;
-    for (;;)
+    /* Static, the main task's stack is small. */
+    static char msg[HEALTH_MSG_SIZE];
+    gui_perf_stats_t gui_stats;
+    size_t gui_len = 0U;
+
+    /* Each message covers one period. */
+    if (ESP_OK != gui_perf_get(&gui_stats, true))
     {
-        vTaskDelay(DELAY_TIME_MS / portTICK_PERIOD_MS);
-        sht31_read_temp_humi(&temp, &humi);
-        printf("temp: %f, humi: %f\n", temp, humi);
-
-        cJSON *root = cJSON_CreateObject();
-        cJSON_AddNumberToObject(root, "temp", (int)temp);
-        cJSON_AddNumberToObject(root, "hum", (int)humi);
-        cJSON *acc = cJSON_CreateObject();
-        cJSON_AddNumberToObject(acc, "x", 1.0);
-        cJSON_AddNumberToObject(acc, "y", 1.0);
-        cJSON_AddNumberToObject(acc, "z", 1.0);
-        cJSON_AddItemToObject(root, "acc", acc);
-        char *json_str = cJSON_Print(root);
-        cJSON_Delete(root);
-        esp_mqtt_client_publish(client, MQTT_TOPIC, json_str, 0, 1, 0);
-        free(json_str);
+        ESP_LOGW(MQTT_TAG, "GUI counters not read.");
+        return;
     }
+
+    int len = snprintf(msg, sizeof(msg), "{\"up\":%lu,\"stack\":{\"main\":%u,\"senzor\":%u,\"vibration\":%u},\"gui\":",
+                       (unsigned long)(esp_timer_get_time() / 1000000LL), _stack_free(xTaskGetCurrentTaskHandle()),
+                       _stack_free(p_senzor_task), _stack_free(p_vibration_task));
+
+    /* One byte is kept for the closing brace. */
+    if ((0 > len) || ((size_t)len >= (sizeof(msg) - 1U)) ||
+        (ESP_OK != gui_perf_to_json(&gui_stats, &msg[len], sizeof(msg) - 1U - (size_t)len, &gui_len)))
+    {
+        ESP_LOGW(MQTT_TAG, "Health message too long.");
+        return;
+    }
+
+    len += (int)gui_len;
+    msg[len++] = '}';
+
+    /* QoS 0, the next message supersedes a lost one. */
+    (void)mqtt_publisher_publish(MQTT_TOPIC_HEALTH, msg, (size_t)len, 0);
 }
 
-static void _wifi_init(void)
+static unsigned _stack_free(TaskHandle_t p_task)
 {
-    _nvs_init();
-    _wifi_init_sta();
+    /* In bytes on ESP-IDF. */
+    return (NULL == p_task) ? 0U : (unsigned)uxTaskGetStackHighWaterMark(p_task);
 }
 
-static esp_err_t _nvs_init(void)
+static bool _telemetry_publish(const char *p_topic, const uint8_t *p_payload, size_t len, void *p_arg)
 {
-    esp_err_t ret = nvs_flash_init();
-    if ((ESP_ERR_NVS_NO_FREE_PAGES == ret) || (ESP_ERR_NVS_NEW_VERSION_FOUND == ret))
-    {
-        ret = nvs_flash_erase();
-        ret |= nvs_flash_init();
-    }
-    return ret;
+    (void)p_arg;
+
+    /* Never blocks, a full outbox leaves the batch with telemetry. */
+    return ESP_OK == mqtt_publisher_publish(p_topic, p_payload, len, 1);
 }
 
-static void _wifi_init_sta(void)
+static bool _telemetry_is_flushed(void *p_arg)
 {
-    s_wifi_event_group = xEventGroupCreate();
-
-    ESP_ERROR_CHECK(esp_netif_init());
+    (void)p_arg;
+    telemetry_stats_t stats;
+    mqtt_publisher_stats_t mqtt_stats;
 
-    ESP_ERROR_CHECK(esp_event_loop_create_default());
-    esp_netif_create_default_wifi_sta();
+    telemetry_get_stats(&stats);
+    mqtt_publisher_get_stats(&mqtt_stats);
 
-    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    ESP_ERROR_CHECK(esp_wifi_init(&cfg));
+    return mqtt_stats.b_is_connected && (0U == stats.ring_level) && (0U == stats.spill_blocks) &&
+           (0U == mqtt_stats.outbox_msgs) && (0U == mqtt_stats.inflight);
+}
 
-    esp_event_handler_instance_t instance_any_id;
-    esp_event_handler_instance_t instance_got_ip;
-    ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &_event_handler, NULL, &instance_any_id));
-    ESP_ERROR_CHECK(esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &_event_handler, NULL, &instance_got_ip));
+static void _senzor_task(void *p_parameter)
+{
+    QueueHandle_t p_sample_queue = xQueueCreate(SENZOR_QUEUE_SIZE, sizeof(sht31_sample_t));
+    sht31_config_t sht31_config = SHT31_CONFIG_DEFAULT();
+    sht31_config.p_sample_queue = p_sample_queue;
+    if (POWER_MODE_LOW_POWER == POWER_MODE)
+    {
+        sht31_config.rate = SHT31_RATE_0_5_MPS;
+    }
 
-    wifi_config_t wifi_config = {
-        .sta = {
-            .ssid = EXAMPLE_ESP_WIFI_SSID,
-            .password = EXAMPLE_ESP_WIFI_PASS,
-            .threshold.authmode = WIFI_AUTH_WPA2_PSK,
-            .sae_pwe_h2e = WPA3_SAE_PWE_BOTH,
-        },
-    };
-    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
-    ESP_ERROR_CHECK(esp_wifi_start());
+    if ((NULL == p_sample_queue) || (ESP_OK != sht31_init(&sht31_config)))
+    {
+        ESP_LOGE(SENZOR_TAG, "SHT31 init failed.");
+        p_senzor_task = NULL;
+        vTaskDelete(NULL);
+    }
 
-    ESP_LOGI(WIFI_TAG, "wifi_init_sta finished.");
+    sht31_sample_t sht31_sample;
+    acc_features_t acc_features;
+    telemetry_sample_t sample = {0};
+    for (;;)
+    {
+        /* Samples arrive at the sensor's periodic acquisition rate. */
+        if (pdTRUE == xQueueReceive(p_sample_queue, &sht31_sample, portMAX_DELAY))
+        {
+            sample.timestamp_ms = sht31_sample.timestamp_ms;
+            sample.temp = sht31_sample.temp;
+            sample.humi = sht31_sample.humi;
+
+            /* The window mean is the static acceleration, i.e. the orientation of the board. */
+            if (pdTRUE == xQueuePeek(p_acc_mailbox, &acc_features, 0))
+            {
+                sample.acc_x = acc_features.mean[ACC_AXIS_X];
+                sample.acc_y = acc_features.mean[ACC_AXIS_Y];
+                sample.acc_z = acc_features.mean[ACC_AXIS_Z];
+            }
+            telemetry_push(&sample);
+
+            /* Lock-free, the GUI picks the sample up on its next frame. */
+            (void)gui_dashboard_push(sht31_sample.temp, sht31_sample.humi);
+        }
+    }
 }
 
-//---------------------------- INTERRUPT HANDLERS -----------------------------
-
-static void _event_handler(void *p_arg, esp_event_base_t event_base, int32_t event_id, void *p_event_data)
+static void _vibration_task(void *p_parameter)
 {
-    if ((WIFI_EVENT == event_base) && (WIFI_EVENT_STA_START == event_id))
+    QueueHandle_t p_features_queue = xQueueCreate(VIBRATION_QUEUE_SIZE, sizeof(acc_features_t));
+    lis2dh12_config_t lis2dh12_config = LIS2DH12_CONFIG_DEFAULT();
+    lis2dh12_config.p_features_queue = p_features_queue;
+    if (POWER_MODE_LOW_POWER == POWER_MODE)
     {
-        ESP_LOGI(WIFI_TAG, "Try to connect.");
-        esp_wifi_connect();
+        /* The FIFO then fills in 320 ms, so the CPU can sleep in between. */
+        lis2dh12_config.odr = LIS2DH12_ODR_100HZ;
     }
-    else if ((IP_EVENT == event_base) && (IP_EVENT_STA_GOT_IP == event_id))
+
+    if ((NULL == p_features_queue) || (NULL == p_acc_mailbox) || (ESP_OK != lis2dh12_init(&lis2dh12_config)))
     {
-        ip_event_got_ip_t *p_event = (ip_event_got_ip_t *)p_event_data;
-        ESP_LOGI(WIFI_TAG, "CONNECTED with IP Address:" IPSTR, IP2STR(&p_event->ip_info.ip));
-        xSemaphoreGive(semafor);
+        ESP_LOGE(SENZOR_TAG, "LIS2DH12 init failed.");
+        p_vibration_task = NULL;
+        vTaskDelete(NULL);
     }
-    else if ((IP_EVENT == event_base))
+
+    static char payload[ACC_FEATURES_JSON_SIZE_MAX];
+    acc_features_t features;
+    size_t len;
+
+    for (;;)
     {
-        printf("eventid: %ld\n", event_id);
+        /* One feature window arrives per ACC_FEATURES_WINDOW_SIZE samples, raw samples stay in the driver. */
+        if (pdTRUE == xQueueReceive(p_features_queue, &features, portMAX_DELAY))
+        {
+            xQueueOverwrite(p_acc_mailbox, &features);
+
+            if (ESP_OK == acc_features_to_json(&features, payload, sizeof(payload), &len))
+            {
+                (void)mqtt_publisher_publish(MQTT_TOPIC_VIBRATION, payload, len, 0);
+            }
+        }
     }
-    else if ((WIFI_EVENT == event_base) && (WIFI_EVENT_STA_DISCONNECTED == event_id))
+}
+
+static void _wifi_init(void)
+{
+    /* Used only until a network is provisioned over the console, e.g. "wifi add <ssid> <password>". */
+    static const wifi_manager_network_t default_network = {
+        .ssid = EXAMPLE_ESP_WIFI_SSID,
+        .password = EXAMPLE_ESP_WIFI_PASS,
+    };
+    wifi_manager_config_t wifi_manager_config = {
+        .p_state_cb = _wifi_state_cb,
+        .p_cb_arg = NULL,
+        .p_default_network = &default_network,
+        .b_is_serial_provisioning = true,
+    };
+
+    ESP_ERROR_CHECK(_nvs_init());
+    ESP_ERROR_CHECK(wifi_manager_init(&wifi_manager_config));
+}
+
+static esp_err_t _nvs_init(void)
+{
+    esp_err_t ret = nvs_flash_init();
+    if ((ESP_ERR_NVS_NO_FREE_PAGES == ret) || (ESP_ERR_NVS_NEW_VERSION_FOUND == ret))
     {
-        ESP_LOGI(WIFI_TAG, "DISCONNECTED. \nReconnecting to the AP again...");
-        esp_wifi_connect();
+        ret = nvs_flash_erase();
+        ret |= nvs_flash_init();
     }
-    else if ((WIFI_EVENT == event_base) && (WIFI_EVENT_STA_CONNECTED == event_id))
+    return ret;
+}
+
+static void _wifi_state_cb(wifi_manager_state_t state, void *p_arg)
+{
+    (void)p_arg;
+
+    if (WIFI_MANAGER_STATE_CONNECTED == state)
+    {
+        ESP_LOGI(WIFI_TAG, "CONNECTED.");
+        /* Connects the first time, afterwards skips the client's reconnect timeout, the radio may be on only for a
+         * short flush window. */
+        mqtt_publisher_start();
+    }
+    else if (WIFI_MANAGER_STATE_PROVISIONING == state)
     {
-        ESP_LOGI(WIFI_TAG, "CONNECTED.\n");
+        ESP_LOGW(WIFI_TAG, "No network stored, use: wifi add <ssid> <password>");
     }
 }
 
-static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data)
-{
-    esp_mqtt_event_handle_t event = event_data;
-    esp_mqtt_client_handle_t client = event->client;
-    int msg_id;
+//---------------------------- INTERRUPT HANDLERS -----------------------------
 
+static void mqtt_event_handler(esp_mqtt_event_handle_t event, void *p_arg)
+{
     switch (event->event_id)
     {
     case MQTT_EVENT_CONNECTED:
         ESP_LOGI(MQTT_TAG, "Connected to MQTT broker");
+        command_handle_event(event);
+        telemetry_set_link_state(true);
+        led_pattern_stop(LED_PATTERN_CHANNEL_MASK(LED_PATTERN_CHANNEL_RED), LED_PATTERN_PRIO_NORMAL);
+        led_pattern_play(LED_PATTERN_HEARTBEAT, LED_PATTERN_CHANNEL_MASK(LED_PATTERN_CHANNEL_GREEN), LED_PATTERN_PRIO_LOW);
         break;
     case MQTT_EVENT_DISCONNECTED:
         ESP_LOGI(MQTT_TAG, "Disconnected from MQTT broker");
+        telemetry_set_link_state(false);
+        led_pattern_stop(LED_PATTERN_CHANNEL_MASK(LED_PATTERN_CHANNEL_GREEN), LED_PATTERN_PRIO_LOW);
+        /* In low power mode the link goes down on purpose between flush windows. */
+        if (POWER_MODE_PERFORMANCE == POWER_MODE)
+        {
+            led_pattern_play(LED_PATTERN_ERROR_2, LED_PATTERN_CHANNEL_MASK(LED_PATTERN_CHANNEL_RED), LED_PATTERN_PRIO_NORMAL);
+        }
         break;
     case MQTT_EVENT_SUBSCRIBED:
         ESP_LOGI(MQTT_TAG, "MQTT_EVENT_SUBSCRIBED, msg_id=%d", event->msg_id);
-        msg_id = esp_mqtt_client_publish(client, "/topic/qos0", "data", 0, 0, 0);
-        ESP_LOGI(MQTT_TAG, "sent publish successful, msg_id=%d", msg_id);
         break;
     case MQTT_EVENT_UNSUBSCRIBED:
         ESP_LOGI(MQTT_TAG, "MQTT_EVENT_UNSUBSCRIBED, msg_id=%d", event->msg_id);
@@ -323,9 +439,7 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
         ESP_LOGI(MQTT_TAG, "MQTT_EVENT_PUBLISHED, msg_id=%d", event->msg_id);
         break;
     case MQTT_EVENT_DATA:
-        ESP_LOGI(MQTT_TAG, "MQTT_EVENT_DATA");
-        printf("TOPIC=%.*s\r\n", event->topic_len, event->topic);
-        printf("DATA=%.*s\r\n", event->data_len, event->data);
+        command_handle_event(event);
         break;
     case MQTT_EVENT_ANY:
         ESP_LOGI(MQTT_TAG, "MQTT_EVENT_ANY");
@@ -348,189 +462,3 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
         break;
     }
 }
-
-static void IRAM_ATTR _btn_1_isr(void *p_arg)
-{
-    (void)p_arg;
-    xTaskCreate(&_buzzer_task, "buzzer_task", 2 * 1024, NULL, 5, &xHandle);
-}
-
-static void IRAM_ATTR _btn_2_isr(void *p_arg)
-{
-    (void)p_arg;
-    vTaskDelete(xHandle);
-    turn_off_buzzer();
-    _led_off(GPIO_LED_BLUE);
-    _led_off(GPIO_LED_RED);
-    _led_off(GPIO_LED_GREEN);
-}
-
-static esp_err_t _button_init(uint8_t pin, button_pressed_isr_t p_isr)
-{
-    gpio_config_t io_conf = {
-        .pin_bit_mask = (1ULL << pin),
-        .mode = GPIO_MODE_INPUT,
-        .pull_up_en = GPIO_PULLUP_DISABLE,
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = (GPIO_INTR_POSEDGE),
-    };
-
-    esp_err_t esp_err = gpio_config(&io_conf);
-
-    if (ESP_OK == esp_err)
-    {
-        esp_err = gpio_set_intr_type(io_conf.pin_bit_mask, io_conf.intr_type);
-    }
-
-    if (ESP_OK == esp_err)
-    {
-        gpio_install_isr_service(ESP_INTR_FLAG_LEVEL3);
-    }
-
-    if (ESP_OK == esp_err)
-    {
-        esp_err = gpio_isr_handler_add(pin, p_isr, (void *)&pin);
-    }
-
-    return esp_err;
-}
-
-//------------------------------ BUZZER FUNCTIONS --------------------------------
-
-void turn_on_buzzer()
-{
-    ledc_set_duty(LEDC_HIGH_SPEED_MODE, BUZZER_CHANNEL, 128);
-    ledc_update_duty(LEDC_HIGH_SPEED_MODE, BUZZER_CHANNEL);
-}
-
-void turn_off_buzzer()
-{
-    ledc_set_duty(LEDC_HIGH_SPEED_MODE, BUZZER_CHANNEL, 0);
-    ledc_update_duty(LEDC_HIGH_SPEED_MODE, BUZZER_CHANNEL);
-}
-
-static void _sos_sequence()
-{
-    turn_on_buzzer();
-    _led_on(GPIO_LED_BLUE);
-    _led_on(GPIO_LED_RED);
-    _led_on(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_SHORT / portTICK_PERIOD_MS);
-    turn_off_buzzer();
-    _led_off(GPIO_LED_BLUE);
-    _led_off(GPIO_LED_RED);
-    _led_off(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_SHORT / portTICK_PERIOD_MS);
-    turn_on_buzzer();
-    _led_on(GPIO_LED_BLUE);
-    _led_on(GPIO_LED_RED);
-    _led_on(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_SHORT / portTICK_PERIOD_MS);
-    turn_off_buzzer();
-    _led_off(GPIO_LED_BLUE);
-    _led_off(GPIO_LED_RED);
-    _led_off(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_SHORT / portTICK_PERIOD_MS);
-    turn_on_buzzer();
-    _led_on(GPIO_LED_BLUE);
-    _led_on(GPIO_LED_RED);
-    _led_on(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_SHORT / portTICK_PERIOD_MS);
-    turn_off_buzzer();
-    _led_off(GPIO_LED_BLUE);
-    _led_off(GPIO_LED_RED);
-    _led_off(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_SHORT / portTICK_PERIOD_MS);
-
-    turn_on_buzzer();
-    _led_on(GPIO_LED_BLUE);
-    _led_on(GPIO_LED_RED);
-    _led_on(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_LONG / portTICK_PERIOD_MS);
-    turn_off_buzzer();
-    _led_off(GPIO_LED_BLUE);
-    _led_off(GPIO_LED_RED);
-    _led_off(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_LONG / portTICK_PERIOD_MS);
-    turn_on_buzzer();
-    _led_on(GPIO_LED_BLUE);
-    _led_on(GPIO_LED_RED);
-    _led_on(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_LONG / portTICK_PERIOD_MS);
-    turn_off_buzzer();
-    _led_off(GPIO_LED_BLUE);
-    _led_off(GPIO_LED_RED);
-    _led_off(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_LONG / portTICK_PERIOD_MS);
-    turn_on_buzzer();
-    _led_on(GPIO_LED_BLUE);
-    _led_on(GPIO_LED_RED);
-    _led_on(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_LONG / portTICK_PERIOD_MS);
-    turn_off_buzzer();
-    _led_off(GPIO_LED_BLUE);
-    _led_off(GPIO_LED_RED);
-    _led_off(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_LONG / portTICK_PERIOD_MS);
-
-    turn_on_buzzer();
-    _led_on(GPIO_LED_BLUE);
-    _led_on(GPIO_LED_RED);
-    _led_on(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_SHORT / portTICK_PERIOD_MS);
-    turn_off_buzzer();
-    _led_off(GPIO_LED_BLUE);
-    _led_off(GPIO_LED_RED);
-    _led_off(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_SHORT / portTICK_PERIOD_MS);
-    turn_on_buzzer();
-    _led_on(GPIO_LED_BLUE);
-    _led_on(GPIO_LED_RED);
-    _led_on(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_SHORT / portTICK_PERIOD_MS);
-    turn_off_buzzer();
-    _led_off(GPIO_LED_BLUE);
-    _led_off(GPIO_LED_RED);
-    _led_off(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_SHORT / portTICK_PERIOD_MS);
-    turn_on_buzzer();
-    _led_on(GPIO_LED_BLUE);
-    _led_on(GPIO_LED_RED);
-    _led_on(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_SHORT / portTICK_PERIOD_MS);
-    turn_off_buzzer();
-    _led_off(GPIO_LED_BLUE);
-    _led_off(GPIO_LED_RED);
-    _led_off(GPIO_LED_GREEN);
-    vTaskDelay(BUZZ_SHORT / portTICK_PERIOD_MS);
-}
-
-//------------------------------ LED FUNCIONS --------------------------------
-
-static void _led_init(uint8_t pin)
-{
-    // zero-initialize the config structure.
-    gpio_config_t io_conf = {};
-    // disable interrupt
-    io_conf.intr_type = GPIO_INTR_DISABLE;
-    // set as output mode
-    io_conf.mode = GPIO_MODE_OUTPUT;
-    // bit mask of the pins that you want to set,e.g.GPIO18/19
-    io_conf.pin_bit_mask = GPIO_BIT_MASK(pin);
-    // disable pull-down mode
-    io_conf.pull_down_en = 0;
-    // disable pull-up mode
-    io_conf.pull_up_en = 0;
-    // configure GPIO with the given settings
-    gpio_config(&io_conf);
-}
-
-static void _led_on(uint8_t pin)
-{
-    gpio_set_level(pin, 1U);
-}
-
-static void _led_off(uint8_t pin)
-{
-    gpio_set_level(pin, 0U);
-}
\ No newline at end of file